@@ -0,0 +1,31 @@
+# invoked by fxng_add_shaders with GLSLC, SOURCE, OUTPUT, STAGE, TARGET_ENV and CACHE_DIR defined
+#
+# the cache key covers the source contents, the stage, the target environment and the compiler itself, so touching a
+# file or switching branches back and forth never recompiles an already known shader
+
+set(FLAGS -fshader-stage=${STAGE} --target-env=${TARGET_ENV} -fauto-map-locations -fauto-bind-uniforms -O)
+
+execute_process(COMMAND "${GLSLC}" --version OUTPUT_VARIABLE GLSLC_VERSION)
+
+file(SHA256 "${SOURCE}" SOURCE_HASH)
+string(SHA256 KEY "${SOURCE_HASH};${FLAGS};${GLSLC_VERSION}")
+
+set(CACHED "${CACHE_DIR}/${KEY}.spv")
+
+if (NOT EXISTS "${CACHED}")
+    file(MAKE_DIRECTORY "${CACHE_DIR}")
+
+    execute_process(
+            COMMAND "${GLSLC}" ${FLAGS} -o "${CACHED}.tmp" "${SOURCE}"
+            RESULT_VARIABLE RESULT)
+    if (NOT RESULT EQUAL 0)
+        file(REMOVE "${CACHED}.tmp")
+        message(FATAL_ERROR "failed to compile shader ${SOURCE}")
+    endif ()
+
+    file(RENAME "${CACHED}.tmp" "${CACHED}")
+endif ()
+
+get_filename_component(OUTPUT_DIR "${OUTPUT}" DIRECTORY)
+file(MAKE_DIRECTORY "${OUTPUT_DIR}")
+file(COPY_FILE "${CACHED}" "${OUTPUT}")
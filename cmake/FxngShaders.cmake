@@ -0,0 +1,66 @@
+find_program(GLSLC_EXECUTABLE glslc HINTS "$ENV{VULKAN_SDK}/bin" REQUIRED)
+
+set(FXNG_SHADER_BINARY_DIR "${CMAKE_BINARY_DIR}/shader" CACHE PATH "output directory of compiled shaders")
+set(FXNG_SHADER_CACHE_DIR "${CMAKE_BINARY_DIR}/shader_cache" CACHE PATH "content-addressed cache of compiled shaders")
+set(FXNG_SHADER_TARGET_ENV "opengl" CACHE STRING "glslc target environment of compiled shaders")
+
+set(FXNG_COMPILE_SHADER_SCRIPT "${CMAKE_CURRENT_LIST_DIR}/CompileShader.cmake")
+
+# fxng_add_shaders(<target> <source>...)
+#
+# compiles every glsl source to ${FXNG_SHADER_BINARY_DIR}/<name>.spv before <target> is built. the stage is taken
+# from the last component of the file name, e.g. default.vertex.glsl or vertex.glsl
+function(fxng_add_shaders TARGET)
+    set(OUTPUTS)
+
+    foreach (SOURCE IN LISTS ARGN)
+        get_filename_component(SOURCE "${SOURCE}" ABSOLUTE)
+        get_filename_component(NAME "${SOURCE}" NAME_WLE)
+        get_filename_component(STAGE_NAME "${NAME}" LAST_EXT)
+
+        if (STAGE_NAME)
+            string(SUBSTRING "${STAGE_NAME}" 1 -1 STAGE_NAME)
+        else ()
+            set(STAGE_NAME "${NAME}")
+        endif ()
+
+        if (STAGE_NAME STREQUAL "vertex")
+            set(STAGE vert)
+        elseif (STAGE_NAME STREQUAL "fragment")
+            set(STAGE frag)
+        elseif (STAGE_NAME STREQUAL "geometry")
+            set(STAGE geom)
+        elseif (STAGE_NAME STREQUAL "tesscontrol")
+            set(STAGE tesc)
+        elseif (STAGE_NAME STREQUAL "tesseval")
+            set(STAGE tese)
+        elseif (STAGE_NAME STREQUAL "compute")
+            set(STAGE comp)
+        else ()
+            message(FATAL_ERROR "cannot derive shader stage from ${SOURCE}")
+        endif ()
+
+        set(OUTPUT "${FXNG_SHADER_BINARY_DIR}/${NAME}.spv")
+
+        add_custom_command(
+                OUTPUT "${OUTPUT}"
+                COMMAND "${CMAKE_COMMAND}"
+                -D "GLSLC=${GLSLC_EXECUTABLE}"
+                -D "SOURCE=${SOURCE}"
+                -D "OUTPUT=${OUTPUT}"
+                -D "STAGE=${STAGE}"
+                -D "TARGET_ENV=${FXNG_SHADER_TARGET_ENV}"
+                -D "CACHE_DIR=${FXNG_SHADER_CACHE_DIR}"
+                -P "${FXNG_COMPILE_SHADER_SCRIPT}"
+                DEPENDS "${SOURCE}" "${FXNG_COMPILE_SHADER_SCRIPT}"
+                COMMENT "Compiling shader ${NAME}"
+                VERBATIM)
+
+        list(APPEND OUTPUTS "${OUTPUT}")
+    endforeach ()
+
+    add_custom_target(${TARGET}_shaders DEPENDS ${OUTPUTS})
+    add_dependencies(${TARGET} ${TARGET}_shaders)
+
+    target_compile_definitions(${TARGET} PUBLIC FXNG_SHADER_BINARY_DIR="${FXNG_SHADER_BINARY_DIR}")
+endfunction()
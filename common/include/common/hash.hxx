@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace common
+{
+    constexpr std::uint64_t HashSeed = 0xcbf29ce484222325ull;
+
+    /**
+     * Hash - 64-bit FNV-1a, stable across runs and platforms so it can key on-disk caches
+     */
+    inline std::uint64_t Hash(const void *data, const std::size_t size, std::uint64_t seed = HashSeed)
+    {
+        const auto bytes = static_cast<const unsigned char *>(data);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            seed ^= bytes[i];
+            seed *= 0x100000001b3ull;
+        }
+        return seed;
+    }
+
+    inline std::uint64_t Hash(const std::string_view string, const std::uint64_t seed = HashSeed)
+    {
+        return Hash(string.data(), string.size(), seed);
+    }
+
+    inline std::uint64_t HashCombine(const std::uint64_t seed, const std::uint64_t value)
+    {
+        return Hash(&value, sizeof(value), seed);
+    }
+}
@@ -1,11 +1,26 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
 #include <filesystem>
 #include <format>
-#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
 #include <string_view>
-#include <unordered_map>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 namespace common
 {
@@ -19,32 +34,383 @@ namespace common
         LogLevel_Fatal,
     };
 
+#ifndef COMMON_LOG_LEVEL
+#define COMMON_LOG_LEVEL LogLevel_Verbose
+#endif
+
+    /**
+     * MinLogLevel - messages below are discarded where they are logged, calls with a constant level fold away
+     */
+    constexpr LogLevel MinLogLevel = COMMON_LOG_LEVEL;
+
+    constexpr std::array<const char *, 6> LogLevelNames
+    {
+        "Verbose",
+        "Debug",
+        "Info",
+        "Warning",
+        "Error",
+        "Fatal",
+    };
+
     inline std::ostream &operator<<(std::ostream &stream, const LogLevel log_level)
     {
-        static const std::unordered_map<LogLevel, const char *> map
-        {
-            { LogLevel_Verbose, "Verbose" },
-            { LogLevel_Debug, "Debug" },
-            { LogLevel_Info, "Info" },
-            { LogLevel_Warning, "Warning" },
-            { LogLevel_Error, "Error" },
-            { LogLevel_Fatal, "Fatal" },
-        };
-        return stream << map.at(log_level);
+        return stream << LogLevelNames[log_level];
     }
 
+    /**
+     * Log Record - one fixed size slot of a log queue. the arguments are copied into the payload, strings included,
+     * and only formatted on the logger thread
+     */
+    struct LogRecord
+    {
+        static constexpr std::size_t PayloadSize = 224;
+
+        /**
+         * formats the payload into the string and destroys it
+         */
+        using FormatFunction = void (*)(std::string &out, void *payload);
+
+        LogLevel Level;
+        std::chrono::system_clock::time_point Timestamp;
+        FormatFunction Format;
+
+        alignas(std::max_align_t) std::byte Payload[PayloadSize];
+    };
+
+    /**
+     * LogStorage - how an argument is kept until it is formatted. anything string-like may point to temporary memory,
+     * so it is copied
+     */
+    template<typename T>
+    using LogStorage = std::conditional_t<
+        std::is_convertible_v<const std::decay_t<T> &, std::string_view>,
+        std::string,
+        std::decay_t<T>>;
+
+    template<typename... Arguments>
+    struct LogPayload
+    {
+        std::string_view Format;
+        std::tuple<LogStorage<Arguments>...> Values;
+
+        static void FormatAndDestroy(std::string &out, void *payload)
+        {
+            const auto self = static_cast<LogPayload *>(payload);
+            std::apply(
+                [&](auto &... arguments)
+                {
+                    std::vformat_to(std::back_inserter(out), self->Format, std::make_format_args(arguments...));
+                },
+                self->Values);
+            self->~LogPayload();
+        }
+    };
+
+    /**
+     * Log Queue - single producer ring of records, only the owning thread reserves and only the logger thread
+     * releases
+     */
+    class LogQueue final
+    {
+    public:
+        static constexpr std::uint64_t Capacity = 1 << 10;
+
+        LogQueue()
+            : m_Records(std::make_unique<LogRecord[]>(Capacity))
+        {
+        }
+
+        /**
+         * Reserve - the next free record, nullptr while the queue is full
+         */
+        LogRecord *Reserve()
+        {
+            const auto head = m_Head.load(std::memory_order_relaxed);
+            if (head - m_Tail.load(std::memory_order_acquire) == Capacity)
+                return nullptr;
+            return &m_Records[head % Capacity];
+        }
+
+        void Commit()
+        {
+            m_Head.store(m_Head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /**
+         * Acquire - the committed records, they stay valid until released
+         */
+        void Acquire(std::vector<LogRecord *> &records, std::uint64_t &end)
+        {
+            const auto tail = m_Tail.load(std::memory_order_relaxed);
+            end = m_Head.load(std::memory_order_acquire);
+
+            for (auto i = tail; i != end; ++i)
+                records.push_back(&m_Records[i % Capacity]);
+        }
+
+        void Release(const std::uint64_t end)
+        {
+            m_Tail.store(end, std::memory_order_release);
+        }
+
+    private:
+        std::unique_ptr<LogRecord[]> m_Records;
+
+        std::atomic<std::uint64_t> m_Head{};
+        std::atomic<std::uint64_t> m_Tail{};
+    };
+
+    /**
+     * Logger - logging threads only copy their arguments into a queue of their own, a background thread formats the
+     * records in timestamp order and writes them in batches. the logger outlives static destruction, it is shut down
+     * at exit and logs synchronously from then on
+     */
+    class Logger final
+    {
+    public:
+        static Logger &Get()
+        {
+            static const auto logger = []
+            {
+                const auto logger = new Logger();
+                std::atexit(
+                    []
+                    {
+                        Get().Shutdown();
+                    });
+                return logger;
+            }();
+            return *logger;
+        }
+
+        template<typename... Arguments>
+        void Enqueue(const LogLevel log_level, std::format_string<Arguments...> format, Arguments &&... arguments)
+        {
+            const auto timestamp = std::chrono::system_clock::now();
+
+            if (!m_Running.load(std::memory_order_acquire))
+            {
+                auto line = std::format("({}) [{}] ", timestamp, LogLevelNames[log_level]);
+                std::format_to(std::back_inserter(line), std::move(format), std::forward<Arguments>(arguments)...);
+                line += '\n';
+
+                std::lock_guard lock(m_Mutex);
+                std::fwrite(line.data(), 1, line.size(), stderr);
+                return;
+            }
+
+            auto &queue = GetQueue();
+
+            // a full queue waits for the logger thread rather than losing messages
+            LogRecord *record;
+            while (!(record = queue.Reserve()))
+            {
+                Wake();
+                std::this_thread::yield();
+            }
+
+            record->Level = log_level;
+            record->Timestamp = timestamp;
+
+            using Payload = LogPayload<Arguments...>;
+            if constexpr (sizeof(Payload) <= LogRecord::PayloadSize && alignof(Payload) <= alignof(std::max_align_t))
+            {
+                new(record->Payload) Payload
+                {
+                    .Format = format.get(),
+                    .Values = { std::forward<Arguments>(arguments)... },
+                };
+                record->Format = &Payload::FormatAndDestroy;
+            }
+            else
+            {
+                // too large for a record, formatted right away instead
+                using StringPayload = LogPayload<std::string>;
+                new(record->Payload) StringPayload
+                {
+                    .Format = "{}",
+                    .Values = { std::format(std::move(format), std::forward<Arguments>(arguments)...) },
+                };
+                record->Format = &StringPayload::FormatAndDestroy;
+            }
+
+            queue.Commit();
+        }
+
+        /**
+         * Flush - blocks until everything logged before the call was written
+         */
+        void Flush()
+        {
+            std::unique_lock lock(m_Mutex);
+
+            if (!m_Running.load(std::memory_order_relaxed))
+            {
+                std::fflush(stderr);
+                return;
+            }
+
+            // the pass in progress may have missed the latest records, the one after it cannot
+            const auto target = m_Passes + 2;
+
+            m_Wake = true;
+            m_Condition.notify_all();
+            m_Condition.wait(
+                lock,
+                [&]
+                {
+                    return m_Passes >= target;
+                });
+        }
+
+        void Shutdown()
+        {
+            {
+                std::lock_guard lock(m_Mutex);
+                if (!m_Running.load(std::memory_order_relaxed))
+                    return;
+
+                m_Running.store(false, std::memory_order_release);
+                m_Condition.notify_all();
+            }
+
+            m_Thread.join();
+
+            // records committed while the thread was stopping
+            Collect();
+        }
+
+    private:
+        static constexpr auto Interval = std::chrono::milliseconds(10);
+
+        Logger()
+        {
+            m_Running.store(true, std::memory_order_release);
+            m_Thread = std::thread(&Logger::Run, this);
+        }
+
+        LogQueue &GetQueue()
+        {
+            thread_local const auto queue = [this]
+            {
+                std::lock_guard lock(m_Mutex);
+                return m_Queues.emplace_back(std::make_unique<LogQueue>()).get();
+            }();
+            return *queue;
+        }
+
+        void Wake()
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Wake = true;
+            m_Condition.notify_all();
+        }
+
+        void Run()
+        {
+            std::unique_lock lock(m_Mutex);
+            while (m_Running.load(std::memory_order_relaxed))
+            {
+                m_Condition.wait_for(
+                    lock,
+                    Interval,
+                    [&]
+                    {
+                        return m_Wake || !m_Running.load(std::memory_order_relaxed);
+                    });
+                m_Wake = false;
+
+                lock.unlock();
+                Collect();
+                lock.lock();
+
+                ++m_Passes;
+                m_Condition.notify_all();
+            }
+        }
+
+        /**
+         * Collect - formats the records of all queues, in timestamp order, and writes them at once
+         */
+        void Collect()
+        {
+            {
+                std::lock_guard lock(m_Mutex);
+
+                m_Snapshot.clear();
+                for (const auto &queue : m_Queues)
+                    m_Snapshot.push_back(queue.get());
+            }
+
+            m_Records.clear();
+            m_Ends.resize(m_Snapshot.size());
+            for (std::size_t i = 0; i < m_Snapshot.size(); ++i)
+                m_Snapshot[i]->Acquire(m_Records, m_Ends[i]);
+
+            if (m_Records.empty())
+                return;
+
+            // each queue is in order already, the stable sort only interleaves them
+            std::ranges::stable_sort(
+                m_Records,
+                [](const LogRecord *a, const LogRecord *b)
+                {
+                    return a->Timestamp < b->Timestamp;
+                });
+
+            m_Buffer.clear();
+            for (const auto record : m_Records)
+            {
+                std::format_to(
+                    std::back_inserter(m_Buffer),
+                    "({}) [{}] ",
+                    record->Timestamp,
+                    LogLevelNames[record->Level]);
+                record->Format(m_Buffer, record->Payload);
+                m_Buffer += '\n';
+            }
+
+            for (std::size_t i = 0; i < m_Snapshot.size(); ++i)
+                m_Snapshot[i]->Release(m_Ends[i]);
+
+            std::fwrite(m_Buffer.data(), 1, m_Buffer.size(), stderr);
+            std::fflush(stderr);
+        }
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+
+        std::vector<std::unique_ptr<LogQueue>> m_Queues;
+
+        std::thread m_Thread;
+        std::atomic<bool> m_Running;
+        bool m_Wake = false;
+        std::uint64_t m_Passes = 0;
+
+        // only touched by the logger thread, kept to reuse their memory
+        std::vector<LogQueue *> m_Snapshot;
+        std::vector<std::uint64_t> m_Ends;
+        std::vector<LogRecord *> m_Records;
+        std::string m_Buffer;
+    };
+
     template<typename... Arguments>
     void Log(const LogLevel log_level, std::format_string<Arguments...> format, Arguments &&... arguments)
     {
-        const auto timestamp = std::chrono::system_clock::now();
-        const auto message = std::format(std::move(format), std::forward<Arguments>(arguments)...);
-        std::cerr << '(' << timestamp << ')' << ' ' << '[' << log_level << ']' << ' ' << message << std::endl;
+        if (log_level < MinLogLevel)
+            return;
+
+        Logger::Get().Enqueue(log_level, std::move(format), std::forward<Arguments>(arguments)...);
     }
 
     template<typename... Arguments>
     [[noreturn]] void Fatal(std::format_string<Arguments...> format, Arguments &&... arguments)
     {
         Log(LogLevel_Fatal, std::move(format), std::forward<Arguments>(arguments)...);
+
+        // abort skips the exit handlers, so the message has to be out before
+        Logger::Get().Flush();
         std::abort();
     }
 
@@ -0,0 +1,387 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define COMMON_PROFILE_TSC
+#endif
+
+namespace common
+{
+    /**
+     * Profile Zone Info - static description of a zone, one per call site
+     */
+    struct ProfileZoneInfo
+    {
+        const char *Name;
+        const char *File;
+        std::uint32_t Line;
+    };
+
+    struct ProfileEvent
+    {
+        const ProfileZoneInfo *Zone;
+        std::uint64_t Begin;
+        std::uint64_t End;
+    };
+
+    struct ProfileZoneStatistics
+    {
+        const ProfileZoneInfo *Zone;
+
+        std::uint64_t Count;
+        double TotalMs;
+        double MinMs;
+        double MaxMs;
+    };
+
+    /**
+     * ProfileTimestamp - raw ticks, the time stamp counter where available. assumes an invariant tsc, which every x86
+     * cpu of the last decade has
+     */
+    inline std::uint64_t ProfileTimestamp()
+    {
+#ifdef COMMON_PROFILE_TSC
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    /**
+     * Profile Thread Buffer - single producer ring, only the owning thread pushes and only the profiler drains. events
+     * are dropped while the ring is full, rather than overwriting events the profiler may be reading
+     */
+    class ProfileThreadBuffer final
+    {
+    public:
+        static constexpr std::uint64_t Capacity = 1 << 14;
+
+        explicit ProfileThreadBuffer(const std::uint32_t id)
+            : m_Id(id),
+              m_Events(std::make_unique<std::array<ProfileEvent, Capacity>>())
+        {
+        }
+
+        void Push(const ProfileZoneInfo *zone, const std::uint64_t begin, const std::uint64_t end)
+        {
+            const auto head = m_Head.load(std::memory_order_relaxed);
+            if (head - m_Tail.load(std::memory_order_acquire) == Capacity)
+            {
+                m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            (*m_Events)[head % Capacity] = { .Zone = zone, .Begin = begin, .End = end };
+            m_Head.store(head + 1, std::memory_order_release);
+        }
+
+        template<typename Consumer>
+        void Drain(Consumer &&consumer)
+        {
+            const auto tail = m_Tail.load(std::memory_order_relaxed);
+            const auto head = m_Head.load(std::memory_order_acquire);
+
+            for (auto i = tail; i != head; ++i)
+                consumer((*m_Events)[i % Capacity]);
+
+            m_Tail.store(head, std::memory_order_release);
+        }
+
+        [[nodiscard]] std::uint32_t GetId() const
+        {
+            return m_Id;
+        }
+
+        [[nodiscard]] std::uint64_t GetDropped() const
+        {
+            return m_Dropped.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::uint32_t m_Id;
+        std::unique_ptr<std::array<ProfileEvent, Capacity>> m_Events;
+
+        std::atomic<std::uint64_t> m_Head{};
+        std::atomic<std::uint64_t> m_Tail{};
+        std::atomic<std::uint64_t> m_Dropped{};
+    };
+
+    /**
+     * Profiler - collects the zones of all threads. recording never takes a lock, draining, statistics and export do
+     */
+    class Profiler final
+    {
+        struct TraceEvent
+        {
+            std::uint32_t Thread;
+            ProfileEvent Event;
+        };
+
+    public:
+        /**
+         * events kept for the trace export, the oldest ones are discarded first
+         */
+        static constexpr std::size_t MaxTraceEvents = 1 << 20;
+
+        static Profiler &Get()
+        {
+            static Profiler profiler;
+            return profiler;
+        }
+
+        /**
+         * GetThreadBuffer - the ring of the calling thread, registered on first use and kept after the thread exits
+         */
+        static ProfileThreadBuffer &GetThreadBuffer()
+        {
+            thread_local const auto buffer = Get().RegisterThread();
+            return *buffer;
+        }
+
+        /**
+         * Drain - once per frame: moves the recorded zones of all threads into the statistics and the trace
+         */
+        void Drain()
+        {
+            std::lock_guard lock(m_Mutex);
+
+            for (const auto &thread : m_Threads)
+                thread->Drain(
+                    [&](const ProfileEvent &event)
+                    {
+                        const auto ticks = event.End - event.Begin;
+
+                        auto [it, inserted] = m_Statistics.try_emplace(
+                            event.Zone,
+                            ZoneTicks{ .Count = 0, .Total = 0, .Min = ticks, .Max = ticks });
+
+                        auto &statistics = it->second;
+                        ++statistics.Count;
+                        statistics.Total += ticks;
+                        statistics.Min = std::min(statistics.Min, ticks);
+                        statistics.Max = std::max(statistics.Max, ticks);
+
+                        if (m_Trace.size() == MaxTraceEvents)
+                            m_Trace.pop_front();
+                        m_Trace.push_back({ .Thread = thread->GetId(), .Event = event });
+                    });
+        }
+
+        /**
+         * GetStatistics - per zone totals since the last reset, of the zones drained so far
+         */
+        [[nodiscard]] std::vector<ProfileZoneStatistics> GetStatistics()
+        {
+            std::lock_guard lock(m_Mutex);
+
+            const auto ms_per_tick = GetNanosecondsPerTick() * 1e-6;
+
+            std::vector<ProfileZoneStatistics> statistics;
+            statistics.reserve(m_Statistics.size());
+
+            for (const auto &[zone, ticks] : m_Statistics)
+                statistics.push_back(
+                    {
+                        .Zone = zone,
+                        .Count = ticks.Count,
+                        .TotalMs = static_cast<double>(ticks.Total) * ms_per_tick,
+                        .MinMs = static_cast<double>(ticks.Min) * ms_per_tick,
+                        .MaxMs = static_cast<double>(ticks.Max) * ms_per_tick,
+                    });
+
+            std::ranges::sort(
+                statistics,
+                [](const ProfileZoneStatistics &a, const ProfileZoneStatistics &b)
+                {
+                    return a.TotalMs > b.TotalMs;
+                });
+            return statistics;
+        }
+
+        void ResetStatistics()
+        {
+            std::lock_guard lock(m_Mutex);
+            m_Statistics.clear();
+        }
+
+        /**
+         * GetDropped - zones lost to full rings, Drain has to run more often if this grows
+         */
+        [[nodiscard]] std::uint64_t GetDropped()
+        {
+            std::lock_guard lock(m_Mutex);
+
+            std::uint64_t dropped = 0;
+            for (const auto &thread : m_Threads)
+                dropped += thread->GetDropped();
+            return dropped;
+        }
+
+        /**
+         * WriteChromeTrace - drains and writes the trace in the chrome trace event format, which perfetto and
+         * chrome://tracing open
+         */
+        void WriteChromeTrace(std::ostream &stream)
+        {
+            Drain();
+
+            std::lock_guard lock(m_Mutex);
+
+            const auto us_per_tick = GetNanosecondsPerTick() * 1e-3;
+
+            // the outermost zones may have begun before the profiler existed
+            auto origin = m_StartTicks;
+            for (const auto &trace_event : m_Trace)
+                origin = std::min(origin, trace_event.Event.Begin);
+
+            stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+            auto first = true;
+            for (const auto &[thread, event] : m_Trace)
+            {
+                if (!first)
+                    stream << ',';
+                first = false;
+
+                const auto begin = event.Begin - origin;
+
+                stream << "{\"name\":";
+                WriteJsonString(stream, event.Zone->Name);
+                stream << ",\"cat\":\"zone\",\"ph\":\"X\",\"pid\":0,\"tid\":" << thread
+                        << ",\"ts\":" << static_cast<double>(begin) * us_per_tick
+                        << ",\"dur\":" << static_cast<double>(event.End - event.Begin) * us_per_tick
+                        << ",\"args\":{\"file\":";
+                WriteJsonString(stream, event.Zone->File);
+                stream << ",\"line\":" << event.Zone->Line << "}}";
+            }
+
+            stream << "]}";
+        }
+
+    private:
+        struct ZoneTicks
+        {
+            std::uint64_t Count;
+            std::uint64_t Total;
+            std::uint64_t Min;
+            std::uint64_t Max;
+        };
+
+        Profiler()
+            : m_StartTicks(ProfileTimestamp()),
+              m_StartTime(std::chrono::steady_clock::now())
+        {
+        }
+
+        ProfileThreadBuffer *RegisterThread()
+        {
+            std::lock_guard lock(m_Mutex);
+
+            const auto id = static_cast<std::uint32_t>(m_Threads.size());
+            return m_Threads.emplace_back(std::make_unique<ProfileThreadBuffer>(id)).get();
+        }
+
+        /**
+         * GetNanosecondsPerTick - the tsc rate is calibrated against the steady clock over the lifetime of the
+         * profiler, which gets more precise the longer it runs
+         */
+        [[nodiscard]] double GetNanosecondsPerTick() const
+        {
+#ifdef COMMON_PROFILE_TSC
+            const auto ticks = ProfileTimestamp() - m_StartTicks;
+            const auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_StartTime).count();
+            return ticks ? static_cast<double>(time) / static_cast<double>(ticks) : 1.0;
+#else
+            return 1.0;
+#endif
+        }
+
+        static void WriteJsonString(std::ostream &stream, const std::string_view string)
+        {
+            stream << '"';
+            for (const auto c : string)
+            {
+                if (c == '"' || c == '\\')
+                    stream << '\\';
+                stream << c;
+            }
+            stream << '"';
+        }
+
+        std::mutex m_Mutex;
+        std::vector<std::unique_ptr<ProfileThreadBuffer>> m_Threads;
+
+        std::unordered_map<const ProfileZoneInfo *, ZoneTicks> m_Statistics;
+        std::deque<TraceEvent> m_Trace;
+
+        std::uint64_t m_StartTicks;
+        std::chrono::steady_clock::time_point m_StartTime;
+    };
+
+    /**
+     * Profile Zone - records the lifetime of the scope it is declared in
+     */
+    class ProfileZone final
+    {
+    public:
+        explicit ProfileZone(const ProfileZoneInfo *zone)
+            : m_Zone(zone),
+              m_Begin(ProfileTimestamp())
+        {
+        }
+
+        ~ProfileZone()
+        {
+            Profiler::GetThreadBuffer().Push(m_Zone, m_Begin, ProfileTimestamp());
+        }
+
+        ProfileZone(const ProfileZone &) = delete;
+        ProfileZone &operator=(const ProfileZone &) = delete;
+
+    private:
+        const ProfileZoneInfo *m_Zone;
+        std::uint64_t m_Begin;
+    };
+}
+
+#define COMMON_PROFILE_CONCAT_(a, b) a##b
+#define COMMON_PROFILE_CONCAT(a, b) COMMON_PROFILE_CONCAT_(a, b)
+
+/**
+ * COMMON_PROFILE_ZONE - records the enclosing scope under a string literal name, COMMON_PROFILE_DRAIN - once per frame.
+ * both compile to nothing unless COMMON_PROFILE is defined
+ */
+#ifdef COMMON_PROFILE
+#define COMMON_PROFILE_ZONE(name)                                                                                      \
+    static constexpr common::ProfileZoneInfo COMMON_PROFILE_CONCAT(profile_zone_info_, __LINE__)                       \
+    {                                                                                                                  \
+        .Name = name,                                                                                                  \
+        .File = __FILE__,                                                                                              \
+        .Line = __LINE__,                                                                                              \
+    };                                                                                                                 \
+    const common::ProfileZone COMMON_PROFILE_CONCAT(profile_zone_, __LINE__)(                                          \
+        &COMMON_PROFILE_CONCAT(profile_zone_info_, __LINE__))
+#define COMMON_PROFILE_DRAIN() common::Profiler::Get().Drain()
+#else
+#define COMMON_PROFILE_ZONE(name) static_cast<void>(0)
+#define COMMON_PROFILE_DRAIN() static_cast<void>(0)
+#endif
@@ -1,7 +1,14 @@
 #version 460 core
 
-#define LIGHT_SOURCE_TYPE_DIRECTIONAL 0
-#define LIGHT_SOURCE_TYPE_POINT 1
+#ifdef VULKAN
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
+
+#define INVALID_TEXTURE_INDEX 0xffffffffu
+
+// see fxng::MaterialFeature, a material without the feature gets a variant with the code behind it removed
+layout (constant_id = 0) const bool FEATURE_DIFFUSE_TEXTURE = true;
+layout (constant_id = 1) const bool FEATURE_SPECULAR = true;
 
 layout (location = 0) in vec4 POSITION;
 layout (location = 1) in vec3 NORMAL;
@@ -10,73 +17,110 @@ layout (location = 3) in vec4 WORLD_POSITION;
 
 layout (location = 0) out vec4 color;
 
-uniform vec3 AMBIENT;
-uniform vec3 DIFFUSE;
-uniform vec3 SPECULAR;
-uniform float SHININESS;
+// see fxng::ViewUniforms
+layout (std140, binding = 1) uniform VIEW_UNIFORMS {
+    mat4 VIEW;
+    mat4 PROJECTION;
+    mat4 VIEW_PROJECTION;
+    vec4 CAMERA_POSITION;
+    uvec4 CLUSTER_GRID;
+    vec4 CLUSTER_SCALE;
+};
 
-struct Camera {
-    vec3 Position;
+// see fxng::MaterialUniforms
+layout (std140, binding = 2) uniform MATERIAL_UNIFORMS {
+    vec3 AMBIENT;
+    vec3 DIFFUSE;
+    vec3 SPECULAR;
+    float SHININESS;
+    uint DIFFUSE_TEXTURE;
 };
 
-uniform Camera CAMERA;
+// see fxng::TextureHeap, spir-v for opengl cannot express bindless handles, so the engine creates no heap there
+#ifdef VULKAN
+layout (set = 1, binding = 0) uniform sampler2D TEXTURES[];
+#endif
 
+// see fxng::LightData
 struct LightSource {
-    uint Type;
     vec3 Position;
+    float Range;
     vec3 Direction;
+    uint Type;
     vec3 Diffuse;
-    vec3 Specular;
     float LinearFalloff;
+    vec3 Specular;
     float QuadraticFalloff;
 };
 
-layout (std430, binding = 1) buffer LIGHT_SOURCE_BUFFER {
+// see fxng::ClusteredLights, the directional lights come first
+layout (std430, binding = 3) readonly buffer LIGHT_SOURCE_BUFFER {
     LightSource LIGHTS[];
 };
 
+// offset and count of the light indices of each cluster
+layout (std430, binding = 4) readonly buffer LIGHT_CLUSTER_BUFFER {
+    uvec2 CLUSTERS[];
+};
+
+layout (std430, binding = 5) readonly buffer LIGHT_INDEX_BUFFER {
+    uint LIGHT_INDICES[];
+};
+
+vec3 shade(LightSource light, vec3 L, float attenuation, vec3 N, vec3 V, vec3 albedo) {
+    float ndl = max(dot(L, N), 0.0);
+
+    vec3 diffuse = albedo * ndl * light.Diffuse;
+
+    vec3 specular = vec3(0.0);
+    if (FEATURE_SPECULAR && ndl > 0.0)
+        specular = SPECULAR * pow(max(dot(N, normalize(L + V)), 0.0), SHININESS) * light.Specular;
+
+    return (diffuse + specular) * attenuation;
+}
+
+vec3 shade_directional(LightSource light, vec3 N, vec3 V, vec3 albedo) {
+    return shade(light, -normalize(light.Direction), 1.0, N, V, albedo);
+}
+
+vec3 shade_point(LightSource light, vec3 P, vec3 N, vec3 V, vec3 albedo) {
+    vec3 forward = light.Position - P;
+    float dist = max(length(forward), 0.001);
+
+    // fades to zero at the range the light was culled with, so cluster borders do not show
+    float window = clamp(1.0 - pow(dist / light.Range, 4.0), 0.0, 1.0);
+    float attenuation = window * window / (1.0 + light.LinearFalloff * dist + light.QuadraticFalloff * dist * dist);
+
+    return shade(light, forward / dist, attenuation, N, V, albedo);
+}
+
 void main() {
 
     vec3 P = WORLD_POSITION.xyz / WORLD_POSITION.w;
     vec3 N = normalize(NORMAL);
-    vec3 V = normalize(CAMERA.Position - P);
+    vec3 V = normalize(CAMERA_POSITION.xyz - P);
+
+    vec3 albedo = DIFFUSE;
+#ifdef VULKAN
+    if (FEATURE_DIFFUSE_TEXTURE && DIFFUSE_TEXTURE != INVALID_TEXTURE_INDEX)
+        albedo *= texture(TEXTURES[nonuniformEXT(DIFFUSE_TEXTURE)], TEX).rgb;
+#endif
 
     vec3 acc = AMBIENT;
-    for (uint m = 0u; m < LIGHTS.length; ++m) {
-        vec3 Lm, Hm, diffuse, specular;
-        float attenuation, ndl;
-
-        switch (LIGHTS[m].Type) {
-            case LIGHT_SOURCE_TYPE_DIRECTIONAL:
-                {
-                    Lm = -normalize(LIGHTS[m].Direction);
-                    attenuation = 1.0;
-                    break;
-                }
-            case LIGHT_SOURCE_TYPE_POINT:
-                {
-                    vec3 forward;
-                    float dist;
-
-                    forward = LIGHTS[m].Position - P;
-                    dist = max(length(forward), 0.001);
-                    Lm = forward / dist;
-                    attenuation = 1.0 / (1.0 + LIGHTS[m].LinearFalloff * dist + LIGHTS[m].QuadraticFalloff * dist * dist);
-                    break;
-                }
-            default:
-                continue;
-        }
-
-        Hm = normalize(Lm + V);
-
-        ndl = max(dot(Lm, N), 0.0);
-
-        diffuse = DIFFUSE * ndl * LIGHTS[m].Diffuse;
-        specular = ndl > 0.0 ? SPECULAR * pow(max(dot(N, Hm), 0.0), SHININESS) * LIGHTS[m].Specular : vec3(0.0);
-
-        acc += (diffuse + specular) * attenuation;
-    }
+    // the light types are split on the cpu, the directional lights come first and the clusters only list point lights
+    for (uint m = 0u; m < CLUSTER_GRID.w; ++m)
+        acc += shade_directional(LIGHTS[m], N, V, albedo);
+
+    // the camera looks down negative z in view space
+    float depth = max(-(VIEW * vec4(P, 1.0)).z, 1e-4);
+    uvec3 cluster = uvec3(clamp(
+        ivec3(gl_FragCoord.xy * CLUSTER_SCALE.xy, floor(log(depth) * CLUSTER_SCALE.z + CLUSTER_SCALE.w)),
+        ivec3(0),
+        ivec3(CLUSTER_GRID.xyz) - 1));
+    uvec2 range = CLUSTERS[(cluster.z * CLUSTER_GRID.y + cluster.y) * CLUSTER_GRID.x + cluster.x];
+
+    for (uint m = 0u; m < range.y; ++m)
+        acc += shade_point(LIGHTS[LIGHT_INDICES[range.x + m]], P, N, V, albedo);
 
     color = vec4(min(acc, vec3(1.0)), 1.0);
 }
@@ -4,20 +4,27 @@ layout (location = 0) in vec4 POSITION;
 layout (location = 1) in vec3 NORMAL;
 layout (location = 2) in vec2 TEX;
 
+// per instance, see fxng::InstanceData
+layout (location = 3) in mat4 WORLD;
+layout (location = 7) in mat4 NORMAL_MATRIX;
+
 layout (location = 0) out vec4 position;
 layout (location = 1) out vec3 normal;
 layout (location = 2) out vec2 tex;
 layout (location = 3) out vec4 world_position;
 
-uniform mat4 MODEL;
-uniform mat4 INVMODEL;
-uniform mat4 VIEW;
-uniform mat4 PROJECTION;
+// see fxng::ViewUniforms, selected from the frame set by a dynamic offset
+layout (std140, binding = 1) uniform VIEW_UNIFORMS {
+    mat4 VIEW;
+    mat4 PROJECTION;
+    mat4 VIEW_PROJECTION;
+    vec4 CAMERA_POSITION;
+};
 
 void main() {
 
-    position = PROJECTION * VIEW * MODEL * POSITION;
-    normal = mat3(transpose(INVMODEL)) * NORMAL;
+    world_position = WORLD * POSITION;
+    position = VIEW_PROJECTION * world_position;
+    normal = mat3(NORMAL_MATRIX) * NORMAL;
     tex = TEX;
-    world_position = MODEL * POSITION;
 }
@@ -0,0 +1,73 @@
+#version 460 core
+
+layout (local_size_x = 64) in;
+
+struct Meshlet {
+    vec4 SPHERE;
+    vec4 CONE;
+    uint INDEX_OFFSET;
+    uint INDEX_COUNT;
+    int VERTEX_OFFSET;
+    uint PADDING;
+};
+
+struct DrawCommand {
+    uint INDEX_COUNT;
+    uint INSTANCE_COUNT;
+    uint FIRST_INDEX;
+    int VERTEX_OFFSET;
+    uint FIRST_INSTANCE;
+};
+
+layout (std140, binding = 0) uniform CULL {
+    mat4 MODEL;
+    vec4 PLANES[6];
+    vec4 CAMERA_POSITION;
+    uint MESHLET_COUNT;
+    uint MESHLET_OFFSET;
+    uint FIRST_INSTANCE;
+};
+
+layout (std430, binding = 1) readonly buffer MESHLET_BUFFER {
+    Meshlet MESHLETS[];
+};
+
+layout (std430, binding = 2) writeonly buffer DRAW_BUFFER {
+    DrawCommand COMMANDS[];
+};
+
+bool visible(Meshlet meshlet) {
+
+    float scale = max(length(MODEL[0].xyz), max(length(MODEL[1].xyz), length(MODEL[2].xyz)));
+
+    vec3 center = (MODEL * vec4(meshlet.SPHERE.xyz, 1.0)).xyz;
+    float radius = meshlet.SPHERE.w * scale;
+
+    for (int i = 0; i < 6; ++i)
+        if (dot(PLANES[i].xyz, center) + PLANES[i].w < -radius)
+            return false;
+
+    // a cutoff of one marks a degenerate cone that can never be back-facing
+    if (meshlet.CONE.w >= 1.0)
+        return true;
+
+    vec3 axis = normalize(mat3(MODEL) * meshlet.CONE.xyz);
+    vec3 view = center - CAMERA_POSITION.xyz;
+
+    return dot(view, axis) < meshlet.CONE.w * length(view) + radius;
+}
+
+void main() {
+
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= MESHLET_COUNT)
+        return;
+
+    Meshlet meshlet = MESHLETS[MESHLET_OFFSET + index];
+
+    COMMANDS[index].INDEX_COUNT = meshlet.INDEX_COUNT;
+    COMMANDS[index].INSTANCE_COUNT = visible(meshlet) ? 1 : 0;
+    COMMANDS[index].FIRST_INDEX = meshlet.INDEX_OFFSET;
+    COMMANDS[index].VERTEX_OFFSET = meshlet.VERTEX_OFFSET;
+    COMMANDS[index].FIRST_INSTANCE = FIRST_INSTANCE;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <string>
 #include <fxng/fxng.hxx>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -41,6 +43,9 @@ namespace fxng
 
         Transform *LookAt(glm::vec3 eye, glm::vec3 center, glm::vec3 up);
 
+        [[nodiscard]] const glm::mat4 &GetMatrix() const;
+        [[nodiscard]] const glm::mat4 &GetInverse() const;
+
         void OnInit() override;
         void PreFrame() override;
 
@@ -58,7 +63,58 @@ namespace fxng
     public:
         explicit Camera(Scene &scene, Entity &parent);
 
+        Camera *SetPerspective(float field_of_view, float near_plane, float far_plane);
+
+        [[nodiscard]] float GetFieldOfView() const;
+        [[nodiscard]] float GetNear() const;
+        [[nodiscard]] float GetFar() const;
+
+        [[nodiscard]] glm::mat4 GetProjection(float aspect) const;
+
+    private:
+        float m_FieldOfView = glm::radians(60.f);
+        float m_Near = 0.1f;
+        float m_Far = 100.f;
+    };
+
+    enum LightType
+    {
+        LightType_Directional,
+        LightType_Point,
+    };
+
+    /**
+     * Light - shines along the negative z axis of the transform of its entity when directional, from its position
+     * otherwise. point light intensity falls off as 1 / (1 + linear * d + quadratic * d^2)
+     */
+    class Light final : public Component
+    {
+    public:
+        explicit Light(Scene &scene, Entity &parent);
+
+        Light *SetType(LightType type);
+        [[nodiscard]] LightType GetType() const;
+
+        Light *SetColor(glm::vec3 diffuse, glm::vec3 specular);
+        [[nodiscard]] glm::vec3 GetDiffuse() const;
+        [[nodiscard]] glm::vec3 GetSpecular() const;
+
+        Light *SetFalloff(float linear, float quadratic);
+        [[nodiscard]] float GetLinearFalloff() const;
+        [[nodiscard]] float GetQuadraticFalloff() const;
+
+        /**
+         * GetRange - distance at which a point light has faded to 1/256, infinite without falloff. lights are culled
+         * and faded out at this distance
+         */
+        [[nodiscard]] float GetRange() const;
+
     private:
+        LightType m_Type = LightType_Point;
+        glm::vec3 m_Diffuse{ 1.f };
+        glm::vec3 m_Specular{ 1.f };
+        float m_LinearFalloff = 0.22f;
+        float m_QuadraticFalloff = 0.2f;
     };
 
     class Model final : public Component
@@ -66,6 +122,18 @@ namespace fxng
     public:
         explicit Model(Scene &scene, Entity &parent);
 
+        Model *SetMesh(std::string mesh);
+        [[nodiscard]] const std::string &GetMesh() const;
+
+        Model *SetMaterial(std::string material);
+        [[nodiscard]] const std::string &GetMaterial() const;
+
+        Model *SetLod(std::uint32_t lod);
+        [[nodiscard]] std::uint32_t GetLod() const;
+
     private:
+        std::string m_Mesh;
+        std::string m_Material;
+        std::uint32_t m_Lod = 0;
     };
 }
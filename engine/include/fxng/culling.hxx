@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <fxng/mesh.hxx>
+#include <glal/glal.hxx>
+#include <glm/glm.hpp>
+
+namespace fxng
+{
+    /**
+     * Frustum - six normalized planes (xyz = normal, w = distance), pointing inwards
+     */
+    struct Frustum
+    {
+        glm::vec4 Planes[6];
+
+        static Frustum FromMatrix(const glm::mat4 &view_projection);
+
+        [[nodiscard]] bool Intersects(glm::vec3 center, float radius) const;
+    };
+
+    /**
+     * Meshlet Data - std430 layout of a meshlet as read by the culling shader
+     */
+    struct MeshletData
+    {
+        glm::vec4 Sphere;
+        glm::vec4 Cone;
+        std::uint32_t IndexOffset;
+        std::uint32_t IndexCount;
+        std::int32_t VertexOffset;
+        std::uint32_t Padding;
+    };
+
+    /**
+     * Meshlet Cull Uniforms - std140 layout of the culling shader uniform block
+     */
+    struct MeshletCullUniforms
+    {
+        glm::mat4 Model;
+        glm::vec4 Planes[6];
+        glm::vec4 CameraPosition;
+        std::uint32_t MeshletCount;
+        std::uint32_t MeshletOffset;
+        std::uint32_t FirstInstance;
+        std::uint32_t Padding;
+    };
+
+    /**
+     * Meshlet Buffers - the meshlets of a mesh as placed in the geometry pool, shared by all levels of detail and all
+     * draws of the mesh
+     */
+    struct MeshletBuffers
+    {
+        glal::Buffer Meshlets;
+        std::uint32_t MeshletCount;
+    };
+
+    struct MeshletCullerConfig
+    {
+        std::uint32_t FramesInFlight = 2;
+    };
+
+    /**
+     * Meshlet Culler - tests the meshlets of single draws against the frustum and their backface cones on the gpu and
+     * writes one indexed indirect draw per meshlet, culled ones with an instance count of zero. every frame in flight
+     * has its own jobs, their buffers are reused and grow on demand. render thread only
+     */
+    class MeshletCuller final
+    {
+    public:
+        explicit MeshletCuller(
+            glal::Device device,
+            glal::ShaderModule shader_module,
+            const MeshletCullerConfig &config);
+        ~MeshletCuller();
+
+        /**
+         * CreateBuffers - the vertex offset and first index are where the geometry pool put the mesh
+         */
+        [[nodiscard]] MeshletBuffers CreateBuffers(
+            const Mesh &mesh,
+            std::int32_t vertex_offset,
+            std::uint32_t first_index) const;
+        void DestroyBuffers(const MeshletBuffers &buffers) const;
+
+        /**
+         * BeginFrame - the gpu has to be done with the jobs of the frame slot
+         */
+        void BeginFrame(std::uint32_t frame_index);
+
+        /**
+         * Cull - queues the culling of one instance of a level of detail and returns the buffer its draws are written
+         * to, nullptr while the culling pipeline is still compiling. the caller then draws the whole level directly
+         */
+        glal::Buffer Cull(
+            const MeshletBuffers &buffers,
+            const MeshLod &lod,
+            const glm::mat4 &model,
+            const Frustum &frustum,
+            glm::vec3 camera_position,
+            std::uint32_t first_instance);
+
+        /**
+         * Record - records the queued dispatches outside of a render pass, their draws may be consumed by indirect
+         * draws afterwards
+         */
+        void Record(glal::CommandBuffer command_buffer) const;
+
+    private:
+        struct Job
+        {
+            glal::Buffer Uniforms;
+            glal::Buffer Commands;
+            glal::DescriptorSet Set;
+
+            std::uint32_t MeshletCount;
+        };
+
+        glal::Device m_Device;
+        MeshletCullerConfig m_Config;
+
+        glal::DescriptorSetLayout m_DescriptorSetLayout;
+        glal::PipelineLayout m_PipelineLayout;
+        glal::Pipeline m_Pipeline;
+
+        std::vector<std::vector<Job>> m_Jobs;
+        std::uint32_t m_FrameIndex;
+        std::uint32_t m_JobCount;
+    };
+}
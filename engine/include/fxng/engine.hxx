@@ -2,10 +2,23 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
+#include <fxng/culling.hxx>
+#include <fxng/frame.hxx>
 #include <fxng/fxng.hxx>
+#include <fxng/geometry.hxx>
+#include <fxng/mesh.hxx>
+#include <fxng/permutation.hxx>
+#include <fxng/profiler.hxx>
+#include <fxng/readback.hxx>
+#include <fxng/render_queue.hxx>
 #include <fxng/scene.hxx>
+#include <fxng/uniform.hxx>
 
 namespace fxng
 {
@@ -28,12 +41,92 @@ namespace fxng
         uint32_t Height = 768;
     };
 
+    enum EngineBackend
+    {
+        EngineBackend_OpenGL,
+        EngineBackend_Vulkan,
+
+        /**
+         * executes nothing, for measuring the cpu side of the engine without a gpu
+         */
+        EngineBackend_Null,
+    };
+
+    /**
+     * Headless Config - renders into offscreen images without any window system, e.g. on a server with a software
+     * rasterizer. windows are ignored
+     */
+    struct HeadlessConfig final
+    {
+        bool Enabled = false;
+        EngineBackend Backend = EngineBackend_OpenGL;
+        uint32_t Width = 1024;
+        uint32_t Height = 768;
+
+        /**
+         * frames rendered before Run returns, 0 renders until RequestExit
+         */
+        uint32_t FrameCount = 0;
+
+        /**
+         * receives the rgba8 pixels of every frame, read back asynchronously a few frames after it was rendered
+         */
+        std::function<void(uint64_t frame, uint32_t width, uint32_t height, const void *pixels)> Capture;
+    };
+
+    /**
+     * Renderer Config - how models are drawn, headless or into the primary window
+     */
+    struct RendererConfig final
+    {
+        /**
+         * measure the gpu time of every pass, the averages are logged when Run returns
+         */
+        bool Profile = false;
+
+        /**
+         * how the draws of the models are sorted
+         */
+        RenderQueueConfig RenderQueue;
+
+        /**
+         * bytes of frame and view blocks per frame slot
+         */
+        std::size_t UniformArenaSize = 1 << 20;
+
+        /**
+         * materials that may be registered, their blocks share one buffer
+         */
+        uint32_t MaxMaterials = 1024;
+
+        /**
+         * capacity of the texture heap, which only exists on devices with bindless textures outside of opengl
+         */
+        uint32_t MaxTextures = 4096;
+
+        /**
+         * models drawn without other instances are culled per meshlet on the gpu and drawn indirectly
+         */
+        bool MeshletCulling = true;
+    };
+
     struct EngineConfig final
     {
         ApplicationConfig Application;
         std::vector<WindowConfig> Windows;
+        HeadlessConfig Headless;
+        RendererConfig Renderer;
 
         std::string InitialScene;
+
+        /**
+         * chrome trace of the cpu zones, written when the engine is destroyed. zones are only recorded in builds with
+         * COMMON_PROFILE
+         */
+        std::filesystem::path ProfileTrace;
+
+        float LodErrorThreshold = 1.f;
+        float LodHysteresis = 0.25f;
     };
 
     struct ShaderAttribute final
@@ -45,7 +138,7 @@ namespace fxng
 
     struct ShaderIndex final
     {
-        std::string Id, Name, Source;
+        std::string Id, Name, Source, Binary;
         std::vector<ShaderAttribute> Input, Output, Uniform;
     };
 
@@ -65,10 +158,65 @@ namespace fxng
     };
 
     struct MeshIndex final
+    {
+        std::string Id, Name, Source;
+
+        uint32_t LodCount = 4;
+        float LodRatio = 0.5f;
+        float LodError = 0.02f;
+    };
+
+    struct TextureIndex final
     {
         std::string Id, Name, Source;
     };
 
+    /**
+     * Material Binding - the gpu state models with the material are drawn with, until the engine builds pipelines
+     * from the material index itself. the pipeline has to be compatible with the render pass of the engine, read the
+     * instance data from the instance buffer binding and use the frame descriptor set layout as set 0. with a texture
+     * heap its layout is set 1. the descriptor set of the material, if any, is bound after them. with permutations the
+     * pipeline is the variant for the features of the uniforms instead
+     */
+    struct MaterialBinding final
+    {
+        glal::Pipeline Pipeline;
+        glal::DescriptorSet DescriptorSet;
+        PipelinePermutations *Permutations = nullptr;
+
+        MaterialUniforms Uniforms{};
+
+        bool Translucent = false;
+    };
+
+    /**
+     * Instance Data - per instance vertex input of model draws, at InstanceBufferBinding. the normal matrix is the
+     * inverse transpose of the world matrix
+     */
+    struct InstanceData final
+    {
+        glm::mat4 World;
+        glm::mat4 Normal;
+    };
+
+    /**
+     * Mesh Geometry - the device copy of a mesh in the geometry pool, all levels of detail share it
+     */
+    struct MeshGeometry final
+    {
+        GeometryHandle Geometry;
+
+        /**
+         * sort key id, in order of creation
+         */
+        uint32_t Id;
+
+        /**
+         * only with meshlet culling
+         */
+        MeshletBuffers Meshlets;
+    };
+
     struct ComponentIndex final
     {
         std::string Type;
@@ -93,23 +241,229 @@ namespace fxng
         explicit Engine(const EngineConfig &config);
         ~Engine();
 
+        /**
+         * Run - renders until the primary window closes, or until the frame count or RequestExit is reached when
+         * headless
+         */
+        void Run();
+        void RequestExit();
+
         Scene &GetScene();
 
+        /**
+         * GetDevice - the glal device models are drawn with, an opengl one on the primary window unless headless
+         */
+        [[nodiscard]] glal::Device GetDevice() const;
+
+        /**
+         * GetGpuProfiler - the pass timings with profiling enabled, nullptr otherwise
+         */
+        [[nodiscard]] const GpuProfiler *GetGpuProfiler() const;
+
+        /**
+         * GetRenderPass - the pass models are drawn in
+         */
+        [[nodiscard]] glal::RenderPass GetRenderPass() const;
+
+        /**
+         * GetRenderQueueStatistics - the commands recorded for the models of the last frame
+         */
+        [[nodiscard]] const RenderQueueStatistics &GetRenderQueueStatistics() const;
+
+        /**
+         * GetFrameDescriptorSetLayout - set 0 of material pipeline layouts
+         */
+        [[nodiscard]] glal::DescriptorSetLayout GetFrameDescriptorSetLayout() const;
+
+        /**
+         * GetTextureHeap - the textures material uniforms index, nullptr on opengl or without bindless texture support
+         */
+        [[nodiscard]] TextureHeap *GetTextureHeap() const;
+
+        /**
+         * RegisterMaterial - models referencing the material are drawn from then on, once its uniforms were uploaded.
+         * the pipeline, permutations and descriptor set stay owned by the caller and have to outlive the engine
+         */
+        void RegisterMaterial(const std::string &id, const MaterialBinding &material_binding);
+
         void InitScene();
         void ExitScene();
 
         void ClearScene();
 
+        const Mesh &GetMesh(const std::string &id);
+        std::vector<char> GetShaderBinary(const std::string &id) const;
+        std::filesystem::path GetTexturePath(const std::string &id) const;
+
+        /**
+         * GetMeshGeometry - uploads the mesh on first use
+         */
+        const MeshGeometry &GetMeshGeometry(const std::string &id);
+
+        /**
+         * GetTexture - with a texture heap only, registers the texture with the streamer on first use. the returned
+         * heap index samples the placeholder until the mip tail is resident, the mip levels follow the screen coverage
+         * of the visible models whose material uniforms reference it
+         */
+        uint32_t GetTexture(const std::string &id);
+
     protected:
         void IndexAssets();
         void IndexYaml(std::filesystem::path path);
 
-        void Frame();
+        void Frame(uint32_t width, uint32_t height);
+
+        void SelectLods(uint32_t height);
+
+        /**
+         * QueueModels - submits the visible models with a registered material to the render queue. opaque models
+         * sharing mesh, level of detail and material become one instanced draw, their instance data is written to the
+         * instance buffer of the frame slot. the view block goes to the uniform arena, which has to be begun
+         */
+        void QueueModels(uint32_t frame_index, uint32_t frame_uniforms, uint32_t width, uint32_t height);
+
+        void CreateHeadless(const ApplicationConfig &application);
+
+        /**
+         * CreateRenderer - everything models are drawn with, on the device of the engine. DestroyRenderer also
+         * destroys the device and the swapchain
+         */
+        void CreateRenderer();
+        void DestroyRenderer();
+
+        /**
+         * CreateSwapchain - the swapchain frames are drawn to and a framebuffer per image, the window one is recreated
+         * whenever its framebuffer is resized
+         */
+        void CreateSwapchain(void *native_window_handle, glal::Extent2D extent);
+        void DestroySwapchain();
+
+        /**
+         * RenderFrame - draws the models of the scene into the next swapchain image and presents it on the queue,
+         * returns the image
+         */
+        glal::Image RenderFrame(uint32_t frame, float time, glal::Queue queue);
+
+        void RunWindowed();
+        void RunHeadless();
 
     private:
+        struct RegisteredMaterial
+        {
+            MaterialBinding Binding;
+
+            /**
+             * sort key id and slot of the uniforms in the material buffer
+             */
+            uint32_t Id;
+            UploadTicket Ticket;
+        };
+
+        struct ModelBatch
+        {
+            const MaterialBinding *Binding;
+            uint32_t PipelineId;
+            uint32_t MaterialId;
+
+            GeometryHandle Geometry;
+            uint32_t MeshId;
+            const MeshLod *Lod;
+            const MeshletBuffers *Meshlets;
+
+            /**
+             * of the first instance, batches of a single instance are culled with it
+             */
+            glm::mat4 World;
+
+            /**
+             * nearest instance, sorts the batch front to back
+             */
+            uint32_t Depth;
+
+            uint32_t FirstInstance;
+            uint32_t InstanceCount;
+        };
+
+        struct ModelInstance
+        {
+            uint32_t Batch;
+            InstanceData Data;
+        };
+
+        struct StreamedTextureBinding
+        {
+            TextureHandle Handle;
+
+            /**
+             * last image view written to the heap index
+             */
+            glal::ImageView View;
+        };
+
         GLFWwindow *m_PrimaryWindow = nullptr;
         std::vector<GLFWwindow *> m_Windows;
 
+        HeadlessConfig m_Headless;
+        RendererConfig m_Renderer;
+        bool m_Exit = false;
+
+        std::filesystem::path m_ProfileTrace;
+
+        glal::Instance m_Instance = nullptr;
+        glal::Device m_Device = nullptr;
+        glal::Swapchain m_Swapchain = nullptr;
+        glal::RenderPass m_RenderPass = nullptr;
+        std::vector<glal::Framebuffer> m_Framebuffers;
+        std::vector<glal::CommandBuffer> m_CommandBuffers;
+        std::unique_ptr<FramePacer> m_FramePacer;
+        uint32_t m_FramesInFlight = 0;
+        std::unique_ptr<ReadbackManager> m_Readback;
+        std::unique_ptr<UploadManager> m_Uploads;
+        std::unique_ptr<GeometryPool> m_GeometryPool;
+        std::unique_ptr<GpuProfiler> m_Profiler;
+        std::unique_ptr<RenderQueue> m_RenderQueue;
+        RenderQueueStatistics m_RenderQueueStatistics{};
+
+        /**
+         * frame and view blocks are written to the arena every frame, material blocks live in one device local buffer
+         * and are only uploaded when a material is registered
+         */
+        std::unique_ptr<UniformArena> m_UniformArena;
+        glal::DescriptorSetLayout m_FrameSetLayout = nullptr;
+        std::vector<glal::DescriptorSet> m_FrameSets;
+        glal::Buffer m_MaterialUniforms = nullptr;
+        std::size_t m_MaterialUniformStride = 0;
+        std::unique_ptr<TextureHeap> m_TextureHeap;
+        std::unique_ptr<TextureStreamer> m_TextureStreamer;
+        glal::Sampler m_TextureSampler = nullptr;
+        std::unique_ptr<ClusteredLights> m_ClusteredLights;
+        std::unique_ptr<MeshletCuller> m_MeshletCuller;
+        glal::ShaderModule m_MeshletCullShader = nullptr;
+
+        /**
+         * one per frame in flight, grown on demand
+         */
+        std::vector<glal::Buffer> m_InstanceBuffers;
+
+        // rebuilt every frame, kept to reuse their memory
+        std::vector<ModelBatch> m_Batches;
+        std::unordered_map<uint64_t, uint32_t> m_BatchIndices;
+        std::vector<ModelInstance> m_Instances;
+
         Scene m_Scene;
+
+        float m_LodErrorThreshold;
+        float m_LodHysteresis;
+
+        std::unordered_map<std::string, ShaderIndex> m_ShaderIndices;
+        std::unordered_map<std::string, MeshIndex> m_MeshIndices;
+        std::unordered_map<std::string, Mesh> m_Meshes;
+        std::unordered_map<std::string, TextureIndex> m_TextureIndices;
+        std::unordered_map<std::string, uint32_t> m_TextureHeapIndices;
+        std::unordered_map<uint32_t, StreamedTextureBinding> m_StreamedTextures;
+
+        std::unordered_map<std::string, MeshGeometry> m_MeshGeometry;
+        std::unordered_map<std::string, RegisteredMaterial> m_Materials;
+        std::unordered_map<glal::Pipeline, uint32_t> m_PipelineIds;
     };
 }
@@ -25,7 +25,7 @@ namespace fxng
         }
 
         template<ComponentType C>
-        C *Get(const unsigned index = 0u)
+        C *Get(const unsigned index = 0u) const
         {
             auto x = 0u;
             for (auto &component : m_Components)
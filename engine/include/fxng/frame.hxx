@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glal/glal.hxx>
+
+namespace fxng
+{
+    struct FramePacerConfig
+    {
+        /**
+         * frames the cpu may record ahead of the gpu, per-frame resources rotate over this many slots
+         */
+        std::uint32_t FramesInFlight = 2;
+
+        /**
+         * wait for the previous frame to complete before starting the next one. trades throughput for input latency,
+         * no more than one frame is ever queued
+         */
+        bool LowLatency = false;
+    };
+
+    /**
+     * Frame Pacer - keeps the cpu a bounded number of frames ahead of the gpu. completion is tracked with a timeline
+     * semaphore signaled to the frame number, or with a fence per slot where timeline semaphores are missing
+     */
+    class FramePacer final
+    {
+    public:
+        explicit FramePacer(glal::Device device, const FramePacerConfig &config);
+        ~FramePacer();
+
+        /**
+         * BeginFrame - blocks until the slot of the new frame is free again and returns its index. call it before
+         * sampling input, so the wait does not add to the latency
+         */
+        std::uint32_t BeginFrame();
+
+        /**
+         * AcquireImage - acquires the next swapchain image, the submission of the frame waits for it
+         */
+        std::uint32_t AcquireImage(glal::Swapchain swapchain);
+
+        /**
+         * Submit - once per frame, the frame counts as complete when these command buffers completed
+         */
+        void Submit(glal::Queue queue, const glal::CommandBuffer *command_buffers, std::uint32_t command_buffer_count);
+
+        /**
+         * Present - presents the acquired image once the submission of the frame finished rendering to it
+         */
+        void Present(glal::Queue queue, glal::Swapchain swapchain);
+
+        /**
+         * WaitIdle - blocks until all submitted frames completed, e.g. before recreating the swapchain
+         */
+        void WaitIdle();
+
+        /**
+         * GetFrame - number of the frame being recorded, frame numbers start at 1
+         */
+        [[nodiscard]] std::uint64_t GetFrame() const;
+        [[nodiscard]] std::uint32_t GetFrameIndex() const;
+
+        /**
+         * GetCompletedFrame - non-blocking, the latest frame the gpu finished
+         */
+        [[nodiscard]] std::uint64_t GetCompletedFrame();
+
+    private:
+        struct FrameSlot
+        {
+            std::uint64_t SubmittedFrame;
+
+            glal::Semaphore ImageAcquired;
+            glal::Semaphore RenderFinished;
+            bool Acquired;
+
+            /**
+             * only used without timeline semaphores
+             */
+            glal::Fence Fence;
+        };
+
+        void WaitForFrame(std::uint64_t frame);
+
+        glal::Device m_Device;
+        FramePacerConfig m_Config;
+
+        glal::Semaphore m_Timeline;
+        std::vector<FrameSlot> m_Slots;
+
+        std::uint64_t m_Frame;
+        std::uint64_t m_SubmittedFrame;
+        std::uint64_t m_CompletedFrame;
+    };
+}
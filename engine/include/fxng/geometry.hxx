@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+#include <fxng/mesh.hxx>
+#include <fxng/upload.hxx>
+#include <glal/glal.hxx>
+
+namespace fxng
+{
+    using GeometryHandle = std::uint32_t;
+
+    /**
+     * Free List - first fit allocator over a range of elements, neighbouring free ranges are merged again
+     */
+    class FreeList final
+    {
+    public:
+        explicit FreeList(std::uint32_t size);
+
+        std::optional<std::uint32_t> Allocate(std::uint32_t size);
+        void Free(std::uint32_t offset, std::uint32_t size);
+
+        [[nodiscard]] std::uint32_t GetSize() const;
+        [[nodiscard]] std::uint32_t GetFree() const;
+
+    private:
+        std::uint32_t m_Size;
+        std::uint32_t m_Free;
+
+        /**
+         * free ranges by offset
+         */
+        std::map<std::uint32_t, std::uint32_t> m_Ranges;
+    };
+
+    struct GeometryPoolConfig
+    {
+        /**
+         * all geometry of a pool shares one vertex format
+         */
+        std::uint32_t VertexStride = sizeof(Vertex);
+
+        /**
+         * elements per block, geometry larger than a block gets a block of its own
+         */
+        std::uint32_t BlockVertexCount = 1 << 20;
+        std::uint32_t BlockIndexCount = 1 << 22;
+
+        /**
+         * frames freed geometry may still be in use by the gpu before its ranges are reused
+         */
+        std::uint32_t FramesInFlight = 2;
+    };
+
+    /**
+     * Geometry Range - where the geometry lives within its block. indices are relative to the geometry, the vertex
+     * offset is the base vertex of indexed draws
+     */
+    struct GeometryRange
+    {
+        std::uint32_t Block;
+
+        std::int32_t VertexOffset;
+        std::uint32_t VertexCount;
+
+        std::uint32_t FirstIndex;
+        std::uint32_t IndexCount;
+
+        UploadTicket Ticket;
+    };
+
+    /**
+     * Geometry Pool - sub-allocates the vertices and 32 bit indices of static geometry from a few large device local
+     * buffers, so draws of different geometry within a block need no buffer rebinds. render thread only
+     */
+    class GeometryPool final
+    {
+    public:
+        explicit GeometryPool(glal::Device device, UploadManager &uploads, const GeometryPoolConfig &config);
+        ~GeometryPool();
+
+        /**
+         * Allocate - copies the data into the pool through the upload manager, the geometry may be drawn once it is
+         * resident. the render thread submits the uploads itself once the ring fills up, so any amount of geometry
+         * may be allocated within a frame
+         */
+        GeometryHandle Allocate(
+            const void *vertices,
+            std::uint32_t vertex_count,
+            const std::uint32_t *indices,
+            std::uint32_t index_count);
+
+        /**
+         * Free - the ranges are reused once the frames in flight completed
+         */
+        void Free(GeometryHandle geometry);
+
+        /**
+         * Update - once per frame: releases the ranges of geometry freed long enough ago
+         */
+        void Update();
+
+        [[nodiscard]] const GeometryRange &GetRange(GeometryHandle geometry) const;
+        [[nodiscard]] bool IsResident(GeometryHandle geometry) const;
+
+        [[nodiscard]] std::uint32_t GetBlockCount() const;
+        [[nodiscard]] glal::Buffer GetVertexBuffer(std::uint32_t block) const;
+        [[nodiscard]] glal::Buffer GetIndexBuffer(std::uint32_t block) const;
+
+    private:
+        struct Block
+        {
+            glal::Buffer Vertices;
+            glal::Buffer Indices;
+
+            FreeList VertexRanges;
+            FreeList IndexRanges;
+        };
+
+        struct PooledGeometry
+        {
+            bool Active;
+            GeometryRange Range;
+        };
+
+        struct RetiredGeometry
+        {
+            std::uint64_t Frame;
+            GeometryHandle Geometry;
+        };
+
+        PooledGeometry &At(GeometryHandle geometry);
+        [[nodiscard]] const PooledGeometry &At(GeometryHandle geometry) const;
+
+        std::uint32_t CreateBlock(std::uint32_t vertex_count, std::uint32_t index_count);
+        void Release(GeometryHandle geometry);
+
+        glal::Device m_Device;
+        UploadManager &m_Uploads;
+        GeometryPoolConfig m_Config;
+
+        std::uint64_t m_Frame;
+
+        std::vector<Block> m_Blocks;
+
+        std::vector<PooledGeometry> m_Geometry;
+        std::vector<GeometryHandle> m_FreeGeometry;
+
+        std::vector<RetiredGeometry> m_Retired;
+    };
+}
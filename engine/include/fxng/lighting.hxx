@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glal/glal.hxx>
+#include <glm/glm.hpp>
+
+namespace fxng
+{
+    /**
+     * bindings of the light buffers in the frame descriptor set, all storage buffers read by the fragment stage
+     */
+    constexpr std::uint32_t LightBufferBinding = 3;
+    constexpr std::uint32_t LightClusterBufferBinding = 4;
+    constexpr std::uint32_t LightIndexBufferBinding = 5;
+
+    /**
+     * Light Data - std430 layout of a light as read by the shaders, in world space. the type is a fxng::LightType
+     */
+    struct LightData
+    {
+        glm::vec3 Position;
+        float Range;
+        glm::vec3 Direction;
+        std::uint32_t Type;
+        glm::vec3 Diffuse;
+        float LinearFalloff;
+        glm::vec3 Specular;
+        float QuadraticFalloff;
+    };
+
+    /**
+     * Light Cluster - std430, the point lights touching a cluster are Count indices starting at Offset in the light
+     * index buffer
+     */
+    struct LightCluster
+    {
+        std::uint32_t Offset;
+        std::uint32_t Count;
+    };
+
+    /**
+     * Light Cluster Params - how a fragment finds its cluster: x and y scale the fragment coordinate to the tile,
+     * the slice is log(view depth) * z + w. the grid is the cluster count per axis and the number of directional
+     * lights at the front of the light buffer, which apply to every cluster
+     */
+    struct LightClusterParams
+    {
+        glm::uvec4 Grid;
+        glm::vec4 Scale;
+    };
+
+    struct ClusteredLightsConfig
+    {
+        /**
+         * screen tiles and exponential depth slices of the cluster grid
+         */
+        std::uint32_t TilesX = 16;
+        std::uint32_t TilesY = 9;
+        std::uint32_t Slices = 24;
+
+        std::uint32_t FramesInFlight = 2;
+    };
+
+    /**
+     * Clustered Lights - bins the point lights of a view into a view space cluster grid on the cpu, so fragments only
+     * shade the lights their cluster touches. the cluster ranges of the lights are computed four at a time, the
+     * lists of all clusters are packed into one index buffer with a counting sort. every frame in flight has its own
+     * buffers. render thread only
+     */
+    class ClusteredLights final
+    {
+    public:
+        explicit ClusteredLights(glal::Device device, const ClusteredLightsConfig &config);
+        ~ClusteredLights();
+
+        void Clear();
+        void Add(const LightData &light);
+
+        /**
+         * Build - bins the added lights for the view, point lights behind the far plane or outside the frustum are
+         * dropped
+         */
+        LightClusterParams Build(
+            const glm::mat4 &view,
+            const glm::mat4 &projection,
+            float near_plane,
+            float far_plane,
+            std::uint32_t width,
+            std::uint32_t height);
+
+        /**
+         * Upload - writes the built lights and clusters to the buffers of the frame slot and binds them to the
+         * descriptor set of the slot, the gpu has to be done with the slot. the buffers grow on demand
+         */
+        void Upload(std::uint32_t frame_index, glal::DescriptorSet descriptor_set);
+
+        [[nodiscard]] std::uint32_t GetLightCount() const;
+        [[nodiscard]] std::uint32_t GetIndexCount() const;
+        [[nodiscard]] std::uint32_t GetClusterCount() const;
+
+    private:
+        /**
+         * inclusive cluster ranges of a visible point light along x, y and z
+         */
+        struct ClusterBounds
+        {
+            std::uint32_t Min[3];
+            std::uint32_t Max[3];
+        };
+
+        struct FrameBuffers
+        {
+            glal::Buffer Lights;
+            glal::Buffer Clusters;
+            glal::Buffer Indices;
+        };
+
+        /**
+         * BoundLights - appends the point lights touching the view to the sorted lights and their cluster ranges to
+         * the bounds, the slice starts have to be set up
+         */
+        void BoundLights(const glm::mat4 &view, const glm::mat4 &projection, float near_plane, float far_plane);
+
+        static void Write(glal::Buffer buffer, const void *data, std::size_t size);
+        glal::Buffer Reserve(glal::Buffer buffer, std::size_t size);
+
+        glal::Device m_Device;
+        ClusteredLightsConfig m_Config;
+
+        std::vector<LightData> m_Lights;
+        std::vector<const LightData *> m_PointLights;
+        std::vector<LightData> m_Sorted;
+        std::vector<ClusterBounds> m_Bounds;
+        std::vector<float> m_SliceStarts;
+
+        std::vector<LightCluster> m_Clusters;
+        std::vector<std::uint32_t> m_Indices;
+
+        std::vector<FrameBuffers> m_Buffers;
+    };
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace fxng
+{
+    constexpr std::uint32_t MaxMeshletVertices = 64;
+    constexpr std::uint32_t MaxMeshletTriangles = 124;
+
+    /**
+     * Vertex - matches the vertex input of the default vertex shader
+     */
+    struct Vertex
+    {
+        glm::vec4 Position;
+        glm::vec3 Normal;
+        glm::vec2 Texture;
+    };
+
+    /**
+     * Meshlet - a contiguous range of the mesh index buffer with culling bounds
+     */
+    struct Meshlet
+    {
+        std::uint32_t IndexOffset;
+        std::uint32_t IndexCount;
+        std::uint32_t VertexCount;
+
+        glm::vec3 Center;
+        float Radius;
+
+        glm::vec3 ConeAxis;
+        float ConeCutoff;
+    };
+
+    /**
+     * Mesh LOD - index and meshlet range of a single level of detail, with its object-space error
+     */
+    struct MeshLod
+    {
+        std::uint32_t IndexOffset;
+        std::uint32_t IndexCount;
+        std::uint32_t MeshletOffset;
+        std::uint32_t MeshletCount;
+
+        float Error;
+    };
+
+    /**
+     * Mesh - all levels of detail share the vertex buffer and are appended to the index buffer
+     */
+    struct Mesh
+    {
+        std::vector<Vertex> Vertices;
+        std::vector<std::uint32_t> Indices;
+        std::vector<Meshlet> Meshlets;
+        std::vector<MeshLod> Lods;
+
+        glm::vec3 Center;
+        float Radius;
+    };
+
+    Mesh LoadMesh(const std::filesystem::path &path);
+
+    std::vector<std::uint32_t> SimplifyMesh(
+        const std::vector<Vertex> &vertices,
+        const std::vector<std::uint32_t> &indices,
+        std::size_t target_index_count,
+        float target_error,
+        float *result_error);
+
+    void BuildLods(Mesh &mesh, std::uint32_t count, float ratio, float error);
+    void BuildMeshlets(Mesh &mesh);
+}
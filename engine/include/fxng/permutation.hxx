@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <fxng/uniform.hxx>
+#include <glal/glal.hxx>
+#include <glal/reflect.hxx>
+
+namespace fxng
+{
+    /**
+     * Material Feature - what a material makes use of. feature bit n is the bool specialization constant with
+     * constant_id n, so a material without a feature never runs the code behind it
+     */
+    enum MaterialFeature : std::uint32_t
+    {
+        MaterialFeature_None = 0,
+        MaterialFeature_DiffuseTexture = 1 << 0,
+        MaterialFeature_Specular = 1 << 1,
+    };
+
+    constexpr std::uint32_t MaterialFeatureCount = 2;
+
+    /**
+     * GetMaterialFeatures - the features the uniforms of a material need
+     */
+    MaterialFeature GetMaterialFeatures(const MaterialUniforms &uniforms);
+
+    /**
+     * Pipeline Permutations - the variants of one pipeline description, specialized per feature set. every stage only
+     * gets the constants its reflection declares, gl rejects the others. variants compile asynchronously on first use
+     * and are kept until the permutations are destroyed. render thread only
+     */
+    class PipelinePermutations final
+    {
+    public:
+        /**
+         * the reflections belong to the stages of the description, in order
+         */
+        explicit PipelinePermutations(
+            glal::Device device,
+            const glal::PipelineDesc &desc,
+            const glal::ShaderReflection *reflections,
+            std::uint32_t reflection_count);
+        ~PipelinePermutations();
+
+        /**
+         * Get - returns right away, a new variant reports pending until it has compiled and draws skip it until then
+         */
+        glal::Pipeline Get(MaterialFeature features);
+
+        [[nodiscard]] std::size_t GetVariantCount() const;
+
+    private:
+        glal::Device m_Device;
+
+        glal::PipelineDesc m_Desc;
+        std::vector<glal::PipelineStage> m_Stages;
+        std::vector<glal::VertexBinding> m_VertexBindings;
+        std::vector<glal::VertexAttribute> m_VertexAttributes;
+
+        /**
+         * per stage, the feature bits it declares a constant for
+         */
+        std::vector<std::uint32_t> m_StageFeatures;
+
+        std::unordered_map<std::uint32_t, glal::Pipeline> m_Variants;
+    };
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <glal/glal.hxx>
+
+namespace fxng
+{
+    struct GpuProfilerConfig
+    {
+        /**
+         * passes that may be measured per frame
+         */
+        std::uint32_t MaxPasses = 32;
+
+        /**
+         * frames recorded before the queries of a frame are read. with more than the frames in flight, the results are
+         * available without waiting for the gpu
+         */
+        std::uint32_t FrameLatency = 3;
+
+        /**
+         * frames the rolling average and maximum of a pass cover
+         */
+        std::uint32_t HistorySize = 64;
+
+        /**
+         * also count the work of every pass, needs DeviceFeature_PipelineStatisticsQuery
+         */
+        bool PipelineStatistics = false;
+    };
+
+    /**
+     * Gpu Pass Timing - the rolling results of a named pass, in milliseconds
+     */
+    struct GpuPassTiming
+    {
+        std::string Name;
+
+        double LastMs = 0.0;
+        double AverageMs = 0.0;
+        double MaxMs = 0.0;
+
+        /**
+         * counters of the latest measured frame, zero unless pipeline statistics are enabled
+         */
+        glal::PipelineStatistics Statistics{};
+    };
+
+    /**
+     * Gpu Profiler - brackets passes with timestamp queries and reads them back a few frames later. results that are
+     * still not available by then are dropped instead of stalling the frame
+     */
+    class GpuProfiler final
+    {
+    public:
+        explicit GpuProfiler(glal::Device device, const GpuProfilerConfig &config);
+        ~GpuProfiler();
+
+        /**
+         * BeginFrame - first command of the frame: collects the frame that used the same queries before and resets them
+         */
+        void BeginFrame(glal::CommandBuffer command_buffer);
+
+        /**
+         * BeginPass, EndPass - around the render passes of a pass, passes cannot nest. passes beyond the maximum of a
+         * frame are not measured
+         */
+        void BeginPass(glal::CommandBuffer command_buffer, std::string_view name);
+        void EndPass(glal::CommandBuffer command_buffer);
+
+        /**
+         * GetPasses - every pass measured so far, in the order they were first seen
+         */
+        [[nodiscard]] const std::vector<GpuPassTiming> &GetPasses() const;
+
+        /**
+         * GetDroppedFrames - frames whose results were not available in time, FrameLatency should be raised if this
+         * keeps growing
+         */
+        [[nodiscard]] std::uint64_t GetDroppedFrames() const;
+
+    private:
+        struct Frame
+        {
+            std::vector<std::uint32_t> Passes;
+        };
+
+        struct History
+        {
+            std::vector<double> Samples;
+            std::uint32_t Next = 0;
+            std::uint32_t Count = 0;
+        };
+
+        void Collect(std::uint32_t frame_index);
+        void AddSample(std::uint32_t pass_index, double ms);
+
+        std::uint32_t FindPass(std::string_view name);
+
+        glal::Device m_Device;
+        GpuProfilerConfig m_Config;
+
+        double m_TimestampPeriod;
+
+        glal::QueryPool m_Timestamps;
+        glal::QueryPool m_Statistics;
+
+        std::vector<Frame> m_Frames;
+        std::uint32_t m_FrameIndex;
+        bool m_InPass;
+
+        std::vector<GpuPassTiming> m_Passes;
+        std::vector<History> m_Histories;
+        std::unordered_map<std::string, std::uint32_t> m_PassIndices;
+
+        std::vector<std::uint64_t> m_Results;
+        std::uint64_t m_DroppedFrames;
+    };
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+#include <glal/glal.hxx>
+
+namespace fxng
+{
+    /**
+     * Readback Callback - receives the tightly packed pixels of the image, the data is only valid during the call
+     */
+    using ReadbackCallback = std::function<void(const void *data, std::size_t size)>;
+
+    struct ReadbackManagerConfig
+    {
+        /**
+         * readbacks that may be in flight at once. with at least one more than the frames in flight, a frame is read
+         * without waiting for the gpu
+         */
+        std::uint32_t MaxReadbacks = 3;
+    };
+
+    /**
+     * Readback Manager - copies images into a ring of host visible buffers and hands the pixels out once the copies
+     * completed. the data of frame n arrives a few frames later, but reading it never stalls the pipeline
+     */
+    class ReadbackManager final
+    {
+    public:
+        explicit ReadbackManager(glal::Device device, const ReadbackManagerConfig &config);
+        ~ReadbackManager();
+
+        /**
+         * ReadImage - render thread only, submit after the work that renders the image. the image has to be in the copy
+         * source state. only blocks when all readbacks are in flight
+         */
+        void ReadImage(glal::Image image, std::uint32_t mip_level, ReadbackCallback callback);
+
+        /**
+         * Poll - once per frame: delivers the completed readbacks in submission order
+         */
+        void Poll();
+
+        /**
+         * Flush - blocks until all readbacks completed and delivers them
+         */
+        void Flush();
+
+    private:
+        struct Slot
+        {
+            glal::Buffer Buffer;
+            void *Data;
+
+            glal::CommandBuffer CommandBuffer;
+            glal::Fence Fence;
+
+            std::size_t Size;
+            ReadbackCallback Callback;
+        };
+
+        /**
+         * Deliver - hands out the oldest readback and frees its slot, waiting for it if necessary
+         */
+        void Deliver();
+
+        glal::Device m_Device;
+        ReadbackManagerConfig m_Config;
+
+        glal::Queue m_Queue;
+
+        std::vector<Slot> m_Slots;
+        std::deque<std::uint32_t> m_InFlight;
+        std::vector<std::uint32_t> m_FreeSlots;
+    };
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glal/glal.hxx>
+
+namespace fxng
+{
+    constexpr std::uint32_t MaxDrawDescriptorSets = 4;
+    constexpr std::uint32_t MaxDrawDynamicOffsets = 8;
+
+    /**
+     * vertex binding the per instance data of instanced draws is bound to
+     */
+    constexpr std::uint32_t InstanceBufferBinding = 1;
+
+    enum DrawPass
+    {
+        DrawPass_Opaque,
+
+        /**
+         * sorted back to front instead of by state
+         */
+        DrawPass_Translucent,
+    };
+
+    /**
+     * Draw Key - packs everything draws are ordered by into 64 bits, most significant first:
+     * view (4) | pass (4) | pipeline (12) | material (12) | mesh (16) | depth (16). opaque draws are grouped by state
+     * and front to back within a group, translucent draws put the inverted depth right after the pass instead. ids
+     * wider than their bits wrap around, which only costs grouping, never correctness
+     */
+    struct DrawKey
+    {
+        static constexpr std::uint32_t ViewBits = 4;
+        static constexpr std::uint32_t PassBits = 4;
+        static constexpr std::uint32_t PipelineBits = 12;
+        static constexpr std::uint32_t MaterialBits = 12;
+        static constexpr std::uint32_t MeshBits = 16;
+        static constexpr std::uint32_t DepthBits = 16;
+
+        static constexpr std::uint32_t ViewShift = 60;
+        static constexpr std::uint32_t PassShift = 56;
+
+        static std::uint64_t Opaque(
+            std::uint32_t view,
+            std::uint32_t pipeline,
+            std::uint32_t material,
+            std::uint32_t mesh,
+            std::uint32_t depth);
+
+        static std::uint64_t Translucent(
+            std::uint32_t view,
+            std::uint32_t pipeline,
+            std::uint32_t material,
+            std::uint32_t mesh,
+            std::uint32_t depth);
+
+        /**
+         * QuantizeDepth - linear view depth between the planes to the depth bits, clamped
+         */
+        static std::uint32_t QuantizeDepth(float depth, float near_plane, float far_plane);
+
+        static std::uint32_t GetView(std::uint64_t key);
+        static DrawPass GetPass(std::uint64_t key);
+    };
+
+    /**
+     * Draw Packet - everything needed to record a draw. without an index buffer the count and first are vertices,
+     * without an instance count the draw is not instanced. the vertex offset is the base vertex of indexed draws. the
+     * dynamic offsets cover all dynamic descriptors of the sets in order. with an indirect buffer the indexed draws are
+     * read from it instead, count, first, vertex offset and instances only describe the draw for the statistics
+     */
+    struct DrawPacket
+    {
+        glal::Pipeline Pipeline;
+
+        std::array<glal::DescriptorSet, MaxDrawDescriptorSets> DescriptorSets;
+        std::uint32_t DescriptorSetCount;
+
+        std::array<std::uint32_t, MaxDrawDynamicOffsets> DynamicOffsets;
+        std::uint32_t DynamicOffsetCount;
+
+        glal::Buffer VertexBuffer;
+        glal::Buffer IndexBuffer;
+        glal::DataType IndexType;
+
+        std::uint32_t Count;
+        std::uint32_t First;
+        std::int32_t VertexOffset;
+
+        glal::Buffer InstanceBuffer;
+        std::uint32_t InstanceCount;
+        std::uint32_t FirstInstance;
+
+        glal::Buffer IndirectBuffer;
+        std::uint32_t IndirectCount;
+    };
+
+    /**
+     * Render Queue Statistics - commands recorded by the last Execute, the binds show how well the keys grouped state
+     */
+    struct RenderQueueStatistics
+    {
+        std::uint32_t Draws;
+        std::uint32_t Instances;
+        std::uint32_t Skipped;
+
+        std::uint32_t PipelineBinds;
+        std::uint32_t DescriptorSetBinds;
+        std::uint32_t VertexBufferBinds;
+        std::uint32_t IndexBufferBinds;
+    };
+
+    struct RenderQueueConfig
+    {
+        /**
+         * queues with fewer draws are sorted on the calling thread
+         */
+        std::size_t ParallelThreshold = 1 << 14;
+
+        /**
+         * threads the sort is split across, 0 uses the hardware concurrency
+         */
+        std::uint32_t MaxThreads = 0;
+    };
+
+    /**
+     * Render Queue - collects the draws of a frame as sort keys with payloads, sorts them with a parallel radix sort
+     * and records them with as few state changes as the order allows. not thread-safe
+     */
+    class RenderQueue final
+    {
+    public:
+        explicit RenderQueue(const RenderQueueConfig &config);
+
+        void Clear();
+        void Submit(std::uint64_t key, const DrawPacket &packet);
+
+        /**
+         * Sort - stable, draws with equal keys keep their submission order
+         */
+        void Sort();
+
+        /**
+         * Execute - records the sorted draws of one view into a render pass. pipelines that are still compiling are
+         * skipped together with their draws. the view constants are pushed at offset 0 to the vertex and fragment
+         * stages whenever a pipeline is bound
+         */
+        RenderQueueStatistics Execute(
+            glal::CommandBuffer command_buffer,
+            std::uint32_t view,
+            const void *view_constants = nullptr,
+            std::uint32_t view_constants_size = 0);
+
+        [[nodiscard]] std::size_t GetSize() const;
+
+    private:
+        struct Entry
+        {
+            std::uint64_t Key;
+            std::uint32_t Packet;
+        };
+
+        [[nodiscard]] std::uint32_t GetThreadCount() const;
+
+        RenderQueueConfig m_Config;
+
+        std::vector<Entry> m_Entries;
+        std::vector<Entry> m_Scratch;
+        std::vector<DrawPacket> m_Packets;
+
+        bool m_Sorted;
+    };
+}
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <vector>
+#include <fxng/upload.hxx>
+#include <glal/glal.hxx>
+
+namespace fxng
+{
+    constexpr std::uint32_t TextureMagic = 0x58455446; // 'FTEX'
+    constexpr std::uint32_t TextureVersion = 1;
+
+    /**
+     * Texture Mip - location of a single mip level inside a texture file
+     */
+    struct TextureMip
+    {
+        std::uint64_t Offset;
+        std::uint64_t Size;
+    };
+
+    /**
+     * Texture Info - header of a texture file. the mip levels are stored contiguously from the largest to the
+     * smallest, so every mip chain suffix can be read in one go
+     */
+    struct TextureInfo
+    {
+        glal::ImageFormat Format;
+        glal::ImageType Type;
+        glal::Extent3D Extent;
+        std::vector<TextureMip> Mips;
+
+        [[nodiscard]] glal::Extent3D GetMipExtent(std::uint32_t mip_level) const;
+
+        /**
+         * GetChainSize - number of bytes of all mip levels starting at mip_level
+         */
+        [[nodiscard]] std::uint64_t GetChainSize(std::uint32_t mip_level) const;
+    };
+
+    TextureInfo LoadTextureInfo(const std::filesystem::path &path);
+    std::vector<char> LoadTextureMips(const std::filesystem::path &path, const TextureInfo &info, std::uint32_t mip_level);
+    void SaveTexture(
+        const std::filesystem::path &path,
+        glal::ImageFormat format,
+        glal::ImageType type,
+        glal::Extent3D extent,
+        const std::vector<std::vector<char>> &mips);
+
+    /**
+     * set and binding of the bindless texture array of a texture heap, materials reference its elements by index
+     */
+    constexpr std::uint32_t TextureHeapSet = 1;
+    constexpr std::uint32_t TextureHeapBinding = 0;
+
+    constexpr std::uint32_t InvalidTextureIndex = ~0u;
+
+    struct TextureHeapConfig
+    {
+        /**
+         * textures the heap holds at once, at most the bindless texture limit of the device
+         */
+        std::uint32_t Capacity = 4096;
+
+        std::uint32_t FramesInFlight = 2;
+    };
+
+    /**
+     * Texture Heap - one bindless array of combined image samplers shared by all materials, which select textures by
+     * 32-bit index instead of binding them. every frame in flight has its own copy of the set and a write reaches a
+     * copy once its frame begins, so an index can be repointed while earlier frames still sample the old texture.
+     * render thread only
+     */
+    class TextureHeap final
+    {
+    public:
+        explicit TextureHeap(glal::Device device, UploadManager &uploads, const TextureHeapConfig &config);
+        ~TextureHeap();
+
+        /**
+         * Allocate - a nullptr image view or sampler selects the white placeholder texture of the heap
+         */
+        std::uint32_t Allocate(glal::ImageView image_view, glal::Sampler sampler);
+
+        /**
+         * Update - the previous image view is sampled until all frames in flight have begun after the update
+         */
+        void Update(std::uint32_t index, glal::ImageView image_view, glal::Sampler sampler);
+
+        /**
+         * Free - the sets drop the image view for the placeholder as their frames begin, the index is handed out
+         * again once the frames in flight that may sample it have finished
+         */
+        void Free(std::uint32_t index);
+
+        /**
+         * BeginFrame - writes the updates the set of the frame slot missed, the gpu has to be done with the slot
+         */
+        void BeginFrame(std::uint32_t frame_index);
+
+        [[nodiscard]] glal::DescriptorSetLayout GetDescriptorSetLayout() const;
+        [[nodiscard]] glal::DescriptorSet GetDescriptorSet(std::uint32_t frame_index) const;
+        [[nodiscard]] std::uint32_t GetCapacity() const;
+
+    private:
+        struct HeapEntry
+        {
+            bool Active;
+
+            glal::ImageView ImageView;
+            glal::Sampler Sampler;
+
+            /**
+             * one bit per frame slot whose set still lacks the current image view
+             */
+            std::uint32_t PendingSlots;
+        };
+
+        struct RetiredIndex
+        {
+            std::uint64_t Frame;
+            std::uint32_t Index;
+        };
+
+        HeapEntry &At(std::uint32_t index);
+        void Write(HeapEntry &entry, std::uint32_t index, glal::ImageView image_view, glal::Sampler sampler);
+
+        glal::Device m_Device;
+        TextureHeapConfig m_Config;
+
+        std::uint64_t m_Frame;
+
+        glal::Image m_PlaceholderImage;
+        glal::ImageView m_PlaceholderView;
+        glal::Sampler m_PlaceholderSampler;
+
+        glal::DescriptorSetLayout m_DescriptorSetLayout;
+        std::vector<glal::DescriptorSet> m_DescriptorSets;
+
+        std::vector<HeapEntry> m_Entries;
+        std::vector<std::uint32_t> m_FreeIndices;
+        std::vector<std::uint32_t> m_Pending;
+        std::vector<RetiredIndex> m_Retired;
+    };
+
+    using TextureHandle = std::uint32_t;
+
+    constexpr TextureHandle InvalidTexture = ~0u;
+
+    struct TextureStreamerConfig
+    {
+        /**
+         * upper bound for the resident image memory of all textures, the mip tails are always kept
+         */
+        std::uint64_t Budget = 256ull << 20;
+
+        /**
+         * mip levels no larger than this are loaded on registration and never evicted
+         */
+        std::uint32_t MipTailSize = 64;
+
+        std::uint32_t MaxLoads = 8;
+
+        /**
+         * frames a replaced image may still be in use by the gpu before it is destroyed
+         */
+        std::uint32_t FramesInFlight = 2;
+    };
+
+    /**
+     * Streamed Texture - residency state of a single texture. the resident image always holds the complete chain
+     * from ResidentMipLevel down to the smallest level
+     */
+    struct StreamedTexture
+    {
+        bool Active;
+
+        std::filesystem::path Path;
+        TextureInfo Info;
+
+        std::uint32_t TailMipLevel;
+        std::uint32_t ResidentMipLevel;
+        std::uint32_t TargetMipLevel;
+
+        float Coverage;
+        std::uint64_t LastRequestFrame;
+
+        glal::Image Image;
+        glal::ImageView View;
+
+        /**
+         * image a load is uploading into, it replaces the resident image once its upload ticket completed
+         */
+        glal::Image LoadImage;
+        std::uint32_t LoadMipLevel;
+        std::future<UploadTicket> Load;
+        UploadTicket LoadTicket;
+    };
+
+    /**
+     * Texture Streamer - keeps the mip levels each texture needs for its current screen coverage resident within a
+     * fixed memory budget. file reads and uploads run on worker threads through the upload manager, a new image is
+     * swapped in once its transfer completed
+     */
+    class TextureStreamer final
+    {
+    public:
+        explicit TextureStreamer(glal::Device device, UploadManager &uploads, const TextureStreamerConfig &config);
+        ~TextureStreamer();
+
+        TextureHandle Register(const std::filesystem::path &path);
+        void Unregister(TextureHandle texture);
+
+        /**
+         * Request - report the number of screen pixels the texture covers along its largest axis this frame, the
+         * largest request of a frame wins
+         */
+        void Request(TextureHandle texture, float coverage);
+
+        /**
+         * Update - once per frame: picks the resident mip levels, starts loads and swaps in finished uploads. the
+         * upload manager is flushed by its owner
+         */
+        void Update();
+
+        /**
+         * GetImageView - nullptr until the mip tail of the texture finished uploading, changes whenever the
+         * residency changes
+         */
+        [[nodiscard]] glal::ImageView GetImageView(TextureHandle texture) const;
+        [[nodiscard]] std::uint32_t GetResidentMipLevel(TextureHandle texture) const;
+        [[nodiscard]] std::uint64_t GetResidentSize() const;
+
+    private:
+        struct RetiredResources
+        {
+            std::uint64_t Frame;
+            UploadTicket Ticket;
+
+            glal::Image Image;
+            glal::ImageView View;
+        };
+
+        StreamedTexture &At(TextureHandle texture);
+        [[nodiscard]] const StreamedTexture &At(TextureHandle texture) const;
+
+        void SelectTargets();
+        void StartLoads();
+        void StartLoad(StreamedTexture &texture, std::uint32_t mip_level);
+        void FinishUploads();
+        void Retire(const RetiredResources &resources);
+        void DestroyRetired(bool all);
+
+        glal::Device m_Device;
+        UploadManager &m_Uploads;
+        TextureStreamerConfig m_Config;
+
+        std::uint64_t m_Frame;
+
+        std::vector<StreamedTexture> m_Textures;
+        std::vector<TextureHandle> m_FreeTextures;
+
+        std::vector<RetiredResources> m_Retired;
+    };
+}
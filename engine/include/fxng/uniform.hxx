@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <fxng/lighting.hxx>
+#include <fxng/texture.hxx>
+#include <glal/glal.hxx>
+#include <glm/glm.hpp>
+
+namespace fxng
+{
+    /**
+     * bindings of the frame descriptor set, set 0 of every material pipeline layout. these are dynamic uniform
+     * buffers, bound with one offset each in this order. the light buffers follow them, see fxng/lighting.hxx
+     */
+    constexpr std::uint32_t FrameUniformBinding = 0;
+    constexpr std::uint32_t ViewUniformBinding = 1;
+    constexpr std::uint32_t MaterialUniformBinding = 2;
+    constexpr std::uint32_t FrameDynamicOffsetCount = 3;
+
+    /**
+     * Frame Uniforms - std140, written once per frame
+     */
+    struct FrameUniforms final
+    {
+        glm::vec2 Resolution;
+        float Time;
+        std::uint32_t Frame;
+    };
+
+    /**
+     * View Uniforms - std140, written once per view and frame. the clusters locate the lights of a fragment
+     */
+    struct ViewUniforms final
+    {
+        glm::mat4 View;
+        glm::mat4 Projection;
+        glm::mat4 ViewProjection;
+        glm::vec4 Position;
+        LightClusterParams Clusters;
+    };
+
+    /**
+     * Material Uniforms - std140, uploaded once whenever the material is registered. textures are indices into the
+     * texture heap
+     */
+    struct MaterialUniforms final
+    {
+        alignas(16) glm::vec3 Ambient;
+        alignas(16) glm::vec3 Diffuse;
+        alignas(16) glm::vec3 Specular;
+        float Shininess;
+
+        std::uint32_t DiffuseTexture = InvalidTextureIndex;
+    };
+
+    struct UniformArenaConfig
+    {
+        /**
+         * bytes per frame slot, a frame has to fit all of its blocks
+         */
+        std::size_t Size = 1 << 20;
+
+        std::uint32_t FramesInFlight = 2;
+    };
+
+    /**
+     * Uniform Arena - one host visible uniform buffer per frame in flight. the blocks of a frame are packed linearly
+     * into the buffer of its slot and selected with dynamic offsets, so the descriptor sets never change. render thread
+     * only
+     */
+    class UniformArena final
+    {
+    public:
+        explicit UniformArena(glal::Device device, const UniformArenaConfig &config);
+        ~UniformArena();
+
+        /**
+         * Begin - maps the buffer of the frame slot, the gpu has to be done with the frame that used it last
+         */
+        void Begin(std::uint32_t frame_index);
+
+        /**
+         * End - unmaps the buffer before the frame is submitted
+         */
+        void End();
+
+        /**
+         * Write - copies the block to the next aligned offset of the current slot and returns the offset
+         */
+        std::uint32_t Write(const void *data, std::size_t size);
+
+        template<typename T>
+        std::uint32_t Write(const T &block)
+        {
+            return Write(&block, sizeof(T));
+        }
+
+        [[nodiscard]] glal::Buffer GetBuffer(std::uint32_t frame_index) const;
+        [[nodiscard]] std::size_t GetAlignment() const;
+
+    private:
+        glal::Device m_Device;
+        UniformArenaConfig m_Config;
+
+        std::size_t m_Alignment;
+
+        std::vector<glal::Buffer> m_Buffers;
+
+        std::byte *m_Mapping;
+        std::uint32_t m_FrameIndex;
+        std::size_t m_Head;
+    };
+}
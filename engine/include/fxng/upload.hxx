@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glal/glal.hxx>
+
+namespace fxng
+{
+    /**
+     * Upload Ticket - identifies the batch an upload was recorded into, tickets complete in order
+     */
+    using UploadTicket = std::uint64_t;
+
+    struct UploadManagerConfig
+    {
+        /**
+         * size of the persistently mapped staging ring all uploads are copied through
+         */
+        std::uint64_t RingSize = 64ull << 20;
+
+        /**
+         * batches that may be in flight on the transfer queue at once
+         */
+        std::uint32_t MaxBatches = 4;
+    };
+
+    /**
+     * Upload Manager - copies buffer and image data through a staging ring and submits the copies in batches on the
+     * transfer queue. uploads may come from any thread, the caller only pays for the memcpy into the ring. batches
+     * are only submitted by the thread that created the manager, the render thread
+     */
+    class UploadManager final
+    {
+    public:
+        explicit UploadManager(glal::Device device, const UploadManagerConfig &config);
+        ~UploadManager();
+
+        /**
+         * UploadBuffer - thread-safe, blocks only while the ring is full. on the render thread a full ring submits
+         * the open batch and waits for the transfer queue instead. uploads larger than a quarter of the ring
+         * are split across several batches, the returned ticket is the one of the last part
+         */
+        UploadTicket UploadBuffer(glal::Buffer dst_buffer, std::size_t dst_offset, const void *data, std::size_t size);
+
+        /**
+         * UploadImage - thread-safe, data holds a tightly packed mip level of at most half the ring size. the image
+         * is left shader readable
+         */
+        UploadTicket UploadImage(glal::Image dst_image, std::uint32_t mip_level, const void *data, std::size_t size);
+
+        /**
+         * Flush - once per frame on the render thread: retires completed batches and submits the pending uploads
+         */
+        void Flush();
+
+        [[nodiscard]] bool IsComplete(UploadTicket ticket) const;
+
+        /**
+         * Wait - render thread only, submits the batch of the ticket if necessary and blocks until it completed
+         */
+        void Wait(UploadTicket ticket);
+
+    private:
+        struct PendingCopy
+        {
+            glal::Buffer DstBuffer;
+            glal::Image DstImage;
+
+            std::size_t SrcOffset;
+            std::size_t DstOffset;
+            std::size_t Size;
+            std::uint32_t MipLevel;
+        };
+
+        struct Batch
+        {
+            UploadTicket Ticket;
+
+            /**
+             * ring position up to which the staging memory is released once the batch completed
+             */
+            std::uint64_t RingEnd;
+
+            glal::CommandBuffer CommandBuffer;
+            glal::Fence Fence;
+        };
+
+        UploadTicket Copy(const PendingCopy &copy, const void *data);
+        std::uint64_t Allocate(std::unique_lock<std::mutex> &lock, std::size_t size);
+
+        /**
+         * Retire - m_Mutex held, releases completed batches and blocks on the ones up to wait_ticket
+         */
+        void Retire(UploadTicket wait_ticket);
+
+        /**
+         * Submit - m_Mutex held, closes the open batch unless it is empty, being written or no batch is free
+         */
+        bool Submit();
+
+        glal::Device m_Device;
+        UploadManagerConfig m_Config;
+
+        glal::Queue m_Queue;
+        std::thread::id m_SubmitThread;
+
+        glal::Buffer m_Ring;
+        char *m_RingData;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+
+        /**
+         * monotonic byte positions, the ring offset is the position modulo the ring size
+         */
+        std::uint64_t m_Head;
+        std::uint64_t m_Tail;
+
+        std::uint32_t m_Writers;
+        std::vector<PendingCopy> m_Pending;
+
+        UploadTicket m_OpenTicket;
+        std::atomic<UploadTicket> m_CompletedTicket;
+
+        std::deque<Batch> m_InFlight;
+        std::vector<Batch> m_FreeBatches;
+    };
+}
@@ -1,6 +1,35 @@
 #include <fxng/component.hxx>
+#include <glm/gtc/matrix_transform.hpp>
 
 fxng::Camera::Camera(Scene &scene, Entity &parent)
     : Component(scene, parent)
 {
 }
+
+fxng::Camera *fxng::Camera::SetPerspective(const float field_of_view, const float near_plane, const float far_plane)
+{
+    m_FieldOfView = field_of_view;
+    m_Near = near_plane;
+    m_Far = far_plane;
+    return this;
+}
+
+float fxng::Camera::GetFieldOfView() const
+{
+    return m_FieldOfView;
+}
+
+float fxng::Camera::GetNear() const
+{
+    return m_Near;
+}
+
+float fxng::Camera::GetFar() const
+{
+    return m_Far;
+}
+
+glm::mat4 fxng::Camera::GetProjection(const float aspect) const
+{
+    return glm::perspective(m_FieldOfView, aspect, m_Near, m_Far);
+}
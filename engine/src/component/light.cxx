@@ -0,0 +1,67 @@
+#include <cmath>
+#include <limits>
+#include <fxng/component.hxx>
+
+fxng::Light::Light(Scene &scene, Entity &parent)
+    : Component(scene, parent)
+{
+}
+
+fxng::Light *fxng::Light::SetType(const LightType type)
+{
+    m_Type = type;
+    return this;
+}
+
+fxng::LightType fxng::Light::GetType() const
+{
+    return m_Type;
+}
+
+fxng::Light *fxng::Light::SetColor(const glm::vec3 diffuse, const glm::vec3 specular)
+{
+    m_Diffuse = diffuse;
+    m_Specular = specular;
+    return this;
+}
+
+glm::vec3 fxng::Light::GetDiffuse() const
+{
+    return m_Diffuse;
+}
+
+glm::vec3 fxng::Light::GetSpecular() const
+{
+    return m_Specular;
+}
+
+fxng::Light *fxng::Light::SetFalloff(const float linear, const float quadratic)
+{
+    m_LinearFalloff = linear;
+    m_QuadraticFalloff = quadratic;
+    return this;
+}
+
+float fxng::Light::GetLinearFalloff() const
+{
+    return m_LinearFalloff;
+}
+
+float fxng::Light::GetQuadraticFalloff() const
+{
+    return m_QuadraticFalloff;
+}
+
+float fxng::Light::GetRange() const
+{
+    // solves 1 + linear * d + quadratic * d^2 = 256 for d
+    constexpr auto cutoff = 255.f;
+
+    if (m_QuadraticFalloff > 0.f)
+        return (-m_LinearFalloff
+                + std::sqrt(m_LinearFalloff * m_LinearFalloff + 4.f * m_QuadraticFalloff * cutoff))
+               / (2.f * m_QuadraticFalloff);
+    if (m_LinearFalloff > 0.f)
+        return cutoff / m_LinearFalloff;
+    return std::numeric_limits<float>::infinity();
+}
@@ -4,3 +4,36 @@ fxng::Model::Model(Scene &scene, Entity &parent)
     : Component(scene, parent)
 {
 }
+
+fxng::Model *fxng::Model::SetMesh(std::string mesh)
+{
+    m_Mesh = std::move(mesh);
+    return this;
+}
+
+const std::string &fxng::Model::GetMesh() const
+{
+    return m_Mesh;
+}
+
+fxng::Model *fxng::Model::SetMaterial(std::string material)
+{
+    m_Material = std::move(material);
+    return this;
+}
+
+const std::string &fxng::Model::GetMaterial() const
+{
+    return m_Material;
+}
+
+fxng::Model *fxng::Model::SetLod(const std::uint32_t lod)
+{
+    m_Lod = lod;
+    return this;
+}
+
+std::uint32_t fxng::Model::GetLod() const
+{
+    return m_Lod;
+}
@@ -57,6 +57,16 @@ fxng::Transform *fxng::Transform::LookAt(const glm::vec3 eye, const glm::vec3 ce
     return this;
 }
 
+const glm::mat4 &fxng::Transform::GetMatrix() const
+{
+    return m_Matrix;
+}
+
+const glm::mat4 &fxng::Transform::GetInverse() const
+{
+    return m_Inverse;
+}
+
 void fxng::Transform::OnInit()
 {
     m_Dirty = true;
@@ -0,0 +1,34 @@
+#include <fxng/culling.hxx>
+
+fxng::Frustum fxng::Frustum::FromMatrix(const glm::mat4 &view_projection)
+{
+    const auto row = [&](const int i)
+    {
+        return glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+    };
+
+    Frustum frustum
+    {
+        .Planes = {
+            row(3) + row(0),
+            row(3) - row(0),
+            row(3) + row(1),
+            row(3) - row(1),
+            row(3) + row(2),
+            row(3) - row(2),
+        },
+    };
+
+    for (auto &plane : frustum.Planes)
+        plane /= glm::length(glm::vec3(plane));
+
+    return frustum;
+}
+
+bool fxng::Frustum::Intersects(const glm::vec3 center, const float radius) const
+{
+    for (auto &plane : Planes)
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            return false;
+    return true;
+}
@@ -0,0 +1,221 @@
+#include <array>
+#include <bit>
+#include <cstring>
+#include <common/log.hxx>
+#include <fxng/culling.hxx>
+
+static constexpr std::uint32_t workgroup_size = 64;
+
+fxng::MeshletCuller::MeshletCuller(
+    glal::Device device,
+    glal::ShaderModule shader_module,
+    const MeshletCullerConfig &config)
+    : m_Device(device),
+      m_Config(config),
+      m_Jobs(config.FramesInFlight),
+      m_FrameIndex(0),
+      m_JobCount(0)
+{
+    common::Assert(shader_module->GetStage() == glal::ShaderStage_Compute, "meshlet culling requires a compute shader");
+
+    const std::array descriptor_bindings
+    {
+        glal::DescriptorBinding
+        {
+            .Binding = 0,
+            .Type = glal::DescriptorType_UniformBuffer,
+            .Count = 1,
+            .Stages = glal::ShaderStage_Compute,
+        },
+        glal::DescriptorBinding
+        {
+            .Binding = 1,
+            .Type = glal::DescriptorType_StorageBuffer,
+            .Count = 1,
+            .Stages = glal::ShaderStage_Compute,
+        },
+        glal::DescriptorBinding
+        {
+            .Binding = 2,
+            .Type = glal::DescriptorType_StorageBuffer,
+            .Count = 1,
+            .Stages = glal::ShaderStage_Compute,
+        },
+    };
+
+    m_DescriptorSetLayout = m_Device->CreateDescriptorSetLayout(
+        {
+            .Set = 0,
+            .DescriptorBindings = descriptor_bindings.data(),
+            .DescriptorBindingCount = descriptor_bindings.size(),
+        });
+
+    m_PipelineLayout = m_Device->CreatePipelineLayout(
+        {
+            .DescriptorSetLayouts = &m_DescriptorSetLayout,
+            .DescriptorSetLayoutCount = 1,
+        });
+
+    const glal::PipelineStage stage
+    {
+        .Stage = glal::ShaderStage_Compute,
+        .Module = shader_module,
+    };
+
+    m_Pipeline = m_Device->CreatePipelineAsync(
+        {
+            .Type = glal::PipelineType_Compute,
+            .Stages = &stage,
+            .StageCount = 1,
+            .Layout = m_PipelineLayout,
+        });
+}
+
+fxng::MeshletCuller::~MeshletCuller()
+{
+    for (auto &jobs : m_Jobs)
+        for (auto &job : jobs)
+        {
+            m_Device->DestroyDescriptorSet(job.Set);
+            m_Device->DestroyBuffer(job.Uniforms);
+            m_Device->DestroyBuffer(job.Commands);
+        }
+
+    m_Device->DestroyPipeline(m_Pipeline);
+    m_Device->DestroyPipelineLayout(m_PipelineLayout);
+    m_Device->DestroyDescriptorSetLayout(m_DescriptorSetLayout);
+}
+
+fxng::MeshletBuffers fxng::MeshletCuller::CreateBuffers(
+    const Mesh &mesh,
+    const std::int32_t vertex_offset,
+    const std::uint32_t first_index) const
+{
+    common::Assert(!mesh.Meshlets.empty(), "mesh has no meshlets");
+
+    const auto meshlet_count = static_cast<std::uint32_t>(mesh.Meshlets.size());
+
+    const MeshletBuffers buffers
+    {
+        .Meshlets = m_Device->CreateBuffer(
+            {
+                .Size = meshlet_count * sizeof(MeshletData),
+                .Usage = glal::BufferUsage_Storage,
+                .Memory = glal::MemoryUsage_HostToDevice,
+            }),
+        .MeshletCount = meshlet_count,
+    };
+
+    const auto mapped = static_cast<MeshletData *>(buffers.Meshlets->Map());
+    for (std::uint32_t i = 0; i < meshlet_count; ++i)
+    {
+        auto &meshlet = mesh.Meshlets[i];
+        mapped[i] = {
+            .Sphere = glm::vec4(meshlet.Center, meshlet.Radius),
+            .Cone = glm::vec4(meshlet.ConeAxis, meshlet.ConeCutoff),
+            .IndexOffset = first_index + meshlet.IndexOffset,
+            .IndexCount = meshlet.IndexCount,
+            .VertexOffset = vertex_offset,
+            .Padding = 0,
+        };
+    }
+    buffers.Meshlets->Unmap();
+
+    return buffers;
+}
+
+void fxng::MeshletCuller::DestroyBuffers(const MeshletBuffers &buffers) const
+{
+    m_Device->DestroyBuffer(buffers.Meshlets);
+}
+
+void fxng::MeshletCuller::BeginFrame(const std::uint32_t frame_index)
+{
+    m_FrameIndex = frame_index;
+    m_JobCount = 0;
+}
+
+glal::Buffer fxng::MeshletCuller::Cull(
+    const MeshletBuffers &buffers,
+    const MeshLod &lod,
+    const glm::mat4 &model,
+    const Frustum &frustum,
+    const glm::vec3 camera_position,
+    const std::uint32_t first_instance)
+{
+    if (m_Pipeline->GetStatus() != glal::PipelineStatus_Ready)
+        return nullptr;
+
+    auto &jobs = m_Jobs.at(m_FrameIndex);
+    if (m_JobCount == jobs.size())
+        jobs.push_back(
+            {
+                .Uniforms = m_Device->CreateBuffer(
+                    {
+                        .Size = sizeof(MeshletCullUniforms),
+                        .Usage = glal::BufferUsage_Uniform,
+                        .Memory = glal::MemoryUsage_HostToDevice,
+                    }),
+                .Commands = nullptr,
+                .Set = m_Device->CreateDescriptorSet({ .Layout = m_DescriptorSetLayout }),
+                .MeshletCount = 0,
+            });
+
+    // the gpu finished with the jobs of the slot when the frame began
+    auto &job = jobs[m_JobCount++];
+    if (!job.Commands || job.Commands->GetSize() < lod.MeshletCount * sizeof(glal::DrawIndexedIndirectCommand))
+    {
+        if (job.Commands)
+            m_Device->DestroyBuffer(job.Commands);
+
+        job.Commands = m_Device->CreateBuffer(
+            {
+                .Size = std::bit_ceil(lod.MeshletCount) * sizeof(glal::DrawIndexedIndirectCommand),
+                .Usage = glal::BufferUsage_Indirect,
+                .Memory = glal::MemoryUsage_DeviceLocal,
+            });
+    }
+    job.MeshletCount = lod.MeshletCount;
+
+    MeshletCullUniforms uniforms
+    {
+        .Model = model,
+        .CameraPosition = glm::vec4(camera_position, 1.f),
+        .MeshletCount = lod.MeshletCount,
+        .MeshletOffset = lod.MeshletOffset,
+        .FirstInstance = first_instance,
+        .Padding = 0,
+    };
+    std::memcpy(uniforms.Planes, frustum.Planes, sizeof(uniforms.Planes));
+
+    std::memcpy(job.Uniforms->Map(), &uniforms, sizeof(uniforms));
+    job.Uniforms->Unmap();
+
+    job.Set->BindBuffer(0, job.Uniforms);
+    job.Set->BindBuffer(1, buffers.Meshlets);
+    job.Set->BindBuffer(2, job.Commands);
+
+    return job.Commands;
+}
+
+void fxng::MeshletCuller::Record(glal::CommandBuffer command_buffer) const
+{
+    if (!m_JobCount)
+        return;
+
+    const auto &jobs = m_Jobs.at(m_FrameIndex);
+
+    // all barriers of a kind go together, so the dispatches do not wait for each other
+    for (std::uint32_t i = 0; i < m_JobCount; ++i)
+        command_buffer->Transition(jobs[i].Commands, glal::ResourceState_UnorderedAccess);
+
+    command_buffer->BindPipeline(m_Pipeline);
+    for (std::uint32_t i = 0; i < m_JobCount; ++i)
+    {
+        command_buffer->BindDescriptorSets(0, 1, &jobs[i].Set, 0, nullptr);
+        command_buffer->Dispatch((jobs[i].MeshletCount + workgroup_size - 1) / workgroup_size, 1, 1);
+    }
+
+    for (std::uint32_t i = 0; i < m_JobCount; ++i)
+        command_buffer->Transition(jobs[i].Commands, glal::ResourceState_IndirectArgument);
+}
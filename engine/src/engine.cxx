@@ -1,9 +1,17 @@
 #define GLFW_INCLUDE_NONE
 
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <common/log.hxx>
+#include <common/profile.hxx>
+#include <fxng/component.hxx>
+#include <fxng/culling.hxx>
 #include <fxng/engine.hxx>
+#include <fxng/entity.hxx>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <yaml-cpp/yaml.h>
@@ -103,13 +111,39 @@ static constexpr std::array colors
     },
 };
 
+/**
+ * find_camera - the first entity with both a camera and a transform
+ */
+static bool find_camera(const fxng::Scene &scene, const fxng::Camera *&camera, const fxng::Transform *&transform)
+{
+    for (auto &entity : scene)
+        if ((camera = entity.Get<fxng::Camera>()))
+        {
+            transform = entity.Get<fxng::Transform>();
+            return transform;
+        }
+    return false;
+}
+
 fxng::Engine::Engine(const EngineConfig &config)
+    : m_Headless(config.Headless),
+      m_Renderer(config.Renderer),
+      m_ProfileTrace(config.ProfileTrace),
+      m_LodErrorThreshold(config.LodErrorThreshold),
+      m_LodHysteresis(config.LodHysteresis)
 {
     IndexAssets();
 
+    if (m_Headless.Enabled)
+    {
+        CreateHeadless(config.Application);
+        return;
+    }
+
     glfwSetErrorCallback(glfw_error_callback);
 
-    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_WAYLAND);
+    // whichever window system is running, forcing one fails everywhere else
+    glfwInitHint(GLFW_PLATFORM, GLFW_ANY_PLATFORM);
     common::Assert(glfwInit(), "failed to initialize glfw");
 
     const auto primary_monitor = glfwGetPrimaryMonitor();
@@ -141,50 +175,65 @@ fxng::Engine::Engine(const EngineConfig &config)
         m_Windows.push_back(window);
     }
 
-    while (!glfwWindowShouldClose(m_PrimaryWindow))
-    {
-        glfwPollEvents();
+    common::Assert(m_PrimaryWindow, "no main window was configured");
 
-        auto index = 0u;
-        auto active = false;
+    // models are drawn on the context of the primary window, secondary windows are only cleared
+    glfwMakeContextCurrent(m_PrimaryWindow);
 
-        for (const auto window : m_Windows)
+    m_Instance = glal::CreateInstanceOpenGL(
         {
-            const auto color_index = index++ % colors.size();
+            .EnableValidation = false,
+            .ApplicationName = config.Application.Name.c_str(),
+            .PipelineCachePath = nullptr,
+            .Headless = false,
+        });
 
-            if (glfwGetWindowAttrib(window, GLFW_ICONIFIED))
-                continue;
+    glal::PhysicalDevice physical_device;
+    common::Assert(m_Instance->EnumeratePhysicalDevices(&physical_device), "no physical device for the primary window");
 
-            int width, height;
-            glfwGetFramebufferSize(window, &width, &height);
+    m_Device = physical_device->CreateDevice();
 
-            if (!width || !height)
-                continue;
+    // a minimized window has no framebuffer yet, the swapchain is resized before the first frame is drawn
+    int width, height;
+    glfwGetFramebufferSize(m_PrimaryWindow, &width, &height);
 
-            active = true;
+    CreateRenderer();
+    CreateSwapchain(
+        m_PrimaryWindow,
+        { static_cast<uint32_t>(std::max(width, 1)), static_cast<uint32_t>(std::max(height, 1)) });
+}
 
-            glfwMakeContextCurrent(window);
+fxng::Engine::~Engine()
+{
+#ifdef COMMON_PROFILE
 
-            glViewport(0, 0, width, height);
-            glClearColor(
-                colors[color_index].r,
-                colors[color_index].g,
-                colors[color_index].b,
-                colors[color_index].a);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    if (!m_ProfileTrace.empty())
+    {
+        std::ofstream stream(m_ProfileTrace);
+        common::Profiler::Get().WriteChromeTrace(stream);
 
-            Frame();
+        for (auto &zone : common::Profiler::Get().GetStatistics())
+            common::Log(
+                common::LogLevel_Info,
+                "zone {} count={} total={:.3f}ms min={:.3f}ms max={:.3f}ms",
+                zone.Zone->Name,
+                zone.Count,
+                zone.TotalMs,
+                zone.MinMs,
+                zone.MaxMs);
+    }
 
-            glfwSwapBuffers(window);
-        }
+#endif
 
-        if (!active)
-            glfwWaitEvents();
+    if (m_Headless.Enabled)
+    {
+        DestroyRenderer();
+        return;
     }
-}
 
-fxng::Engine::~Engine()
-{
+    glfwMakeContextCurrent(m_PrimaryWindow);
+    DestroyRenderer();
+
     for (const auto window : m_Windows)
         glfwDestroyWindow(window);
 
@@ -192,11 +241,105 @@ fxng::Engine::~Engine()
     glfwSetErrorCallback(nullptr);
 }
 
+void fxng::Engine::Run()
+{
+    m_Exit = false;
+
+    if (m_Headless.Enabled)
+        RunHeadless();
+    else
+        RunWindowed();
+
+    m_FramePacer->WaitIdle();
+
+    if (!m_Profiler)
+        return;
+
+    for (auto &pass : m_Profiler->GetPasses())
+        common::Log(
+            common::LogLevel_Info,
+            "gpu pass {} last={:.3f}ms avg={:.3f}ms max={:.3f}ms fragments={}",
+            pass.Name,
+            pass.LastMs,
+            pass.AverageMs,
+            pass.MaxMs,
+            pass.Statistics.FragmentShaderInvocations);
+}
+
+void fxng::Engine::RequestExit()
+{
+    m_Exit = true;
+}
+
 fxng::Scene &fxng::Engine::GetScene()
 {
     return m_Scene;
 }
 
+glal::Device fxng::Engine::GetDevice() const
+{
+    return m_Device;
+}
+
+const fxng::GpuProfiler *fxng::Engine::GetGpuProfiler() const
+{
+    return m_Profiler.get();
+}
+
+glal::RenderPass fxng::Engine::GetRenderPass() const
+{
+    return m_RenderPass;
+}
+
+const fxng::RenderQueueStatistics &fxng::Engine::GetRenderQueueStatistics() const
+{
+    return m_RenderQueueStatistics;
+}
+
+void fxng::Engine::RegisterMaterial(const std::string &id, const MaterialBinding &material_binding)
+{
+    auto binding = material_binding;
+    if (binding.Permutations)
+        binding.Pipeline = binding.Permutations->Get(GetMaterialFeatures(binding.Uniforms));
+
+    common::Assert(binding.Pipeline, "material {} has no pipeline", id);
+
+    m_PipelineIds.try_emplace(binding.Pipeline, static_cast<uint32_t>(m_PipelineIds.size()));
+
+    // registering a material again keeps its sort key id and uniform slot
+    auto material_id = static_cast<uint32_t>(m_Materials.size());
+    if (const auto it = m_Materials.find(id); it != m_Materials.end())
+        material_id = it->second.Id;
+
+    common::Assert(
+        material_id < m_Renderer.MaxMaterials,
+        "material {} exceeds the limit of {} materials",
+        id,
+        m_Renderer.MaxMaterials);
+
+    const auto ticket = m_Uploads->UploadBuffer(
+        m_MaterialUniforms,
+        material_id * m_MaterialUniformStride,
+        &binding.Uniforms,
+        sizeof(MaterialUniforms));
+
+    m_Materials[id] = {
+        .Binding = binding,
+        .Id = material_id,
+        .Ticket = ticket,
+    };
+}
+
+glal::DescriptorSetLayout fxng::Engine::GetFrameDescriptorSetLayout() const
+{
+    return m_FrameSetLayout;
+}
+
+fxng::TextureHeap *fxng::Engine::GetTextureHeap() const
+{
+    return m_TextureHeap.get();
+}
+
 void fxng::Engine::InitScene()
 {
     m_Scene.OnInit();
@@ -212,8 +355,111 @@ void fxng::Engine::ClearScene()
     m_Scene.Clear();
 }
 
+const fxng::Mesh &fxng::Engine::GetMesh(const std::string &id)
+{
+    if (const auto it = m_Meshes.find(id); it != m_Meshes.end())
+        return it->second;
+
+    const auto index = m_MeshIndices.find(id);
+    common::Assert(index != m_MeshIndices.end(), "mesh {} is not indexed", id);
+
+    auto mesh = LoadMesh(index->second.Source);
+    BuildLods(mesh, index->second.LodCount, index->second.LodRatio, index->second.LodError);
+    BuildMeshlets(mesh);
+
+    common::Log(
+        common::LogLevel_Info,
+        "load mesh id={} vertices={} lods={} meshlets={}",
+        id,
+        mesh.Vertices.size(),
+        mesh.Lods.size(),
+        mesh.Meshlets.size());
+
+    for (auto &lod : mesh.Lods)
+        common::Log(
+            common::LogLevel_Info,
+            "  lod triangles={} meshlets={} error={}",
+            lod.IndexCount / 3,
+            lod.MeshletCount,
+            lod.Error);
+
+    return m_Meshes[id] = std::move(mesh);
+}
+
+std::vector<char> fxng::Engine::GetShaderBinary(const std::string &id) const
+{
+    const auto index = m_ShaderIndices.find(id);
+    common::Assert(index != m_ShaderIndices.end(), "shader {} is not indexed", id);
+
+    std::ifstream stream(index->second.Binary, std::ios::binary | std::ios::ate);
+    common::Assert(stream.is_open(), "failed to open {}, was the shader compiled?", index->second.Binary);
+
+    std::vector<char> code(stream.tellg());
+    stream.seekg(0, std::ios::beg);
+    stream.read(code.data(), static_cast<std::streamsize>(code.size()));
+
+    return code;
+}
+
+std::filesystem::path fxng::Engine::GetTexturePath(const std::string &id) const
+{
+    const auto index = m_TextureIndices.find(id);
+    common::Assert(index != m_TextureIndices.end(), "texture {} is not indexed", id);
+
+    return index->second.Source;
+}
+
+uint32_t fxng::Engine::GetTexture(const std::string &id)
+{
+    if (const auto it = m_TextureHeapIndices.find(id); it != m_TextureHeapIndices.end())
+        return it->second;
+
+    common::Assert(m_TextureStreamer != nullptr, "texture {} can only be streamed with a texture heap", id);
+
+    const auto handle = m_TextureStreamer->Register(GetTexturePath(id));
+    const auto heap_index = m_TextureHeap->Allocate(nullptr, nullptr);
+
+    m_StreamedTextures[heap_index] = {
+        .Handle = handle,
+        .View = nullptr,
+    };
+
+    return m_TextureHeapIndices[id] = heap_index;
+}
+
+const fxng::MeshGeometry &fxng::Engine::GetMeshGeometry(const std::string &id)
+{
+    if (const auto it = m_MeshGeometry.find(id); it != m_MeshGeometry.end())
+        return it->second;
+
+    auto &mesh = GetMesh(id);
+
+    const auto geometry = m_GeometryPool->Allocate(
+        mesh.Vertices.data(),
+        static_cast<uint32_t>(mesh.Vertices.size()),
+        mesh.Indices.data(),
+        static_cast<uint32_t>(mesh.Indices.size()));
+
+    const auto mesh_id = static_cast<uint32_t>(m_MeshGeometry.size());
+
+    MeshletBuffers meshlets{};
+    if (m_MeshletCuller && !mesh.Meshlets.empty())
+    {
+        const auto &range = m_GeometryPool->GetRange(geometry);
+        meshlets = m_MeshletCuller->CreateBuffers(mesh, range.VertexOffset, range.FirstIndex);
+    }
+
+    return m_MeshGeometry[id] = {
+               .Geometry = geometry,
+               .Id = mesh_id,
+               .Meshlets = meshlets,
+           };
+}
+
 void fxng::Engine::IndexAssets()
 {
+    COMMON_PROFILE_ZONE("Engine::IndexAssets");
+
 #ifdef FXNG_PACKAGE
 
     Fatal("TODO");
@@ -257,6 +503,18 @@ void fxng::Engine::IndexYaml(std::filesystem::path path)
 
         common::Log(common::LogLevel_Info, "index shader id={} name={} source={}", id, name, source);
 
+        // the build compiles every shader source to <name>.spv, see fxng_add_shaders
+        auto binary = std::filesystem::path(FXNG_SHADER_BINARY_DIR) / std::filesystem::path(source).stem();
+        binary += ".spv";
+
+        auto &index = m_ShaderIndices[id];
+        index = {
+            .Id = id,
+            .Name = name,
+            .Source = (path.parent_path() / source).string(),
+            .Binary = binary.string(),
+        };
+
         for (auto node : root["input"])
         {
             auto input_name = node["name"].as<std::string>();
@@ -269,6 +527,8 @@ void fxng::Engine::IndexYaml(std::filesystem::path path)
                 input_name,
                 input_type,
                 input_reference);
+
+            index.Input.push_back({ input_name, input_type, input_reference });
         }
 
         for (auto node : root["output"])
@@ -283,6 +543,8 @@ void fxng::Engine::IndexYaml(std::filesystem::path path)
                 output_name,
                 output_type,
                 output_reference);
+
+            index.Output.push_back({ output_name, output_type, output_reference });
         }
 
         for (auto node : root["uniform"])
@@ -297,6 +559,8 @@ void fxng::Engine::IndexYaml(std::filesystem::path path)
                 uniform_name,
                 uniform_type,
                 uniform_reference);
+
+            index.Uniform.push_back({ uniform_name, uniform_type, uniform_reference });
         }
 
         return;
@@ -326,6 +590,39 @@ void fxng::Engine::IndexYaml(std::filesystem::path path)
 
         common::Log(common::LogLevel_Info, "index mesh id={} name={} source={}", id, name, source);
 
+        MeshIndex index
+        {
+            .Id = id,
+            .Name = name,
+            .Source = (path.parent_path() / source).string(),
+        };
+
+        if (auto lod = root["lod"])
+        {
+            index.LodCount = lod["count"].as<uint32_t>(index.LodCount);
+            index.LodRatio = lod["ratio"].as<float>(index.LodRatio);
+            index.LodError = lod["error"].as<float>(index.LodError);
+        }
+
+        m_MeshIndices[id] = std::move(index);
+
+        return;
+    }
+
+    if (type == "texture")
+    {
+        auto id = root["id"].as<std::string>();
+        auto name = root["name"].as<std::string>();
+        auto source = root["source"].as<std::string>();
+
+        common::Log(common::LogLevel_Info, "index texture id={} name={} source={}", id, name, source);
+
+        m_TextureIndices[id] = {
+            .Id = id,
+            .Name = name,
+            .Source = (path.parent_path() / source).string(),
+        };
+
         return;
     }
 
@@ -357,9 +654,828 @@ void fxng::Engine::IndexYaml(std::filesystem::path path)
     common::Log(common::LogLevel_Error, "invalid yaml file type {}", type);
 }
 
-void fxng::Engine::Frame()
+void fxng::Engine::Frame(const uint32_t width, const uint32_t height)
 {
+    COMMON_PROFILE_ZONE("Engine::Frame");
+
+    (void) width;
+
     m_Scene.PreFrame();
+    SelectLods(height);
     m_Scene.OnFrame();
     m_Scene.PostFrame();
 }
+
+void fxng::Engine::SelectLods(const uint32_t height)
+{
+    const Camera *camera = nullptr;
+    const Transform *camera_transform = nullptr;
+
+    if (!find_camera(m_Scene, camera, camera_transform) || !height)
+        return;
+
+    const auto camera_position = glm::vec3(camera_transform->GetMatrix()[3]);
+
+    // object-space error of one unit at distance one covers this many pixels
+    const auto pixels_per_unit = static_cast<float>(height) * 0.5f / std::tan(camera->GetFieldOfView() * 0.5f);
+
+    for (auto &entity : m_Scene)
+    {
+        const auto model = entity.Get<Model>();
+        if (!model || model->GetMesh().empty())
+            continue;
+
+        const auto transform = entity.Get<Transform>();
+
+        auto &mesh = GetMesh(model->GetMesh());
+
+        auto matrix = glm::mat4(1.f);
+        if (transform)
+            matrix = transform->GetMatrix();
+
+        const auto scale = std::max(
+            glm::length(glm::vec3(matrix[0])),
+            std::max(glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))));
+
+        const auto center = glm::vec3(matrix * glm::vec4(mesh.Center, 1.f));
+        const auto distance = std::max(
+            glm::length(center - camera_position) - mesh.Radius * scale,
+            camera->GetNear());
+
+        const auto projected_error = [&](const std::uint32_t lod)
+        {
+            return mesh.Lods[lod].Error * scale / distance * pixels_per_unit;
+        };
+
+        // coarsest level whose error stays below the threshold, levels are ordered by increasing error
+        const auto current = std::min(model->GetLod(), static_cast<std::uint32_t>(mesh.Lods.size() - 1));
+
+        auto target = current;
+        while (target > 0 && projected_error(target) > m_LodErrorThreshold)
+            --target;
+
+        // only step down to coarser levels once they are comfortably below the threshold
+        if (target == current)
+            while (target + 1 < mesh.Lods.size()
+                   && projected_error(target + 1) <= m_LodErrorThreshold * (1.f - m_LodHysteresis))
+                ++target;
+
+        model->SetLod(target);
+    }
+}
+
+void fxng::Engine::QueueModels(
+    const uint32_t frame_index,
+    const uint32_t frame_uniforms,
+    const uint32_t width,
+    const uint32_t height)
+{
+    COMMON_PROFILE_ZONE("Engine::QueueModels");
+
+    m_RenderQueue->Clear();
+    m_Batches.clear();
+    m_BatchIndices.clear();
+    m_Instances.clear();
+
+    const Camera *camera = nullptr;
+    const Transform *camera_transform = nullptr;
+
+    if (!find_camera(m_Scene, camera, camera_transform) || !width || !height)
+        return;
+
+    const auto &view = camera_transform->GetInverse();
+    const auto projection = camera->GetProjection(static_cast<float>(width) / static_cast<float>(height));
+    const auto frustum = Frustum::FromMatrix(projection * view);
+
+    m_ClusteredLights->Clear();
+    for (auto &entity : m_Scene)
+    {
+        const auto light = entity.Get<Light>();
+        if (!light)
+            continue;
+
+        auto matrix = glm::mat4(1.f);
+        if (const auto transform = entity.Get<Transform>())
+            matrix = transform->GetMatrix();
+
+        m_ClusteredLights->Add(
+            {
+                .Position = glm::vec3(matrix[3]),
+                .Range = light->GetRange(),
+                .Direction = -glm::normalize(glm::vec3(matrix[2])),
+                .Type = static_cast<std::uint32_t>(light->GetType()),
+                .Diffuse = light->GetDiffuse(),
+                .LinearFalloff = light->GetLinearFalloff(),
+                .Specular = light->GetSpecular(),
+                .QuadraticFalloff = light->GetQuadraticFalloff(),
+            });
+    }
+
+    const auto clusters = m_ClusteredLights->Build(
+        view,
+        projection,
+        camera->GetNear(),
+        camera->GetFar(),
+        width,
+        height);
+    m_ClusteredLights->Upload(frame_index, m_FrameSets[frame_index]);
+
+    const auto camera_position = glm::vec3(camera_transform->GetMatrix()[3]);
+
+    // a unit at distance one covers this many pixels, streamed textures are requested at the projected diameter
+    const auto pixels_per_unit = static_cast<float>(height) * 0.5f / std::tan(camera->GetFieldOfView() * 0.5f);
+
+    const auto view_uniforms = m_UniformArena->Write(
+        ViewUniforms
+        {
+            .View = view,
+            .Projection = projection,
+            .ViewProjection = projection * view,
+            .Position = camera_transform->GetMatrix()[3],
+            .Clusters = clusters,
+        });
+
+    for (auto &entity : m_Scene)
+    {
+        const auto model = entity.Get<Model>();
+        if (!model || model->GetMesh().empty())
+            continue;
+
+        const auto material = m_Materials.find(model->GetMaterial());
+        if (material == m_Materials.end() || !m_Uploads->IsComplete(material->second.Ticket))
+            continue;
+
+        const auto transform = entity.Get<Transform>();
+
+        auto &mesh = GetMesh(model->GetMesh());
+
+        auto matrix = glm::mat4(1.f);
+        auto inverse = glm::mat4(1.f);
+        if (transform)
+        {
+            matrix = transform->GetMatrix();
+            inverse = transform->GetInverse();
+        }
+
+        const auto scale = std::max(
+            glm::length(glm::vec3(matrix[0])),
+            std::max(glm::length(glm::vec3(matrix[1])), glm::length(glm::vec3(matrix[2]))));
+
+        const auto center = glm::vec3(matrix * glm::vec4(mesh.Center, 1.f));
+        if (!frustum.Intersects(center, mesh.Radius * scale))
+            continue;
+
+        // drawn once the upload completed, the queue is flushed at the end of every frame or earlier once the upload
+        // ring is full
+        auto &mesh_geometry = GetMeshGeometry(model->GetMesh());
+        if (!m_GeometryPool->IsResident(mesh_geometry.Geometry))
+            continue;
+
+        const auto &binding = material->second.Binding;
+        const auto material_id = material->second.Id;
+
+        if (const auto it = m_StreamedTextures.find(binding.Uniforms.DiffuseTexture); it != m_StreamedTextures.end())
+        {
+            const auto distance = std::max(
+                glm::length(center - camera_position) - mesh.Radius * scale,
+                camera->GetNear());
+            m_TextureStreamer->Request(it->second.Handle, 2.f * mesh.Radius * scale / distance * pixels_per_unit);
+        }
+
+        const auto lod = std::min(model->GetLod(), static_cast<uint32_t>(mesh.Lods.size() - 1));
+
+        // the camera looks down negative z in view space
+        const auto depth = DrawKey::QuantizeDepth(
+            -(view * glm::vec4(center, 1.f)).z,
+            camera->GetNear(),
+            camera->GetFar());
+
+        // translucent models have to be sorted one by one, only opaque ones are merged
+        auto batch_index = static_cast<uint32_t>(m_Batches.size());
+        auto inserted = true;
+        if (!binding.Translucent)
+        {
+            const auto batch_key = static_cast<uint64_t>(material_id) << 48
+                                   | static_cast<uint64_t>(mesh_geometry.Id) << 16
+                                   | lod;
+            const auto [it, emplaced] = m_BatchIndices.try_emplace(batch_key, batch_index);
+            batch_index = it->second;
+            inserted = emplaced;
+        }
+
+        if (inserted)
+            m_Batches.push_back(
+                {
+                    .Binding = &binding,
+                    .PipelineId = m_PipelineIds.at(binding.Pipeline),
+                    .MaterialId = material_id,
+                    .Geometry = mesh_geometry.Geometry,
+                    .MeshId = mesh_geometry.Id,
+                    .Lod = &mesh.Lods[lod],
+                    .Meshlets = &mesh_geometry.Meshlets,
+                    .World = matrix,
+                    .Depth = depth,
+                    .FirstInstance = 0,
+                    .InstanceCount = 0,
+                });
+
+        auto &batch = m_Batches[batch_index];
+        batch.Depth = std::min(batch.Depth, depth);
+        ++batch.InstanceCount;
+
+        m_Instances.push_back(
+            {
+                .Batch = batch_index,
+                .Data = {
+                    .World = matrix,
+                    .Normal = glm::transpose(inverse),
+                },
+            });
+    }
+
+    if (m_Instances.empty())
+        return;
+
+    // the gpu finished with the buffer of this slot when the frame began
+    auto &instance_buffer = m_InstanceBuffers[frame_index];
+    if (!instance_buffer || instance_buffer->GetSize() < m_Instances.size() * sizeof(InstanceData))
+    {
+        if (instance_buffer)
+            m_Device->DestroyBuffer(instance_buffer);
+
+        instance_buffer = m_Device->CreateBuffer(
+            {
+                .Size = std::bit_ceil(m_Instances.size()) * sizeof(InstanceData),
+                .Usage = glal::BufferUsage_Vertex,
+                .Memory = glal::MemoryUsage_HostToDevice,
+            });
+    }
+
+    uint32_t first_instance = 0;
+    for (auto &batch : m_Batches)
+    {
+        batch.FirstInstance = first_instance;
+        first_instance += batch.InstanceCount;
+
+        // counts up again while the instances are scattered
+        batch.InstanceCount = 0;
+    }
+
+    const auto instance_data = static_cast<InstanceData *>(instance_buffer->Map());
+    for (auto &[batch_index, data] : m_Instances)
+    {
+        auto &batch = m_Batches[batch_index];
+        instance_data[batch.FirstInstance + batch.InstanceCount++] = data;
+    }
+    instance_buffer->Unmap();
+
+    for (auto &batch : m_Batches)
+    {
+        const auto make_key = batch.Binding->Translucent ? &DrawKey::Translucent : &DrawKey::Opaque;
+        const auto key = make_key(0, batch.PipelineId, batch.MaterialId, batch.MeshId, batch.Depth);
+
+        // meshes sharing a block of the pool need no buffer rebinds in between
+        const auto &range = m_GeometryPool->GetRange(batch.Geometry);
+
+        // texture indices come with the material uniforms, so the heap never has to be rebound between draws
+        std::array<glal::DescriptorSet, MaxDrawDescriptorSets> descriptor_sets{ m_FrameSets[frame_index] };
+        auto descriptor_set_count = 1u;
+        if (m_TextureHeap)
+            descriptor_sets[descriptor_set_count++] = m_TextureHeap->GetDescriptorSet(frame_index);
+        if (batch.Binding->DescriptorSet)
+            descriptor_sets[descriptor_set_count++] = batch.Binding->DescriptorSet;
+
+        // instanced batches share one draw for all of their instances, only single models are culled per meshlet
+        glal::Buffer indirect_buffer = nullptr;
+        if (m_MeshletCuller && batch.InstanceCount == 1 && batch.Meshlets->Meshlets && batch.Lod->MeshletCount)
+            indirect_buffer = m_MeshletCuller->Cull(
+                *batch.Meshlets,
+                *batch.Lod,
+                batch.World,
+                frustum,
+                camera_position,
+                batch.FirstInstance);
+
+        m_RenderQueue->Submit(
+            key,
+            {
+                .Pipeline = batch.Binding->Pipeline,
+                .DescriptorSets = descriptor_sets,
+                .DescriptorSetCount = descriptor_set_count,
+                .DynamicOffsets = {
+                    frame_uniforms,
+                    view_uniforms,
+                    static_cast<uint32_t>(batch.MaterialId * m_MaterialUniformStride),
+                },
+                .DynamicOffsetCount = FrameDynamicOffsetCount,
+                .VertexBuffer = m_GeometryPool->GetVertexBuffer(range.Block),
+                .IndexBuffer = m_GeometryPool->GetIndexBuffer(range.Block),
+                .IndexType = glal::DataType_UInt32,
+                .Count = batch.Lod->IndexCount,
+                .First = range.FirstIndex + batch.Lod->IndexOffset,
+                .VertexOffset = range.VertexOffset,
+                .InstanceBuffer = instance_buffer,
+                .InstanceCount = batch.InstanceCount,
+                .FirstInstance = batch.FirstInstance,
+                .IndirectBuffer = indirect_buffer,
+                .IndirectCount = indirect_buffer ? batch.Lod->MeshletCount : 0,
+            });
+    }
+
+    m_RenderQueue->Sort();
+}
+
+void fxng::Engine::CreateHeadless(const ApplicationConfig &application)
+{
+    const glal::InstanceDesc instance_desc
+    {
+        .EnableValidation = false,
+        .ApplicationName = application.Name.c_str(),
+        .PipelineCachePath = nullptr,
+        .Headless = true,
+    };
+
+    switch (m_Headless.Backend)
+    {
+    case EngineBackend_OpenGL:
+        m_Instance = glal::CreateInstanceOpenGL(instance_desc);
+        break;
+    case EngineBackend_Vulkan:
+        m_Instance = glal::CreateInstanceVulkan(instance_desc);
+        break;
+    case EngineBackend_Null:
+        m_Instance = glal::CreateInstanceNull(instance_desc);
+        break;
+    }
+
+    glal::PhysicalDevice physical_device;
+    common::Assert(m_Instance->EnumeratePhysicalDevices(&physical_device), "no physical device for headless rendering");
+
+    m_Device = physical_device->CreateDevice();
+
+    CreateRenderer();
+    CreateSwapchain(nullptr, { m_Headless.Width, m_Headless.Height });
+
+    if (m_Headless.Capture)
+        m_Readback = std::make_unique<ReadbackManager>(
+            m_Device,
+            ReadbackManagerConfig
+            {
+                .MaxReadbacks = m_FramesInFlight + 1,
+            });
+}
+
+void fxng::Engine::CreateRenderer()
+{
+    const FramePacerConfig frame_pacer_config;
+    m_FramePacer = std::make_unique<FramePacer>(m_Device, frame_pacer_config);
+    m_FramesInFlight = frame_pacer_config.FramesInFlight;
+
+    const glal::Attachment color_attachment
+    {
+        .Type = glal::AttachmentType_Color,
+
+        .Clear = true,
+        .Mask = glal::ClearValueMask_Color_Float,
+        .Value = { .Color = { colors[0].r, colors[0].g, colors[0].b, colors[0].a } },
+    };
+
+    m_RenderPass = m_Device->CreateRenderPass(
+        {
+            .Attachments = &color_attachment,
+            .AttachmentCount = 1,
+        });
+
+    for (std::uint32_t i = 0; i < frame_pacer_config.FramesInFlight; ++i)
+        m_CommandBuffers.push_back(
+            m_Device->CreateCommandBuffer(glal::CommandBufferUsage_Reusable, glal::QueueType_Graphics));
+
+    if (m_Renderer.Profile && m_Device->Supports(glal::DeviceFeature_TimestampQuery))
+        m_Profiler = std::make_unique<GpuProfiler>(
+            m_Device,
+            GpuProfilerConfig
+            {
+                .FrameLatency = frame_pacer_config.FramesInFlight + 1,
+                .PipelineStatistics = true,
+            });
+
+    m_Uploads = std::make_unique<UploadManager>(m_Device, UploadManagerConfig{});
+    m_GeometryPool = std::make_unique<GeometryPool>(
+        m_Device,
+        *m_Uploads,
+        GeometryPoolConfig
+        {
+            .FramesInFlight = frame_pacer_config.FramesInFlight,
+        });
+
+    m_RenderQueue = std::make_unique<RenderQueue>(m_Renderer.RenderQueue);
+    m_InstanceBuffers.resize(frame_pacer_config.FramesInFlight);
+
+    m_UniformArena = std::make_unique<UniformArena>(
+        m_Device,
+        UniformArenaConfig
+        {
+            .Size = m_Renderer.UniformArenaSize,
+            .FramesInFlight = frame_pacer_config.FramesInFlight,
+        });
+
+    // every material block starts at an offset the device can bind dynamically
+    const auto alignment = m_UniformArena->GetAlignment();
+    m_MaterialUniformStride = (sizeof(MaterialUniforms) + alignment - 1) / alignment * alignment;
+    m_MaterialUniforms = m_Device->CreateBuffer(
+        {
+            .Size = m_MaterialUniformStride * m_Renderer.MaxMaterials,
+            .Usage = glal::BufferUsage_Uniform,
+            .Memory = glal::MemoryUsage_DeviceLocal,
+        });
+
+    constexpr auto stages = static_cast<glal::ShaderStage>(glal::ShaderStage_Vertex | glal::ShaderStage_Fragment);
+    const std::array descriptor_bindings
+    {
+        glal::DescriptorBinding
+        {
+            .Binding = FrameUniformBinding,
+            .Type = glal::DescriptorType_UniformBufferDynamic,
+            .Count = 1,
+            .Stages = stages,
+        },
+        glal::DescriptorBinding
+        {
+            .Binding = ViewUniformBinding,
+            .Type = glal::DescriptorType_UniformBufferDynamic,
+            .Count = 1,
+            .Stages = stages,
+        },
+        glal::DescriptorBinding
+        {
+            .Binding = MaterialUniformBinding,
+            .Type = glal::DescriptorType_UniformBufferDynamic,
+            .Count = 1,
+            .Stages = stages,
+        },
+        glal::DescriptorBinding
+        {
+            .Binding = LightBufferBinding,
+            .Type = glal::DescriptorType_StorageBuffer,
+            .Count = 1,
+            .Stages = glal::ShaderStage_Fragment,
+        },
+        glal::DescriptorBinding
+        {
+            .Binding = LightClusterBufferBinding,
+            .Type = glal::DescriptorType_StorageBuffer,
+            .Count = 1,
+            .Stages = glal::ShaderStage_Fragment,
+        },
+        glal::DescriptorBinding
+        {
+            .Binding = LightIndexBufferBinding,
+            .Type = glal::DescriptorType_StorageBuffer,
+            .Count = 1,
+            .Stages = glal::ShaderStage_Fragment,
+        },
+    };
+
+    m_FrameSetLayout = m_Device->CreateDescriptorSetLayout(
+        {
+            .Set = 0,
+            .DescriptorBindings = descriptor_bindings.data(),
+            .DescriptorBindingCount = descriptor_bindings.size(),
+        });
+
+    // the uniform bindings never change, the dynamic offsets select the blocks of a draw. the light buffers are bound
+    // by the clusterer before the first draw of a frame
+    for (std::uint32_t i = 0; i < frame_pacer_config.FramesInFlight; ++i)
+    {
+        const auto frame_set = m_Device->CreateDescriptorSet({ .Layout = m_FrameSetLayout });
+        frame_set->BindBuffer(FrameUniformBinding, m_UniformArena->GetBuffer(i), 0, sizeof(FrameUniforms));
+        frame_set->BindBuffer(ViewUniformBinding, m_UniformArena->GetBuffer(i), 0, sizeof(ViewUniforms));
+        frame_set->BindBuffer(MaterialUniformBinding, m_MaterialUniforms, 0, sizeof(MaterialUniforms));
+        m_FrameSets.push_back(frame_set);
+    }
+
+    m_ClusteredLights = std::make_unique<ClusteredLights>(
+        m_Device,
+        ClusteredLightsConfig
+        {
+            .FramesInFlight = frame_pacer_config.FramesInFlight,
+        });
+
+    if (m_Renderer.MeshletCulling)
+    {
+        const auto code = GetShaderBinary("fxng:meshlet_cull.compute");
+        m_MeshletCullShader = m_Device->CreateShaderModule(
+            {
+                .Stage = glal::ShaderStage_Compute,
+                .Code = code.data(),
+                .Size = code.size(),
+            });
+
+        m_MeshletCuller = std::make_unique<MeshletCuller>(
+            m_Device,
+            m_MeshletCullShader,
+            MeshletCullerConfig
+            {
+                .FramesInFlight = frame_pacer_config.FramesInFlight,
+            });
+    }
+
+    // spir-v for opengl cannot read bindless handles, so the default shaders could never sample a heap there
+    const auto opengl = !m_Headless.Enabled || m_Headless.Backend == EngineBackend_OpenGL;
+    if (!opengl && m_Device->Supports(glal::DeviceFeature_BindlessTextures))
+    {
+        m_TextureHeap = std::make_unique<TextureHeap>(
+            m_Device,
+            *m_Uploads,
+            TextureHeapConfig
+            {
+                .Capacity = std::min(m_Renderer.MaxTextures, m_Device->GetLimits().MaxBindlessTextures),
+                .FramesInFlight = frame_pacer_config.FramesInFlight,
+            });
+
+        // streamed textures are only reachable through the heap
+        m_TextureStreamer = std::make_unique<TextureStreamer>(
+            m_Device,
+            *m_Uploads,
+            TextureStreamerConfig
+            {
+                .FramesInFlight = frame_pacer_config.FramesInFlight,
+            });
+        m_TextureSampler = m_Device->CreateSampler(
+            {
+                .MinFilter = glal::Filter_Linear,
+                .MagFilter = glal::Filter_Linear,
+                .AddressU = glal::AddressMode_Repeat,
+                .AddressV = glal::AddressMode_Repeat,
+                .AddressW = glal::AddressMode_Repeat,
+            });
+    }
+}
+
+void fxng::Engine::DestroyRenderer()
+{
+    m_Readback.reset();
+    m_Profiler.reset();
+    m_RenderQueue.reset();
+
+    m_FramePacer->WaitIdle();
+    m_FramePacer.reset();
+
+    for (const auto instance_buffer : m_InstanceBuffers)
+        if (instance_buffer)
+            m_Device->DestroyBuffer(instance_buffer);
+    m_InstanceBuffers.clear();
+
+    for (const auto frame_set : m_FrameSets)
+        m_Device->DestroyDescriptorSet(frame_set);
+    m_FrameSets.clear();
+    m_Device->DestroyDescriptorSetLayout(m_FrameSetLayout);
+    m_UniformArena.reset();
+    m_TextureHeap.reset();
+    m_TextureStreamer.reset();
+    if (m_TextureSampler)
+        m_Device->DestroySampler(m_TextureSampler);
+    m_TextureHeapIndices.clear();
+    m_StreamedTextures.clear();
+    m_ClusteredLights.reset();
+
+    if (m_MeshletCuller)
+        for (auto &[id, mesh_geometry] : m_MeshGeometry)
+            if (mesh_geometry.Meshlets.Meshlets)
+                m_MeshletCuller->DestroyBuffers(mesh_geometry.Meshlets);
+    m_MeshletCuller.reset();
+    if (m_MeshletCullShader)
+        m_Device->DestroyShaderModule(m_MeshletCullShader);
+
+    // the pool waits for its uploads, so it goes before the upload manager
+    m_GeometryPool.reset();
+    m_Uploads.reset();
+    m_MeshGeometry.clear();
+
+    // material uploads may still have been pending until the upload manager finished
+    m_Device->DestroyBuffer(m_MaterialUniforms);
+
+    for (const auto command_buffer : m_CommandBuffers)
+        m_Device->DestroyCommandBuffer(command_buffer);
+
+    DestroySwapchain();
+    m_Device->DestroyRenderPass(m_RenderPass);
+
+    m_Device->GetPhysicalDevice()->DestroyDevice(m_Device);
+    glal::DestroyInstance(m_Instance);
+}
+
+void fxng::Engine::CreateSwapchain(void *native_window_handle, const glal::Extent2D extent)
+{
+    // one more image than frames in flight, so the newest finished frame can be read back while the next ones render
+    m_Swapchain = m_Device->CreateSwapchain(
+        {
+            .NativeWindowHandle = native_window_handle,
+            .Extent = extent,
+            .Format = glal::ImageFormat_RGBA8_UNorm,
+            .ImageCount = m_FramesInFlight + 1,
+        });
+
+    for (std::uint32_t i = 0; i < m_Swapchain->GetImageCount(); ++i)
+    {
+        const auto image_view = m_Swapchain->GetImageView(i);
+        m_Framebuffers.push_back(
+            m_Device->CreateFramebuffer(
+                {
+                    .Attachments = &image_view,
+                    .AttachmentCount = 1,
+                    .Pass = m_RenderPass,
+                }));
+    }
+}
+
+void fxng::Engine::DestroySwapchain()
+{
+    for (const auto framebuffer : m_Framebuffers)
+        m_Device->DestroyFramebuffer(framebuffer);
+    m_Framebuffers.clear();
+
+    m_Device->DestroySwapchain(m_Swapchain);
+    m_Swapchain = nullptr;
+}
+
+void fxng::Engine::RunWindowed()
+{
+    const auto present_queue = m_Device->GetQueue(glal::QueueType_Present);
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t frame = 0; !m_Exit && !glfwWindowShouldClose(m_PrimaryWindow);)
+    {
+        glfwPollEvents();
+
+        auto index = 0u;
+        auto active = false;
+
+        for (const auto window : m_Windows)
+        {
+            const auto color_index = index++ % colors.size();
+
+            if (glfwGetWindowAttrib(window, GLFW_ICONIFIED))
+                continue;
+
+            int width, height;
+            glfwGetFramebufferSize(window, &width, &height);
+
+            if (!width || !height)
+                continue;
+
+            active = true;
+
+            glfwMakeContextCurrent(window);
+
+            if (window != m_PrimaryWindow)
+            {
+                glViewport(0, 0, width, height);
+                glClearColor(
+                    colors[color_index].r,
+                    colors[color_index].g,
+                    colors[color_index].b,
+                    colors[color_index].a);
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                glfwSwapBuffers(window);
+                continue;
+            }
+
+            // the swapchain images have the size of the window, they are recreated once no frame uses them anymore
+            const glal::Extent2D extent{ static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+            if (const auto current = m_Swapchain->GetExtent();
+                current.Width != extent.Width || current.Height != extent.Height)
+            {
+                m_FramePacer->WaitIdle();
+                DestroySwapchain();
+                CreateSwapchain(m_PrimaryWindow, extent);
+            }
+
+            RenderFrame(
+                frame++,
+                std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count(),
+                present_queue);
+        }
+
+        if (!active)
+            glfwWaitEvents();
+    }
+}
+
+void fxng::Engine::RunHeadless()
+{
+    // there is no present queue without a window system, the offscreen swapchain completes on the graphics queue
+    const auto graphics_queue = m_Device->GetQueue(glal::QueueType_Graphics);
+    const auto extent = m_Swapchain->GetExtent();
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t frame = 0; !m_Exit && (!m_Headless.FrameCount || frame < m_Headless.FrameCount); ++frame)
+    {
+        const auto image = RenderFrame(
+            frame,
+            std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count(),
+            graphics_queue);
+
+        if (!m_Readback)
+            continue;
+
+        m_Readback->ReadImage(
+            image,
+            0,
+            [this, extent, frame_number = m_FramePacer->GetFrame()](const void *data, std::size_t)
+            {
+                m_Headless.Capture(frame_number, extent.Width, extent.Height, data);
+            });
+        m_Readback->Poll();
+    }
+
+    if (m_Readback)
+        m_Readback->Flush();
+}
+
+glal::Image fxng::Engine::RenderFrame(const uint32_t frame, const float time, glal::Queue queue)
+{
+    const auto extent = m_Swapchain->GetExtent();
+
+    const auto frame_index = m_FramePacer->BeginFrame();
+    const auto command_buffer = m_CommandBuffers[frame_index];
+
+    Frame(extent.Width, extent.Height);
+
+    // the gpu finished with the arena slot and the texture heap set when the frame began
+    m_UniformArena->Begin(frame_index);
+    if (m_TextureHeap)
+        m_TextureHeap->BeginFrame(frame_index);
+    if (m_MeshletCuller)
+        m_MeshletCuller->BeginFrame(frame_index);
+
+    const auto frame_uniforms = m_UniformArena->Write(
+        FrameUniforms
+        {
+            .Resolution = { static_cast<float>(extent.Width), static_cast<float>(extent.Height) },
+            .Time = time,
+            .Frame = frame,
+        });
+
+    // transforms are final once the scene finished the frame
+    QueueModels(frame_index, frame_uniforms, extent.Width, extent.Height);
+
+    m_UniformArena->End();
+
+    // requests of this frame are in, swapped in images reach the heap sets as their frames begin
+    if (m_TextureStreamer)
+    {
+        m_TextureStreamer->Update();
+        for (auto &[heap_index, texture] : m_StreamedTextures)
+            if (const auto view = m_TextureStreamer->GetImageView(texture.Handle); view != texture.View)
+            {
+                m_TextureHeap->Update(heap_index, view, m_TextureSampler);
+                texture.View = view;
+            }
+    }
+
+    m_GeometryPool->Update();
+    m_Uploads->Flush();
+
+    const auto image_index = m_FramePacer->AcquireImage(m_Swapchain);
+    const auto image = m_Swapchain->GetImageView(image_index)->GetImage();
+
+    command_buffer->Begin();
+    if (m_Profiler)
+    {
+        m_Profiler->BeginFrame(command_buffer);
+        m_Profiler->BeginPass(command_buffer, "main");
+    }
+
+    // culling dispatches cannot be recorded within the render pass that draws their results
+    if (m_MeshletCuller)
+        m_MeshletCuller->Record(command_buffer);
+
+    command_buffer->Transition(image, glal::ResourceState_RenderTarget);
+
+    command_buffer->BeginRenderPass(m_RenderPass, m_Framebuffers[image_index]);
+    command_buffer->SetViewport(
+        0.f,
+        0.f,
+        static_cast<float>(extent.Width),
+        static_cast<float>(extent.Height),
+        0.f,
+        1.f);
+    command_buffer->SetScissor(0, 0, extent.Width, extent.Height);
+    m_RenderQueueStatistics = m_RenderQueue->Execute(command_buffer, 0);
+    command_buffer->EndRenderPass();
+
+    if (m_Profiler)
+        m_Profiler->EndPass(command_buffer);
+
+    // finished frames are left ready to be copied out
+    command_buffer->Transition(image, glal::ResourceState_CopySrc);
+    command_buffer->End();
+
+    m_FramePacer->Submit(queue, &command_buffer, 1);
+    m_FramePacer->Present(queue, m_Swapchain);
+
+    COMMON_PROFILE_DRAIN();
+
+    return image;
+}
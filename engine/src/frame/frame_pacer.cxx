@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <common/log.hxx>
+#include <fxng/frame.hxx>
+
+fxng::FramePacer::FramePacer(glal::Device device, const FramePacerConfig &config)
+    : m_Device(device),
+      m_Config(config),
+      m_Timeline(),
+      m_Frame(0),
+      m_SubmittedFrame(0),
+      m_CompletedFrame(0)
+{
+    common::Assert(m_Config.FramesInFlight, "at least one frame has to be in flight");
+
+    if (m_Device->Supports(glal::DeviceFeature_TimelineSemaphore))
+        m_Timeline = m_Device->CreateSemaphore(
+            {
+                .Type = glal::SemaphoreType_Timeline,
+                .InitialValue = 0,
+            });
+
+    for (std::uint32_t i = 0; i < m_Config.FramesInFlight; ++i)
+        m_Slots.push_back(
+            {
+                .SubmittedFrame = 0,
+                .ImageAcquired = m_Device->CreateSemaphore({ .Type = glal::SemaphoreType_Binary }),
+                .RenderFinished = m_Device->CreateSemaphore({ .Type = glal::SemaphoreType_Binary }),
+                .Acquired = false,
+                .Fence = m_Timeline ? nullptr : m_Device->CreateFence(),
+            });
+}
+
+fxng::FramePacer::~FramePacer()
+{
+    WaitIdle();
+
+    for (auto &slot : m_Slots)
+    {
+        m_Device->DestroySemaphore(slot.ImageAcquired);
+        m_Device->DestroySemaphore(slot.RenderFinished);
+        if (slot.Fence)
+            m_Device->DestroyFence(slot.Fence);
+    }
+
+    if (m_Timeline)
+        m_Device->DestroySemaphore(m_Timeline);
+}
+
+std::uint32_t fxng::FramePacer::BeginFrame()
+{
+    ++m_Frame;
+
+    // the slot is free once the frame that used it before completed, low latency waits for the previous frame
+    const std::uint64_t ahead = m_Config.LowLatency ? 1 : m_Config.FramesInFlight;
+    if (m_Frame > ahead)
+        WaitForFrame(m_Frame - ahead);
+
+    return GetFrameIndex();
+}
+
+std::uint32_t fxng::FramePacer::AcquireImage(glal::Swapchain swapchain)
+{
+    auto &slot = m_Slots[GetFrameIndex()];
+    common::Assert(!slot.Acquired, "frame {} already acquired an image", m_Frame);
+
+    slot.Acquired = true;
+    return swapchain->AcquireNextImage(slot.ImageAcquired, nullptr);
+}
+
+void fxng::FramePacer::Submit(
+    glal::Queue queue,
+    const glal::CommandBuffer *command_buffers,
+    const std::uint32_t command_buffer_count)
+{
+    auto &slot = m_Slots[GetFrameIndex()];
+    common::Assert(slot.SubmittedFrame != m_Frame, "frame {} was already submitted", m_Frame);
+
+    std::vector<glal::SemaphoreValue> wait_semaphores;
+    std::vector<glal::SemaphoreValue> signal_semaphores;
+
+    // binary semaphores have to be waited on exactly once, so the present semaphore is only signaled with an image
+    if (slot.Acquired)
+    {
+        wait_semaphores.push_back({ .Target = slot.ImageAcquired, .Value = 0 });
+        signal_semaphores.push_back({ .Target = slot.RenderFinished, .Value = 0 });
+    }
+    if (m_Timeline)
+        signal_semaphores.push_back({ .Target = m_Timeline, .Value = m_Frame });
+    else
+        slot.Fence->Reset();
+
+    queue->Submit(
+        {
+            .CommandBuffers = command_buffers,
+            .CommandBufferCount = command_buffer_count,
+            .WaitSemaphores = wait_semaphores.data(),
+            .WaitSemaphoreCount = static_cast<std::uint32_t>(wait_semaphores.size()),
+            .SignalSemaphores = signal_semaphores.data(),
+            .SignalSemaphoreCount = static_cast<std::uint32_t>(signal_semaphores.size()),
+            .SignalFence = slot.Fence,
+        });
+
+    slot.SubmittedFrame = m_Frame;
+    m_SubmittedFrame = m_Frame;
+}
+
+void fxng::FramePacer::Present(glal::Queue queue, glal::Swapchain swapchain)
+{
+    auto &slot = m_Slots[GetFrameIndex()];
+    common::Assert(
+        slot.Acquired && slot.SubmittedFrame == m_Frame,
+        "frame {} has to acquire an image and submit before presenting",
+        m_Frame);
+
+    queue->Present(swapchain, slot.RenderFinished);
+    slot.Acquired = false;
+}
+
+void fxng::FramePacer::WaitIdle()
+{
+    if (m_SubmittedFrame)
+        WaitForFrame(m_SubmittedFrame);
+}
+
+std::uint64_t fxng::FramePacer::GetFrame() const
+{
+    return m_Frame;
+}
+
+std::uint32_t fxng::FramePacer::GetFrameIndex() const
+{
+    return static_cast<std::uint32_t>(m_Frame % m_Config.FramesInFlight);
+}
+
+std::uint64_t fxng::FramePacer::GetCompletedFrame()
+{
+    if (m_Timeline)
+        return m_CompletedFrame = m_Timeline->GetValue();
+
+    for (auto &slot : m_Slots)
+        if (slot.SubmittedFrame > m_CompletedFrame && slot.Fence->IsSignaled())
+            m_CompletedFrame = slot.SubmittedFrame;
+    return m_CompletedFrame;
+}
+
+void fxng::FramePacer::WaitForFrame(const std::uint64_t frame)
+{
+    if (frame <= m_CompletedFrame)
+        return;
+
+    // a frame that never submitted has nothing to wait for, its slot still holds an older submission
+    auto &slot = m_Slots[frame % m_Config.FramesInFlight];
+    if (slot.SubmittedFrame < frame)
+        return;
+
+    if (m_Timeline)
+        m_Timeline->Wait(frame, UINT64_MAX);
+    else
+        slot.Fence->Wait();
+
+    m_CompletedFrame = std::max(m_CompletedFrame, frame);
+}
@@ -0,0 +1,80 @@
+#include <common/log.hxx>
+#include <fxng/geometry.hxx>
+
+fxng::FreeList::FreeList(const std::uint32_t size)
+    : m_Size(size),
+      m_Free(size)
+{
+    if (size)
+        m_Ranges.emplace(0, size);
+}
+
+std::optional<std::uint32_t> fxng::FreeList::Allocate(const std::uint32_t size)
+{
+    if (!size || size > m_Free)
+        return std::nullopt;
+
+    for (auto it = m_Ranges.begin(); it != m_Ranges.end(); ++it)
+    {
+        const auto [offset, range_size] = *it;
+        if (range_size < size)
+            continue;
+
+        m_Ranges.erase(it);
+        if (range_size > size)
+            m_Ranges.emplace(offset + size, range_size - size);
+
+        m_Free -= size;
+        return offset;
+    }
+
+    return std::nullopt;
+}
+
+void fxng::FreeList::Free(std::uint32_t offset, std::uint32_t size)
+{
+    if (!size)
+        return;
+
+    common::Assert(
+        offset + size <= m_Size,
+        "range {}+{} lies outside of the free list of size {}",
+        offset,
+        size,
+        m_Size);
+
+    m_Free += size;
+
+    const auto next = m_Ranges.lower_bound(offset);
+    common::Assert(next == m_Ranges.end() || offset + size <= next->first, "range {}+{} is already free", offset, size);
+
+    if (next != m_Ranges.end() && offset + size == next->first)
+    {
+        size += next->second;
+        m_Ranges.erase(next);
+    }
+
+    if (auto prev = m_Ranges.lower_bound(offset); prev != m_Ranges.begin())
+    {
+        --prev;
+        common::Assert(prev->first + prev->second <= offset, "range {}+{} is already free", offset, size);
+
+        if (prev->first + prev->second == offset)
+        {
+            prev->second += size;
+            return;
+        }
+    }
+
+    m_Ranges.emplace(offset, size);
+}
+
+std::uint32_t fxng::FreeList::GetSize() const
+{
+    return m_Size;
+}
+
+std::uint32_t fxng::FreeList::GetFree() const
+{
+    return m_Free;
+}
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <common/log.hxx>
+#include <fxng/geometry.hxx>
+
+fxng::GeometryPool::GeometryPool(glal::Device device, UploadManager &uploads, const GeometryPoolConfig &config)
+    : m_Device(device),
+      m_Uploads(uploads),
+      m_Config(config),
+      m_Frame(0)
+{
+    common::Assert(m_Config.VertexStride, "geometry pool vertex stride must not be zero");
+}
+
+fxng::GeometryPool::~GeometryPool()
+{
+    // pending uploads still copy into the blocks, the last ticket covers all earlier ones
+    UploadTicket ticket = 0;
+    for (auto &geometry : m_Geometry)
+        ticket = std::max(ticket, geometry.Range.Ticket);
+    if (ticket)
+        m_Uploads.Wait(ticket);
+
+    for (auto &block : m_Blocks)
+    {
+        m_Device->DestroyBuffer(block.Vertices);
+        m_Device->DestroyBuffer(block.Indices);
+    }
+}
+
+fxng::GeometryHandle fxng::GeometryPool::Allocate(
+    const void *vertices,
+    const std::uint32_t vertex_count,
+    const std::uint32_t *indices,
+    const std::uint32_t index_count)
+{
+    common::Assert(vertex_count && index_count, "geometry needs at least one vertex and one index");
+
+    std::optional<std::uint32_t> vertex_offset, first_index;
+
+    auto block_index = 0u;
+    for (; block_index < m_Blocks.size(); ++block_index)
+    {
+        auto &block = m_Blocks[block_index];
+        if (block.VertexRanges.GetFree() < vertex_count || block.IndexRanges.GetFree() < index_count)
+            continue;
+
+        if (!(vertex_offset = block.VertexRanges.Allocate(vertex_count)))
+            continue;
+
+        if ((first_index = block.IndexRanges.Allocate(index_count)))
+            break;
+
+        block.VertexRanges.Free(*vertex_offset, vertex_count);
+    }
+
+    if (block_index == m_Blocks.size())
+    {
+        block_index = CreateBlock(
+            std::max(m_Config.BlockVertexCount, vertex_count),
+            std::max(m_Config.BlockIndexCount, index_count));
+
+        auto &block = m_Blocks[block_index];
+        vertex_offset = block.VertexRanges.Allocate(vertex_count);
+        first_index = block.IndexRanges.Allocate(index_count);
+    }
+
+    auto &block = m_Blocks[block_index];
+
+    m_Uploads.UploadBuffer(
+        block.Vertices,
+        static_cast<std::size_t>(*vertex_offset) * m_Config.VertexStride,
+        vertices,
+        static_cast<std::size_t>(vertex_count) * m_Config.VertexStride);
+
+    // tickets complete in order, the one of the indices covers the vertices as well
+    const auto ticket = m_Uploads.UploadBuffer(
+        block.Indices,
+        *first_index * sizeof(std::uint32_t),
+        indices,
+        index_count * sizeof(std::uint32_t));
+
+    GeometryHandle handle;
+    if (m_FreeGeometry.empty())
+    {
+        handle = static_cast<GeometryHandle>(m_Geometry.size());
+        m_Geometry.emplace_back();
+    }
+    else
+    {
+        handle = m_FreeGeometry.back();
+        m_FreeGeometry.pop_back();
+    }
+
+    m_Geometry[handle] = {
+        .Active = true,
+        .Range = {
+            .Block = block_index,
+            .VertexOffset = static_cast<std::int32_t>(*vertex_offset),
+            .VertexCount = vertex_count,
+            .FirstIndex = *first_index,
+            .IndexCount = index_count,
+            .Ticket = ticket,
+        },
+    };
+    return handle;
+}
+
+void fxng::GeometryPool::Free(const GeometryHandle geometry)
+{
+    At(geometry).Active = false;
+
+    // the gpu may still draw the geometry this frame
+    m_Retired.push_back({ .Frame = m_Frame, .Geometry = geometry });
+}
+
+void fxng::GeometryPool::Update()
+{
+    ++m_Frame;
+
+    std::erase_if(
+        m_Retired,
+        [this](const RetiredGeometry &retired)
+        {
+            // an upload still copying into the ranges would overwrite the next geometry
+            if (retired.Frame + m_Config.FramesInFlight > m_Frame
+                || !m_Uploads.IsComplete(m_Geometry[retired.Geometry].Range.Ticket))
+                return false;
+
+            Release(retired.Geometry);
+            return true;
+        });
+}
+
+const fxng::GeometryRange &fxng::GeometryPool::GetRange(const GeometryHandle geometry) const
+{
+    return At(geometry).Range;
+}
+
+bool fxng::GeometryPool::IsResident(const GeometryHandle geometry) const
+{
+    return m_Uploads.IsComplete(At(geometry).Range.Ticket);
+}
+
+std::uint32_t fxng::GeometryPool::GetBlockCount() const
+{
+    return static_cast<std::uint32_t>(m_Blocks.size());
+}
+
+glal::Buffer fxng::GeometryPool::GetVertexBuffer(const std::uint32_t block) const
+{
+    return m_Blocks.at(block).Vertices;
+}
+
+glal::Buffer fxng::GeometryPool::GetIndexBuffer(const std::uint32_t block) const
+{
+    return m_Blocks.at(block).Indices;
+}
+
+fxng::GeometryPool::PooledGeometry &fxng::GeometryPool::At(const GeometryHandle geometry)
+{
+    common::Assert(
+        geometry < m_Geometry.size() && m_Geometry[geometry].Active,
+        "geometry {} is not allocated",
+        geometry);
+    return m_Geometry[geometry];
+}
+
+const fxng::GeometryPool::PooledGeometry &fxng::GeometryPool::At(const GeometryHandle geometry) const
+{
+    common::Assert(
+        geometry < m_Geometry.size() && m_Geometry[geometry].Active,
+        "geometry {} is not allocated",
+        geometry);
+    return m_Geometry[geometry];
+}
+
+std::uint32_t fxng::GeometryPool::CreateBlock(const std::uint32_t vertex_count, const std::uint32_t index_count)
+{
+    common::Log(
+        common::LogLevel_Info,
+        "create geometry block vertices={} indices={}",
+        vertex_count,
+        index_count);
+
+    m_Blocks.push_back(
+        {
+            .Vertices = m_Device->CreateBuffer(
+                {
+                    .Size = static_cast<std::size_t>(vertex_count) * m_Config.VertexStride,
+                    .Usage = glal::BufferUsage_Vertex,
+                    .Memory = glal::MemoryUsage_DeviceLocal,
+                }),
+            .Indices = m_Device->CreateBuffer(
+                {
+                    .Size = static_cast<std::size_t>(index_count) * sizeof(std::uint32_t),
+                    .Usage = glal::BufferUsage_Index,
+                    .Memory = glal::MemoryUsage_DeviceLocal,
+                }),
+            .VertexRanges = FreeList(vertex_count),
+            .IndexRanges = FreeList(index_count),
+        });
+    return static_cast<std::uint32_t>(m_Blocks.size() - 1);
+}
+
+void fxng::GeometryPool::Release(const GeometryHandle geometry)
+{
+    const auto &range = m_Geometry[geometry].Range;
+
+    auto &block = m_Blocks[range.Block];
+    block.VertexRanges.Free(static_cast<std::uint32_t>(range.VertexOffset), range.VertexCount);
+    block.IndexRanges.Free(range.FirstIndex, range.IndexCount);
+
+    m_FreeGeometry.push_back(geometry);
+}
@@ -0,0 +1,371 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <common/log.hxx>
+#include <common/profile.hxx>
+#include <fxng/component.hxx>
+#include <fxng/lighting.hxx>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define FXNG_SSE2
+#include <emmintrin.h>
+#endif
+
+fxng::ClusteredLights::ClusteredLights(glal::Device device, const ClusteredLightsConfig &config)
+    : m_Device(device),
+      m_Config(config)
+{
+    common::Assert(
+        m_Config.TilesX && m_Config.TilesY && m_Config.Slices,
+        "cluster grid {}x{}x{} must not be empty",
+        m_Config.TilesX,
+        m_Config.TilesY,
+        m_Config.Slices);
+
+    m_Clusters.resize(GetClusterCount());
+    m_Buffers.resize(m_Config.FramesInFlight);
+}
+
+fxng::ClusteredLights::~ClusteredLights()
+{
+    for (auto &buffers : m_Buffers)
+        for (const auto buffer : { buffers.Lights, buffers.Clusters, buffers.Indices })
+            if (buffer)
+                m_Device->DestroyBuffer(buffer);
+}
+
+void fxng::ClusteredLights::Clear()
+{
+    m_Lights.clear();
+}
+
+void fxng::ClusteredLights::Add(const LightData &light)
+{
+    m_Lights.push_back(light);
+}
+
+fxng::LightClusterParams fxng::ClusteredLights::Build(
+    const glm::mat4 &view,
+    const glm::mat4 &projection,
+    const float near_plane,
+    const float far_plane,
+    const std::uint32_t width,
+    const std::uint32_t height)
+{
+    COMMON_PROFILE_ZONE("ClusteredLights::Build");
+
+    m_Sorted.clear();
+    m_Bounds.clear();
+    m_Indices.clear();
+
+    // directional lights reach every cluster, they go first and are not binned
+    for (auto &light : m_Lights)
+        if (light.Type == LightType_Directional)
+            m_Sorted.push_back(light);
+
+    const auto directional_count = static_cast<std::uint32_t>(m_Sorted.size());
+
+    // slices are spaced exponentially, so clusters stay roughly cubic at every depth
+    const auto depth_scale = static_cast<float>(m_Config.Slices) / std::log(far_plane / near_plane);
+    const auto depth_bias = -std::log(near_plane) * depth_scale;
+
+    // the slice of a depth is the number of slice starts it reached, which needs no logarithm per light
+    m_SliceStarts.resize(m_Config.Slices - 1);
+    for (std::uint32_t i = 1; i < m_Config.Slices; ++i)
+        m_SliceStarts[i - 1] = std::exp((static_cast<float>(i) - depth_bias) / depth_scale);
+
+    BoundLights(view, projection, near_plane, far_plane);
+
+    std::ranges::fill(m_Clusters, LightCluster{});
+    for (auto &bounds : m_Bounds)
+        for (auto z = bounds.Min[2]; z <= bounds.Max[2]; ++z)
+            for (auto y = bounds.Min[1]; y <= bounds.Max[1]; ++y)
+                for (auto x = bounds.Min[0]; x <= bounds.Max[0]; ++x)
+                    ++m_Clusters[(z * m_Config.TilesY + y) * m_Config.TilesX + x].Count;
+
+    // counting sort, the counts become offsets and are counted up again while the indices are scattered
+    std::uint32_t offset = 0;
+    for (auto &cluster : m_Clusters)
+    {
+        cluster.Offset = offset;
+        offset += cluster.Count;
+        cluster.Count = 0;
+    }
+
+    // the bounds are in the order of the point lights in the sorted buffer
+    m_Indices.resize(offset);
+    for (std::uint32_t i = 0; i < m_Bounds.size(); ++i)
+    {
+        const auto &bounds = m_Bounds[i];
+        for (auto z = bounds.Min[2]; z <= bounds.Max[2]; ++z)
+            for (auto y = bounds.Min[1]; y <= bounds.Max[1]; ++y)
+                for (auto x = bounds.Min[0]; x <= bounds.Max[0]; ++x)
+                {
+                    auto &cluster = m_Clusters[(z * m_Config.TilesY + y) * m_Config.TilesX + x];
+                    m_Indices[cluster.Offset + cluster.Count++] = directional_count + i;
+                }
+    }
+
+    return {
+        .Grid = { m_Config.TilesX, m_Config.TilesY, m_Config.Slices, directional_count },
+        .Scale = {
+            static_cast<float>(m_Config.TilesX) / static_cast<float>(width),
+            static_cast<float>(m_Config.TilesY) / static_cast<float>(height),
+            depth_scale,
+            depth_bias,
+        },
+    };
+}
+
+void fxng::ClusteredLights::Upload(const std::uint32_t frame_index, glal::DescriptorSet descriptor_set)
+{
+    auto &buffers = m_Buffers.at(frame_index);
+
+    buffers.Lights = Reserve(buffers.Lights, m_Sorted.size() * sizeof(LightData));
+    buffers.Clusters = Reserve(buffers.Clusters, m_Clusters.size() * sizeof(LightCluster));
+    buffers.Indices = Reserve(buffers.Indices, m_Indices.size() * sizeof(std::uint32_t));
+
+    Write(buffers.Lights, m_Sorted.data(), m_Sorted.size() * sizeof(LightData));
+    Write(buffers.Clusters, m_Clusters.data(), m_Clusters.size() * sizeof(LightCluster));
+    Write(buffers.Indices, m_Indices.data(), m_Indices.size() * sizeof(std::uint32_t));
+
+    // a buffer may have grown, rebinding all three is cheaper than tracking it
+    descriptor_set->BindBuffer(LightBufferBinding, buffers.Lights);
+    descriptor_set->BindBuffer(LightClusterBufferBinding, buffers.Clusters);
+    descriptor_set->BindBuffer(LightIndexBufferBinding, buffers.Indices);
+}
+
+std::uint32_t fxng::ClusteredLights::GetLightCount() const
+{
+    return static_cast<std::uint32_t>(m_Sorted.size());
+}
+
+std::uint32_t fxng::ClusteredLights::GetIndexCount() const
+{
+    return static_cast<std::uint32_t>(m_Indices.size());
+}
+
+std::uint32_t fxng::ClusteredLights::GetClusterCount() const
+{
+    return m_Config.TilesX * m_Config.TilesY * m_Config.Slices;
+}
+
+void fxng::ClusteredLights::BoundLights(
+    const glm::mat4 &view,
+    const glm::mat4 &projection,
+    const float near_plane,
+    const float far_plane)
+{
+    m_PointLights.clear();
+    for (auto &light : m_Lights)
+        if (light.Type != LightType_Directional)
+            m_PointLights.push_back(&light);
+
+#ifdef FXNG_SSE2
+    const auto zero = _mm_setzero_ps();
+    const auto one = _mm_set1_ps(1.f);
+    const auto minus_one = _mm_set1_ps(-1.f);
+    const auto half = _mm_set1_ps(0.5f);
+    const auto near_depth = _mm_set1_ps(near_plane);
+    const auto far_depth = _mm_set1_ps(far_plane);
+
+    const auto select = [](const __m128 mask, const __m128 a, const __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    };
+
+    // the camera looks down negative z in view space
+    const auto transform = [&](const std::uint32_t row, const __m128 x, const __m128 y, const __m128 z)
+    {
+        return _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(view[0][row]), x), _mm_mul_ps(_mm_set1_ps(view[1][row]), y)),
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(view[2][row]), z), _mm_set1_ps(view[3][row])));
+    };
+
+    // the ndc range of a view space interval over a depth range: the extremes lie at the nearest or farthest depth
+    const auto project = [&](
+        const __m128 min,
+        const __m128 max,
+        const float scale,
+        const __m128 min_depth,
+        const __m128 max_depth)
+    {
+        return std::pair(
+            _mm_div_ps(_mm_mul_ps(_mm_set1_ps(scale), min), select(_mm_cmplt_ps(min, zero), min_depth, max_depth)),
+            _mm_div_ps(_mm_mul_ps(_mm_set1_ps(scale), max), select(_mm_cmplt_ps(max, zero), max_depth, min_depth)));
+    };
+
+    // clamping before the truncation floors, the value is no longer negative
+    const auto to_tile = [&](const __m128 ndc, const std::uint32_t tiles)
+    {
+        const auto tile = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(ndc, half), half), _mm_set1_ps(static_cast<float>(tiles)));
+        return _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(tile, zero), _mm_set1_ps(static_cast<float>(tiles - 1))));
+    };
+
+    const auto to_slice = [&](const __m128 depth)
+    {
+        // a passed start compares to all ones, subtracting it counts up
+        auto slice = _mm_setzero_si128();
+        for (const auto start : m_SliceStarts)
+            slice = _mm_sub_epi32(slice, _mm_castps_si128(_mm_cmpge_ps(depth, _mm_set1_ps(start))));
+        return slice;
+    };
+
+    for (std::size_t i = 0; i < m_PointLights.size(); i += 4)
+    {
+        const auto lane_count = std::min<std::size_t>(m_PointLights.size() - i, 4);
+
+        // lanes past the last light stay zero and are ignored
+        alignas(16) float position_x[4]{}, position_y[4]{}, position_z[4]{}, range[4]{};
+        for (std::size_t lane = 0; lane < lane_count; ++lane)
+        {
+            const auto &light = *m_PointLights[i + lane];
+            position_x[lane] = light.Position.x;
+            position_y[lane] = light.Position.y;
+            position_z[lane] = light.Position.z;
+            range[lane] = light.Range;
+        }
+
+        const auto x = _mm_load_ps(position_x);
+        const auto y = _mm_load_ps(position_y);
+        const auto z = _mm_load_ps(position_z);
+
+        const auto center_x = transform(0, x, y, z);
+        const auto center_y = transform(1, x, y, z);
+        const auto depth = _mm_sub_ps(zero, transform(2, x, y, z));
+        const auto radius = _mm_min_ps(_mm_load_ps(range), far_depth);
+
+        const auto min_depth = _mm_max_ps(_mm_sub_ps(depth, radius), near_depth);
+        const auto max_depth = _mm_min_ps(_mm_add_ps(depth, radius), far_depth);
+
+        const auto [min_x, max_x] = project(
+            _mm_sub_ps(center_x, radius),
+            _mm_add_ps(center_x, radius),
+            projection[0][0],
+            min_depth,
+            max_depth);
+        const auto [min_y, max_y] = project(
+            _mm_sub_ps(center_y, radius),
+            _mm_add_ps(center_y, radius),
+            projection[1][1],
+            min_depth,
+            max_depth);
+
+        auto visible = _mm_cmple_ps(min_depth, max_depth);
+        visible = _mm_and_ps(visible, _mm_and_ps(_mm_cmple_ps(min_x, one), _mm_cmpge_ps(max_x, minus_one)));
+        visible = _mm_and_ps(visible, _mm_and_ps(_mm_cmple_ps(min_y, one), _mm_cmpge_ps(max_y, minus_one)));
+
+        const auto visible_mask = _mm_movemask_ps(visible);
+        if (!visible_mask)
+            continue;
+
+        alignas(16) std::uint32_t tiles[6][4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(tiles[0]), to_tile(min_x, m_Config.TilesX));
+        _mm_store_si128(reinterpret_cast<__m128i *>(tiles[1]), to_tile(min_y, m_Config.TilesY));
+        _mm_store_si128(reinterpret_cast<__m128i *>(tiles[2]), to_slice(min_depth));
+        _mm_store_si128(reinterpret_cast<__m128i *>(tiles[3]), to_tile(max_x, m_Config.TilesX));
+        _mm_store_si128(reinterpret_cast<__m128i *>(tiles[4]), to_tile(max_y, m_Config.TilesY));
+        _mm_store_si128(reinterpret_cast<__m128i *>(tiles[5]), to_slice(max_depth));
+
+        for (std::size_t lane = 0; lane < lane_count; ++lane)
+        {
+            if (!(visible_mask >> lane & 1))
+                continue;
+
+            m_Sorted.push_back(*m_PointLights[i + lane]);
+            m_Bounds.push_back(
+                {
+                    .Min = { tiles[0][lane], tiles[1][lane], tiles[2][lane] },
+                    .Max = { tiles[3][lane], tiles[4][lane], tiles[5][lane] },
+                });
+        }
+    }
+#else
+    const auto to_slice = [&](const float depth)
+    {
+        return static_cast<std::uint32_t>(
+            std::upper_bound(m_SliceStarts.begin(), m_SliceStarts.end(), depth) - m_SliceStarts.begin());
+    };
+
+    const auto to_tile = [](const float ndc, const std::uint32_t tiles)
+    {
+        const auto tile = std::floor((ndc * 0.5f + 0.5f) * static_cast<float>(tiles));
+        return static_cast<std::uint32_t>(std::clamp(tile, 0.f, static_cast<float>(tiles - 1)));
+    };
+
+    // the ndc range of a view space interval over a depth range: the extremes lie at the nearest or farthest depth
+    const auto project = [](
+        const float min,
+        const float max,
+        const float scale,
+        const float min_depth,
+        const float max_depth)
+    {
+        return std::pair(
+            scale * min / (min < 0.f ? min_depth : max_depth),
+            scale * max / (max < 0.f ? max_depth : min_depth));
+    };
+
+    for (const auto light : m_PointLights)
+    {
+        const auto center = glm::vec3(view * glm::vec4(light->Position, 1.f));
+        const auto radius = std::min(light->Range, far_plane);
+
+        // the camera looks down negative z in view space
+        const auto min_depth = std::max(-center.z - radius, near_plane);
+        const auto max_depth = std::min(-center.z + radius, far_plane);
+        if (min_depth > max_depth)
+            continue;
+
+        const auto [min_x, max_x] = project(
+            center.x - radius,
+            center.x + radius,
+            projection[0][0],
+            min_depth,
+            max_depth);
+        const auto [min_y, max_y] = project(
+            center.y - radius,
+            center.y + radius,
+            projection[1][1],
+            min_depth,
+            max_depth);
+        if (min_x > 1.f || max_x < -1.f || min_y > 1.f || max_y < -1.f)
+            continue;
+
+        m_Sorted.push_back(*light);
+        m_Bounds.push_back(
+            {
+                .Min = { to_tile(min_x, m_Config.TilesX), to_tile(min_y, m_Config.TilesY), to_slice(min_depth) },
+                .Max = { to_tile(max_x, m_Config.TilesX), to_tile(max_y, m_Config.TilesY), to_slice(max_depth) },
+            });
+    }
+#endif
+}
+
+void fxng::ClusteredLights::Write(glal::Buffer buffer, const void *data, const std::size_t size)
+{
+    if (!size)
+        return;
+
+    std::memcpy(buffer->Map(), data, size);
+    buffer->Unmap();
+}
+
+glal::Buffer fxng::ClusteredLights::Reserve(glal::Buffer buffer, const std::size_t size)
+{
+    if (buffer && buffer->GetSize() >= size)
+        return buffer;
+
+    // the gpu finished with the buffers of the slot when the frame began
+    if (buffer)
+        m_Device->DestroyBuffer(buffer);
+
+    return m_Device->CreateBuffer(
+        {
+            .Size = std::bit_ceil(std::max<std::size_t>(size, 1)),
+            .Usage = glal::BufferUsage_Storage,
+            .Memory = glal::MemoryUsage_HostToDevice,
+        });
+}
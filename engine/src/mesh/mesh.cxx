@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <common/log.hxx>
+#include <fxng/mesh.hxx>
+
+static std::uint32_t resolve_index(const long index, const std::size_t count)
+{
+    if (index < 0)
+        return static_cast<std::uint32_t>(static_cast<long>(count) + index);
+    return static_cast<std::uint32_t>(index - 1);
+}
+
+fxng::Mesh fxng::LoadMesh(const std::filesystem::path &path)
+{
+    std::ifstream stream(path);
+    common::Assert(stream.is_open(), "failed to open {}", path);
+
+    std::vector<glm::vec4> positions;
+    std::vector<glm::vec2> textures;
+    std::vector<glm::vec3> normals;
+
+    Mesh mesh;
+    std::unordered_map<std::uint64_t, std::uint32_t> vertex_map;
+
+    const auto emit_vertex = [&](const std::string &token) -> std::uint32_t
+    {
+        long v = 0, vt = 0, vn = 0;
+
+        std::istringstream token_stream(token);
+        token_stream >> v;
+        if (token_stream.peek() == '/')
+        {
+            token_stream.get();
+            if (token_stream.peek() != '/')
+                token_stream >> vt;
+            if (token_stream.peek() == '/')
+            {
+                token_stream.get();
+                token_stream >> vn;
+            }
+        }
+
+        common::Assert(v != 0, "invalid face vertex '{}' in {}", token, path);
+
+        const auto position_index = resolve_index(v, positions.size());
+        const auto texture_index = vt ? resolve_index(vt, textures.size()) : ~0u;
+        const auto normal_index = vn ? resolve_index(vn, normals.size()) : ~0u;
+
+        const auto key = static_cast<std::uint64_t>(position_index) << 42
+                         ^ static_cast<std::uint64_t>(texture_index & 0x1fffff) << 21
+                         ^ static_cast<std::uint64_t>(normal_index & 0x1fffff);
+
+        if (const auto it = vertex_map.find(key); it != vertex_map.end())
+            return it->second;
+
+        mesh.Vertices.push_back(
+            {
+                .Position = positions.at(position_index),
+                .Normal = normal_index != ~0u ? normals.at(normal_index) : glm::vec3(0.f),
+                .Texture = texture_index != ~0u ? textures.at(texture_index) : glm::vec2(0.f),
+            });
+
+        const auto index = static_cast<std::uint32_t>(mesh.Vertices.size() - 1);
+        vertex_map.emplace(key, index);
+        return index;
+    };
+
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        std::istringstream line_stream(line);
+
+        std::string type;
+        line_stream >> type;
+
+        if (type == "v")
+        {
+            auto &position = positions.emplace_back(0.f, 0.f, 0.f, 1.f);
+            line_stream >> position.x >> position.y >> position.z;
+            continue;
+        }
+
+        if (type == "vt")
+        {
+            auto &texture = textures.emplace_back(0.f);
+            line_stream >> texture.x >> texture.y;
+            continue;
+        }
+
+        if (type == "vn")
+        {
+            auto &normal = normals.emplace_back(0.f);
+            line_stream >> normal.x >> normal.y >> normal.z;
+            continue;
+        }
+
+        if (type == "f")
+        {
+            std::vector<std::uint32_t> polygon;
+            for (std::string token; line_stream >> token;)
+                polygon.push_back(emit_vertex(token));
+
+            common::Assert(polygon.size() >= 3, "face with less than three vertices in {}", path);
+
+            for (std::size_t i = 2; i < polygon.size(); ++i)
+            {
+                mesh.Indices.push_back(polygon[0]);
+                mesh.Indices.push_back(polygon[i - 1]);
+                mesh.Indices.push_back(polygon[i]);
+            }
+        }
+    }
+
+    common::Assert(!mesh.Vertices.empty(), "mesh {} has no vertices", path);
+
+    auto min = glm::vec3(mesh.Vertices.front().Position);
+    auto max = min;
+    for (auto &vertex : mesh.Vertices)
+    {
+        min = glm::min(min, glm::vec3(vertex.Position));
+        max = glm::max(max, glm::vec3(vertex.Position));
+    }
+
+    mesh.Center = (min + max) * 0.5f;
+    mesh.Radius = 0.f;
+    for (auto &vertex : mesh.Vertices)
+        mesh.Radius = std::max(mesh.Radius, glm::length(glm::vec3(vertex.Position) - mesh.Center));
+
+    mesh.Lods = {
+        {
+            .IndexOffset = 0,
+            .IndexCount = static_cast<std::uint32_t>(mesh.Indices.size()),
+            .MeshletOffset = 0,
+            .MeshletCount = 0,
+            .Error = 0.f,
+        },
+    };
+
+    return mesh;
+}
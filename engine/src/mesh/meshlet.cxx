@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <common/log.hxx>
+#include <fxng/mesh.hxx>
+
+static void compute_bounds(const fxng::Mesh &mesh, const std::uint32_t *indices, fxng::Meshlet &meshlet)
+{
+    const auto position = [&](const std::uint32_t i)
+    {
+        return glm::vec3(mesh.Vertices[indices[i]].Position);
+    };
+
+    // Ritter's bounding sphere: approximate the diameter from an arbitrary point, then grow to fit
+    auto a = position(0);
+    auto b = a;
+    for (std::uint32_t i = 0; i < meshlet.IndexCount; ++i)
+        if (const auto p = position(i); glm::dot(p - a, p - a) > glm::dot(b - a, b - a))
+            b = p;
+    a = b;
+    for (std::uint32_t i = 0; i < meshlet.IndexCount; ++i)
+        if (const auto p = position(i); glm::dot(p - b, p - b) > glm::dot(a - b, a - b))
+            a = p;
+
+    auto center = (a + b) * 0.5f;
+    auto radius = glm::length(a - b) * 0.5f;
+
+    for (std::uint32_t i = 0; i < meshlet.IndexCount; ++i)
+    {
+        const auto p = position(i);
+        const auto distance = glm::length(p - center);
+        if (distance <= radius)
+            continue;
+
+        const auto new_radius = (radius + distance) * 0.5f;
+        center += (p - center) * ((new_radius - radius) / distance);
+        radius = new_radius;
+    }
+
+    meshlet.Center = center;
+    meshlet.Radius = radius;
+
+    // normal cone: average of the triangle normals, opened wide enough to contain all of them
+    std::vector<glm::vec3> normals;
+    normals.reserve(meshlet.IndexCount / 3);
+
+    auto axis = glm::vec3(0.f);
+    for (std::uint32_t i = 0; i < meshlet.IndexCount; i += 3)
+    {
+        const auto p0 = position(i);
+        const auto normal = glm::cross(position(i + 1) - p0, position(i + 2) - p0);
+        const auto length = glm::length(normal);
+        if (length <= std::numeric_limits<float>::epsilon())
+            continue;
+
+        normals.push_back(normal / length);
+        axis += normals.back();
+    }
+
+    meshlet.ConeAxis = glm::vec3(0.f);
+    meshlet.ConeCutoff = 1.f;
+
+    const auto axis_length = glm::length(axis);
+    if (normals.empty() || axis_length <= std::numeric_limits<float>::epsilon())
+        return;
+
+    axis /= axis_length;
+
+    auto min_dot = 1.f;
+    for (auto &normal : normals)
+        min_dot = std::min(min_dot, glm::dot(normal, axis));
+
+    // a cone wider than ~84 degrees will practically never be culled, mark it as degenerate
+    if (min_dot <= 0.1f)
+        return;
+
+    meshlet.ConeAxis = axis;
+    meshlet.ConeCutoff = std::sqrt(1.f - min_dot * min_dot);
+}
+
+static void build_range(
+    fxng::Mesh &mesh,
+    const std::uint32_t *source,
+    const std::uint32_t index_count,
+    std::vector<std::uint32_t> &indices,
+    std::vector<std::uint32_t> &vertex_stamp)
+{
+    const auto triangle_count = index_count / 3;
+    const auto vertex_count = static_cast<std::uint32_t>(mesh.Vertices.size());
+
+    // vertex -> triangle adjacency in compressed form
+    std::vector<std::uint32_t> adjacency_offsets(vertex_count + 1, 0);
+    for (std::uint32_t i = 0; i < index_count; ++i)
+        ++adjacency_offsets[source[i] + 1];
+    for (std::uint32_t i = 0; i < vertex_count; ++i)
+        adjacency_offsets[i + 1] += adjacency_offsets[i];
+
+    std::vector<std::uint32_t> adjacency(index_count);
+    {
+        auto cursor = adjacency_offsets;
+        for (std::uint32_t i = 0; i < index_count; ++i)
+            adjacency[cursor[source[i]]++] = i / 3;
+    }
+
+    std::vector<bool> emitted(triangle_count, false);
+
+    std::vector<std::uint32_t> meshlet_vertices;
+    meshlet_vertices.reserve(fxng::MaxMeshletVertices);
+
+    std::uint32_t seed = 0;
+
+    while (true)
+    {
+        while (seed < triangle_count && emitted[seed])
+            ++seed;
+        if (seed >= triangle_count)
+            break;
+
+        // stamp of the meshlet a vertex was last added to, avoids clearing a set for every meshlet
+        const auto stamp = static_cast<std::uint32_t>(mesh.Meshlets.size());
+
+        fxng::Meshlet meshlet{};
+        meshlet.IndexOffset = static_cast<std::uint32_t>(indices.size());
+
+        meshlet_vertices.clear();
+
+        const auto count_new_vertices = [&](const std::uint32_t triangle)
+        {
+            std::uint32_t count = 0;
+            for (std::uint32_t k = 0; k < 3; ++k)
+                count += vertex_stamp[source[triangle * 3 + k]] != stamp;
+            return count;
+        };
+
+        const auto emit_triangle = [&](const std::uint32_t triangle)
+        {
+            for (std::uint32_t k = 0; k < 3; ++k)
+            {
+                const auto index = source[triangle * 3 + k];
+                if (vertex_stamp[index] != stamp)
+                {
+                    vertex_stamp[index] = stamp;
+                    meshlet_vertices.push_back(index);
+                }
+                indices.push_back(index);
+            }
+            emitted[triangle] = true;
+        };
+
+        emit_triangle(seed);
+
+        for (std::uint32_t triangles = 1; triangles < fxng::MaxMeshletTriangles; ++triangles)
+        {
+            // prefer the adjacent triangle that adds the fewest vertices to keep the meshlet compact
+            auto best_triangle = ~0u;
+            auto best_count = 4u;
+
+            for (std::uint32_t v = 0; v < meshlet_vertices.size() && best_count; ++v)
+            {
+                const auto vertex = meshlet_vertices[v];
+                for (auto j = adjacency_offsets[vertex]; j < adjacency_offsets[vertex + 1]; ++j)
+                {
+                    const auto triangle = adjacency[j];
+                    if (emitted[triangle])
+                        continue;
+
+                    if (const auto count = count_new_vertices(triangle); count < best_count)
+                    {
+                        best_triangle = triangle;
+                        best_count = count;
+                        if (!count)
+                            break;
+                    }
+                }
+            }
+
+            // disconnected geometry, continue filling with the next unused triangle in index order
+            if (best_triangle == ~0u)
+            {
+                while (seed < triangle_count && emitted[seed])
+                    ++seed;
+                if (seed >= triangle_count)
+                    break;
+
+                best_triangle = seed;
+                best_count = count_new_vertices(seed);
+            }
+
+            if (meshlet_vertices.size() + best_count > fxng::MaxMeshletVertices)
+                break;
+
+            emit_triangle(best_triangle);
+        }
+
+        meshlet.IndexCount = static_cast<std::uint32_t>(indices.size()) - meshlet.IndexOffset;
+        meshlet.VertexCount = static_cast<std::uint32_t>(meshlet_vertices.size());
+
+        mesh.Meshlets.push_back(meshlet);
+    }
+}
+
+void fxng::BuildMeshlets(Mesh &mesh)
+{
+    common::Assert(mesh.Indices.size() % 3 == 0, "mesh index count {} is not a multiple of three", mesh.Indices.size());
+
+    mesh.Meshlets.clear();
+
+    std::vector<std::uint32_t> indices;
+    indices.reserve(mesh.Indices.size());
+
+    std::vector<std::uint32_t> vertex_stamp(mesh.Vertices.size(), ~0u);
+
+    // every level of detail gets its own meshlets, its index range is rewritten in meshlet order
+    for (auto &lod : mesh.Lods)
+    {
+        const auto index_offset = static_cast<std::uint32_t>(indices.size());
+        const auto meshlet_offset = static_cast<std::uint32_t>(mesh.Meshlets.size());
+
+        build_range(mesh, mesh.Indices.data() + lod.IndexOffset, lod.IndexCount, indices, vertex_stamp);
+
+        lod.IndexOffset = index_offset;
+        lod.MeshletOffset = meshlet_offset;
+        lod.MeshletCount = static_cast<std::uint32_t>(mesh.Meshlets.size()) - meshlet_offset;
+    }
+
+    mesh.Indices = std::move(indices);
+
+    for (auto &meshlet : mesh.Meshlets)
+        compute_bounds(mesh, mesh.Indices.data() + meshlet.IndexOffset, meshlet);
+}
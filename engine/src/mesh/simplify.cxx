@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <common/log.hxx>
+#include <fxng/mesh.hxx>
+
+/**
+ * quadric_t - symmetric 4x4 error quadric, accumulated from area-weighted triangle planes
+ */
+struct quadric_t
+{
+    double a00, a01, a02, a11, a12, a22;
+    double b0, b1, b2;
+    double c;
+    double weight;
+};
+
+struct collapse_t
+{
+    std::uint32_t from, to;
+    float error;
+};
+
+static void quadric_add(quadric_t &dst, const quadric_t &src)
+{
+    dst.a00 += src.a00;
+    dst.a01 += src.a01;
+    dst.a02 += src.a02;
+    dst.a11 += src.a11;
+    dst.a12 += src.a12;
+    dst.a22 += src.a22;
+    dst.b0 += src.b0;
+    dst.b1 += src.b1;
+    dst.b2 += src.b2;
+    dst.c += src.c;
+    dst.weight += src.weight;
+}
+
+static quadric_t quadric_from_plane(const glm::dvec3 normal, const double distance, const double weight)
+{
+    return {
+        .a00 = normal.x * normal.x * weight,
+        .a01 = normal.x * normal.y * weight,
+        .a02 = normal.x * normal.z * weight,
+        .a11 = normal.y * normal.y * weight,
+        .a12 = normal.y * normal.z * weight,
+        .a22 = normal.z * normal.z * weight,
+        .b0 = normal.x * distance * weight,
+        .b1 = normal.y * distance * weight,
+        .b2 = normal.z * distance * weight,
+        .c = distance * distance * weight,
+        .weight = weight,
+    };
+}
+
+/**
+ * returns the squared distance of p to the planes accumulated in q, normalized by their total weight
+ */
+static float quadric_error(const quadric_t &q, const glm::vec3 p)
+{
+    const double x = p.x, y = p.y, z = p.z;
+
+    const auto rx = q.a00 * x + q.a01 * y + q.a02 * z + q.b0;
+    const auto ry = q.a01 * x + q.a11 * y + q.a12 * z + q.b1;
+    const auto rz = q.a02 * x + q.a12 * y + q.a22 * z + q.b2;
+
+    const auto error = x * rx + y * ry + z * rz + q.b0 * x + q.b1 * y + q.b2 * z + q.c;
+
+    return static_cast<float>(std::abs(error) / std::max(q.weight, 1e-12));
+}
+
+std::vector<std::uint32_t> fxng::SimplifyMesh(
+    const std::vector<Vertex> &vertices,
+    const std::vector<std::uint32_t> &indices,
+    const std::size_t target_index_count,
+    const float target_error,
+    float *result_error)
+{
+    const auto vertex_count = static_cast<std::uint32_t>(vertices.size());
+
+    const auto position = [&](const std::uint32_t i)
+    {
+        return glm::vec3(vertices[i].Position);
+    };
+
+    const auto edge_key = [](const std::uint32_t a, const std::uint32_t b)
+    {
+        return static_cast<std::uint64_t>(std::min(a, b)) << 32 | std::max(a, b);
+    };
+
+    // collapses are half-edge only, so every level keeps referencing the original vertex buffer. vertices on
+    // borders, attribute seams and non-manifold edges are locked to keep the silhouette and uv layout intact
+    std::vector<bool> locked(vertex_count, false);
+    {
+        std::unordered_map<std::uint64_t, std::uint32_t> edge_count;
+        for (std::size_t i = 0; i < indices.size(); i += 3)
+            for (std::size_t k = 0; k < 3; ++k)
+                ++edge_count[edge_key(indices[i + k], indices[i + (k + 1) % 3])];
+
+        for (auto &[key, count] : edge_count)
+            if (count != 2)
+            {
+                locked[key >> 32] = true;
+                locked[key & 0xffffffff] = true;
+            }
+    }
+
+    std::vector<quadric_t> quadrics(vertex_count);
+    for (std::size_t i = 0; i < indices.size(); i += 3)
+    {
+        const auto p0 = position(indices[i]);
+        const auto normal = glm::dvec3(glm::cross(position(indices[i + 1]) - p0, position(indices[i + 2]) - p0));
+
+        const auto length = glm::length(normal);
+        if (length <= 0.0)
+            continue;
+
+        const auto quadric = quadric_from_plane(normal / length, -glm::dot(normal / length, glm::dvec3(p0)), length * 0.5);
+        for (std::size_t k = 0; k < 3; ++k)
+            quadric_add(quadrics[indices[i + k]], quadric);
+    }
+
+    std::vector<std::uint32_t> result = indices;
+    std::vector<std::uint32_t> remap(vertex_count);
+
+    const auto error_limit = target_error * target_error;
+    auto max_error = 0.f;
+
+    std::vector<collapse_t> collapses;
+    std::vector<bool> touched(vertex_count);
+
+    std::vector<std::uint32_t> adjacency_offsets(vertex_count + 1);
+    std::vector<std::uint32_t> adjacency;
+
+    while (result.size() > target_index_count)
+    {
+        // vertex -> triangle adjacency of the current pass
+        std::fill(adjacency_offsets.begin(), adjacency_offsets.end(), 0);
+        for (const auto index : result)
+            ++adjacency_offsets[index + 1];
+        for (std::uint32_t i = 0; i < vertex_count; ++i)
+            adjacency_offsets[i + 1] += adjacency_offsets[i];
+
+        adjacency.resize(result.size());
+        {
+            auto cursor = adjacency_offsets;
+            for (std::uint32_t i = 0; i < result.size(); ++i)
+                adjacency[cursor[result[i]]++] = i / 3;
+        }
+
+        // every interior edge is seen once per winding direction, only take it from one side
+        collapses.clear();
+        for (std::size_t i = 0; i < result.size(); i += 3)
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                const auto a = result[i + k];
+                const auto b = result[i + (k + 1) % 3];
+                if (a > b || (locked[a] && locked[b]))
+                    continue;
+
+                auto quadric = quadrics[a];
+                quadric_add(quadric, quadrics[b]);
+
+                const auto error_ab = locked[a] ? INFINITY : quadric_error(quadric, position(b));
+                const auto error_ba = locked[b] ? INFINITY : quadric_error(quadric, position(a));
+
+                if (error_ab <= error_ba)
+                    collapses.push_back({ .from = a, .to = b, .error = error_ab });
+                else
+                    collapses.push_back({ .from = b, .to = a, .error = error_ba });
+            }
+
+        std::sort(
+            collapses.begin(),
+            collapses.end(),
+            [](const collapse_t &a, const collapse_t &b)
+            {
+                return a.error < b.error;
+            });
+
+        for (std::uint32_t i = 0; i < vertex_count; ++i)
+            remap[i] = i;
+        std::fill(touched.begin(), touched.end(), false);
+
+        auto triangle_count = result.size() / 3;
+        auto applied = 0u;
+
+        for (auto &collapse : collapses)
+        {
+            if (collapse.error > error_limit || triangle_count * 3 <= target_index_count)
+                break;
+
+            if (touched[collapse.from] || touched[collapse.to])
+                continue;
+
+            // reject collapses that would flip or degenerate any of the remaining triangles
+            auto flips = false;
+            auto removed = 0u;
+            for (auto j = adjacency_offsets[collapse.from]; j < adjacency_offsets[collapse.from + 1] && !flips; ++j)
+            {
+                const auto triangle = result.data() + adjacency[j] * 3;
+                if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+                {
+                    ++removed;
+                    continue;
+                }
+
+                glm::vec3 before[3], after[3];
+                for (std::uint32_t k = 0; k < 3; ++k)
+                {
+                    before[k] = position(triangle[k]);
+                    after[k] = triangle[k] == collapse.from ? position(collapse.to) : before[k];
+                }
+
+                const auto normal_before = glm::cross(before[1] - before[0], before[2] - before[0]);
+                const auto normal_after = glm::cross(after[1] - after[0], after[2] - after[0]);
+                flips = glm::dot(normal_before, normal_after) <= 0.f;
+            }
+
+            if (flips)
+                continue;
+
+            remap[collapse.from] = collapse.to;
+            quadric_add(quadrics[collapse.to], quadrics[collapse.from]);
+
+            // the neighbourhood changed, re-evaluate it in the next pass
+            for (auto j = adjacency_offsets[collapse.from]; j < adjacency_offsets[collapse.from + 1]; ++j)
+                for (std::uint32_t k = 0; k < 3; ++k)
+                    touched[result[adjacency[j] * 3 + k]] = true;
+
+            triangle_count -= removed;
+            max_error = std::max(max_error, collapse.error);
+            ++applied;
+        }
+
+        if (!applied)
+            break;
+
+        std::size_t write = 0;
+        for (std::size_t i = 0; i < result.size(); i += 3)
+        {
+            const auto a = remap[result[i]];
+            const auto b = remap[result[i + 1]];
+            const auto c = remap[result[i + 2]];
+            if (a == b || b == c || c == a)
+                continue;
+
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    if (result_error)
+        *result_error = std::sqrt(max_error);
+
+    return result;
+}
+
+void fxng::BuildLods(Mesh &mesh, const std::uint32_t count, const float ratio, const float error)
+{
+    common::Assert(!mesh.Lods.empty(), "mesh has no base level of detail");
+    common::Assert(ratio > 0.f && ratio < 1.f, "lod ratio {} must be in (0, 1)", ratio);
+
+    mesh.Lods.resize(1);
+
+    auto &base = mesh.Lods.front();
+    std::vector<std::uint32_t> source(
+        mesh.Indices.begin() + base.IndexOffset,
+        mesh.Indices.begin() + base.IndexOffset + base.IndexCount);
+
+    auto lod_error = 0.f;
+
+    for (std::uint32_t i = 1; i < count; ++i)
+    {
+        const auto target_index_count = static_cast<std::size_t>(static_cast<float>(source.size() / 3) * ratio) * 3;
+
+        auto simplify_error = 0.f;
+        auto indices = SimplifyMesh(mesh.Vertices, source, target_index_count, error * mesh.Radius, &simplify_error);
+
+        // the remaining geometry is locked or already too coarse to be worth another level
+        if (indices.empty() || indices.size() * 10 > source.size() * 9)
+            break;
+
+        // every level is simplified from the previous one, so the errors add up
+        lod_error += simplify_error;
+
+        mesh.Lods.push_back(
+            {
+                .IndexOffset = static_cast<std::uint32_t>(mesh.Indices.size()),
+                .IndexCount = static_cast<std::uint32_t>(indices.size()),
+                .MeshletOffset = 0,
+                .MeshletCount = 0,
+                .Error = lod_error,
+            });
+        mesh.Indices.insert(mesh.Indices.end(), indices.begin(), indices.end());
+
+        source = std::move(indices);
+    }
+}
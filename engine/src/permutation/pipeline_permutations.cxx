@@ -0,0 +1,103 @@
+#include <common/log.hxx>
+#include <fxng/permutation.hxx>
+
+fxng::MaterialFeature fxng::GetMaterialFeatures(const MaterialUniforms &uniforms)
+{
+    std::uint32_t features = MaterialFeature_None;
+
+    if (uniforms.DiffuseTexture != InvalidTextureIndex)
+        features |= MaterialFeature_DiffuseTexture;
+
+    if (uniforms.Specular != glm::vec3(0.f))
+        features |= MaterialFeature_Specular;
+
+    return static_cast<MaterialFeature>(features);
+}
+
+fxng::PipelinePermutations::PipelinePermutations(
+    glal::Device device,
+    const glal::PipelineDesc &desc,
+    const glal::ShaderReflection *reflections,
+    const std::uint32_t reflection_count)
+    : m_Device(device),
+      m_Desc(desc),
+      m_Stages(desc.Stages, desc.Stages + desc.StageCount),
+      m_VertexBindings(desc.VertexBindings, desc.VertexBindings + desc.VertexBindingCount),
+      m_VertexAttributes(desc.VertexAttributes, desc.VertexAttributes + desc.VertexAttributeCount),
+      m_StageFeatures(desc.StageCount)
+{
+    common::Assert(
+        reflection_count == desc.StageCount,
+        "{} reflections were given for {} pipeline stages",
+        reflection_count,
+        desc.StageCount);
+
+    // the caller's arrays are gone when a variant is first requested, point the copy at owned storage
+    m_Desc.Stages = m_Stages.data();
+    m_Desc.VertexBindings = m_VertexBindings.data();
+    m_Desc.VertexAttributes = m_VertexAttributes.data();
+
+    for (std::uint32_t i = 0; i < desc.StageCount; ++i)
+    {
+        common::Assert(
+            !m_Stages[i].SpecializationConstantCount,
+            "the constants of pipeline permutations are set per variant");
+
+        for (std::uint32_t feature = 0; feature < MaterialFeatureCount; ++feature)
+            if (reflections[i].FindSpecializationConstant(feature))
+                m_StageFeatures[i] |= 1u << feature;
+    }
+}
+
+fxng::PipelinePermutations::~PipelinePermutations()
+{
+    for (const auto &[features, pipeline] : m_Variants)
+        m_Device->DestroyPipeline(pipeline);
+}
+
+glal::Pipeline fxng::PipelinePermutations::Get(const MaterialFeature features)
+{
+    // features no stage declares would only compile the same code again
+    std::uint32_t used_features = 0;
+    for (const auto stage_features : m_StageFeatures)
+        used_features |= stage_features;
+
+    const auto key = features & used_features;
+    if (const auto it = m_Variants.find(key); it != m_Variants.end())
+        return it->second;
+
+    std::vector<glal::SpecializationConstant> constants;
+    std::vector<glal::PipelineStage> stages(m_Stages);
+
+    // every stage points into the same array, reserved up front so it does not move while it is filled
+    constants.reserve(m_Stages.size() * MaterialFeatureCount);
+    for (std::size_t i = 0; i < stages.size(); ++i)
+    {
+        stages[i].SpecializationConstants = constants.data() + constants.size();
+
+        for (std::uint32_t feature = 0; feature < MaterialFeatureCount; ++feature)
+            if (m_StageFeatures[i] & (1u << feature))
+                constants.push_back({ .Id = feature, .Value = (key >> feature) & 1u });
+
+        stages[i].SpecializationConstantCount = static_cast<std::uint32_t>(
+            constants.data() + constants.size() - stages[i].SpecializationConstants);
+    }
+
+    auto desc = m_Desc;
+    desc.Stages = stages.data();
+
+    const auto pipeline = m_Device->CreatePipelineAsync(desc);
+    m_Variants.emplace(key, pipeline);
+
+    common::Log(
+        common::LogLevel_Info,
+        "compiling pipeline permutation {:#x}, {} variants",
+        key,
+        m_Variants.size());
+    return pipeline;
+}
+
+std::size_t fxng::PipelinePermutations::GetVariantCount() const
+{
+    return m_Variants.size();
+}
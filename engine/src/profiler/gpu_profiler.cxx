@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <common/log.hxx>
+#include <fxng/profiler.hxx>
+
+static constexpr std::uint32_t pipeline_statistics_count = sizeof(glal::PipelineStatistics) / sizeof(std::uint64_t);
+
+fxng::GpuProfiler::GpuProfiler(glal::Device device, const GpuProfilerConfig &config)
+    : m_Device(device),
+      m_Config(config),
+      m_TimestampPeriod(device->GetLimits().TimestampPeriod),
+      m_Timestamps(),
+      m_Statistics(),
+      m_Frames(config.FrameLatency),
+      // the first BeginFrame moves on to slot 0
+      m_FrameIndex(config.FrameLatency - 1),
+      m_InPass(false),
+      m_DroppedFrames(0)
+{
+    common::Assert(m_Config.FrameLatency, "the gpu profiler needs at least one frame of latency");
+    common::Assert(m_Config.HistorySize, "the gpu profiler needs at least one sample of history");
+    common::Assert(
+        m_Device->Supports(glal::DeviceFeature_TimestampQuery),
+        "timestamp queries are not supported by this device");
+
+    // every pass of every frame slot has a begin and an end timestamp
+    const auto query_count = m_Config.FrameLatency * m_Config.MaxPasses;
+
+    m_Timestamps = m_Device->CreateQueryPool(
+        {
+            .Type = glal::QueryType_Timestamp,
+            .Count = query_count * 2,
+        });
+
+    if (m_Config.PipelineStatistics && m_Device->Supports(glal::DeviceFeature_PipelineStatisticsQuery))
+        m_Statistics = m_Device->CreateQueryPool(
+            {
+                .Type = glal::QueryType_PipelineStatistics,
+                .Count = query_count,
+            });
+
+    m_Results.resize(m_Config.MaxPasses * std::max(2u, pipeline_statistics_count));
+}
+
+fxng::GpuProfiler::~GpuProfiler()
+{
+    m_Device->DestroyQueryPool(m_Timestamps);
+    if (m_Statistics)
+        m_Device->DestroyQueryPool(m_Statistics);
+}
+
+void fxng::GpuProfiler::BeginFrame(glal::CommandBuffer command_buffer)
+{
+    common::Assert(!m_InPass, "pass was not ended before the next frame");
+
+    m_FrameIndex = (m_FrameIndex + 1) % m_Config.FrameLatency;
+
+    Collect(m_FrameIndex);
+
+    const auto first_query = m_FrameIndex * m_Config.MaxPasses;
+    command_buffer->ResetQueries(m_Timestamps, first_query * 2, m_Config.MaxPasses * 2);
+    if (m_Statistics)
+        command_buffer->ResetQueries(m_Statistics, first_query, m_Config.MaxPasses);
+}
+
+void fxng::GpuProfiler::BeginPass(glal::CommandBuffer command_buffer, const std::string_view name)
+{
+    common::Assert(!m_InPass, "passes cannot nest, {} began inside another pass", name);
+
+    auto &frame = m_Frames[m_FrameIndex];
+    if (frame.Passes.size() >= m_Config.MaxPasses)
+        return;
+
+    const auto query = m_FrameIndex * m_Config.MaxPasses + static_cast<std::uint32_t>(frame.Passes.size());
+
+    frame.Passes.push_back(FindPass(name));
+    m_InPass = true;
+
+    command_buffer->WriteTimestamp(m_Timestamps, query * 2);
+    if (m_Statistics)
+        command_buffer->BeginQuery(m_Statistics, query);
+}
+
+void fxng::GpuProfiler::EndPass(glal::CommandBuffer command_buffer)
+{
+    // passes beyond the maximum were never begun
+    if (!m_InPass)
+        return;
+
+    const auto &frame = m_Frames[m_FrameIndex];
+    const auto query = m_FrameIndex * m_Config.MaxPasses + static_cast<std::uint32_t>(frame.Passes.size()) - 1;
+
+    m_InPass = false;
+
+    if (m_Statistics)
+        command_buffer->EndQuery(m_Statistics, query);
+    command_buffer->WriteTimestamp(m_Timestamps, query * 2 + 1);
+}
+
+const std::vector<fxng::GpuPassTiming> &fxng::GpuProfiler::GetPasses() const
+{
+    return m_Passes;
+}
+
+std::uint64_t fxng::GpuProfiler::GetDroppedFrames() const
+{
+    return m_DroppedFrames;
+}
+
+void fxng::GpuProfiler::Collect(const std::uint32_t frame_index)
+{
+    auto &frame = m_Frames[frame_index];
+    if (frame.Passes.empty())
+        return;
+
+    const auto pass_count = static_cast<std::uint32_t>(frame.Passes.size());
+    const auto first_query = frame_index * m_Config.MaxPasses;
+
+    if (!m_Timestamps->GetResults(first_query * 2, pass_count * 2, m_Results.data()))
+    {
+        ++m_DroppedFrames;
+        frame.Passes.clear();
+        return;
+    }
+
+    for (std::uint32_t i = 0; i < pass_count; ++i)
+    {
+        const auto begin = m_Results[i * 2];
+        const auto end = m_Results[i * 2 + 1];
+
+        // ticks are scaled to nanoseconds, then to milliseconds
+        const auto ticks = end > begin ? end - begin : 0;
+        AddSample(frame.Passes[i], static_cast<double>(ticks) * m_TimestampPeriod * 1e-6);
+    }
+
+    if (m_Statistics && m_Statistics->GetResults(first_query, pass_count, m_Results.data()))
+        for (std::uint32_t i = 0; i < pass_count; ++i)
+        {
+            auto &statistics = m_Passes[frame.Passes[i]].Statistics;
+            std::copy_n(
+                m_Results.data() + i * pipeline_statistics_count,
+                pipeline_statistics_count,
+                reinterpret_cast<std::uint64_t *>(&statistics));
+        }
+
+    frame.Passes.clear();
+}
+
+void fxng::GpuProfiler::AddSample(const std::uint32_t pass_index, const double ms)
+{
+    auto &[samples, next, count] = m_Histories[pass_index];
+
+    samples[next] = ms;
+    next = (next + 1) % m_Config.HistorySize;
+    count = std::min(count + 1, m_Config.HistorySize);
+
+    auto sum = 0.0, max = 0.0;
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        sum += samples[i];
+        max = std::max(max, samples[i]);
+    }
+
+    auto &timing = m_Passes[pass_index];
+    timing.LastMs = ms;
+    timing.AverageMs = sum / count;
+    timing.MaxMs = max;
+}
+
+std::uint32_t fxng::GpuProfiler::FindPass(const std::string_view name)
+{
+    if (const auto it = m_PassIndices.find(std::string(name)); it != m_PassIndices.end())
+        return it->second;
+
+    const auto index = static_cast<std::uint32_t>(m_Passes.size());
+
+    m_Passes.push_back({ .Name = std::string(name) });
+    m_Histories.push_back({ .Samples = std::vector<double>(m_Config.HistorySize) });
+    m_PassIndices.emplace(name, index);
+
+    return index;
+}
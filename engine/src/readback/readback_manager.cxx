@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <common/log.hxx>
+#include <fxng/readback.hxx>
+
+fxng::ReadbackManager::ReadbackManager(glal::Device device, const ReadbackManagerConfig &config)
+    : m_Device(device),
+      m_Config(config),
+      m_Queue(device->GetQueue(glal::QueueType_Graphics))
+{
+    common::Assert(m_Config.MaxReadbacks, "the readback manager needs at least one readback");
+
+    // buffers are created on first use, when the size of the images is known
+    for (std::uint32_t i = 0; i < m_Config.MaxReadbacks; ++i)
+    {
+        m_Slots.push_back(
+            {
+                .Buffer = nullptr,
+                .Data = nullptr,
+                .CommandBuffer = m_Device->CreateCommandBuffer(glal::CommandBufferUsage_Once, glal::QueueType_Graphics),
+                .Fence = m_Device->CreateFence(),
+                .Size = 0,
+                .Callback = {},
+            });
+        m_FreeSlots.push_back(m_Config.MaxReadbacks - 1 - i);
+    }
+}
+
+fxng::ReadbackManager::~ReadbackManager()
+{
+    Flush();
+
+    for (auto &slot : m_Slots)
+    {
+        if (slot.Buffer)
+        {
+            slot.Buffer->Unmap();
+            m_Device->DestroyBuffer(slot.Buffer);
+        }
+        m_Device->DestroyCommandBuffer(slot.CommandBuffer);
+        m_Device->DestroyFence(slot.Fence);
+    }
+}
+
+void fxng::ReadbackManager::ReadImage(
+    glal::Image image,
+    const std::uint32_t mip_level,
+    ReadbackCallback callback)
+{
+    if (m_FreeSlots.empty())
+        Deliver();
+
+    const auto index = m_FreeSlots.back();
+    m_FreeSlots.pop_back();
+
+    auto &slot = m_Slots[index];
+
+    const auto extent = image->GetExtent();
+    const glal::Extent3D mip_extent
+    {
+        .Width = std::max(extent.Width >> mip_level, 1u),
+        .Height = std::max(extent.Height >> mip_level, 1u),
+        .Depth = std::max(extent.Depth >> mip_level, 1u),
+    };
+    const auto size = glal::GetImageDataSize(image->GetFormat(), mip_extent);
+
+    // buffers only grow, captures usually have the same size every frame
+    if (!slot.Buffer || slot.Buffer->GetSize() < size)
+    {
+        if (slot.Buffer)
+        {
+            slot.Buffer->Unmap();
+            m_Device->DestroyBuffer(slot.Buffer);
+        }
+
+        slot.Buffer = m_Device->CreateBuffer(
+            {
+                .Size = size,
+                .Usage = glal::BufferUsage_Staging,
+                .Memory = glal::MemoryUsage_DeviceToHost,
+            });
+        slot.Data = slot.Buffer->Map();
+    }
+
+    slot.Size = size;
+    slot.Callback = std::move(callback);
+
+    const auto command_buffer = slot.CommandBuffer;
+    command_buffer->Begin();
+    command_buffer->CopyImageToBuffer(image, slot.Buffer, 0, mip_level);
+    command_buffer->End();
+
+    slot.Fence->Reset();
+    m_Queue->Submit(&command_buffer, 1, slot.Fence);
+
+    m_InFlight.push_back(index);
+}
+
+void fxng::ReadbackManager::Poll()
+{
+    while (!m_InFlight.empty() && m_Slots[m_InFlight.front()].Fence->IsSignaled())
+        Deliver();
+}
+
+void fxng::ReadbackManager::Flush()
+{
+    while (!m_InFlight.empty())
+        Deliver();
+}
+
+void fxng::ReadbackManager::Deliver()
+{
+    const auto index = m_InFlight.front();
+    m_InFlight.pop_front();
+
+    auto &slot = m_Slots[index];
+    slot.Fence->Wait();
+
+    if (slot.Callback)
+        slot.Callback(slot.Data, slot.Size);
+
+    slot.Callback = {};
+    m_FreeSlots.push_back(index);
+}
@@ -0,0 +1,389 @@
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <thread>
+#include <common/log.hxx>
+#include <common/profile.hxx>
+#include <fxng/render_queue.hxx>
+
+static constexpr std::uint32_t radix_bits = 8;
+static constexpr std::uint32_t radix_passes = 64 / radix_bits;
+
+using histogram = std::array<std::uint32_t, 1 << radix_bits>;
+
+static std::uint64_t mask(const std::uint32_t value, const std::uint32_t bits)
+{
+    return value & ((1ull << bits) - 1);
+}
+
+static std::uint32_t digit(const std::uint64_t key, const std::uint32_t pass)
+{
+    return static_cast<std::uint32_t>(key >> (pass * radix_bits)) & ((1u << radix_bits) - 1);
+}
+
+/**
+ * parallel_for - runs the function for every thread index, index 0 on the calling thread
+ */
+template<typename F>
+static void parallel_for(const std::uint32_t thread_count, F &&function)
+{
+    std::vector<std::future<void>> futures;
+    futures.reserve(thread_count - 1);
+
+    for (std::uint32_t i = 1; i < thread_count; ++i)
+        futures.push_back(std::async(std::launch::async, function, i));
+
+    function(0u);
+
+    for (auto &future : futures)
+        future.get();
+}
+
+std::uint64_t fxng::DrawKey::Opaque(
+    const std::uint32_t view,
+    const std::uint32_t pipeline,
+    const std::uint32_t material,
+    const std::uint32_t mesh,
+    const std::uint32_t depth)
+{
+    return mask(view, ViewBits) << ViewShift
+           | mask(DrawPass_Opaque, PassBits) << PassShift
+           | mask(pipeline, PipelineBits) << (MaterialBits + MeshBits + DepthBits)
+           | mask(material, MaterialBits) << (MeshBits + DepthBits)
+           | mask(mesh, MeshBits) << DepthBits
+           | mask(depth, DepthBits);
+}
+
+std::uint64_t fxng::DrawKey::Translucent(
+    const std::uint32_t view,
+    const std::uint32_t pipeline,
+    const std::uint32_t material,
+    const std::uint32_t mesh,
+    const std::uint32_t depth)
+{
+    // far draws have to come first, state only breaks ties
+    return mask(view, ViewBits) << ViewShift
+           | mask(DrawPass_Translucent, PassBits) << PassShift
+           | mask(~depth, DepthBits) << (PipelineBits + MaterialBits + MeshBits)
+           | mask(pipeline, PipelineBits) << (MaterialBits + MeshBits)
+           | mask(material, MaterialBits) << MeshBits
+           | mask(mesh, MeshBits);
+}
+
+std::uint32_t fxng::DrawKey::QuantizeDepth(const float depth, const float near_plane, const float far_plane)
+{
+    const auto normalized = std::clamp((depth - near_plane) / (far_plane - near_plane), 0.f, 1.f);
+    return static_cast<std::uint32_t>(std::lround(normalized * static_cast<float>((1u << DepthBits) - 1)));
+}
+
+std::uint32_t fxng::DrawKey::GetView(const std::uint64_t key)
+{
+    return static_cast<std::uint32_t>(key >> ViewShift);
+}
+
+fxng::DrawPass fxng::DrawKey::GetPass(const std::uint64_t key)
+{
+    return static_cast<DrawPass>((key >> PassShift) & ((1u << PassBits) - 1));
+}
+
+fxng::RenderQueue::RenderQueue(const RenderQueueConfig &config)
+    : m_Config(config),
+      m_Sorted(true)
+{
+}
+
+void fxng::RenderQueue::Clear()
+{
+    m_Entries.clear();
+    m_Packets.clear();
+    m_Sorted = true;
+}
+
+void fxng::RenderQueue::Submit(const std::uint64_t key, const DrawPacket &packet)
+{
+    common::Assert(
+        packet.DescriptorSetCount <= MaxDrawDescriptorSets,
+        "draw packet binds {} descriptor sets, at most {} are supported",
+        packet.DescriptorSetCount,
+        MaxDrawDescriptorSets);
+    common::Assert(
+        packet.DynamicOffsetCount <= MaxDrawDynamicOffsets,
+        "draw packet has {} dynamic offsets, at most {} are supported",
+        packet.DynamicOffsetCount,
+        MaxDrawDynamicOffsets);
+
+    m_Entries.push_back({ .Key = key, .Packet = static_cast<std::uint32_t>(m_Packets.size()) });
+    m_Packets.push_back(packet);
+    m_Sorted = false;
+}
+
+void fxng::RenderQueue::Sort()
+{
+    COMMON_PROFILE_ZONE("RenderQueue::Sort");
+
+    if (m_Sorted)
+        return;
+    m_Sorted = true;
+
+    const auto count = m_Entries.size();
+    const auto thread_count = GetThreadCount();
+    const auto chunk_size = (count + thread_count - 1) / thread_count;
+
+    const auto chunk = [&](const std::uint32_t thread)
+    {
+        const auto begin = std::min(count, thread * chunk_size);
+        return std::pair{ begin, std::min(count, begin + chunk_size) };
+    };
+
+    m_Scratch.resize(count);
+
+    auto src = m_Entries.data();
+    auto dst = m_Scratch.data();
+
+    // all digits are counted in one read, a digit every key shares, like the view of a single view frame, is skipped
+    std::vector<std::array<histogram, radix_passes>> counts(thread_count);
+    parallel_for(
+        thread_count,
+        [&](const std::uint32_t thread)
+        {
+            auto &thread_counts = counts[thread] = {};
+
+            const auto [begin, end] = chunk(thread);
+            for (auto i = begin; i < end; ++i)
+                for (std::uint32_t pass = 0; pass < radix_passes; ++pass)
+                    ++thread_counts[pass][digit(src[i].Key, pass)];
+        });
+
+    std::vector<histogram> offsets(thread_count);
+    auto reordered = false;
+
+    for (std::uint32_t pass = 0; pass < radix_passes; ++pass)
+    {
+        histogram totals{};
+        for (auto &thread_counts : counts)
+            for (std::uint32_t bucket = 0; bucket < totals.size(); ++bucket)
+                totals[bucket] += thread_counts[pass][bucket];
+
+        if (std::ranges::find(totals, count) != totals.end())
+            continue;
+
+        // the chunk counts of the first digit sorted match the unsorted entries, later ones are counted again
+        if (reordered)
+            parallel_for(
+                thread_count,
+                [&](const std::uint32_t thread)
+                {
+                    auto &thread_counts = counts[thread][pass] = {};
+
+                    const auto [begin, end] = chunk(thread);
+                    for (auto i = begin; i < end; ++i)
+                        ++thread_counts[digit(src[i].Key, pass)];
+                });
+
+        // bucket major, then thread, so every thread scatters its chunk in order and the sort stays stable
+        std::uint32_t offset = 0;
+        for (std::uint32_t bucket = 0; bucket < totals.size(); ++bucket)
+            for (std::uint32_t thread = 0; thread < thread_count; ++thread)
+            {
+                offsets[thread][bucket] = offset;
+                offset += counts[thread][pass][bucket];
+            }
+
+        parallel_for(
+            thread_count,
+            [&](const std::uint32_t thread)
+            {
+                auto &thread_offsets = offsets[thread];
+
+                const auto [begin, end] = chunk(thread);
+                for (auto i = begin; i < end; ++i)
+                    dst[thread_offsets[digit(src[i].Key, pass)]++] = src[i];
+            });
+
+        std::swap(src, dst);
+        reordered = true;
+    }
+
+    if (src != m_Entries.data())
+        m_Entries.swap(m_Scratch);
+}
+
+fxng::RenderQueueStatistics fxng::RenderQueue::Execute(
+    glal::CommandBuffer command_buffer,
+    const std::uint32_t view,
+    const void *view_constants,
+    const std::uint32_t view_constants_size)
+{
+    COMMON_PROFILE_ZONE("RenderQueue::Execute");
+
+    common::Assert(m_Sorted, "render queue has to be sorted before it is executed");
+
+    RenderQueueStatistics statistics{};
+
+    const auto first = std::ranges::partition_point(
+        m_Entries,
+        [view](const Entry &entry)
+        {
+            return DrawKey::GetView(entry.Key) < view;
+        });
+    const auto last = std::ranges::partition_point(
+        first,
+        m_Entries.end(),
+        [view](const Entry &entry)
+        {
+            return DrawKey::GetView(entry.Key) <= view;
+        });
+
+    glal::Pipeline pipeline = nullptr;
+    std::array<glal::DescriptorSet, MaxDrawDescriptorSets> descriptor_sets{};
+    std::array<std::uint32_t, MaxDrawDynamicOffsets> dynamic_offsets{};
+    std::uint32_t dynamic_offset_count = 0;
+    glal::Buffer vertex_buffer = nullptr;
+    glal::Buffer instance_buffer = nullptr;
+    glal::Buffer index_buffer = nullptr;
+    auto index_type = glal::DataType_None;
+
+    // the status is only polled once per pipeline and frame, not once per draw
+    glal::Pipeline checked_pipeline = nullptr;
+    auto pipeline_ready = false;
+
+    for (auto entry = first; entry != last; ++entry)
+    {
+        auto &packet = m_Packets[entry->Packet];
+
+        if (packet.Pipeline != checked_pipeline)
+        {
+            checked_pipeline = packet.Pipeline;
+            pipeline_ready = packet.Pipeline->GetStatus() == glal::PipelineStatus_Ready;
+        }
+
+        if (!pipeline_ready)
+        {
+            ++statistics.Skipped;
+            continue;
+        }
+
+        if (packet.Pipeline != pipeline)
+        {
+            command_buffer->BindPipeline(pipeline = packet.Pipeline);
+            ++statistics.PipelineBinds;
+
+            // sets are not guaranteed to stay bound across pipelines with different layouts, and the vertex strides
+            // may differ as well
+            descriptor_sets = {};
+            vertex_buffer = nullptr;
+            instance_buffer = nullptr;
+
+            // push constants do not survive a change of layout either
+            if (view_constants_size)
+                command_buffer->PushConstants(
+                    static_cast<glal::ShaderStage>(glal::ShaderStage_Vertex | glal::ShaderStage_Fragment),
+                    0,
+                    view_constants_size,
+                    view_constants);
+        }
+
+        // rebinds from the first set that changed, the sets before it stay bound
+        std::uint32_t first_set = 0;
+        while (first_set < packet.DescriptorSetCount
+               && packet.DescriptorSets[first_set] == descriptor_sets[first_set])
+            ++first_set;
+
+        // which set a dynamic offset belongs to is unknown here, so packets with dynamic offsets rebind all of their
+        // sets whenever a set or an offset changed
+        if (packet.DynamicOffsetCount
+            && (first_set < packet.DescriptorSetCount
+                || packet.DynamicOffsetCount != dynamic_offset_count
+                || !std::equal(
+                    packet.DynamicOffsets.begin(),
+                    packet.DynamicOffsets.begin() + packet.DynamicOffsetCount,
+                    dynamic_offsets.begin())))
+            first_set = 0;
+
+        if (first_set < packet.DescriptorSetCount)
+        {
+            command_buffer->BindDescriptorSets(
+                first_set,
+                packet.DescriptorSetCount - first_set,
+                packet.DescriptorSets.data() + first_set,
+                packet.DynamicOffsetCount,
+                packet.DynamicOffsets.data());
+            ++statistics.DescriptorSetBinds;
+
+            std::copy(
+                packet.DescriptorSets.begin() + first_set,
+                packet.DescriptorSets.begin() + packet.DescriptorSetCount,
+                descriptor_sets.begin() + first_set);
+
+            dynamic_offsets = packet.DynamicOffsets;
+            dynamic_offset_count = packet.DynamicOffsetCount;
+        }
+
+        if (packet.VertexBuffer != vertex_buffer)
+        {
+            command_buffer->BindVertexBuffer(vertex_buffer = packet.VertexBuffer, 0, 0);
+            ++statistics.VertexBufferBinds;
+        }
+
+        if (packet.InstanceBuffer && packet.InstanceBuffer != instance_buffer)
+        {
+            command_buffer->BindVertexBuffer(instance_buffer = packet.InstanceBuffer, InstanceBufferBinding, 0);
+            ++statistics.VertexBufferBinds;
+        }
+
+        ++statistics.Draws;
+        statistics.Instances += std::max(packet.InstanceCount, 1u);
+
+        if (!packet.IndexBuffer)
+        {
+            if (packet.InstanceCount)
+                command_buffer->DrawInstanced(packet.Count, packet.InstanceCount, packet.First, packet.FirstInstance);
+            else
+                command_buffer->Draw(packet.Count, packet.First);
+            continue;
+        }
+
+        if (packet.IndexBuffer != index_buffer || packet.IndexType != index_type)
+        {
+            command_buffer->BindIndexBuffer(index_buffer = packet.IndexBuffer, index_type = packet.IndexType);
+            ++statistics.IndexBufferBinds;
+        }
+
+        if (packet.IndirectBuffer)
+            command_buffer->DrawIndexedIndirect(
+                packet.IndirectBuffer,
+                0,
+                packet.IndirectCount,
+                sizeof(glal::DrawIndexedIndirectCommand));
+        else if (packet.InstanceCount || packet.VertexOffset)
+            command_buffer->DrawIndexedInstanced(
+                packet.Count,
+                std::max(packet.InstanceCount, 1u),
+                packet.First,
+                packet.VertexOffset,
+                packet.FirstInstance);
+        else
+            command_buffer->DrawIndexed(packet.Count, packet.First);
+    }
+
+    return statistics;
+}
+
+std::size_t fxng::RenderQueue::GetSize() const
+{
+    return m_Entries.size();
+}
+
+std::uint32_t fxng::RenderQueue::GetThreadCount() const
+{
+    if (m_Entries.size() < m_Config.ParallelThreshold)
+        return 1;
+
+    auto thread_count = m_Config.MaxThreads;
+    if (!thread_count)
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    // every thread should get a fair share of the threshold, below that the threads cost more than they save
+    const auto useful = m_Entries.size() * 4 / std::max<std::size_t>(1, m_Config.ParallelThreshold);
+    return static_cast<std::uint32_t>(std::clamp<std::size_t>(useful, 1, thread_count));
+}
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <cstring>
+#include <common/log.hxx>
+#include <fxng/uniform.hxx>
+
+fxng::UniformArena::UniformArena(glal::Device device, const UniformArenaConfig &config)
+    : m_Device(device),
+      m_Config(config),
+      m_Alignment(std::max<std::size_t>(device->GetLimits().MinUniformBufferOffsetAlignment, 1)),
+      m_Mapping(nullptr),
+      m_FrameIndex(0),
+      m_Head(0)
+{
+    for (std::uint32_t i = 0; i < m_Config.FramesInFlight; ++i)
+        m_Buffers.push_back(
+            m_Device->CreateBuffer(
+                {
+                    .Size = m_Config.Size,
+                    .Usage = glal::BufferUsage_Uniform,
+                    .Memory = glal::MemoryUsage_HostToDevice,
+                }));
+}
+
+fxng::UniformArena::~UniformArena()
+{
+    if (m_Mapping)
+        End();
+
+    for (const auto buffer : m_Buffers)
+        m_Device->DestroyBuffer(buffer);
+}
+
+void fxng::UniformArena::Begin(const std::uint32_t frame_index)
+{
+    common::Assert(!m_Mapping, "uniform arena frame {} was not ended", m_FrameIndex);
+
+    m_FrameIndex = frame_index;
+    m_Head = 0;
+    m_Mapping = static_cast<std::byte *>(m_Buffers.at(frame_index)->Map());
+}
+
+void fxng::UniformArena::End()
+{
+    m_Buffers[m_FrameIndex]->Unmap();
+    m_Mapping = nullptr;
+}
+
+std::uint32_t fxng::UniformArena::Write(const void *data, const std::size_t size)
+{
+    common::Assert(m_Mapping, "uniform arena is written outside of a frame");
+
+    const auto offset = (m_Head + m_Alignment - 1) / m_Alignment * m_Alignment;
+    common::Assert(
+        offset + size <= m_Config.Size,
+        "uniform arena of {} bytes is full, raise its size",
+        m_Config.Size);
+
+    std::memcpy(m_Mapping + offset, data, size);
+    m_Head = offset + size;
+    return static_cast<std::uint32_t>(offset);
+}
+
+glal::Buffer fxng::UniformArena::GetBuffer(const std::uint32_t frame_index) const
+{
+    return m_Buffers.at(frame_index);
+}
+
+std::size_t fxng::UniformArena::GetAlignment() const
+{
+    return m_Alignment;
+}
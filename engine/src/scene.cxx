@@ -1,3 +1,4 @@
+#include <common/profile.hxx>
 #include <fxng/scene.hxx>
 
 void fxng::Scene::Clear()
@@ -20,30 +21,40 @@ fxng::Entity *fxng::Scene::Get(const std::string &id)
 
 void fxng::Scene::OnInit() const
 {
+    COMMON_PROFILE_ZONE("Scene::OnInit");
+
     for (auto &entity : m_Entities)
         entity.OnInit();
 }
 
 void fxng::Scene::PreFrame() const
 {
+    COMMON_PROFILE_ZONE("Scene::PreFrame");
+
     for (auto &entity : m_Entities)
         entity.PreFrame();
 }
 
 void fxng::Scene::OnFrame() const
 {
+    COMMON_PROFILE_ZONE("Scene::OnFrame");
+
     for (auto &entity : m_Entities)
         entity.OnFrame();
 }
 
 void fxng::Scene::PostFrame() const
 {
+    COMMON_PROFILE_ZONE("Scene::PostFrame");
+
     for (auto &entity : m_Entities)
         entity.PostFrame();
 }
 
 void fxng::Scene::OnExit() const
 {
+    COMMON_PROFILE_ZONE("Scene::OnExit");
+
     for (auto &entity : m_Entities)
         entity.OnExit();
 }
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <fstream>
+#include <common/log.hxx>
+#include <fxng/texture.hxx>
+
+struct texture_header_t
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t format;
+    std::uint32_t type;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t depth;
+    std::uint32_t mip_count;
+};
+
+struct texture_mip_t
+{
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+glal::Extent3D fxng::TextureInfo::GetMipExtent(const std::uint32_t mip_level) const
+{
+    return {
+        .Width = std::max(Extent.Width >> mip_level, 1u),
+        .Height = std::max(Extent.Height >> mip_level, 1u),
+        .Depth = std::max(Extent.Depth >> mip_level, 1u),
+    };
+}
+
+std::uint64_t fxng::TextureInfo::GetChainSize(const std::uint32_t mip_level) const
+{
+    if (mip_level >= Mips.size())
+        return 0;
+    return Mips.back().Offset + Mips.back().Size - Mips[mip_level].Offset;
+}
+
+fxng::TextureInfo fxng::LoadTextureInfo(const std::filesystem::path &path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    common::Assert(stream.is_open(), "failed to open {}", path);
+
+    texture_header_t header{};
+    stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+    common::Assert(stream && header.magic == TextureMagic, "{} is not a texture file", path);
+    common::Assert(
+        header.version == TextureVersion,
+        "texture file {} has version {}, expected {}",
+        path,
+        header.version,
+        TextureVersion);
+    common::Assert(header.mip_count, "texture file {} has no mip levels", path);
+
+    TextureInfo info
+    {
+        .Format = static_cast<glal::ImageFormat>(header.format),
+        .Type = static_cast<glal::ImageType>(header.type),
+        .Extent = { .Width = header.width, .Height = header.height, .Depth = header.depth },
+        .Mips = std::vector<TextureMip>(header.mip_count),
+    };
+
+    for (auto &mip : info.Mips)
+    {
+        texture_mip_t entry{};
+        stream.read(reinterpret_cast<char *>(&entry), sizeof(entry));
+        common::Assert(!!stream, "truncated mip table in texture file {}", path);
+
+        mip = { .Offset = entry.offset, .Size = entry.size };
+    }
+
+    for (std::uint32_t i = 1; i < info.Mips.size(); ++i)
+        common::Assert(
+            info.Mips[i].Offset == info.Mips[i - 1].Offset + info.Mips[i - 1].Size,
+            "mip levels of texture file {} are not contiguous",
+            path);
+
+    return info;
+}
+
+std::vector<char> fxng::LoadTextureMips(
+    const std::filesystem::path &path,
+    const TextureInfo &info,
+    const std::uint32_t mip_level)
+{
+    common::Assert(mip_level < info.Mips.size(), "mip level {} is out of range for texture {}", mip_level, path);
+
+    std::ifstream stream(path, std::ios::binary);
+    common::Assert(stream.is_open(), "failed to open {}", path);
+
+    std::vector<char> data(info.GetChainSize(mip_level));
+    stream.seekg(static_cast<std::streamoff>(info.Mips[mip_level].Offset), std::ios::beg);
+    stream.read(data.data(), static_cast<std::streamsize>(data.size()));
+    common::Assert(!!stream, "truncated mip data in texture file {}", path);
+
+    return data;
+}
+
+void fxng::SaveTexture(
+    const std::filesystem::path &path,
+    const glal::ImageFormat format,
+    const glal::ImageType type,
+    const glal::Extent3D extent,
+    const std::vector<std::vector<char>> &mips)
+{
+    std::ofstream stream(path, std::ios::binary);
+    common::Assert(stream.is_open(), "failed to open {}", path);
+
+    const texture_header_t header
+    {
+        .magic = TextureMagic,
+        .version = TextureVersion,
+        .format = static_cast<std::uint32_t>(format),
+        .type = static_cast<std::uint32_t>(type),
+        .width = extent.Width,
+        .height = extent.Height,
+        .depth = extent.Depth,
+        .mip_count = static_cast<std::uint32_t>(mips.size()),
+    };
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    auto offset = static_cast<std::uint64_t>(sizeof(texture_header_t) + mips.size() * sizeof(texture_mip_t));
+    for (auto &mip : mips)
+    {
+        const texture_mip_t entry
+        {
+            .offset = offset,
+            .size = mip.size(),
+        };
+        stream.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+
+        offset += mip.size();
+    }
+
+    for (auto &mip : mips)
+        stream.write(mip.data(), static_cast<std::streamsize>(mip.size()));
+
+    common::Assert(!!stream, "failed to write texture file {}", path);
+}
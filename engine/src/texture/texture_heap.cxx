@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <common/log.hxx>
+#include <fxng/texture.hxx>
+
+fxng::TextureHeap::TextureHeap(glal::Device device, UploadManager &uploads, const TextureHeapConfig &config)
+    : m_Device(device),
+      m_Config(config),
+      m_Frame(0)
+{
+    common::Assert(
+        m_Device->Supports(glal::DeviceFeature_BindlessTextures),
+        "texture heaps require bindless texture support");
+    common::Assert(
+        m_Config.Capacity <= m_Device->GetLimits().MaxBindlessTextures,
+        "texture heap capacity {} exceeds the device limit of {}",
+        m_Config.Capacity,
+        m_Device->GetLimits().MaxBindlessTextures);
+    common::Assert(m_Config.FramesInFlight <= 32, "texture heaps track at most 32 frames in flight");
+
+    const glal::DescriptorBinding descriptor_binding
+    {
+        .Binding = TextureHeapBinding,
+        .Type = glal::DescriptorType_CombinedImageSampler,
+        .Count = m_Config.Capacity,
+        .Stages = static_cast<glal::ShaderStage>(glal::ShaderStage_Vertex | glal::ShaderStage_Fragment),
+        .Flags = static_cast<glal::DescriptorBindingFlag>(
+            glal::DescriptorBindingFlag_PartiallyBound | glal::DescriptorBindingFlag_UpdateAfterBind),
+    };
+
+    m_DescriptorSetLayout = m_Device->CreateDescriptorSetLayout(
+        {
+            .Set = TextureHeapSet,
+            .DescriptorBindings = &descriptor_binding,
+            .DescriptorBindingCount = 1,
+        });
+
+    for (std::uint32_t i = 0; i < m_Config.FramesInFlight; ++i)
+        m_DescriptorSets.push_back(m_Device->CreateDescriptorSet({ .Layout = m_DescriptorSetLayout }));
+
+    // a single white texel, freed and not yet resident indices point at it so every element stays a valid texture
+    m_PlaceholderImage = m_Device->CreateImage(
+        {
+            .Format = glal::ImageFormat_RGBA8_UNorm,
+            .Type = glal::ImageType_2D,
+            .Extent = { 1, 1, 1 },
+            .MipLevelCount = 1,
+            .ArrayLayerCount = 1,
+        });
+    m_PlaceholderView = m_Device->CreateImageView(
+        {
+            .Format = glal::ImageFormat_RGBA8_UNorm,
+            .Type = glal::ImageType_2D,
+            .ImageResource = m_PlaceholderImage,
+        });
+    m_PlaceholderSampler = m_Device->CreateSampler(
+        {
+            .MinFilter = glal::Filter_Nearest,
+            .MagFilter = glal::Filter_Nearest,
+            .AddressU = glal::AddressMode_Repeat,
+            .AddressV = glal::AddressMode_Repeat,
+            .AddressW = glal::AddressMode_Repeat,
+        });
+
+    constexpr std::uint32_t white = ~0u;
+    uploads.Wait(uploads.UploadImage(m_PlaceholderImage, 0, &white, sizeof(white)));
+}
+
+fxng::TextureHeap::~TextureHeap()
+{
+    for (const auto descriptor_set : m_DescriptorSets)
+        m_Device->DestroyDescriptorSet(descriptor_set);
+
+    m_Device->DestroyDescriptorSetLayout(m_DescriptorSetLayout);
+
+    m_Device->DestroySampler(m_PlaceholderSampler);
+    m_Device->DestroyImageView(m_PlaceholderView);
+    m_Device->DestroyImage(m_PlaceholderImage);
+}
+
+std::uint32_t fxng::TextureHeap::Allocate(glal::ImageView image_view, glal::Sampler sampler)
+{
+    std::uint32_t index;
+    if (m_FreeIndices.empty())
+    {
+        common::Assert(
+            m_Entries.size() < m_Config.Capacity,
+            "texture heap is full at {} textures",
+            m_Config.Capacity);
+
+        index = static_cast<std::uint32_t>(m_Entries.size());
+        m_Entries.emplace_back();
+    }
+    else
+    {
+        index = m_FreeIndices.back();
+        m_FreeIndices.pop_back();
+    }
+
+    m_Entries[index] = {
+        .Active = true,
+        .ImageView = nullptr,
+        .Sampler = nullptr,
+        .PendingSlots = 0,
+    };
+
+    Update(index, image_view, sampler);
+    return index;
+}
+
+void fxng::TextureHeap::Update(const std::uint32_t index, glal::ImageView image_view, glal::Sampler sampler)
+{
+    Write(At(index), index, image_view, sampler);
+}
+
+void fxng::TextureHeap::Free(const std::uint32_t index)
+{
+    auto &entry = At(index);
+
+    // the sets have to let go of the image view, the opengl backend keeps its bindless handle resident until then
+    Write(entry, index, nullptr, nullptr);
+    entry.Active = false;
+
+    m_Retired.push_back({ .Frame = m_Frame, .Index = index });
+}
+
+void fxng::TextureHeap::BeginFrame(const std::uint32_t frame_index)
+{
+    ++m_Frame;
+
+    const auto descriptor_set = m_DescriptorSets.at(frame_index);
+    const auto slot_bit = 1u << frame_index;
+
+    std::erase_if(
+        m_Pending,
+        [this, descriptor_set, slot_bit](const std::uint32_t index)
+        {
+            auto &entry = m_Entries[index];
+            if (entry.PendingSlots & slot_bit)
+            {
+                descriptor_set->BindImageView(TextureHeapBinding, index, entry.ImageView, entry.Sampler);
+                entry.PendingSlots &= ~slot_bit;
+            }
+            return !entry.PendingSlots;
+        });
+
+    std::erase_if(
+        m_Retired,
+        [this](const RetiredIndex &retired)
+        {
+            if (retired.Frame + m_Config.FramesInFlight > m_Frame)
+                return false;
+
+            m_FreeIndices.push_back(retired.Index);
+            return true;
+        });
+}
+
+glal::DescriptorSetLayout fxng::TextureHeap::GetDescriptorSetLayout() const
+{
+    return m_DescriptorSetLayout;
+}
+
+glal::DescriptorSet fxng::TextureHeap::GetDescriptorSet(const std::uint32_t frame_index) const
+{
+    return m_DescriptorSets.at(frame_index);
+}
+
+std::uint32_t fxng::TextureHeap::GetCapacity() const
+{
+    return m_Config.Capacity;
+}
+
+fxng::TextureHeap::HeapEntry &fxng::TextureHeap::At(const std::uint32_t index)
+{
+    common::Assert(
+        index < m_Entries.size() && m_Entries[index].Active,
+        "texture heap index {} is not allocated",
+        index);
+    return m_Entries[index];
+}
+
+void fxng::TextureHeap::Write(
+    HeapEntry &entry,
+    const std::uint32_t index,
+    glal::ImageView image_view,
+    glal::Sampler sampler)
+{
+    if (!entry.PendingSlots)
+        m_Pending.push_back(index);
+
+    entry.ImageView = image_view ? image_view : m_PlaceholderView;
+    entry.Sampler = sampler ? sampler : m_PlaceholderSampler;
+    entry.PendingSlots = static_cast<std::uint32_t>((1ull << m_Config.FramesInFlight) - 1);
+}
@@ -0,0 +1,349 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <common/log.hxx>
+#include <fxng/texture.hxx>
+
+static std::uint32_t get_max_dimension(const glal::Extent3D extent)
+{
+    return std::max(extent.Width, std::max(extent.Height, extent.Depth));
+}
+
+fxng::TextureStreamer::TextureStreamer(glal::Device device, UploadManager &uploads, const TextureStreamerConfig &config)
+    : m_Device(device),
+      m_Uploads(uploads),
+      m_Config(config),
+      m_Frame(0)
+{
+}
+
+fxng::TextureStreamer::~TextureStreamer()
+{
+    for (auto &texture : m_Textures)
+    {
+        if (texture.Load.valid())
+            texture.LoadTicket = texture.Load.get();
+
+        if (texture.LoadImage)
+        {
+            m_Uploads.Wait(texture.LoadTicket);
+            m_Device->DestroyImage(texture.LoadImage);
+        }
+
+        if (texture.View)
+            m_Device->DestroyImageView(texture.View);
+        if (texture.Image)
+            m_Device->DestroyImage(texture.Image);
+    }
+
+    DestroyRetired(true);
+}
+
+fxng::TextureHandle fxng::TextureStreamer::Register(const std::filesystem::path &path)
+{
+    TextureHandle handle;
+    if (m_FreeTextures.empty())
+    {
+        handle = static_cast<TextureHandle>(m_Textures.size());
+        m_Textures.emplace_back();
+    }
+    else
+    {
+        handle = m_FreeTextures.back();
+        m_FreeTextures.pop_back();
+    }
+
+    auto &texture = m_Textures[handle];
+    texture.Active = true;
+    texture.Path = path;
+    texture.Info = LoadTextureInfo(path);
+
+    const auto mip_count = static_cast<std::uint32_t>(texture.Info.Mips.size());
+
+    // the tail starts at the first level small enough, textures smaller than the tail size are resident as a whole
+    texture.TailMipLevel = mip_count - 1;
+    for (std::uint32_t i = 0; i < mip_count; ++i)
+        if (get_max_dimension(texture.Info.GetMipExtent(i)) <= m_Config.MipTailSize)
+        {
+            texture.TailMipLevel = i;
+            break;
+        }
+
+    texture.ResidentMipLevel = mip_count;
+    texture.TargetMipLevel = texture.TailMipLevel;
+    texture.Coverage = 0.f;
+    texture.LastRequestFrame = m_Frame;
+    texture.Image = nullptr;
+    texture.View = nullptr;
+
+    StartLoad(texture, texture.TailMipLevel);
+
+    return handle;
+}
+
+void fxng::TextureStreamer::Unregister(const TextureHandle texture)
+{
+    auto &streamed_texture = At(texture);
+
+    if (streamed_texture.Load.valid())
+        streamed_texture.LoadTicket = streamed_texture.Load.get();
+
+    // the gpu may still sample the image this frame
+    Retire(
+        {
+            .Frame = m_Frame,
+            .Ticket = 0,
+            .Image = streamed_texture.Image,
+            .View = streamed_texture.View,
+        });
+
+    // an unfinished upload still writes into its image
+    if (streamed_texture.LoadImage)
+        Retire(
+            {
+                .Frame = m_Frame,
+                .Ticket = streamed_texture.LoadTicket,
+                .Image = streamed_texture.LoadImage,
+                .View = nullptr,
+            });
+
+    streamed_texture = {};
+    m_FreeTextures.push_back(texture);
+}
+
+void fxng::TextureStreamer::Request(const TextureHandle texture, const float coverage)
+{
+    auto &streamed_texture = At(texture);
+    streamed_texture.Coverage = std::max(streamed_texture.Coverage, coverage);
+    streamed_texture.LastRequestFrame = m_Frame;
+}
+
+void fxng::TextureStreamer::Update()
+{
+    DestroyRetired(false);
+
+    SelectTargets();
+    FinishUploads();
+    StartLoads();
+
+    ++m_Frame;
+}
+
+glal::ImageView fxng::TextureStreamer::GetImageView(const TextureHandle texture) const
+{
+    return At(texture).View;
+}
+
+std::uint32_t fxng::TextureStreamer::GetResidentMipLevel(const TextureHandle texture) const
+{
+    return At(texture).ResidentMipLevel;
+}
+
+std::uint64_t fxng::TextureStreamer::GetResidentSize() const
+{
+    std::uint64_t size = 0;
+    for (auto &texture : m_Textures)
+        if (texture.Active)
+            size += texture.Info.GetChainSize(texture.ResidentMipLevel);
+    return size;
+}
+
+fxng::StreamedTexture &fxng::TextureStreamer::At(const TextureHandle texture)
+{
+    common::Assert(
+        texture < m_Textures.size() && m_Textures[texture].Active,
+        "texture {} is not registered",
+        texture);
+    return m_Textures[texture];
+}
+
+const fxng::StreamedTexture &fxng::TextureStreamer::At(const TextureHandle texture) const
+{
+    common::Assert(
+        texture < m_Textures.size() && m_Textures[texture].Active,
+        "texture {} is not registered",
+        texture);
+    return m_Textures[texture];
+}
+
+void fxng::TextureStreamer::SelectTargets()
+{
+    std::vector<TextureHandle> order;
+    order.reserve(m_Textures.size());
+
+    // the tails are never evicted, only what lies above them competes for the budget
+    std::uint64_t used = 0;
+    for (TextureHandle i = 0; i < m_Textures.size(); ++i)
+        if (m_Textures[i].Active)
+        {
+            order.push_back(i);
+            used += m_Textures[i].Info.GetChainSize(m_Textures[i].TailMipLevel);
+        }
+
+    // textures seen this frame go first by coverage, the rest by how recently they were needed
+    std::sort(
+        order.begin(),
+        order.end(),
+        [&](const TextureHandle a, const TextureHandle b)
+        {
+            auto &texture_a = m_Textures[a];
+            auto &texture_b = m_Textures[b];
+            if (texture_a.LastRequestFrame != texture_b.LastRequestFrame)
+                return texture_a.LastRequestFrame > texture_b.LastRequestFrame;
+            return texture_a.Coverage > texture_b.Coverage;
+        });
+
+    for (const auto handle : order)
+    {
+        auto &texture = m_Textures[handle];
+
+        // one texel per pixel: every halving of the coverage drops one mip level. textures that were not requested
+        // keep what they have until the budget is needed elsewhere
+        auto desired = std::min(texture.ResidentMipLevel, texture.TailMipLevel);
+        if (texture.LastRequestFrame == m_Frame)
+        {
+            desired = texture.TailMipLevel;
+            if (texture.Coverage > 0.f)
+            {
+                const auto ratio = static_cast<float>(get_max_dimension(texture.Info.Extent)) / texture.Coverage;
+                const auto level = ratio > 1.f ? static_cast<std::uint32_t>(std::floor(std::log2(ratio))) : 0u;
+                desired = std::min(level, texture.TailMipLevel);
+            }
+        }
+
+        const auto tail_size = texture.Info.GetChainSize(texture.TailMipLevel);
+
+        auto level = desired;
+        while (level < texture.TailMipLevel && used + texture.Info.GetChainSize(level) - tail_size > m_Config.Budget)
+            ++level;
+
+        used += texture.Info.GetChainSize(level) - tail_size;
+
+        texture.TargetMipLevel = level;
+        texture.Coverage = 0.f;
+    }
+}
+
+void fxng::TextureStreamer::StartLoads()
+{
+    std::uint32_t loads = 0;
+    for (auto &texture : m_Textures)
+        loads += texture.LoadImage != nullptr;
+
+    for (auto &texture : m_Textures)
+    {
+        if (loads >= m_Config.MaxLoads)
+            break;
+
+        if (!texture.Active || texture.LoadImage || !texture.Image)
+            continue;
+        if (texture.ResidentMipLevel == texture.TargetMipLevel)
+            continue;
+
+        // refine one level at a time so the texture sharpens progressively, evict straight to the target
+        StartLoad(
+            texture,
+            texture.TargetMipLevel < texture.ResidentMipLevel
+                ? texture.ResidentMipLevel - 1
+                : texture.TargetMipLevel);
+
+        ++loads;
+    }
+}
+
+void fxng::TextureStreamer::StartLoad(StreamedTexture &texture, const std::uint32_t mip_level)
+{
+    const auto mip_count = static_cast<std::uint32_t>(texture.Info.Mips.size()) - mip_level;
+
+    // the image is created here on the render thread, the worker only reads the file and fills the upload ring
+    texture.LoadImage = m_Device->CreateImage(
+        {
+            .Format = texture.Info.Format,
+            .Type = texture.Info.Type,
+            .Extent = texture.Info.GetMipExtent(mip_level),
+            .MipLevelCount = mip_count,
+            .ArrayLayerCount = 1,
+        });
+    texture.LoadMipLevel = mip_level;
+    texture.LoadTicket = 0;
+    texture.Load = std::async(
+        std::launch::async,
+        [&uploads = m_Uploads, path = texture.Path, info = texture.Info, mip_level, image = texture.LoadImage]
+        {
+            const auto data = LoadTextureMips(path, info, mip_level);
+            const auto base_offset = info.Mips[mip_level].Offset;
+
+            UploadTicket ticket = 0;
+            for (auto i = mip_level; i < info.Mips.size(); ++i)
+                ticket = uploads.UploadImage(
+                    image,
+                    i - mip_level,
+                    data.data() + (info.Mips[i].Offset - base_offset),
+                    info.Mips[i].Size);
+            return ticket;
+        });
+}
+
+void fxng::TextureStreamer::FinishUploads()
+{
+    for (auto &texture : m_Textures)
+    {
+        if (!texture.Active || !texture.LoadImage)
+            continue;
+
+        if (texture.Load.valid())
+        {
+            if (texture.Load.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                continue;
+            texture.LoadTicket = texture.Load.get();
+        }
+
+        if (!m_Uploads.IsComplete(texture.LoadTicket))
+            continue;
+
+        // the target may have moved while loading, the loaded chain is still a valid residency step
+        const auto view = m_Device->CreateImageView(
+            {
+                .Format = texture.Info.Format,
+                .Type = texture.Info.Type,
+                .ImageResource = texture.LoadImage,
+            });
+
+        Retire(
+            {
+                .Frame = m_Frame,
+                .Ticket = 0,
+                .Image = texture.Image,
+                .View = texture.View,
+            });
+
+        texture.Image = texture.LoadImage;
+        texture.View = view;
+        texture.ResidentMipLevel = texture.LoadMipLevel;
+        texture.LoadImage = nullptr;
+    }
+}
+
+void fxng::TextureStreamer::Retire(const RetiredResources &resources)
+{
+    m_Retired.push_back(resources);
+}
+
+void fxng::TextureStreamer::DestroyRetired(const bool all)
+{
+    std::erase_if(
+        m_Retired,
+        [&](const RetiredResources &resources)
+        {
+            if (!all && (resources.Frame + m_Config.FramesInFlight > m_Frame || !m_Uploads.IsComplete(resources.Ticket)))
+                return false;
+            if (all)
+                m_Uploads.Wait(resources.Ticket);
+
+            if (resources.View)
+                m_Device->DestroyImageView(resources.View);
+            if (resources.Image)
+                m_Device->DestroyImage(resources.Image);
+            return true;
+        });
+}
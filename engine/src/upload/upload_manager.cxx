@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <cstring>
+#include <common/log.hxx>
+#include <fxng/upload.hxx>
+
+/**
+ * staging offsets are aligned for every texel block size and the copy offset rules of both backends
+ */
+static constexpr std::uint64_t copy_alignment = 16;
+
+fxng::UploadManager::UploadManager(glal::Device device, const UploadManagerConfig &config)
+    : m_Device(device),
+      m_Config(config),
+      m_Queue(device->GetQueue(glal::QueueType_Transfer)),
+      m_SubmitThread(std::this_thread::get_id()),
+      m_Ring(),
+      m_RingData(),
+      m_Head(0),
+      m_Tail(0),
+      m_Writers(0),
+      m_OpenTicket(1),
+      m_CompletedTicket(0)
+{
+    common::Assert(
+        m_Config.RingSize && m_Config.RingSize % copy_alignment == 0,
+        "upload ring size {} is not a multiple of {}",
+        m_Config.RingSize,
+        copy_alignment);
+    common::Assert(m_Config.MaxBatches, "the upload manager needs at least one batch");
+
+    m_Ring = m_Device->CreateBuffer(
+        {
+            .Size = m_Config.RingSize,
+            .Usage = glal::BufferUsage_Staging,
+            .Memory = glal::MemoryUsage_HostToDevice,
+        });
+    m_RingData = static_cast<char *>(m_Ring->Map());
+
+    for (std::uint32_t i = 0; i < m_Config.MaxBatches; ++i)
+        m_FreeBatches.push_back(
+            {
+                .Ticket = 0,
+                .RingEnd = 0,
+                .CommandBuffer = m_Device->CreateCommandBuffer(glal::CommandBufferUsage_Once, glal::QueueType_Transfer),
+                .Fence = m_Device->CreateFence(),
+            });
+}
+
+fxng::UploadManager::~UploadManager()
+{
+    {
+        std::unique_lock lock(m_Mutex);
+        m_Condition.wait(
+            lock,
+            [this]
+            {
+                return !m_Writers;
+            });
+
+        while (!m_Pending.empty())
+        {
+            if (m_FreeBatches.empty())
+                Retire(m_InFlight.front().Ticket);
+            Submit();
+        }
+
+        if (!m_InFlight.empty())
+            Retire(m_InFlight.back().Ticket);
+    }
+
+    for (auto &batch : m_FreeBatches)
+    {
+        m_Device->DestroyCommandBuffer(batch.CommandBuffer);
+        m_Device->DestroyFence(batch.Fence);
+    }
+
+    m_Ring->Unmap();
+    m_Device->DestroyBuffer(m_Ring);
+}
+
+fxng::UploadTicket fxng::UploadManager::UploadBuffer(
+    glal::Buffer dst_buffer,
+    const std::size_t dst_offset,
+    const void *data,
+    const std::size_t size)
+{
+    const auto max_part_size = static_cast<std::size_t>(m_Config.RingSize / 4);
+
+    auto ticket = m_CompletedTicket.load();
+    for (std::size_t offset = 0; offset < size; offset += max_part_size)
+    {
+        const auto part_size = std::min(max_part_size, size - offset);
+        ticket = Copy(
+            {
+                .DstBuffer = dst_buffer,
+                .DstImage = nullptr,
+                .SrcOffset = 0,
+                .DstOffset = dst_offset + offset,
+                .Size = part_size,
+                .MipLevel = 0,
+            },
+            static_cast<const char *>(data) + offset);
+    }
+    return ticket;
+}
+
+fxng::UploadTicket fxng::UploadManager::UploadImage(
+    glal::Image dst_image,
+    const std::uint32_t mip_level,
+    const void *data,
+    const std::size_t size)
+{
+    // mip levels are copied in one piece and never wrap, beyond half the ring the padding could exceed the ring
+    common::Assert(
+        size <= m_Config.RingSize / 2,
+        "image upload of {} bytes exceeds half the upload ring of {} bytes",
+        size,
+        m_Config.RingSize);
+
+    return Copy(
+        {
+            .DstBuffer = nullptr,
+            .DstImage = dst_image,
+            .SrcOffset = 0,
+            .DstOffset = 0,
+            .Size = size,
+            .MipLevel = mip_level,
+        },
+        data);
+}
+
+void fxng::UploadManager::Flush()
+{
+    std::lock_guard lock(m_Mutex);
+
+    Retire(0);
+    Submit();
+}
+
+bool fxng::UploadManager::IsComplete(const UploadTicket ticket) const
+{
+    return ticket <= m_CompletedTicket.load();
+}
+
+void fxng::UploadManager::Wait(const UploadTicket ticket)
+{
+    std::unique_lock lock(m_Mutex);
+
+    if (ticket >= m_OpenTicket)
+    {
+        // writers of the open batch have to finish their memcpy before it can be closed
+        m_Condition.wait(
+            lock,
+            [this]
+            {
+                return !m_Writers;
+            });
+
+        if (m_FreeBatches.empty())
+            Retire(m_InFlight.front().Ticket);
+        Submit();
+    }
+
+    Retire(ticket);
+}
+
+fxng::UploadTicket fxng::UploadManager::Copy(const PendingCopy &copy, const void *data)
+{
+    std::unique_lock lock(m_Mutex);
+
+    const auto position = Allocate(lock, copy.Size);
+    const auto offset = static_cast<std::size_t>(position % m_Config.RingSize);
+
+    // the open batch cannot be submitted while a writer is active, so the ticket stays valid until the copy is queued
+    ++m_Writers;
+    lock.unlock();
+
+    std::memcpy(m_RingData + offset, data, copy.Size);
+
+    lock.lock();
+    --m_Writers;
+
+    auto &pending = m_Pending.emplace_back(copy);
+    pending.SrcOffset = offset;
+
+    const auto ticket = m_OpenTicket;
+    lock.unlock();
+
+    m_Condition.notify_all();
+    return ticket;
+}
+
+std::uint64_t fxng::UploadManager::Allocate(std::unique_lock<std::mutex> &lock, const std::size_t size)
+{
+    for (;;)
+    {
+        // nothing in the ring references staging memory, start over at its beginning so large copies fit again
+        if (m_InFlight.empty() && m_Pending.empty() && !m_Writers)
+            m_Head = m_Tail = 0;
+
+        auto position = (m_Head + copy_alignment - 1) / copy_alignment * copy_alignment;
+
+        // copies never wrap around the end of the ring
+        if (const auto offset = position % m_Config.RingSize; offset + size > m_Config.RingSize)
+            position += m_Config.RingSize - offset;
+
+        if (position + size - m_Tail <= m_Config.RingSize)
+        {
+            m_Head = position + size;
+            return position;
+        }
+
+        // other threads wait for the submitting thread to release space with its next flush
+        if (std::this_thread::get_id() != m_SubmitThread)
+        {
+            m_Condition.wait(lock);
+            continue;
+        }
+
+        // the submitting thread would wait for itself, it has to release space on its own. writers of the open
+        // batch only finish their memcpy, they never wait for this thread
+        if (m_Writers)
+        {
+            m_Condition.wait(
+                lock,
+                [this]
+                {
+                    return !m_Writers;
+                });
+            continue;
+        }
+
+        if (!m_Pending.empty())
+        {
+            if (m_FreeBatches.empty())
+                Retire(m_InFlight.front().Ticket);
+            Submit();
+            continue;
+        }
+
+        common::Assert(
+            !m_InFlight.empty(),
+            "copy of {} bytes does not fit into the empty upload ring of {} bytes",
+            size,
+            m_Config.RingSize);
+        Retire(m_InFlight.front().Ticket);
+    }
+}
+
+void fxng::UploadManager::Retire(const UploadTicket wait_ticket)
+{
+    auto released = false;
+    while (!m_InFlight.empty())
+    {
+        auto &batch = m_InFlight.front();
+        if (!batch.Fence->IsSignaled())
+        {
+            if (batch.Ticket > wait_ticket)
+                break;
+            batch.Fence->Wait();
+        }
+
+        m_Tail = batch.RingEnd;
+        m_CompletedTicket = batch.Ticket;
+
+        m_FreeBatches.push_back(batch);
+        m_InFlight.pop_front();
+        released = true;
+    }
+
+    if (released)
+        m_Condition.notify_all();
+}
+
+bool fxng::UploadManager::Submit()
+{
+    if (m_Pending.empty() || m_Writers || m_FreeBatches.empty())
+        return false;
+
+    auto batch = m_FreeBatches.back();
+    m_FreeBatches.pop_back();
+
+    batch.Ticket = m_OpenTicket++;
+    batch.RingEnd = m_Head;
+
+    const auto command_buffer = batch.CommandBuffer;
+    command_buffer->Begin();
+    for (auto &copy : m_Pending)
+    {
+        if (copy.DstImage)
+        {
+            command_buffer->Transition(copy.DstImage, glal::ResourceState_CopyDst);
+            command_buffer->CopyBufferToImage(m_Ring, copy.DstImage, copy.SrcOffset, copy.MipLevel);
+            command_buffer->Transition(copy.DstImage, glal::ResourceState_ShaderResource);
+            continue;
+        }
+
+        command_buffer->CopyBuffer(m_Ring, copy.DstBuffer, copy.SrcOffset, copy.DstOffset, copy.Size);
+    }
+    command_buffer->End();
+
+    m_Pending.clear();
+
+    batch.Fence->Reset();
+    m_Queue->Submit(&command_buffer, 1, batch.Fence);
+
+    m_InFlight.push_back(batch);
+    return true;
+}
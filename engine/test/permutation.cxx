@@ -0,0 +1,98 @@
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <fxng/permutation.hxx>
+#include <glal/null.hxx>
+
+static constexpr auto compile_time = std::chrono::milliseconds(200);
+static constexpr auto ready_timeout = std::chrono::seconds(5);
+
+static int failures = 0;
+
+static void check(const bool condition, const char *description)
+{
+    std::printf("%s: %s\n", condition ? "pass" : "FAIL", description);
+    if (!condition)
+        ++failures;
+}
+
+/**
+ * a fragment module declaring the diffuse texture feature: OpName %1 "A", OpDecorate %1 SpecId 0, OpTypeBool %2,
+ * OpSpecConstantFalse %2 %1
+ */
+static constexpr std::uint32_t fragment_code[]
+{
+    0x07230203, 0x00010000, 0, 3, 0,
+    (3u << 16) | 5, 1, 'A',
+    (4u << 16) | 71, 1, 1, 0,
+    (2u << 16) | 20, 2,
+    (3u << 16) | 49, 2, 1,
+};
+
+int main()
+{
+    const auto instance = glal::CreateInstanceNull({});
+
+    glal::PhysicalDevice physical_device;
+    instance->EnumeratePhysicalDevices(&physical_device);
+
+    const auto device = physical_device->CreateDevice();
+    dynamic_cast<glal::null::DeviceT *>(device)->SetPipelineCompileTime(compile_time);
+
+    const glal::ShaderModuleDesc module_desc
+    {
+        .Stage = glal::ShaderStage_Fragment,
+        .Code = fragment_code,
+        .Size = sizeof(fragment_code),
+    };
+    const auto reflection = glal::Reflect(module_desc);
+    const auto module = device->CreateShaderModule(module_desc);
+
+    check(reflection.FindSpecializationConstant(0), "the module declares the diffuse texture feature");
+
+    {
+        const glal::PipelineStage stage
+        {
+            .Stage = glal::ShaderStage_Fragment,
+            .Module = module,
+        };
+        fxng::PipelinePermutations permutations(
+            device,
+            {
+                .Type = glal::PipelineType_Graphics,
+                .Stages = &stage,
+                .StageCount = 1,
+            },
+            &reflection,
+            1);
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto pipeline = permutations.Get(fxng::MaterialFeature_DiffuseTexture);
+        const auto get_time = std::chrono::steady_clock::now() - start;
+
+        check(get_time < compile_time, "Get returns before the variant has compiled");
+        check(pipeline->GetStatus() == glal::PipelineStatus_Pending, "a new variant is pending");
+
+        check(
+            permutations.Get(fxng::MaterialFeature_DiffuseTexture) == pipeline,
+            "a pending variant is not compiled again");
+        check(pipeline->GetStatus() == glal::PipelineStatus_Pending, "the variant stays pending while it compiles");
+
+        auto status = pipeline->GetStatus();
+        while (status == glal::PipelineStatus_Pending && std::chrono::steady_clock::now() - start < ready_timeout)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            status = pipeline->GetStatus();
+        }
+
+        check(status == glal::PipelineStatus_Ready, "the variant becomes ready");
+        check(std::chrono::steady_clock::now() - start >= compile_time, "the variant is not ready before it compiled");
+        check(permutations.GetVariantCount() == 1, "a single variant was created");
+    }
+
+    device->DestroyShaderModule(module);
+    physical_device->DestroyDevice(device);
+    glal::DestroyInstance(instance);
+
+    return failures ? 1 : 0;
+}
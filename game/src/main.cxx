@@ -3,9 +3,12 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <common/log.hxx>
 #include <fxng/engine.hxx>
+#include <fxng/frame.hxx>
 #include <glal/glal.hxx>
+#include <glal/reflect.hxx>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 
@@ -29,6 +32,8 @@ struct UniformBufferObject
     glm::mat4 proj;
 };
 
+static constexpr std::uint32_t frames_in_flight = 2;
+
 static constexpr Vertex vertices[] = {
     { { 0.0f, 0.57735027f }, { 1, 0, 0 } },
     { { -0.5f, -0.28867513f }, { 0, 1, 0 } },
@@ -38,7 +43,8 @@ static constexpr Vertex vertices[] = {
 static glal::ShaderModule load_shader_module(
     glal::Device device,
     glal::ShaderStage stage,
-    std::filesystem::path path)
+    std::filesystem::path path,
+    glal::ShaderReflection &reflection)
 {
     std::ifstream stream(path, std::ios::binary | std::ios::ate);
     common::Assert(stream.is_open(), "failed to open file {}", path);
@@ -47,25 +53,33 @@ static glal::ShaderModule load_shader_module(
     stream.seekg(0, std::ios::beg);
     stream.read(code.data(), static_cast<long>(code.size()));
 
-    return device->CreateShaderModule(
-        {
-            .Stage = stage,
-            .Code = code.data(),
-            .Size = code.size(),
-        });
+    const glal::ShaderModuleDesc desc
+    {
+        .Stage = stage,
+        .Code = code.data(),
+        .Size = code.size(),
+    };
+
+    reflection = glal::Reflect(desc);
+    return device->CreateShaderModule(desc);
 }
 
 struct
 {
     glal::Device device;
     glal::Swapchain swapchain;
+    fxng::FramePacer *frame_pacer;
 } static application_state = {
     .device = nullptr,
     .swapchain = nullptr,
+    .frame_pacer = nullptr,
 };
 
 static void glfw_framebuffer_size_callback(GLFWwindow *window, const int width, const int height)
 {
+    // frames in flight may still render to the old images
+    application_state.frame_pacer->WaitIdle();
+
     application_state.device->DestroySwapchain(application_state.swapchain);
     application_state.swapchain = application_state.device->CreateSwapchain(
         {
@@ -109,6 +123,7 @@ int main()
     {
         .EnableValidation = true,
         .ApplicationName = "Hello World",
+        .PipelineCachePath = "pipeline.cache",
     };
 
 #if 1
@@ -143,34 +158,29 @@ int main()
             .ImageCount = 2,
         });
 
-    const std::array descriptor_bindings
-    {
-        glal::DescriptorBinding
-        {
-            .Binding = 0,
-            .Type = glal::DescriptorType_UniformBuffer,
-            .Count = 1,
-            .Stages = glal::ShaderStage_Vertex,
-        },
-    };
+    const std::filesystem::path shader_binary_dir = FXNG_SHADER_BINARY_DIR;
 
-    const auto descriptor_set_layout = device->CreateDescriptorSetLayout(
-        {
-            .Set = 0,
-            .DescriptorBindings = descriptor_bindings.data(),
-            .DescriptorBindingCount = descriptor_bindings.size(),
-        });
+    std::array<glal::ShaderReflection, 2> shader_reflections;
 
-    const auto pipeline_layout = device->CreatePipelineLayout(
-        {
-            .DescriptorSetLayouts = &descriptor_set_layout,
-            .DescriptorSetLayoutCount = 1,
-        });
+    const auto vertex_shader = load_shader_module(
+        device,
+        glal::ShaderStage_Vertex,
+        shader_binary_dir / "vertex.spv",
+        shader_reflections[0]);
+    const auto fragment_shader = load_shader_module(
+        device,
+        glal::ShaderStage_Fragment,
+        shader_binary_dir / "fragment.spv",
+        shader_reflections[1]);
+
+    glal::LayoutCache layout_cache(device);
 
-    const auto descriptor_set = device->CreateDescriptorSet({ .Layout = descriptor_set_layout });
+    const auto pipeline_layout = layout_cache.GetPipelineLayout(shader_reflections.data(), shader_reflections.size());
 
-    const auto vertex_shader = load_shader_module(device, glal::ShaderStage_Vertex, "vertex.spv");
-    const auto fragment_shader = load_shader_module(device, glal::ShaderStage_Fragment, "fragment.spv");
+    const auto uniform_binding = shader_reflections[0].FindBinding("UniformBufferObject");
+    common::Assert(
+        uniform_binding && uniform_binding->Block.Size == sizeof(UniformBufferObject),
+        "uniform block does not match UniformBufferObject");
 
     const std::array pipeline_stages
     {
@@ -186,35 +196,9 @@ int main()
         },
     };
 
-    const std::array vertex_bindings
-    {
-        glal::VertexBinding
-        {
-            .Binding = 0,
-            .Stride = sizeof(Vertex),
-            .Instance = false,
-        },
-    };
-
-    const std::array vertex_attributes
-    {
-        glal::VertexAttribute
-        {
-            .Binding = 0,
-            .Location = 0,
-            .Type = glal::DataType_Float,
-            .Count = 2,
-            .Offset = offsetof(Vertex, position),
-        },
-        glal::VertexAttribute
-        {
-            .Binding = 0,
-            .Location = 1,
-            .Type = glal::DataType_Float,
-            .Count = 3,
-            .Offset = offsetof(Vertex, color),
-        },
-    };
+    std::vector<glal::VertexAttribute> vertex_attributes;
+    const auto vertex_binding = glal::DeriveVertexInput(shader_reflections[0], 0, vertex_attributes);
+    common::Assert(vertex_binding.Stride == sizeof(Vertex), "vertex input does not match Vertex");
 
     const glal::Attachment color_attachment
     {
@@ -231,17 +215,19 @@ int main()
             .AttachmentCount = 1,
         });
 
-    const auto pipeline = device->CreatePipeline(
+    const auto pipeline = device->CreatePipelineAsync(
         {
             .Type = glal::PipelineType_Graphics,
             .Stages = pipeline_stages.data(),
             .StageCount = pipeline_stages.size(),
-            .VertexBindings = vertex_bindings.data(),
-            .VertexBindingCount = vertex_bindings.size(),
+            .VertexBindings = &vertex_binding,
+            .VertexBindingCount = 1,
             .VertexAttributes = vertex_attributes.data(),
-            .VertexAttributeCount = vertex_attributes.size(),
+            .VertexAttributeCount = static_cast<std::uint32_t>(vertex_attributes.size()),
             .Topology = glal::VertexTopology_TriangleList,
             .PrimitiveRestartEnable = false,
+            .Culling = glal::CullMode_None,
+            .Winding = glal::FrontFace_CounterClockwise,
             .Layout = pipeline_layout,
             .Pass = render_pass,
             .DepthTest = false,
@@ -249,14 +235,39 @@ int main()
             .BlendEnable = false,
         });
 
-    const auto uniform_buffer = device->CreateBuffer(
+    auto frame_pacer = std::make_unique<fxng::FramePacer>(
+        device,
+        fxng::FramePacerConfig
         {
-            .Size = sizeof(UniformBufferObject),
-            .Usage = glal::BufferUsage_Storage,
-            .Memory = glal::MemoryUsage_HostToDevice,
+            .FramesInFlight = frames_in_flight,
+            .LowLatency = false,
         });
+    application_state.frame_pacer = frame_pacer.get();
 
-    descriptor_set->BindBuffer(0, uniform_buffer);
+    // everything the cpu writes per frame exists once per frame in flight
+    struct
+    {
+        glal::Buffer uniform_buffer;
+        glal::DescriptorSet descriptor_set;
+        glal::CommandBuffer command_buffer;
+        glal::Framebuffer framebuffer;
+    } frames[frames_in_flight];
+
+    for (auto &frame : frames)
+    {
+        frame.uniform_buffer = device->CreateBuffer(
+            {
+                .Size = sizeof(UniformBufferObject),
+                .Usage = glal::BufferUsage_Storage,
+                .Memory = glal::MemoryUsage_HostToDevice,
+            });
+        frame.descriptor_set = device->CreateDescriptorSet({ .Layout = pipeline_layout->GetDescriptorSetLayout(0) });
+        frame.descriptor_set->BindBuffer(0, frame.uniform_buffer);
+        frame.command_buffer = device->CreateCommandBuffer(
+            glal::CommandBufferUsage_Reusable,
+            glal::QueueType_Graphics);
+        frame.framebuffer = nullptr;
+    }
 
     const auto vertex_buffer = device->CreateBuffer(
         {
@@ -271,12 +282,13 @@ int main()
         vertex_buffer->Unmap();
     }
 
-    const auto command_buffer = device->CreateCommandBuffer(glal::CommandBufferUsage_Reusable);
-    const auto fence = device->CreateFence();
-
     const auto start_time = std::chrono::high_resolution_clock::now();
     while (!glfwWindowShouldClose(window))
     {
+        // wait for a free frame before polling, so the input is as fresh as possible when the frame is recorded
+        auto &frame = frames[frame_pacer->BeginFrame()];
+        const auto command_buffer = frame.command_buffer;
+
         glfwPollEvents();
 
         const auto current_time = std::chrono::high_resolution_clock::now();
@@ -296,15 +308,19 @@ int main()
         };
 
         {
-            const auto mapped = uniform_buffer->Map();
+            const auto mapped = frame.uniform_buffer->Map();
             std::memcpy(mapped, &uniform_buffer_object, sizeof(uniform_buffer_object));
-            uniform_buffer->Unmap();
+            frame.uniform_buffer->Unmap();
         }
 
-        const auto image_index = swapchain->AcquireNextImage(fence);
+        const auto image_index = frame_pacer->AcquireImage(swapchain);
         const auto image_view = swapchain->GetImageView(image_index);
 
-        const auto framebuffer = device->CreateFramebuffer(
+        // the gpu finished with the framebuffer of this slot when BeginFrame returned
+        if (frame.framebuffer)
+            device->DestroyFramebuffer(frame.framebuffer);
+
+        const auto framebuffer = frame.framebuffer = device->CreateFramebuffer(
             {
                 .Attachments = &image_view,
                 .AttachmentCount = 1,
@@ -327,21 +343,35 @@ int main()
             0,
             swapchain->GetExtent().Width,
             swapchain->GetExtent().Height);
-        command_buffer->BindPipeline(pipeline);
-        command_buffer->BindDescriptorSets(0, 1, &descriptor_set);
-        command_buffer->BindVertexBuffer(vertex_buffer, 0, 0);
-        command_buffer->Draw(sizeof(vertices) / sizeof(Vertex), 0);
+        // keep presenting cleared frames until the pipeline finished compiling in the background
+        if (pipeline->GetStatus() == glal::PipelineStatus_Ready)
+        {
+            command_buffer->BindPipeline(pipeline);
+            command_buffer->BindDescriptorSets(0, 1, &frame.descriptor_set, 0, nullptr);
+            command_buffer->BindVertexBuffer(vertex_buffer, 0, 0);
+            command_buffer->Draw(sizeof(vertices) / sizeof(Vertex), 0);
+        }
         command_buffer->EndRenderPass();
 
         command_buffer->Transition(image_view->GetImage(), glal::ResourceState_Present);
         command_buffer->End();
 
-        graphics_queue->Submit(&command_buffer, 1, fence);
-        present_queue->Present(swapchain);
+        frame_pacer->Submit(graphics_queue, &command_buffer, 1);
+        frame_pacer->Present(present_queue, swapchain);
+    }
+
+    frame_pacer->WaitIdle();
+
+    for (auto &frame : frames)
+    {
+        if (frame.framebuffer)
+            device->DestroyFramebuffer(frame.framebuffer);
+        device->DestroyCommandBuffer(frame.command_buffer);
+        device->DestroyDescriptorSet(frame.descriptor_set);
+        device->DestroyBuffer(frame.uniform_buffer);
     }
 
     device->DestroyBuffer(vertex_buffer);
-    device->DestroyBuffer(uniform_buffer);
 
     device->DestroySwapchain(application_state.swapchain);
 
@@ -349,13 +379,10 @@ int main()
     device->DestroyShaderModule(fragment_shader);
 
     device->DestroyPipeline(pipeline);
-    device->DestroyPipelineLayout(pipeline_layout);
 
-    device->DestroyDescriptorSetLayout(descriptor_set_layout);
-    device->DestroyDescriptorSet(descriptor_set);
+    layout_cache.Clear();
 
-    device->DestroyCommandBuffer(command_buffer);
-    device->DestroyFence(fence);
+    frame_pacer.reset();
 
     physical_device->DestroyDevice(device);
 
@@ -376,4 +403,5 @@ int main()
     //         },
     //         .InitialScene = "entry",
     //     });
+    // engine.Run();
 }
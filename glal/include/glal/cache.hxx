@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <common/hash.hxx>
+#include <common/log.hxx>
+#include <glal/desc.hxx>
+
+namespace glal
+{
+    /**
+     * Cache Key - the descriptor fields of a cached object in the order they were added. the hash selects the
+     * entry, the fields are compared on a match so descriptors with colliding hashes never share an object
+     */
+    struct CacheKey
+    {
+        std::uint64_t Hash = common::HashSeed;
+        std::vector<std::uint64_t> Fields;
+
+        void Add(const std::uint64_t field)
+        {
+            Hash = common::HashCombine(Hash, field);
+            Fields.push_back(field);
+        }
+
+        bool operator==(const CacheKey &key) const
+        {
+            return Hash == key.Hash && Fields == key.Fields;
+        }
+    };
+
+    struct CacheKeyHash
+    {
+        std::size_t operator()(const CacheKey &key) const
+        {
+            return static_cast<std::size_t>(key.Hash);
+        }
+    };
+
+    void AddDescriptorBinding(CacheKey &key, const DescriptorBinding &binding);
+
+    CacheKey GetSamplerKey(const SamplerDesc &desc);
+    CacheKey GetDescriptorSetLayoutKey(const DescriptorSetLayoutDesc &desc);
+
+    /**
+     * GetPipelineKey - shader modules are keyed by the hash of their code. layouts and render passes are keyed by
+     * identity, they have to outlive the pipelines created with them anyway
+     */
+    CacheKey GetPipelineKey(const PipelineDesc &desc);
+
+    /**
+     * Object Cache - reference counted deduplication of immutable device objects by the key of their descriptor.
+     * creating an object that is cached hands out the same object again, which is only destroyed with its last
+     * reference. not thread-safe, like the devices using it
+     */
+    template<typename T>
+    class ObjectCache final
+    {
+    public:
+        /**
+         * Acquire - the cached object for the key with one more reference, nullptr if there is none
+         */
+        T *Acquire(const CacheKey &key)
+        {
+            const auto it = m_Objects.find(key);
+            if (it == m_Objects.end())
+                return nullptr;
+
+            ++m_Entries.at(it->second).References;
+            return it->second;
+        }
+
+        /**
+         * Insert - caches a newly created object with one reference
+         */
+        T *Insert(const CacheKey &key, T *object)
+        {
+            common::Assert(m_Objects.emplace(key, object).second, "object cache key {:#016x} is taken", key.Hash);
+            m_Entries.emplace(object, Entry{ .Key = key, .References = 1 });
+            return object;
+        }
+
+        /**
+         * Release - drops a reference, true once the last one is gone and the object has to be destroyed
+         */
+        bool Release(const void *object)
+        {
+            const auto it = m_Entries.find(object);
+            if (it == m_Entries.end())
+                return true;
+
+            if (--it->second.References)
+                return false;
+
+            m_Objects.erase(it->second.Key);
+            m_Entries.erase(it);
+            return true;
+        }
+
+        [[nodiscard]] std::size_t GetSize() const
+        {
+            return m_Objects.size();
+        }
+
+    private:
+        struct Entry
+        {
+            CacheKey Key;
+            std::uint32_t References;
+        };
+
+        std::unordered_map<CacheKey, T *, CacheKeyHash> m_Objects;
+        std::unordered_map<const void *, Entry> m_Entries;
+    };
+}
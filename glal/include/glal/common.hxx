@@ -54,6 +54,18 @@ namespace glal
         DescriptorType Type;
         std::uint32_t Count;
         ShaderStage Stages;
+        DescriptorBindingFlag Flags;
+    };
+
+    /**
+     * Push Constant Range - bytes of the push constant block visible to the stages, offset and size are multiples of
+     * four
+     */
+    struct PushConstantRange
+    {
+        std::uint32_t Offset;
+        std::uint32_t Size;
+        ShaderStage Stages;
     };
 
     /**
@@ -64,6 +76,43 @@ namespace glal
         std::uint32_t MaxTextureSize2D;
         std::uint32_t MaxUniformBuffers;
         std::uint64_t MaxBufferSize;
+        std::uint32_t MaxPushConstantsSize;
+        std::uint32_t MinUniformBufferOffsetAlignment;
+
+        /**
+         * elements of a bindless combined image sampler array, 0 without bindless texture support
+         */
+        std::uint32_t MaxBindlessTextures;
+
+        /**
+         * nanoseconds per timestamp tick
+         */
+        float TimestampPeriod;
+    };
+
+    /**
+     * Pipeline Statistics - layout of the results of a single pipeline statistics query
+     */
+    struct PipelineStatistics
+    {
+        std::uint64_t InputVertices;
+        std::uint64_t InputPrimitives;
+        std::uint64_t VertexShaderInvocations;
+        std::uint64_t ClippingInvocations;
+        std::uint64_t FragmentShaderInvocations;
+        std::uint64_t ComputeShaderInvocations;
+    };
+
+    /**
+     * Draw Indexed Indirect Command - layout of a single command in an indirect buffer
+     */
+    struct DrawIndexedIndirectCommand
+    {
+        std::uint32_t IndexCount;
+        std::uint32_t InstanceCount;
+        std::uint32_t FirstIndex;
+        std::int32_t VertexOffset;
+        std::uint32_t FirstInstance;
     };
 
     /**
@@ -86,12 +135,26 @@ namespace glal
     };
 
     /**
-     * Pipeline Stage - describes a single executable pipeline stage
+     * Specialization Constant - overrides the default of the constant with the given constant_id in a stage, the value
+     * is the raw 32 bits of a bool, int, uint or float
+     */
+    struct SpecializationConstant
+    {
+        std::uint32_t Id;
+        std::uint32_t Value;
+    };
+
+    /**
+     * Pipeline Stage - describes a single executable pipeline stage, the specialization constants are folded into the
+     * compiled stage so branches on them cost nothing at runtime
      */
     struct PipelineStage
     {
         ShaderStage Stage;
         ShaderModule Module;
+
+        const SpecializationConstant *SpecializationConstants;
+        std::uint32_t SpecializationConstantCount;
     };
 
     /**
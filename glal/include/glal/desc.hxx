@@ -13,6 +13,17 @@ namespace glal
     {
         bool EnableValidation;
         const char *ApplicationName;
+
+        /**
+         * file the backend persists compiled pipelines to, or nullptr to disable the cache
+         */
+        const char *PipelineCachePath;
+
+        /**
+         * no window system: opengl creates its own surfaceless egl context, vulkan enables no surface extensions.
+         * swapchains have to be created without a window
+         */
+        bool Headless;
     };
 
     /**
@@ -85,7 +96,8 @@ namespace glal
         const DescriptorSetLayout *DescriptorSetLayouts;
         std::uint32_t DescriptorSetLayoutCount;
 
-        // TODO: push constant ranges
+        const PushConstantRange *PushConstantRanges;
+        std::uint32_t PushConstantRangeCount;
     };
 
     /**
@@ -107,6 +119,12 @@ namespace glal
         PrimitiveTopology Topology;
         bool PrimitiveRestartEnable;
 
+        /**
+         * faces are not culled unless the pipeline asks for it
+         */
+        CullMode Culling;
+        FrontFace Winding;
+
         PipelineLayout Layout;
         RenderPass Pass;
 
@@ -135,7 +153,8 @@ namespace glal
     };
 
     /**
-     * Swapchain Descriptor - describes a specific swapchain
+     * Swapchain Descriptor - without a native window the swapchain is offscreen: it owns its images, acquiring
+     * rotates through them and presenting only completes the frame
      */
     struct SwapchainDesc
     {
@@ -154,4 +173,49 @@ namespace glal
         const Attachment *Attachments;
         std::uint32_t AttachmentCount;
     };
+
+    /**
+     * Query Pool Descriptor - pipeline statistics queries need DeviceFeature_PipelineStatisticsQuery
+     */
+    struct QueryPoolDesc
+    {
+        QueryType Type;
+        std::uint32_t Count;
+    };
+
+    /**
+     * Semaphore Descriptor - binary semaphores ignore the initial value
+     */
+    struct SemaphoreDesc
+    {
+        SemaphoreType Type;
+        std::uint64_t InitialValue;
+    };
+
+    /**
+     * Semaphore Value - a semaphore a submission waits on or signals, binary semaphores ignore the value
+     */
+    struct SemaphoreValue
+    {
+        Semaphore Target;
+        std::uint64_t Value;
+    };
+
+    /**
+     * Submit Descriptor - the submission starts once all wait semaphores reached their values and signals the
+     * semaphores and the fence when it completed
+     */
+    struct SubmitDesc
+    {
+        const CommandBuffer *CommandBuffers;
+        std::uint32_t CommandBufferCount;
+
+        const SemaphoreValue *WaitSemaphores;
+        std::uint32_t WaitSemaphoreCount;
+
+        const SemaphoreValue *SignalSemaphores;
+        std::uint32_t SignalSemaphoreCount;
+
+        Fence SignalFence;
+    };
 }
@@ -17,6 +17,8 @@ namespace glal
         BufferUsage_Index,
         BufferUsage_Uniform,
         BufferUsage_Storage,
+        BufferUsage_Indirect,
+        BufferUsage_Staging,
     };
 
     enum CommandBufferUsage
@@ -25,6 +27,26 @@ namespace glal
         CommandBufferUsage_Reusable,
     };
 
+    enum CullMode
+    {
+        CullMode_None,
+        CullMode_Front,
+        CullMode_Back,
+    };
+
+    enum SemaphoreType
+    {
+        SemaphoreType_Binary,
+        SemaphoreType_Timeline,
+    };
+
+    enum QueryType
+    {
+        QueryType_Timestamp,
+        QueryType_Occlusion,
+        QueryType_PipelineStatistics,
+    };
+
     enum DataType
     {
         DataType_None,
@@ -40,9 +62,31 @@ namespace glal
         DataType_Double,
     };
 
+    enum DescriptorBindingFlag : std::uint32_t
+    {
+        DescriptorBindingFlag_None = 0,
+
+        /**
+         * elements a draw does not use do not have to be written. gl backs partially bound combined image sampler
+         * arrays with bindless texture handles
+         */
+        DescriptorBindingFlag_PartiallyBound = 1 << 0,
+
+        /**
+         * elements may be written while the set is bound, as long as no pending draw uses them
+         */
+        DescriptorBindingFlag_UpdateAfterBind = 1 << 1,
+    };
+
     enum DescriptorType
     {
         DescriptorType_UniformBuffer,
+
+        /**
+         * the offset bound to the set is a base, every BindDescriptorSets adds a dynamic offset to it
+         */
+        DescriptorType_UniformBufferDynamic,
+
         DescriptorType_StorageBuffer,
         DescriptorType_CombinedImageSampler,
         DescriptorType_SampledImage,
@@ -60,6 +104,17 @@ namespace glal
         DeviceFeature_ExplicitBarriers,
         DeviceFeature_DescriptorSets,
         DeviceFeature_TimelineSemaphore,
+        DeviceFeature_AsyncPipelines,
+        DeviceFeature_TextureCompressionBC,
+        DeviceFeature_TextureCompressionETC2,
+        DeviceFeature_TextureCompressionASTC,
+        DeviceFeature_TimestampQuery,
+        DeviceFeature_PipelineStatisticsQuery,
+
+        /**
+         * partially bound, update after bind arrays of combined image samplers, indexed non-uniformly by shaders
+         */
+        DeviceFeature_BindlessTextures,
     };
 
     enum Filter
@@ -68,6 +123,15 @@ namespace glal
         Filter_Linear,
     };
 
+    /**
+     * winding of front faces in normalized device coordinates, the same on every backend
+     */
+    enum FrontFace
+    {
+        FrontFace_CounterClockwise,
+        FrontFace_Clockwise,
+    };
+
     enum ImageType
     {
         ImageType_1D,
@@ -87,6 +151,22 @@ namespace glal
 
         ImageFormat_D24S8,
         ImageFormat_D32F,
+
+        ImageFormat_BC1_UNorm,
+        ImageFormat_BC1_SRGB,
+        ImageFormat_BC3_UNorm,
+        ImageFormat_BC3_SRGB,
+        ImageFormat_BC4_UNorm,
+        ImageFormat_BC5_UNorm,
+        ImageFormat_BC6H_UFloat,
+        ImageFormat_BC7_UNorm,
+        ImageFormat_BC7_SRGB,
+
+        ImageFormat_ETC2_RGB8_UNorm,
+        ImageFormat_ETC2_RGBA8_UNorm,
+
+        ImageFormat_ASTC_4x4_UNorm,
+        ImageFormat_ASTC_4x4_SRGB,
     };
 
     enum MemoryUsage
@@ -103,6 +183,13 @@ namespace glal
         PipelineType_RayTracing,
     };
 
+    enum PipelineStatus
+    {
+        PipelineStatus_Pending,
+        PipelineStatus_Ready,
+        PipelineStatus_Failed,
+    };
+
     enum QueueType : std::uint32_t
     {
         QueueType_None     = 0,
@@ -132,6 +219,7 @@ namespace glal
         ResourceState_DepthStencil,
         ResourceState_CopySrc,
         ResourceState_CopyDst,
+        ResourceState_IndirectArgument,
         ResourceState_Present,
     };
 
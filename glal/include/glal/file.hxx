@@ -0,0 +1,14 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <ostream>
+
+namespace glal
+{
+    /**
+     * WriteFileAtomic - writes through a temporary file next to the path and renames it into place, so a crash
+     * mid-write never leaves a partial file behind. failures are logged as warnings and reported through the result
+     */
+    bool WriteFileAtomic(const std::filesystem::path &path, const std::function<void(std::ostream &)> &write);
+}
@@ -21,6 +21,8 @@ namespace glal
     class FramebufferT;
     class CommandBufferT;
     class FenceT;
+    class SemaphoreT;
+    class QueryPoolT;
     class QueueT;
 
     using Instance = InstanceT *;
@@ -42,5 +44,7 @@ namespace glal
     using Framebuffer = FramebufferT *;
     using CommandBuffer = CommandBufferT *;
     using Fence = FenceT *;
+    using Semaphore = SemaphoreT *;
+    using QueryPool = QueryPoolT *;
     using Queue = QueueT *;
 }
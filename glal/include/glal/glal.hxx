@@ -60,6 +60,11 @@ namespace glal
         virtual void DestroyPipelineLayout(PipelineLayout pipeline_layout) = 0;
 
         virtual Pipeline CreatePipeline(const PipelineDesc &desc) = 0;
+        /**
+         * CreatePipelineAsync - returns immediately and compiles in the background, poll the pipeline status before
+         * binding it. the shader modules must outlive the compilation
+         */
+        virtual Pipeline CreatePipelineAsync(const PipelineDesc &desc) = 0;
         virtual void DestroyPipeline(Pipeline pipeline) = 0;
 
         virtual DescriptorSetLayout CreateDescriptorSetLayout(const DescriptorSetLayoutDesc &desc) = 0;
@@ -77,12 +82,28 @@ namespace glal
         virtual Framebuffer CreateFramebuffer(const FramebufferDesc &desc) = 0;
         virtual void DestroyFramebuffer(Framebuffer framebuffer) = 0;
 
-        virtual CommandBuffer CreateCommandBuffer(CommandBufferUsage usage) = 0;
+        /**
+         * CreateCommandBuffer - the command buffer may only be submitted to the queue of the given type. transfer
+         * command buffers only record copies and transitions
+         */
+        virtual CommandBuffer CreateCommandBuffer(CommandBufferUsage usage, QueueType queue_type) = 0;
         virtual void DestroyCommandBuffer(CommandBuffer command_buffer) = 0;
 
         virtual Fence CreateFence() = 0;
         virtual void DestroyFence(Fence fence) = 0;
 
+        /**
+         * CreateSemaphore - timeline semaphores need DeviceFeature_TimelineSemaphore
+         */
+        virtual Semaphore CreateSemaphore(const SemaphoreDesc &desc) = 0;
+        virtual void DestroySemaphore(Semaphore semaphore) = 0;
+
+        virtual QueryPool CreateQueryPool(const QueryPoolDesc &desc) = 0;
+        virtual void DestroyQueryPool(QueryPool query_pool) = 0;
+
+        /**
+         * GetQueue - prefers a dedicated queue for the type, falls back to a queue that supports it among others
+         */
         virtual Queue GetQueue(QueueType type) = 0;
 
         [[nodiscard]] virtual bool Supports(DeviceFeature feature) const = 0;
@@ -138,6 +159,9 @@ namespace glal
 
         [[nodiscard]] virtual std::uint32_t GetDescriptorSetLayoutCount() const = 0;
         [[nodiscard]] virtual DescriptorSetLayout GetDescriptorSetLayout(std::uint32_t index) const = 0;
+
+        [[nodiscard]] virtual std::uint32_t GetPushConstantRangeCount() const = 0;
+        [[nodiscard]] virtual const PushConstantRange &GetPushConstantRange(std::uint32_t index) const = 0;
     };
 
     class PipelineT
@@ -147,6 +171,8 @@ namespace glal
 
         [[nodiscard]] virtual PipelineType GetType() const = 0;
         [[nodiscard]] virtual PrimitiveTopology GetTopology() const = 0;
+
+        [[nodiscard]] virtual PipelineStatus GetStatus() = 0;
     };
 
     class ShaderModuleT
@@ -155,6 +181,11 @@ namespace glal
         virtual ~ShaderModuleT() = default;
 
         [[nodiscard]] virtual ShaderStage GetStage() const = 0;
+
+        /**
+         * GetHash - hash of the code, modules with the same code are interchangeable
+         */
+        [[nodiscard]] virtual std::uint64_t GetHash() const = 0;
     };
 
     class SwapchainT
@@ -166,8 +197,11 @@ namespace glal
         [[nodiscard]] virtual ImageView GetImageView(std::uint32_t index) const = 0;
         [[nodiscard]] virtual Extent2D GetExtent() const = 0;
 
-        virtual std::uint32_t AcquireNextImage(Fence fence) = 0;
-        virtual void Present() const = 0;
+        /**
+         * AcquireNextImage - blocks until an image is available, the binary semaphore and the fence are signaled
+         * once it may be rendered to. both are optional
+         */
+        virtual std::uint32_t AcquireNextImage(Semaphore semaphore, Fence fence) = 0;
     };
 
     class DescriptorSetLayoutT
@@ -200,6 +234,16 @@ namespace glal
             std::uint32_t binding,
             ImageView image_view,
             Sampler sampler) = 0;
+
+        /**
+         * BindImageView - writes one element of an array binding. the image view has to outlive the set or be
+         * replaced before it is destroyed
+         */
+        virtual void BindImageView(
+            std::uint32_t binding,
+            std::uint32_t array_element,
+            ImageView image_view,
+            Sampler sampler) = 0;
     };
 
     class RenderPassT
@@ -237,14 +281,52 @@ namespace glal
         virtual void BindPipeline(Pipeline pipeline) = 0;
         virtual void BindVertexBuffer(Buffer buffer, std::uint32_t binding, std::size_t offset) = 0;
         virtual void BindIndexBuffer(Buffer buffer, DataType type) = 0;
+        /**
+         * BindDescriptorSets - takes one dynamic offset per dynamic descriptor of the bound sets, in set and then
+         * binding order. dynamic offsets are multiples of the minimum uniform buffer offset alignment
+         */
         virtual void BindDescriptorSets(
             std::uint32_t first_set,
             std::uint32_t set_count,
-            const DescriptorSet *descriptor_sets) = 0;
+            const DescriptorSet *descriptor_sets,
+            std::uint32_t dynamic_offset_count,
+            const std::uint32_t *dynamic_offsets) = 0;
+
+        /**
+         * PushConstants - updates a range of the push constant block of the bound pipeline's layout. the values are
+         * captured at the call and stay set for later draws and dispatches until they are overwritten or a pipeline
+         * with another layout is bound
+         */
+        virtual void PushConstants(
+            ShaderStage stages,
+            std::uint32_t offset,
+            std::uint32_t size,
+            const void *data) = 0;
 
         virtual void Draw(std::uint32_t vertex_count, std::uint32_t first_vertex) = 0;
         virtual void DrawIndexed(std::uint32_t index_count, std::uint32_t first_index) = 0;
 
+        /**
+         * DrawInstanced, DrawIndexedInstanced - vertex bindings with Instance set advance once per instance, starting
+         * at the first instance. the vertex offset is added to every index before the vertices are fetched
+         */
+        virtual void DrawInstanced(
+            std::uint32_t vertex_count,
+            std::uint32_t instance_count,
+            std::uint32_t first_vertex,
+            std::uint32_t first_instance) = 0;
+        virtual void DrawIndexedInstanced(
+            std::uint32_t index_count,
+            std::uint32_t instance_count,
+            std::uint32_t first_index,
+            std::int32_t vertex_offset,
+            std::uint32_t first_instance) = 0;
+        virtual void DrawIndexedIndirect(
+            Buffer buffer,
+            std::size_t offset,
+            std::uint32_t draw_count,
+            std::uint32_t stride) = 0;
+
         virtual void Dispatch(std::uint32_t x, std::uint32_t y, std::uint32_t z) = 0;
 
         virtual void CopyBuffer(
@@ -254,8 +336,38 @@ namespace glal
             std::size_t dst_offset,
             std::size_t size) = 0;
         virtual void CopyBufferToImage(Buffer src_buffer, Image dst_image) = 0;
+        virtual void CopyBufferToImage(
+            Buffer src_buffer,
+            Image dst_image,
+            std::size_t src_offset,
+            std::uint32_t mip_level) = 0;
+
+        /**
+         * CopyImageToBuffer - writes a tightly packed mip level, the image is moved to the copy source state if it is not
+         */
+        virtual void CopyImageToBuffer(
+            Image src_image,
+            Buffer dst_buffer,
+            std::size_t dst_offset,
+            std::uint32_t mip_level) = 0;
 
         virtual void Transition(Resource resource, ResourceState state) = 0;
+
+        /**
+         * ResetQueries - outside of render passes, queries have to be reset before they are written again
+         */
+        virtual void ResetQueries(QueryPool query_pool, std::uint32_t first_query, std::uint32_t query_count) = 0;
+
+        /**
+         * WriteTimestamp - written once all previously recorded commands completed
+         */
+        virtual void WriteTimestamp(QueryPool query_pool, std::uint32_t query) = 0;
+
+        /**
+         * BeginQuery, EndQuery - occlusion and pipeline statistics queries, at most one of each type may be active
+         */
+        virtual void BeginQuery(QueryPool query_pool, std::uint32_t query) = 0;
+        virtual void EndQuery(QueryPool query_pool, std::uint32_t query) = 0;
     };
 
     class FenceT
@@ -265,6 +377,53 @@ namespace glal
 
         virtual void Wait() = 0;
         virtual void Reset() = 0;
+
+        /**
+         * IsSignaled - non-blocking, true once all work of the submission the fence was passed to completed
+         */
+        [[nodiscard]] virtual bool IsSignaled() = 0;
+    };
+
+    class SemaphoreT
+    {
+    public:
+        virtual ~SemaphoreT() = default;
+
+        [[nodiscard]] virtual SemaphoreType GetType() const = 0;
+
+        /**
+         * GetValue - timeline only, non-blocking, the largest value signaled so far
+         */
+        [[nodiscard]] virtual std::uint64_t GetValue() = 0;
+
+        /**
+         * Wait - timeline only, blocks the calling thread until the value is reached or the timeout in nanoseconds
+         * expired. returns false on timeout
+         */
+        virtual bool Wait(std::uint64_t value, std::uint64_t timeout) = 0;
+
+        /**
+         * Signal - timeline only, sets the value from the host
+         */
+        virtual void Signal(std::uint64_t value) = 0;
+    };
+
+    class QueryPoolT
+    {
+    public:
+        virtual ~QueryPoolT() = default;
+
+        [[nodiscard]] virtual QueryType GetType() const = 0;
+        [[nodiscard]] virtual std::uint32_t GetCount() const = 0;
+
+        /**
+         * GetResults - non-blocking, false while any of the queries is not available yet. timestamps are in ticks of
+         * DeviceLimits::TimestampPeriod, pipeline statistics queries write one PipelineStatistics each
+         */
+        [[nodiscard]] virtual bool GetResults(
+            std::uint32_t first_query,
+            std::uint32_t query_count,
+            std::uint64_t *results) = 0;
     };
 
     class QueueT
@@ -276,12 +435,38 @@ namespace glal
             const CommandBuffer *command_buffers,
             std::uint32_t command_buffer_count,
             Fence fence) = 0;
+        virtual void Submit(const SubmitDesc &desc) = 0;
 
-        virtual void Present(Swapchain swapchain) = 0;
+        /**
+         * Present - presents the last acquired image of the swapchain once the optional binary semaphore is signaled
+         */
+        virtual void Present(Swapchain swapchain, Semaphore wait_semaphore) = 0;
     };
 
+    /**
+     * GetFormatBlock - texel footprint and byte size of a single block, uncompressed formats have 1x1 blocks
+     */
+    void GetFormatBlock(
+        ImageFormat format,
+        std::uint32_t *block_width,
+        std::uint32_t *block_height,
+        std::uint32_t *block_size);
+
+    [[nodiscard]] bool IsCompressedFormat(ImageFormat format);
+
+    /**
+     * GetImageDataSize - tightly packed size of a single mip level, partial blocks at the edges count as whole blocks
+     */
+    [[nodiscard]] std::size_t GetImageDataSize(ImageFormat format, Extent3D extent);
+
     Instance CreateInstanceOpenGL(const InstanceDesc &desc);
     Instance CreateInstanceVulkan(const InstanceDesc &desc);
 
+    /**
+     * CreateInstanceNull - needs neither a window system nor a driver and executes nothing, for measuring the cpu
+     * side. the command statistics are on glal::null::DeviceT
+     */
+    Instance CreateInstanceNull(const InstanceDesc &desc);
+
     void DestroyInstance(Instance instance);
 }
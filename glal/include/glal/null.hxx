@@ -0,0 +1,607 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <glal/cache.hxx>
+#include <glal/glal.hxx>
+
+/**
+ * Null Backend - executes nothing and completes every submission right away. resources only keep their description
+ * and host visible buffers their memory, so the cpu side of a renderer can be measured without a gpu or a driver
+ */
+namespace glal::null
+{
+    class InstanceT;
+    class PhysicalDeviceT;
+    class DeviceT;
+
+    class BufferT;
+    class ImageT;
+    class ImageViewT;
+    class SamplerT;
+    class ShaderModuleT;
+    class PipelineLayoutT;
+    class PipelineT;
+    class DescriptorSetLayoutT;
+    class DescriptorSetT;
+    class SwapchainT;
+    class RenderPassT;
+    class FramebufferT;
+    class CommandBufferT;
+    class FenceT;
+    class SemaphoreT;
+    class QueryPoolT;
+    class QueueT;
+
+    /**
+     * Statistics - totals over all submitted command buffers, a reusable command buffer counts once per submission
+     */
+    struct Statistics
+    {
+        std::uint64_t Submits;
+        std::uint64_t CommandBuffers;
+        std::uint64_t RenderPasses;
+
+        std::uint64_t Draws;
+        std::uint64_t IndirectDraws;
+        std::uint64_t Dispatches;
+        std::uint64_t Instances;
+        std::uint64_t Vertices;
+        std::uint64_t Indices;
+
+        std::uint64_t PipelineBinds;
+        std::uint64_t VertexBufferBinds;
+        std::uint64_t IndexBufferBinds;
+        std::uint64_t DescriptorSetBinds;
+        std::uint64_t PushConstants;
+        std::uint64_t PushConstantBytes;
+        std::uint64_t Transitions;
+        std::uint64_t Queries;
+
+        std::uint64_t Copies;
+        std::uint64_t BytesUploaded;
+        std::uint64_t BytesReadBack;
+
+        Statistics &operator+=(const Statistics &other);
+    };
+
+    class InstanceT final : public glal::InstanceT
+    {
+    public:
+        explicit InstanceT(const InstanceDesc &desc);
+
+        std::uint32_t EnumeratePhysicalDevices(PhysicalDevice *devices) override;
+
+    private:
+        std::vector<PhysicalDeviceT> m_PhysicalDevices;
+    };
+
+    class PhysicalDeviceT final : public glal::PhysicalDeviceT
+    {
+    public:
+        explicit PhysicalDeviceT(InstanceT *instance);
+        ~PhysicalDeviceT() override;
+
+        Device CreateDevice() override;
+        void DestroyDevice(Device device) override;
+
+        [[nodiscard]] Instance GetInstance() const override;
+
+        [[nodiscard]] bool Supports(DeviceFeature feature) const override;
+        [[nodiscard]] const DeviceLimits &GetLimits() const override;
+
+    private:
+        InstanceT *m_Instance;
+        DeviceLimits m_Limits;
+
+        std::vector<DeviceT *> m_Devices;
+    };
+
+    class DeviceT final : public glal::DeviceT
+    {
+    public:
+        explicit DeviceT(PhysicalDeviceT *physical_device);
+        ~DeviceT() override;
+
+        PhysicalDeviceT *GetPhysicalDevice() const override;
+
+        Buffer CreateBuffer(const BufferDesc &desc) override;
+        void DestroyBuffer(Buffer buffer) override;
+
+        Image CreateImage(const ImageDesc &desc) override;
+        void DestroyImage(Image image) override;
+
+        ImageView CreateImageView(const ImageViewDesc &desc) override;
+        void DestroyImageView(ImageView image_view) override;
+
+        Sampler CreateSampler(const SamplerDesc &desc) override;
+        void DestroySampler(Sampler sampler) override;
+
+        ShaderModule CreateShaderModule(const ShaderModuleDesc &desc) override;
+        void DestroyShaderModule(ShaderModule shader_module) override;
+
+        PipelineLayout CreatePipelineLayout(const PipelineLayoutDesc &desc) override;
+        void DestroyPipelineLayout(PipelineLayout pipeline_layout) override;
+
+        Pipeline CreatePipeline(const PipelineDesc &desc) override;
+        Pipeline CreatePipelineAsync(const PipelineDesc &desc) override;
+        void DestroyPipeline(Pipeline pipeline) override;
+
+        DescriptorSetLayout CreateDescriptorSetLayout(const DescriptorSetLayoutDesc &desc) override;
+        void DestroyDescriptorSetLayout(DescriptorSetLayout descriptor_set_layout) override;
+
+        DescriptorSet CreateDescriptorSet(const DescriptorSetDesc &desc) override;
+        void DestroyDescriptorSet(DescriptorSet descriptor_set) override;
+
+        Swapchain CreateSwapchain(const SwapchainDesc &desc) override;
+        void DestroySwapchain(Swapchain swapchain) override;
+
+        RenderPass CreateRenderPass(const RenderPassDesc &desc) override;
+        void DestroyRenderPass(RenderPass render_pass) override;
+
+        Framebuffer CreateFramebuffer(const FramebufferDesc &desc) override;
+        void DestroyFramebuffer(Framebuffer framebuffer) override;
+
+        CommandBuffer CreateCommandBuffer(CommandBufferUsage usage, QueueType queue_type) override;
+        void DestroyCommandBuffer(CommandBuffer command_buffer) override;
+
+        Fence CreateFence() override;
+        void DestroyFence(Fence fence) override;
+
+        Semaphore CreateSemaphore(const SemaphoreDesc &desc) override;
+        void DestroySemaphore(Semaphore semaphore) override;
+
+        QueryPool CreateQueryPool(const QueryPoolDesc &desc) override;
+        void DestroyQueryPool(QueryPool query_pool) override;
+
+        Queue GetQueue(QueueType type) override;
+
+        [[nodiscard]] bool Supports(DeviceFeature feature) const override;
+        [[nodiscard]] const DeviceLimits &GetLimits() const override;
+
+        /**
+         * EnableStatistics - statistics are off by default, command buffers begun afterwards are counted
+         */
+        void EnableStatistics(bool enable);
+        [[nodiscard]] bool IsRecordingStatistics() const;
+
+        [[nodiscard]] const Statistics &GetStatistics() const;
+        void ResetStatistics();
+
+        void AddStatistics(const Statistics &statistics);
+
+        /**
+         * SetPipelineCompileTime - async pipelines created afterwards stay pending this long, zero by default
+         */
+        void SetPipelineCompileTime(std::chrono::nanoseconds compile_time);
+        [[nodiscard]] std::chrono::nanoseconds GetPipelineCompileTime() const;
+
+    private:
+        PhysicalDeviceT *m_PhysicalDevice;
+
+        std::vector<BufferT *> m_Buffers;
+        std::vector<ImageT *> m_Images;
+        std::vector<ImageViewT *> m_ImageViews;
+        std::vector<SamplerT *> m_Samplers;
+        std::vector<ShaderModuleT *> m_ShaderModules;
+        std::vector<PipelineLayoutT *> m_PipelineLayouts;
+        std::vector<PipelineT *> m_Pipelines;
+        std::vector<DescriptorSetLayoutT *> m_DescriptorSetLayouts;
+        std::vector<DescriptorSetT *> m_DescriptorSets;
+        std::vector<SwapchainT *> m_Swapchains;
+        std::vector<RenderPassT *> m_RenderPasses;
+        std::vector<FramebufferT *> m_Framebuffers;
+        std::vector<CommandBufferT *> m_CommandBuffers;
+        std::vector<FenceT *> m_Fences;
+        std::vector<SemaphoreT *> m_Semaphores;
+        std::vector<QueryPoolT *> m_QueryPools;
+
+        /**
+         * samplers, pipelines and descriptor set layouts with identical descriptors are shared, see ObjectCache
+         */
+        ObjectCache<SamplerT> m_SharedSamplers;
+        ObjectCache<PipelineT> m_SharedPipelines;
+        ObjectCache<DescriptorSetLayoutT> m_SharedDescriptorSetLayouts;
+
+        QueueT *m_Queue;
+
+        bool m_RecordStatistics;
+        Statistics m_Statistics;
+
+        std::chrono::nanoseconds m_PipelineCompileTime;
+    };
+
+    /**
+     * Queue - a single queue of every type, submissions complete before Submit returns
+     */
+    class QueueT final : public glal::QueueT
+    {
+    public:
+        explicit QueueT(DeviceT *device);
+
+        void Submit(
+            const CommandBuffer *command_buffers,
+            std::uint32_t command_buffer_count,
+            Fence fence) override;
+        void Submit(const SubmitDesc &desc) override;
+
+        void Present(Swapchain swapchain, Semaphore wait_semaphore) override;
+
+    private:
+        DeviceT *m_Device;
+    };
+
+    class BufferT final : public glal::BufferT
+    {
+    public:
+        explicit BufferT(DeviceT *device, const BufferDesc &desc);
+
+        [[nodiscard]] std::size_t GetSize() const override;
+        [[nodiscard]] BufferUsage GetUsage() const override;
+
+        void *Map() override;
+        void Unmap() override;
+
+    private:
+        DeviceT *m_Device;
+
+        std::size_t m_Size;
+        BufferUsage m_Usage;
+        MemoryUsage m_Memory;
+
+        /**
+         * only host visible buffers have memory, nothing is ever copied into it
+         */
+        std::vector<char> m_Data;
+    };
+
+    class ImageT final : public glal::ImageT
+    {
+    public:
+        explicit ImageT(DeviceT *device, const ImageDesc &desc);
+
+        [[nodiscard]] ImageFormat GetFormat() const override;
+        [[nodiscard]] ImageType GetType() const override;
+        [[nodiscard]] Extent3D GetExtent() const override;
+        [[nodiscard]] std::uint32_t GetMipLevelCount() const override;
+        [[nodiscard]] std::uint32_t GetArrayLayerCount() const override;
+
+    private:
+        DeviceT *m_Device;
+
+        ImageFormat m_Format;
+        ImageType m_Type;
+        Extent3D m_Extent;
+        std::uint32_t m_MipLevelCount;
+        std::uint32_t m_ArrayLayerCount;
+    };
+
+    class ImageViewT final : public glal::ImageViewT
+    {
+    public:
+        explicit ImageViewT(DeviceT *device, const ImageViewDesc &desc);
+
+        [[nodiscard]] Image GetImage() const override;
+        [[nodiscard]] ImageFormat GetFormat() const override;
+        [[nodiscard]] ImageType GetType() const override;
+
+    private:
+        DeviceT *m_Device;
+        Image m_Image;
+
+        ImageFormat m_Format;
+        ImageType m_Type;
+    };
+
+    class SamplerT final : public glal::SamplerT
+    {
+    public:
+        explicit SamplerT(DeviceT *device, const SamplerDesc &desc);
+
+    private:
+        DeviceT *m_Device;
+    };
+
+    class ShaderModuleT final : public glal::ShaderModuleT
+    {
+    public:
+        explicit ShaderModuleT(DeviceT *device, const ShaderModuleDesc &desc);
+
+        [[nodiscard]] ShaderStage GetStage() const override;
+        [[nodiscard]] std::uint64_t GetHash() const override;
+
+    private:
+        DeviceT *m_Device;
+
+        ShaderStage m_Stage;
+        std::uint64_t m_Hash;
+    };
+
+    class PipelineLayoutT final : public glal::PipelineLayoutT
+    {
+    public:
+        explicit PipelineLayoutT(DeviceT *device, const PipelineLayoutDesc &desc);
+
+        [[nodiscard]] std::uint32_t GetDescriptorSetLayoutCount() const override;
+        [[nodiscard]] DescriptorSetLayout GetDescriptorSetLayout(std::uint32_t index) const override;
+
+        [[nodiscard]] std::uint32_t GetPushConstantRangeCount() const override;
+        [[nodiscard]] const PushConstantRange &GetPushConstantRange(std::uint32_t index) const override;
+
+    private:
+        DeviceT *m_Device;
+
+        std::vector<DescriptorSetLayout> m_DescriptorSetLayouts;
+        std::vector<PushConstantRange> m_PushConstantRanges;
+    };
+
+    /**
+     * Pipeline - nothing is compiled, async pipelines are ready once the compile time of the device has passed
+     */
+    class PipelineT final : public glal::PipelineT
+    {
+    public:
+        explicit PipelineT(DeviceT *device, const PipelineDesc &desc, bool async);
+
+        [[nodiscard]] PipelineType GetType() const override;
+        [[nodiscard]] PrimitiveTopology GetTopology() const override;
+
+        [[nodiscard]] PipelineStatus GetStatus() override;
+
+    private:
+        DeviceT *m_Device;
+
+        PipelineType m_Type;
+        PrimitiveTopology m_Topology;
+
+        std::chrono::steady_clock::time_point m_ReadyTime;
+    };
+
+    class DescriptorSetLayoutT final : public glal::DescriptorSetLayoutT
+    {
+    public:
+        explicit DescriptorSetLayoutT(DeviceT *device, const DescriptorSetLayoutDesc &desc);
+
+        [[nodiscard]] std::uint32_t GetSet() const override;
+        [[nodiscard]] std::uint32_t GetDescriptorBindingCount() const override;
+        [[nodiscard]] const DescriptorBinding &GetDescriptorBinding(std::uint32_t index) const override;
+        [[nodiscard]] const DescriptorBinding *FindDescriptorBinding(std::uint32_t binding) const override;
+
+    private:
+        DeviceT *m_Device;
+
+        std::uint32_t m_Set;
+        std::vector<DescriptorBinding> m_DescriptorBindings;
+    };
+
+    class DescriptorSetT final : public glal::DescriptorSetT
+    {
+    public:
+        explicit DescriptorSetT(DeviceT *device, const DescriptorSetDesc &desc);
+
+        void BindBuffer(
+            std::uint32_t binding,
+            Buffer buffer) override;
+
+        void BindBuffer(
+            std::uint32_t binding,
+            Buffer buffer,
+            std::uint32_t offset,
+            std::uint32_t size) override;
+
+        void BindImageView(
+            std::uint32_t binding,
+            ImageView image_view,
+            Sampler sampler) override;
+
+        void BindImageView(
+            std::uint32_t binding,
+            std::uint32_t array_element,
+            ImageView image_view,
+            Sampler sampler) override;
+
+    private:
+        DeviceT *m_Device;
+        DescriptorSetLayout m_Layout;
+    };
+
+    class SwapchainT final : public glal::SwapchainT
+    {
+    public:
+        explicit SwapchainT(DeviceT *device, const SwapchainDesc &desc);
+        ~SwapchainT() override;
+
+        [[nodiscard]] std::uint32_t GetImageCount() const override;
+        [[nodiscard]] ImageView GetImageView(std::uint32_t index) const override;
+        [[nodiscard]] Extent2D GetExtent() const override;
+
+        std::uint32_t AcquireNextImage(Semaphore semaphore, Fence fence) override;
+
+    private:
+        DeviceT *m_Device;
+
+        Extent2D m_Extent;
+        std::uint32_t m_ImageIndex;
+        std::vector<Image> m_Images;
+        std::vector<ImageView> m_ImageViews;
+    };
+
+    class RenderPassT final : public glal::RenderPassT
+    {
+    public:
+        explicit RenderPassT(DeviceT *device, const RenderPassDesc &desc);
+
+        [[nodiscard]] std::uint32_t GetAttachmentCount() const override;
+        [[nodiscard]] const Attachment &GetAttachment(std::uint32_t index) const override;
+
+    private:
+        DeviceT *m_Device;
+
+        std::vector<Attachment> m_Attachments;
+    };
+
+    class FramebufferT final : public glal::FramebufferT
+    {
+    public:
+        explicit FramebufferT(DeviceT *device, const FramebufferDesc &desc);
+
+        [[nodiscard]] std::uint32_t GetAttachmentCount() const override;
+        [[nodiscard]] ImageView GetAttachment(std::uint32_t index) const override;
+
+    private:
+        DeviceT *m_Device;
+
+        std::vector<ImageView> m_Attachments;
+    };
+
+    /**
+     * Command Buffer - recording only counts the commands, and only while the device records statistics
+     */
+    class CommandBufferT final : public glal::CommandBufferT
+    {
+    public:
+        explicit CommandBufferT(DeviceT *device, CommandBufferUsage usage, QueueType queue_type);
+
+        void Begin() override;
+        void End() override;
+
+        void BeginRenderPass(RenderPass render_pass, Framebuffer framebuffer) override;
+        void EndRenderPass() override;
+
+        void SetViewport(float x, float y, float width, float height, float min_depth, float max_depth) override;
+        void SetScissor(std::int32_t x, std::int32_t y, std::uint32_t width, std::uint32_t height) override;
+
+        void BindPipeline(Pipeline pipeline) override;
+        void BindVertexBuffer(Buffer buffer, std::uint32_t binding, std::size_t offset) override;
+        void BindIndexBuffer(Buffer buffer, DataType type) override;
+        void BindDescriptorSets(
+            std::uint32_t first_set,
+            std::uint32_t set_count,
+            const DescriptorSet *descriptor_sets,
+            std::uint32_t dynamic_offset_count,
+            const std::uint32_t *dynamic_offsets) override;
+        void PushConstants(
+            ShaderStage stages,
+            std::uint32_t offset,
+            std::uint32_t size,
+            const void *data) override;
+
+        void Draw(std::uint32_t vertex_count, std::uint32_t first_vertex) override;
+        void DrawIndexed(std::uint32_t index_count, std::uint32_t first_index) override;
+        void DrawInstanced(
+            std::uint32_t vertex_count,
+            std::uint32_t instance_count,
+            std::uint32_t first_vertex,
+            std::uint32_t first_instance) override;
+        void DrawIndexedInstanced(
+            std::uint32_t index_count,
+            std::uint32_t instance_count,
+            std::uint32_t first_index,
+            std::int32_t vertex_offset,
+            std::uint32_t first_instance) override;
+        void DrawIndexedIndirect(
+            Buffer buffer,
+            std::size_t offset,
+            std::uint32_t draw_count,
+            std::uint32_t stride) override;
+
+        void Dispatch(std::uint32_t x, std::uint32_t y, std::uint32_t z) override;
+
+        void CopyBuffer(
+            Buffer src_buffer,
+            Buffer dst_buffer,
+            std::size_t src_offset,
+            std::size_t dst_offset,
+            std::size_t size) override;
+        void CopyBufferToImage(Buffer src_buffer, Image dst_image) override;
+        void CopyBufferToImage(
+            Buffer src_buffer,
+            Image dst_image,
+            std::size_t src_offset,
+            std::uint32_t mip_level) override;
+        void CopyImageToBuffer(
+            Image src_image,
+            Buffer dst_buffer,
+            std::size_t dst_offset,
+            std::uint32_t mip_level) override;
+
+        void Transition(Resource resource, ResourceState state) override;
+
+        void ResetQueries(QueryPool query_pool, std::uint32_t first_query, std::uint32_t query_count) override;
+        void WriteTimestamp(QueryPool query_pool, std::uint32_t query) override;
+        void BeginQuery(QueryPool query_pool, std::uint32_t query) override;
+        void EndQuery(QueryPool query_pool, std::uint32_t query) override;
+
+        [[nodiscard]] const Statistics &GetStatistics() const;
+
+    private:
+        DeviceT *m_Device;
+        CommandBufferUsage m_Usage;
+
+        bool m_Record;
+        Statistics m_Statistics;
+    };
+
+    class FenceT final : public glal::FenceT
+    {
+    public:
+        explicit FenceT(DeviceT *device);
+
+        void Wait() override;
+        void Reset() override;
+        [[nodiscard]] bool IsSignaled() override;
+
+        void Signal();
+
+    private:
+        DeviceT *m_Device;
+
+        bool m_Signaled;
+    };
+
+    /**
+     * Semaphore - every signal happens right away, so waits never block. a timeline wait for a value nobody signaled
+     * yet fails instead of running into its timeout
+     */
+    class SemaphoreT final : public glal::SemaphoreT
+    {
+    public:
+        explicit SemaphoreT(DeviceT *device, const SemaphoreDesc &desc);
+
+        [[nodiscard]] SemaphoreType GetType() const override;
+        [[nodiscard]] std::uint64_t GetValue() override;
+
+        bool Wait(std::uint64_t value, std::uint64_t timeout) override;
+        void Signal(std::uint64_t value) override;
+
+    private:
+        DeviceT *m_Device;
+
+        SemaphoreType m_Type;
+        std::uint64_t m_Value;
+    };
+
+    /**
+     * Query Pool - nothing executes, so every query is available right away and reads as zero
+     */
+    class QueryPoolT final : public glal::QueryPoolT
+    {
+    public:
+        explicit QueryPoolT(DeviceT *device, const QueryPoolDesc &desc);
+
+        [[nodiscard]] QueryType GetType() const override;
+        [[nodiscard]] std::uint32_t GetCount() const override;
+
+        [[nodiscard]] bool GetResults(
+            std::uint32_t first_query,
+            std::uint32_t query_count,
+            std::uint64_t *results) override;
+
+    private:
+        DeviceT *m_Device;
+
+        QueryType m_Type;
+        std::uint32_t m_Count;
+    };
+}
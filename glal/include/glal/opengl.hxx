@@ -1,8 +1,18 @@
 #pragma once
 
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <span>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 #include <GL/glew.h>
+#include <glal/cache.hxx>
 #include <glal/glal.hxx>
 
 namespace glal::opengl
@@ -23,17 +33,41 @@ namespace glal::opengl
     class SwapchainT;
     class CommandBufferT;
     class FenceT;
+    class SemaphoreT;
+    class QueryPoolT;
     class QueueT;
 
+    /**
+     * gl has no push constants, shaders declare the push constant block as a uniform block at this binding instead,
+     * past the bindings of the descriptor sets. its bytes are copied as pushed, so the block has to be laid out to
+     * match
+     */
+    constexpr std::uint32_t PushConstantBinding = 64;
+    constexpr std::uint32_t MaxPushConstantsSize = 128;
+
     class InstanceT final : public glal::InstanceT
     {
     public:
         explicit InstanceT(const InstanceDesc &desc);
+        ~InstanceT() override;
 
         std::uint32_t EnumeratePhysicalDevices(PhysicalDevice *devices) override;
 
+        [[nodiscard]] const std::filesystem::path &GetPipelineCachePath() const;
+        [[nodiscard]] bool IsHeadless() const;
+
     private:
         std::vector<PhysicalDeviceT> m_PhysicalDevices;
+
+        std::filesystem::path m_PipelineCachePath;
+
+        /**
+         * egl objects of the headless context, kept opaque so egl stays out of this header
+         */
+        bool m_Headless;
+        void *m_Display;
+        void *m_Surface;
+        void *m_Context;
     };
 
     class PhysicalDeviceT final : public glal::PhysicalDeviceT
@@ -57,6 +91,86 @@ namespace glal::opengl
         std::vector<DeviceT *> m_Devices;
     };
 
+    struct ProgramBinary
+    {
+        GLenum Format;
+        std::vector<char> Data;
+    };
+
+    /**
+     * the default values are the initial state of a gl context
+     */
+    struct RasterState
+    {
+        bool CullFace = false;
+        GLenum CullMode = GL_BACK;
+        GLenum FrontFace = GL_CCW;
+        bool PrimitiveRestart = false;
+
+        bool operator==(const RasterState &) const = default;
+    };
+
+    struct DepthStencilState
+    {
+        bool DepthTest = false;
+        GLboolean DepthMask = GL_TRUE;
+        GLenum DepthFunc = GL_LESS;
+
+        bool operator==(const DepthStencilState &) const = default;
+    };
+
+    struct BlendState
+    {
+        bool Blend = false;
+        GLenum SrcColor = GL_ONE;
+        GLenum DstColor = GL_ZERO;
+        GLenum SrcAlpha = GL_ONE;
+        GLenum DstAlpha = GL_ZERO;
+        GLenum Equation = GL_FUNC_ADD;
+
+        bool operator==(const BlendState &) const = default;
+    };
+
+    /**
+     * State Block - the complete fixed function state of a pipeline, baked when it is created. binding a pipeline
+     * only changes the gl state that differs from the block bound before
+     */
+    struct StateBlock
+    {
+        RasterState Raster;
+        DepthStencilState DepthStencil;
+        BlendState Blend;
+    };
+
+    /**
+     * Uniform Ring - persistently mapped uniform buffer handed out in aligned slices. the ring is split into segments,
+     * a segment is fenced once it is left and only written again after the gpu passed the fence
+     */
+    class UniformRing final
+    {
+    public:
+        explicit UniformRing(std::size_t size, std::uint32_t segment_count);
+        ~UniformRing();
+
+        /**
+         * Push - copies the data into the next slice and returns its offset, may wait for the gpu to release it
+         */
+        std::size_t Push(const void *data, std::size_t size);
+
+        [[nodiscard]] GLuint GetHandle() const;
+
+    private:
+        GLuint m_Handle;
+        std::byte *m_Mapping;
+
+        std::size_t m_Alignment;
+        std::size_t m_SegmentSize;
+
+        std::size_t m_Head;
+        std::uint32_t m_Segment;
+        std::vector<GLsync> m_Fences;
+    };
+
     class DeviceT final : public glal::DeviceT
     {
     public:
@@ -84,6 +198,7 @@ namespace glal::opengl
         void DestroyPipelineLayout(PipelineLayout pipeline_layout) override;
 
         Pipeline CreatePipeline(const PipelineDesc &desc) override;
+        Pipeline CreatePipelineAsync(const PipelineDesc &desc) override;
         void DestroyPipeline(Pipeline pipeline) override;
 
         DescriptorSetLayout CreateDescriptorSetLayout(const DescriptorSetLayoutDesc &desc) override;
@@ -101,18 +216,55 @@ namespace glal::opengl
         Framebuffer CreateFramebuffer(const FramebufferDesc &desc) override;
         void DestroyFramebuffer(Framebuffer framebuffer) override;
 
-        CommandBuffer CreateCommandBuffer(CommandBufferUsage usage) override;
+        CommandBuffer CreateCommandBuffer(CommandBufferUsage usage, QueueType queue_type) override;
         void DestroyCommandBuffer(CommandBuffer command_buffer) override;
 
         Fence CreateFence() override;
         void DestroyFence(Fence fence) override;
 
+        Semaphore CreateSemaphore(const SemaphoreDesc &desc) override;
+        void DestroySemaphore(Semaphore semaphore) override;
+
+        QueryPool CreateQueryPool(const QueryPoolDesc &desc) override;
+        void DestroyQueryPool(QueryPool query_pool) override;
+
         Queue GetQueue(QueueType type) override;
 
         [[nodiscard]] bool Supports(DeviceFeature feature) const override;
         [[nodiscard]] const DeviceLimits &GetLimits() const override;
 
+        /**
+         * FindProgramBinary, StoreProgramBinary - also called from the compile queue, a found binary is copied out
+         */
+        [[nodiscard]] bool FindProgramBinary(std::uint64_t key, ProgramBinary *binary) const;
+        void StoreProgramBinary(std::uint64_t key, ProgramBinary binary);
+
+        /**
+         * GetCompileQueue - the worker async pipelines compile on when the driver cannot compile in parallel itself,
+         * nullptr if it can or no context to share with was current
+         */
+        [[nodiscard]] QueueT *GetCompileQueue() const;
+
+        [[nodiscard]] UniformRing *GetPushConstantRing() const;
+
+        /**
+         * ApplyStateBlock - issues the gl calls for the state that differs from the current block, graphics context
+         * only
+         */
+        void ApplyStateBlock(const StateBlock &state);
+        [[nodiscard]] const StateBlock &GetStateBlock() const;
+
+        /**
+         * AcquireTextureHandle, ReleaseTextureHandle - bindless handles stay resident while any descriptor set holds
+         * them, the same image view and sampler always map to the same handle
+         */
+        GLuint64 AcquireTextureHandle(ImageViewT *image_view_impl, SamplerT *sampler_impl);
+        void ReleaseTextureHandle(GLuint64 handle);
+
     private:
+        void LoadPipelineCache();
+        void SavePipelineCache() const;
+
         PhysicalDeviceT *m_PhysicalDevice;
 
         std::vector<BufferT *> m_Buffers;
@@ -129,23 +281,82 @@ namespace glal::opengl
         std::vector<FramebufferT *> m_Framebuffers;
         std::vector<CommandBufferT *> m_CommandBuffers;
         std::vector<FenceT *> m_Fences;
-
-        QueueT *m_Queue;
+        std::vector<SemaphoreT *> m_Semaphores;
+        std::vector<QueryPoolT *> m_QueryPools;
+
+        /**
+         * samplers, pipelines and descriptor set layouts with identical descriptors are shared, see ObjectCache
+         */
+        ObjectCache<SamplerT> m_SharedSamplers;
+        ObjectCache<PipelineT> m_SharedPipelines;
+        ObjectCache<DescriptorSetLayoutT> m_SharedDescriptorSetLayouts;
+
+        QueueT *m_GraphicsQueue;
+        QueueT *m_TransferQueue;
+        QueueT *m_CompileQueue;
+
+        UniformRing *m_PushConstantRing;
+
+        /**
+         * the state block the graphics context is in, gl is never changed behind its back
+         */
+        StateBlock m_StateBlock;
+
+        std::unordered_map<GLuint64, std::uint32_t> m_TextureHandleReferences;
+
+        std::filesystem::path m_PipelineCachePath;
+        std::uint64_t m_DriverHash;
+        bool m_PipelineCacheDirty;
+        std::unordered_map<std::uint64_t, ProgramBinary> m_ProgramBinaries;
+        mutable std::mutex m_ProgramBinaryMutex;
     };
 
+    /**
+     * Queue - executes on the calling thread, or, when created with a shared context, on a worker thread that owns a
+     * hidden context sharing objects with it
+     */
     class QueueT final : public glal::QueueT
     {
     public:
-        explicit QueueT(DeviceT *device);
+        explicit QueueT(DeviceT *device, void *shared_context);
+        ~QueueT() override;
 
         void Submit(
             const CommandBuffer *command_buffers,
             std::uint32_t command_buffer_count,
             Fence fence) override;
-        void Present(Swapchain swapchain) override;
+        void Submit(const SubmitDesc &desc) override;
+
+        void Present(Swapchain swapchain, Semaphore wait_semaphore) override;
+
+        [[nodiscard]] bool IsAsync() const;
+
+        /**
+         * Execute - runs the command after all previous submissions, the fence is signaled once the gpu work it
+         * issued has completed
+         */
+        void Execute(std::function<void()> command, FenceT *fence);
 
     private:
+        struct Submission
+        {
+            std::vector<std::function<void()>> Commands;
+            std::vector<std::pair<SemaphoreT *, std::uint64_t>> Waits;
+            std::vector<std::pair<SemaphoreT *, std::uint64_t>> Signals;
+            FenceT *FenceRef;
+        };
+
+        void Run();
+
         DeviceT *m_Device;
+
+        void *m_Window;
+        std::thread m_Thread;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        std::deque<Submission> m_Submissions;
+        bool m_Stop;
     };
 
     class DescriptorSetLayoutT final : public glal::DescriptorSetLayoutT
@@ -171,6 +382,7 @@ namespace glal::opengl
         BufferT *BufferImpl;
         GLsizeiptr Offset;
         GLintptr Size;
+        bool Dynamic;
     };
 
     struct ImageBinding
@@ -179,10 +391,21 @@ namespace glal::opengl
         SamplerT *SamplerImpl;
     };
 
+    /**
+     * Bindless Binding - a partially bound combined image sampler array, its texture handles are kept in a storage
+     * buffer that shaders read and construct their samplers from
+     */
+    struct BindlessBinding
+    {
+        GLuint Buffer;
+        std::vector<GLuint64> Handles;
+    };
+
     class DescriptorSetT final : public glal::DescriptorSetT
     {
     public:
         explicit DescriptorSetT(DeviceT *device, const DescriptorSetDesc &desc);
+        ~DescriptorSetT() override;
 
         void BindBuffer(
             std::uint32_t binding,
@@ -199,14 +422,29 @@ namespace glal::opengl
             ImageView image_view,
             Sampler sampler) override;
 
-        void Bind(std::uint32_t set) const;
+        void BindImageView(
+            std::uint32_t binding,
+            std::uint32_t array_element,
+            ImageView image_view,
+            Sampler sampler) override;
+
+        /**
+         * Bind - consumes one dynamic offset per dynamic binding in binding order, returns how many it consumed
+         */
+        std::uint32_t Bind(std::uint32_t set, const std::uint32_t *dynamic_offsets) const;
+
+        [[nodiscard]] std::uint32_t GetDynamicBindingCount() const;
 
     private:
         DeviceT *m_Device;
         DescriptorSetLayout m_Layout;
 
-        std::unordered_map<GLuint, BufferBinding> m_BufferBindings;
+        /**
+         * ordered, dynamic offsets are handed out in binding order
+         */
+        std::map<GLuint, BufferBinding> m_BufferBindings;
         std::unordered_map<GLuint, ImageBinding> m_ImageBindings;
+        std::unordered_map<GLuint, BindlessBinding> m_BindlessBindings;
     };
 
     class RenderPassT final : public glal::RenderPassT
@@ -244,7 +482,7 @@ namespace glal::opengl
     class CommandBufferT final : public glal::CommandBufferT
     {
     public:
-        explicit CommandBufferT(DeviceT *device, CommandBufferUsage usage);
+        explicit CommandBufferT(DeviceT *device, CommandBufferUsage usage, QueueType queue_type);
 
         void Begin() override;
         void End() override;
@@ -261,10 +499,33 @@ namespace glal::opengl
         void BindDescriptorSets(
             std::uint32_t first_set,
             std::uint32_t set_count,
-            const DescriptorSet *descriptor_sets) override;
+            const DescriptorSet *descriptor_sets,
+            std::uint32_t dynamic_offset_count,
+            const std::uint32_t *dynamic_offsets) override;
+        void PushConstants(
+            ShaderStage stages,
+            std::uint32_t offset,
+            std::uint32_t size,
+            const void *data) override;
 
         void Draw(std::uint32_t vertex_count, std::uint32_t first_vertex) override;
         void DrawIndexed(std::uint32_t index_count, std::uint32_t first_index) override;
+        void DrawInstanced(
+            std::uint32_t vertex_count,
+            std::uint32_t instance_count,
+            std::uint32_t first_vertex,
+            std::uint32_t first_instance) override;
+        void DrawIndexedInstanced(
+            std::uint32_t index_count,
+            std::uint32_t instance_count,
+            std::uint32_t first_index,
+            std::int32_t vertex_offset,
+            std::uint32_t first_instance) override;
+        void DrawIndexedIndirect(
+            Buffer buffer,
+            std::size_t offset,
+            std::uint32_t draw_count,
+            std::uint32_t stride) override;
 
         void Dispatch(std::uint32_t x, std::uint32_t y, std::uint32_t z) override;
 
@@ -275,13 +536,46 @@ namespace glal::opengl
             std::size_t dst_offset,
             std::size_t size) override;
         void CopyBufferToImage(Buffer src_buffer, Image dst_image) override;
+        void CopyBufferToImage(
+            Buffer src_buffer,
+            Image dst_image,
+            std::size_t src_offset,
+            std::uint32_t mip_level) override;
+        void CopyImageToBuffer(
+            Image src_image,
+            Buffer dst_buffer,
+            std::size_t dst_offset,
+            std::uint32_t mip_level) override;
 
         void Transition(Resource resource, ResourceState state) override;
 
+        void ResetQueries(QueryPool query_pool, std::uint32_t first_query, std::uint32_t query_count) override;
+        void WriteTimestamp(QueryPool query_pool, std::uint32_t query) override;
+        void BeginQuery(QueryPool query_pool, std::uint32_t query) override;
+        void EndQuery(QueryPool query_pool, std::uint32_t query) override;
+
+        /**
+         * GetCommands - the recorded commands of a deferred command buffer, empty for immediate ones
+         */
+        [[nodiscard]] const std::vector<std::function<void()>> &GetCommands() const;
+
     private:
+        /**
+         * Record - runs the command right away, or keeps it for the queue if the command buffer is deferred
+         */
+        void Record(std::function<void()> command);
+
+        /**
+         * FlushPushConstants - binds the current push constants before a draw or dispatch
+         */
+        void FlushPushConstants();
+
         DeviceT *m_Device;
         CommandBufferUsage m_Usage;
 
+        bool m_Deferred;
+        std::vector<std::function<void()>> m_Commands;
+
         PipelineT *m_Pipeline;
         RenderPassT *m_RenderPass;
         FramebufferT *m_Framebuffer;
@@ -289,19 +583,129 @@ namespace glal::opengl
         GLuint m_VertexArray;
 
         DataType m_IndexType;
+
+        /**
+         * pushed values are kept here and copied to a fresh ring slice before the next draw or dispatch that follows
+         * a change
+         */
+        std::array<std::byte, MaxPushConstantsSize> m_PushConstants;
+        std::uint32_t m_PushConstantsSize;
+        bool m_PushConstantsDirty;
     };
 
+    /**
+     * Fence - the graphics queue attaches a sync object, the transfer worker signals the fence itself once its
+     * commands completed
+     */
     class FenceT final : public glal::FenceT
     {
     public:
         explicit FenceT(DeviceT *device);
+        ~FenceT() override;
 
         void Wait() override;
         void Reset() override;
+        [[nodiscard]] bool IsSignaled() override;
+
+        void Submit(GLsync sync);
+        void Signal();
 
     private:
         DeviceT *m_Device;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+
         GLsync m_Sync;
+        bool m_Pending;
+        bool m_Signaled;
+    };
+
+    class SemaphoreT final : public glal::SemaphoreT
+    {
+        struct PendingSignal
+        {
+            std::uint64_t Value;
+            GLsync Sync;
+        };
+
+    public:
+        explicit SemaphoreT(DeviceT *device, const SemaphoreDesc &desc);
+        ~SemaphoreT() override;
+
+        [[nodiscard]] SemaphoreType GetType() const override;
+        [[nodiscard]] std::uint64_t GetValue() override;
+
+        bool Wait(std::uint64_t value, std::uint64_t timeout) override;
+        void Signal(std::uint64_t value) override;
+
+        /**
+         * ResolveSignalValue, ResolveWaitValue - binary semaphores count their signals and waits in submission
+         * order, so the n-th wait pairs with the n-th signal. timeline values pass through
+         */
+        std::uint64_t ResolveSignalValue(std::uint64_t value);
+        std::uint64_t ResolveWaitValue(std::uint64_t value);
+
+        /**
+         * Enqueue - attaches the sync of the submission that signals the value, nullptr signals it right away
+         */
+        void Enqueue(GLsync sync, std::uint64_t value);
+
+        /**
+         * WaitOnGpu - makes the current context wait for the value without blocking the host once the signaling
+         * submission was issued
+         */
+        void WaitOnGpu(std::uint64_t value);
+
+    private:
+        void Poll();
+
+        DeviceT *m_Device;
+
+        SemaphoreType m_Type;
+
+        std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+
+        std::uint64_t m_Value;
+        std::uint64_t m_IssuedValue;
+        std::deque<PendingSignal> m_Pending;
+
+        std::uint64_t m_BinarySignals;
+        std::uint64_t m_BinaryWaits;
+    };
+
+    /**
+     * Query Pool - one query object per query, pipeline statistics queries take one per counter, since gl only has a
+     * target per counter
+     */
+    class QueryPoolT final : public glal::QueryPoolT
+    {
+    public:
+        explicit QueryPoolT(DeviceT *device, const QueryPoolDesc &desc);
+        ~QueryPoolT() override;
+
+        [[nodiscard]] QueryType GetType() const override;
+        [[nodiscard]] std::uint32_t GetCount() const override;
+
+        [[nodiscard]] bool GetResults(
+            std::uint32_t first_query,
+            std::uint32_t query_count,
+            std::uint64_t *results) override;
+
+        /**
+         * GetTargets - the query targets of a single query, in the order of its results
+         */
+        [[nodiscard]] std::span<const GLenum> GetTargets() const;
+        [[nodiscard]] const GLuint *GetHandles(std::uint32_t query) const;
+
+    private:
+        DeviceT *m_Device;
+
+        QueryType m_Type;
+        std::uint32_t m_Count;
+
+        std::vector<GLuint> m_Handles;
     };
 
     class BufferT final : public glal::BufferT
@@ -326,6 +730,11 @@ namespace glal::opengl
         MemoryUsage m_Memory;
 
         GLuint m_Handle;
+
+        /**
+         * staging buffers stay mapped for their whole lifetime, so any thread may write through the pointer
+         */
+        void *m_PersistentMapping;
     };
 
     class ImageT final : public glal::ImageT
@@ -393,7 +802,6 @@ namespace glal::opengl
         {
             ImageT *ImageRef;
             ImageViewT *ImageViewRef;
-            FenceT *FenceRef;
         };
 
     public:
@@ -404,8 +812,8 @@ namespace glal::opengl
         [[nodiscard]] ImageView GetImageView(std::uint32_t index) const override;
         [[nodiscard]] Extent2D GetExtent() const override;
 
-        std::uint32_t AcquireNextImage(Fence fence) override;
-        void Present() const override;
+        std::uint32_t AcquireNextImage(Semaphore semaphore, Fence fence) override;
+        void Present() const;
 
     private:
         DeviceT *m_Device;
@@ -426,12 +834,23 @@ namespace glal::opengl
 
         [[nodiscard]] ShaderStage GetStage() const override;
 
+        /**
+         * CreateShader - a new shader object specialized with the constants, owned by the caller. gl specializes
+         * shader objects instead of programs, so every variant needs its own. its compile status is left to the
+         * caller, querying it waits for the specialization
+         */
+        [[nodiscard]] GLuint CreateShader(const SpecializationConstant *constants, std::uint32_t constant_count) const;
+
+        [[nodiscard]] std::uint64_t GetHash() const override;
+
         [[nodiscard]] GLuint GetHandle() const;
 
     private:
         DeviceT *m_Device;
 
         ShaderStage m_Stage;
+        std::uint64_t m_Hash;
+        std::vector<char> m_Code;
 
         GLuint m_Handle;
     };
@@ -444,22 +863,29 @@ namespace glal::opengl
         [[nodiscard]] std::uint32_t GetDescriptorSetLayoutCount() const override;
         [[nodiscard]] DescriptorSetLayout GetDescriptorSetLayout(std::uint32_t index) const override;
 
+        [[nodiscard]] std::uint32_t GetPushConstantRangeCount() const override;
+        [[nodiscard]] const PushConstantRange &GetPushConstantRange(std::uint32_t index) const override;
+
     private:
         DeviceT *m_Device;
 
         std::vector<DescriptorSetLayout> m_DescriptorSetLayouts;
+        std::vector<PushConstantRange> m_PushConstantRanges;
     };
 
     class PipelineT final : public glal::PipelineT
     {
     public:
-        explicit PipelineT(DeviceT *device, const PipelineDesc &desc);
+        explicit PipelineT(DeviceT *device, const PipelineDesc &desc, bool async);
         ~PipelineT() override;
 
         [[nodiscard]] PipelineType GetType() const override;
         [[nodiscard]] PrimitiveTopology GetTopology() const override;
 
+        [[nodiscard]] PipelineStatus GetStatus() override;
+
         [[nodiscard]] GLuint GetHandle() const;
+        [[nodiscard]] const StateBlock &GetStateBlock() const;
 
         void BindVertexArray(GLuint vertex_array) const;
         void BindVertexBuffer(
@@ -469,6 +895,12 @@ namespace glal::opengl
             std::uint32_t offset) const;
 
     private:
+        /**
+         * Compile - loads the cached binary or specializes the shaders and links them, without querying any status
+         */
+        void Compile();
+        void Finish(bool fatal);
+
         DeviceT *m_Device;
         PipelineLayoutT *m_Layout;
 
@@ -476,8 +908,24 @@ namespace glal::opengl
         PrimitiveTopology m_Topology;
         std::vector<VertexBinding> m_VertexBindings;
         std::vector<VertexAttribute> m_VertexAttributes;
+        StateBlock m_StateBlock;
 
         GLuint m_Handle;
+
+        /**
+         * the stages are compiled after the descriptor is gone, their constants point into the owned array
+         */
+        std::vector<PipelineStage> m_Stages;
+        std::vector<SpecializationConstant> m_SpecializationConstants;
+
+        PipelineStatus m_Status;
+        std::uint64_t m_Key;
+        std::vector<GLuint> m_Shaders;
+
+        /**
+         * signaled once the compile queue is done with the pipeline, nullptr when it was compiled on this context
+         */
+        FenceT *m_CompileFence;
     };
 
     void TranslateImageFormat(
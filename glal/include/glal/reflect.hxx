@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <glal/cache.hxx>
+#include <glal/common.hxx>
+#include <glal/desc.hxx>
+#include <glal/enum.hxx>
+#include <glal/forward.hxx>
+
+namespace glal
+{
+    /**
+     * Block Member - a single member of a uniform, storage or push constant block, laid out as the shader declares it
+     */
+    struct BlockMember
+    {
+        std::string Name;
+        std::uint32_t Offset;
+        std::uint32_t Size;
+
+        DataType Type;
+        std::uint32_t Count;
+        std::uint32_t MatrixStride;
+
+        std::uint32_t ArrayCount;
+        std::uint32_t ArrayStride;
+    };
+
+    /**
+     * Block Layout - the members of a block, size is the end of the last member (runtime arrays count as empty)
+     */
+    struct BlockLayout
+    {
+        std::string Name;
+        std::uint32_t Size;
+        std::vector<BlockMember> Members;
+
+        [[nodiscard]] const BlockMember *FindMember(std::string_view name) const;
+    };
+
+    /**
+     * Reflected Binding - a descriptor as used by a single shader stage
+     */
+    struct ReflectedBinding
+    {
+        std::string Name;
+        std::uint32_t Set;
+        DescriptorBinding Binding;
+
+        /**
+         * only filled for uniform and storage buffers
+         */
+        BlockLayout Block;
+    };
+
+    /**
+     * Reflected Input - a stage input with an explicit location, matrices are split into one input per column
+     */
+    struct ReflectedInput
+    {
+        std::string Name;
+        std::uint32_t Location;
+        DataType Type;
+        std::uint32_t Count;
+    };
+
+    /**
+     * Reflected Specialization Constant - a constant the stage declares with a constant_id
+     */
+    struct ReflectedSpecializationConstant
+    {
+        std::string Name;
+        std::uint32_t Id;
+    };
+
+    /**
+     * Shader Reflection - everything the pipeline layout and vertex input of a shader module can be derived from
+     */
+    struct ShaderReflection
+    {
+        ShaderStage Stage;
+
+        std::vector<ReflectedBinding> Bindings;
+        std::vector<ReflectedInput> Inputs;
+
+        /**
+         * sorted by id
+         */
+        std::vector<ReflectedSpecializationConstant> SpecializationConstants;
+
+        std::vector<PushConstantRange> PushConstantRanges;
+        BlockLayout PushConstantBlock;
+
+        [[nodiscard]] const ReflectedBinding *FindBinding(std::string_view name) const;
+        [[nodiscard]] const ReflectedSpecializationConstant *FindSpecializationConstant(std::uint32_t id) const;
+    };
+
+    /**
+     * Reflect - parses the SPIR-V code of a shader module descriptor
+     */
+    ShaderReflection Reflect(const ShaderModuleDesc &desc);
+
+    /**
+     * Derive Vertex Input - packs the inputs of a vertex shader into a single interleaved binding in location order
+     */
+    VertexBinding DeriveVertexInput(
+        const ShaderReflection &reflection,
+        std::uint32_t binding,
+        std::vector<VertexAttribute> &attributes);
+
+    /**
+     * Layout Cache - creates descriptor set and pipeline layouts from shader reflection and hands out the same object
+     * for identical layouts. owns everything it created
+     */
+    class LayoutCache final
+    {
+    public:
+        explicit LayoutCache(Device device);
+        ~LayoutCache();
+
+        DescriptorSetLayout GetDescriptorSetLayout(const DescriptorSetLayoutDesc &desc);
+        PipelineLayout GetPipelineLayout(const PipelineLayoutDesc &desc);
+
+        /**
+         * GetPipelineLayout - merges the bindings of all stages, unused sets in between get empty layouts
+         */
+        PipelineLayout GetPipelineLayout(const ShaderReflection *reflections, std::uint32_t reflection_count);
+
+        /**
+         * Clear - destroys all cached layouts, has to happen before the device is destroyed
+         */
+        void Clear();
+
+    private:
+        Device m_Device;
+
+        std::unordered_map<CacheKey, DescriptorSetLayout, CacheKeyHash> m_DescriptorSetLayouts;
+        std::unordered_map<CacheKey, PipelineLayout, CacheKeyHash> m_PipelineLayouts;
+    };
+}
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <filesystem>
+#include <future>
 #include <vector>
+#include <glal/cache.hxx>
 #include <glal/glal.hxx>
 #include <vulkan/vulkan.h>
 
@@ -22,6 +26,8 @@ namespace glal::vulkan
     class SwapchainT;
     class CommandBufferT;
     class FenceT;
+    class SemaphoreT;
+    class QueryPoolT;
     class QueueT;
 
     class InstanceT final : public glal::InstanceT
@@ -34,10 +40,16 @@ namespace glal::vulkan
 
         VkInstance GetHandle() const;
 
+        [[nodiscard]] const std::filesystem::path &GetPipelineCachePath() const;
+        [[nodiscard]] bool IsHeadless() const;
+
     private:
         VkInstance m_Handle;
         VkDebugUtilsMessengerEXT m_DebugUtilsMessenger;
         std::vector<PhysicalDeviceT> m_PhysicalDevices;
+
+        std::filesystem::path m_PipelineCachePath;
+        bool m_Headless;
     };
 
     class PhysicalDeviceT final : public glal::PhysicalDeviceT
@@ -60,6 +72,8 @@ namespace glal::vulkan
         std::vector<DeviceT *> m_Devices;
 
         VkPhysicalDevice m_Handle;
+
+        DeviceLimits m_Limits;
     };
 
     class DeviceT final : public glal::DeviceT
@@ -89,6 +103,7 @@ namespace glal::vulkan
         void DestroyPipelineLayout(PipelineLayout pipeline_layout) override;
 
         Pipeline CreatePipeline(const PipelineDesc &desc) override;
+        Pipeline CreatePipelineAsync(const PipelineDesc &desc) override;
         void DestroyPipeline(Pipeline pipeline) override;
 
         DescriptorSetLayout CreateDescriptorSetLayout(const DescriptorSetLayoutDesc &desc) override;
@@ -106,20 +121,35 @@ namespace glal::vulkan
         Framebuffer CreateFramebuffer(const FramebufferDesc &desc) override;
         void DestroyFramebuffer(Framebuffer framebuffer) override;
 
-        CommandBuffer CreateCommandBuffer(CommandBufferUsage usage) override;
+        CommandBuffer CreateCommandBuffer(CommandBufferUsage usage, QueueType queue_type) override;
         void DestroyCommandBuffer(CommandBuffer command_buffer) override;
 
         Fence CreateFence() override;
         void DestroyFence(Fence fence) override;
 
+        Semaphore CreateSemaphore(const SemaphoreDesc &desc) override;
+        void DestroySemaphore(Semaphore semaphore) override;
+
+        QueryPool CreateQueryPool(const QueryPoolDesc &desc) override;
+        void DestroyQueryPool(QueryPool query_pool) override;
+
         Queue GetQueue(QueueType type) override;
 
         [[nodiscard]] bool Supports(DeviceFeature feature) const override;
         [[nodiscard]] const DeviceLimits &GetLimits() const override;
 
         [[nodiscard]] VkDevice GetHandle() const;
+        [[nodiscard]] VkPipelineCache GetPipelineCache() const;
+
+        /**
+         * GetSharingQueueFamilies - the families resources are shared between, so uploads on the transfer queue need
+         * no ownership transfers
+         */
+        [[nodiscard]] const std::vector<std::uint32_t> &GetSharingQueueFamilies() const;
 
     private:
+        void SavePipelineCache() const;
+
         PhysicalDeviceT *m_PhysicalDevice;
 
         std::vector<BufferT *> m_Buffers;
@@ -136,10 +166,34 @@ namespace glal::vulkan
         std::vector<FramebufferT *> m_Framebuffers;
         std::vector<CommandBufferT *> m_CommandBuffers;
         std::vector<FenceT *> m_Fences;
+        std::vector<SemaphoreT *> m_Semaphores;
+        std::vector<QueryPoolT *> m_QueryPools;
+
+        /**
+         * samplers, pipelines and descriptor set layouts with identical descriptors are shared, see ObjectCache
+         */
+        ObjectCache<SamplerT> m_SharedSamplers;
+        ObjectCache<PipelineT> m_SharedPipelines;
+        ObjectCache<DescriptorSetLayoutT> m_SharedDescriptorSetLayouts;
 
         std::vector<QueueT *> m_Queues;
+        std::vector<std::uint32_t> m_SharingQueueFamilies;
 
         VkDevice m_Handle;
+
+        std::filesystem::path m_PipelineCachePath;
+        VkPipelineCache m_PipelineCache;
+    };
+
+    /**
+     * Resource Access - how a resource was last used, the source scope of the next barrier on it. tracked while
+     * recording, so command buffers have to be submitted in the order they were recorded
+     */
+    struct ResourceAccess
+    {
+        VkPipelineStageFlags Stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        VkAccessFlags Access = 0;
+        VkImageLayout Layout = VK_IMAGE_LAYOUT_UNDEFINED;
     };
 
     class BufferT final : public glal::BufferT
@@ -155,6 +209,8 @@ namespace glal::vulkan
 
         [[nodiscard]] VkBuffer GetHandle() const;
 
+        [[nodiscard]] ResourceAccess &GetAccess();
+
     private:
         DeviceT *m_Device;
 
@@ -163,6 +219,8 @@ namespace glal::vulkan
 
         VkBuffer m_Handle;
         VkDeviceMemory m_MemoryHandle;
+
+        ResourceAccess m_Access;
     };
 
     class ImageT final : public glal::ImageT
@@ -181,6 +239,8 @@ namespace glal::vulkan
 
         [[nodiscard]] VkImage GetHandle() const;
 
+        [[nodiscard]] ResourceAccess &GetAccess();
+
     private:
         DeviceT *m_Device;
 
@@ -191,6 +251,9 @@ namespace glal::vulkan
         std::uint32_t m_ArrayLayerCount;
 
         VkImage m_Handle;
+        VkDeviceMemory m_MemoryHandle;
+
+        ResourceAccess m_Access;
     };
 
     class ImageViewT final : public glal::ImageViewT
@@ -234,6 +297,7 @@ namespace glal::vulkan
         ~ShaderModuleT() override;
 
         [[nodiscard]] ShaderStage GetStage() const override;
+        [[nodiscard]] std::uint64_t GetHash() const override;
 
         [[nodiscard]] VkShaderModule GetHandle() const;
 
@@ -241,6 +305,7 @@ namespace glal::vulkan
         DeviceT *m_Device;
 
         ShaderStage m_Stage;
+        std::uint64_t m_Hash;
 
         VkShaderModule m_Handle;
     };
@@ -253,11 +318,15 @@ namespace glal::vulkan
         [[nodiscard]] std::uint32_t GetDescriptorSetLayoutCount() const override;
         [[nodiscard]] DescriptorSetLayout GetDescriptorSetLayout(std::uint32_t index) const override;
 
+        [[nodiscard]] std::uint32_t GetPushConstantRangeCount() const override;
+        [[nodiscard]] const PushConstantRange &GetPushConstantRange(std::uint32_t index) const override;
+
         [[nodiscard]] VkPipelineLayout GetHandle() const;
 
     private:
         DeviceT *m_Device;
         std::vector<DescriptorSetLayout> m_DescriptorSetLayouts;
+        std::vector<PushConstantRange> m_PushConstantRanges;
 
         VkPipelineLayout m_Handle;
     };
@@ -265,21 +334,35 @@ namespace glal::vulkan
     class PipelineT final : public glal::PipelineT
     {
     public:
-        explicit PipelineT(DeviceT *device, const PipelineDesc &desc);
+        explicit PipelineT(DeviceT *device, const PipelineDesc &desc, bool async);
         ~PipelineT() override;
 
         [[nodiscard]] PipelineType GetType() const override;
         [[nodiscard]] PrimitiveTopology GetTopology() const override;
 
+        [[nodiscard]] PipelineStatus GetStatus() override;
+
         [[nodiscard]] VkPipeline GetHandle() const;
+        [[nodiscard]] PipelineLayoutT *GetLayout() const;
 
     private:
+        void Create();
+
         DeviceT *m_Device;
 
         PipelineType m_Type;
         PrimitiveTopology m_Topology;
 
+        PipelineDesc m_Desc;
+        std::vector<PipelineStage> m_Stages;
+        std::vector<SpecializationConstant> m_SpecializationConstants;
+        std::vector<VertexBinding> m_VertexBindings;
+        std::vector<VertexAttribute> m_VertexAttributes;
+
         VkPipeline m_Handle;
+
+        std::atomic<PipelineStatus> m_Status;
+        std::future<void> m_Future;
     };
 
     class DescriptorSetLayoutT final : public glal::DescriptorSetLayoutT
@@ -322,14 +405,18 @@ namespace glal::vulkan
             ImageView image_view,
             Sampler sampler) override;
 
-        void Bind() const;
+        void BindImageView(
+            std::uint32_t binding,
+            std::uint32_t array_element,
+            ImageView image_view,
+            Sampler sampler) override;
+
+        [[nodiscard]] VkDescriptorSet GetHandle() const;
 
     private:
         DeviceT *m_Device;
         DescriptorSetLayoutT *m_Layout;
 
-        std::vector<VkWriteDescriptorSet> m_WriteDescriptorSets;
-
         VkDescriptorSet m_Handle;
         VkDescriptorPool m_PoolHandle;
     };
@@ -344,21 +431,28 @@ namespace glal::vulkan
     {
     public:
         explicit SwapchainT(DeviceT *device, const SwapchainDesc &desc);
+        ~SwapchainT() override;
 
         [[nodiscard]] std::uint32_t GetImageCount() const override;
         [[nodiscard]] ImageView GetImageView(std::uint32_t index) const override;
 
         [[nodiscard]] Extent2D GetExtent() const override;
 
-        std::uint32_t AcquireNextImage(Fence fence) override;
+        std::uint32_t AcquireNextImage(Semaphore semaphore, Fence fence) override;
 
-        void Present() const override;
+        void Present(VkQueue queue, VkSemaphore wait_semaphore) const;
 
     private:
+        /**
+         * Signal - offscreen images are available immediately, an empty submission hands that to the waiters
+         */
+        void Signal(VkSemaphore semaphore, VkFence fence) const;
+
         DeviceT *m_Device;
 
         std::vector<Frame> m_Frames;
         Extent2D m_Extent;
+        std::uint32_t m_ImageIndex;
 
         VkSwapchainKHR m_Handle;
         VkSurfaceKHR m_Surface;
@@ -403,7 +497,7 @@ namespace glal::vulkan
     class CommandBufferT final : public glal::CommandBufferT
     {
     public:
-        explicit CommandBufferT(DeviceT *device, CommandBufferUsage usage);
+        explicit CommandBufferT(DeviceT *device, CommandBufferUsage usage, QueueType queue_type);
         ~CommandBufferT() override;
 
         void Begin() override;
@@ -423,10 +517,33 @@ namespace glal::vulkan
         void BindDescriptorSets(
             std::uint32_t first_set,
             std::uint32_t set_count,
-            const DescriptorSet *descriptor_sets) override;
+            const DescriptorSet *descriptor_sets,
+            std::uint32_t dynamic_offset_count,
+            const std::uint32_t *dynamic_offsets) override;
+        void PushConstants(
+            ShaderStage stages,
+            std::uint32_t offset,
+            std::uint32_t size,
+            const void *data) override;
 
         void Draw(std::uint32_t vertex_count, std::uint32_t first_vertex) override;
         void DrawIndexed(std::uint32_t index_count, std::uint32_t first_index) override;
+        void DrawInstanced(
+            std::uint32_t vertex_count,
+            std::uint32_t instance_count,
+            std::uint32_t first_vertex,
+            std::uint32_t first_instance) override;
+        void DrawIndexedInstanced(
+            std::uint32_t index_count,
+            std::uint32_t instance_count,
+            std::uint32_t first_index,
+            std::int32_t vertex_offset,
+            std::uint32_t first_instance) override;
+        void DrawIndexedIndirect(
+            Buffer buffer,
+            std::size_t offset,
+            std::uint32_t draw_count,
+            std::uint32_t stride) override;
 
         void Dispatch(std::uint32_t x, std::uint32_t y, std::uint32_t z) override;
 
@@ -437,14 +554,33 @@ namespace glal::vulkan
             std::size_t dst_offset,
             std::size_t size) override;
         void CopyBufferToImage(Buffer src_buffer, Image dst_image) override;
+        void CopyBufferToImage(
+            Buffer src_buffer,
+            Image dst_image,
+            std::size_t src_offset,
+            std::uint32_t mip_level) override;
+        void CopyImageToBuffer(
+            Image src_image,
+            Buffer dst_buffer,
+            std::size_t dst_offset,
+            std::uint32_t mip_level) override;
 
         void Transition(Resource resource, ResourceState state) override;
 
+        void ResetQueries(QueryPool query_pool, std::uint32_t first_query, std::uint32_t query_count) override;
+        void WriteTimestamp(QueryPool query_pool, std::uint32_t query) override;
+        void BeginQuery(QueryPool query_pool, std::uint32_t query) override;
+        void EndQuery(QueryPool query_pool, std::uint32_t query) override;
+
+        [[nodiscard]] VkCommandBuffer GetHandle() const;
+
     private:
         DeviceT *m_Device;
 
         VkCommandPool m_PoolHandle;
         VkCommandBuffer m_Handle;
+
+        PipelineT *m_Pipeline;
     };
 
     class FenceT final : public glal::FenceT
@@ -455,6 +591,9 @@ namespace glal::vulkan
 
         void Wait() override;
         void Reset() override;
+        [[nodiscard]] bool IsSignaled() override;
+
+        [[nodiscard]] VkFence GetHandle() const;
 
     private:
         DeviceT *m_Device;
@@ -462,23 +601,101 @@ namespace glal::vulkan
         VkFence m_Handle;
     };
 
+    class SemaphoreT final : public glal::SemaphoreT
+    {
+    public:
+        explicit SemaphoreT(DeviceT *device, const SemaphoreDesc &desc);
+        ~SemaphoreT() override;
+
+        [[nodiscard]] SemaphoreType GetType() const override;
+        [[nodiscard]] std::uint64_t GetValue() override;
+
+        bool Wait(std::uint64_t value, std::uint64_t timeout) override;
+        void Signal(std::uint64_t value) override;
+
+        [[nodiscard]] VkSemaphore GetHandle() const;
+
+    private:
+        DeviceT *m_Device;
+
+        SemaphoreType m_Type;
+
+        VkSemaphore m_Handle;
+    };
+
+    class QueryPoolT final : public glal::QueryPoolT
+    {
+    public:
+        explicit QueryPoolT(DeviceT *device, const QueryPoolDesc &desc);
+        ~QueryPoolT() override;
+
+        [[nodiscard]] QueryType GetType() const override;
+        [[nodiscard]] std::uint32_t GetCount() const override;
+
+        [[nodiscard]] bool GetResults(
+            std::uint32_t first_query,
+            std::uint32_t query_count,
+            std::uint64_t *results) override;
+
+        [[nodiscard]] VkQueryPool GetHandle() const;
+
+    private:
+        DeviceT *m_Device;
+
+        QueryType m_Type;
+        std::uint32_t m_Count;
+
+        VkQueryPool m_Handle;
+    };
+
     class QueueT final : public glal::QueueT
     {
     public:
+        explicit QueueT(DeviceT *device, std::uint32_t family_index, QueueType types);
+
         void Submit(
             const CommandBuffer *command_buffers,
             std::uint32_t command_buffer_count,
             Fence fence) override;
+        void Submit(const SubmitDesc &desc) override;
+
+        void Present(Swapchain swapchain, Semaphore wait_semaphore) override;
+
+        [[nodiscard]] std::uint32_t GetFamilyIndex() const;
+        [[nodiscard]] QueueType GetTypes() const;
 
-        void Present(Swapchain swapchain) override;
+        [[nodiscard]] VkQueue GetHandle() const;
+
+    private:
+        DeviceT *m_Device;
+
+        std::uint32_t m_FamilyIndex;
+        QueueType m_Types;
+
+        VkQueue m_Handle;
     };
 
     VkFilter ToVkFilter(Filter filter);
     VkSamplerAddressMode ToVkAddressMode(AddressMode address_mode);
     VkPipelineBindPoint ToVkPipelineBindPoint(PipelineType pipeline_type);
     VkShaderStageFlagBits ToVkShaderStage(ShaderStage shader_stage);
+    VkShaderStageFlags ToVkShaderStageFlags(ShaderStage shader_stages);
     VkFormat ToVkFormat(DataType data_type, std::uint32_t count);
     VkFormat ToVkFormat(ImageFormat image_format);
     VkPrimitiveTopology ToVkPrimitiveTopology(PrimitiveTopology primitive_topology);
+    VkCullModeFlags ToVkCullMode(CullMode cull_mode);
+
+    /**
+     * ToVkFrontFace - the viewport is not flipped, so vulkan sees every triangle mirrored compared to opengl
+     */
+    VkFrontFace ToVkFrontFace(FrontFace front_face);
+    VkIndexType ToVkIndexType(DataType data_type);
+    ResourceAccess ToVkResourceAccess(ResourceState resource_state);
     VkDescriptorType ToVkDescriptorType(DescriptorType descriptor_type);
+    VkDescriptorBindingFlags ToVkDescriptorBindingFlags(DescriptorBindingFlag descriptor_binding_flags);
+
+    std::uint32_t FindMemoryTypeIndex(
+        VkPhysicalDevice physical_device,
+        std::uint32_t type_bits,
+        VkMemoryPropertyFlags property_flags);
 }
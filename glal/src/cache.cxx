@@ -0,0 +1,86 @@
+#include <cstdint>
+#include <common/hash.hxx>
+#include <glal/cache.hxx>
+#include <glal/glal.hxx>
+
+void glal::AddDescriptorBinding(CacheKey &key, const DescriptorBinding &binding)
+{
+    key.Add(binding.Binding);
+    key.Add(binding.Type);
+    key.Add(binding.Count);
+    key.Add(binding.Stages);
+    key.Add(binding.Flags);
+}
+
+glal::CacheKey glal::GetSamplerKey(const SamplerDesc &desc)
+{
+    CacheKey key;
+    key.Add(desc.MinFilter);
+    key.Add(desc.MagFilter);
+    key.Add(desc.AddressU);
+    key.Add(desc.AddressV);
+    key.Add(desc.AddressW);
+    return key;
+}
+
+glal::CacheKey glal::GetDescriptorSetLayoutKey(const DescriptorSetLayoutDesc &desc)
+{
+    CacheKey key;
+    key.Add(desc.Set);
+    key.Add(desc.DescriptorBindingCount);
+    for (std::uint32_t i = 0; i < desc.DescriptorBindingCount; ++i)
+        AddDescriptorBinding(key, desc.DescriptorBindings[i]);
+    return key;
+}
+
+glal::CacheKey glal::GetPipelineKey(const PipelineDesc &desc)
+{
+    CacheKey key;
+    key.Add(desc.Type);
+
+    // the counts keep the variable length arrays apart
+    key.Add(desc.StageCount);
+    for (std::uint32_t i = 0; i < desc.StageCount; ++i)
+    {
+        const auto &stage = desc.Stages[i];
+        key.Add(stage.Stage);
+        key.Add(stage.Module->GetHash());
+        key.Add(stage.SpecializationConstantCount);
+        for (std::uint32_t j = 0; j < stage.SpecializationConstantCount; ++j)
+        {
+            key.Add(stage.SpecializationConstants[j].Id);
+            key.Add(stage.SpecializationConstants[j].Value);
+        }
+    }
+
+    key.Add(desc.VertexBindingCount);
+    for (std::uint32_t i = 0; i < desc.VertexBindingCount; ++i)
+    {
+        const auto &binding = desc.VertexBindings[i];
+        key.Add(binding.Binding);
+        key.Add(binding.Stride);
+        key.Add(binding.Instance);
+    }
+
+    key.Add(desc.VertexAttributeCount);
+    for (std::uint32_t i = 0; i < desc.VertexAttributeCount; ++i)
+    {
+        const auto &attribute = desc.VertexAttributes[i];
+        key.Add(attribute.Binding);
+        key.Add(attribute.Location);
+        key.Add(attribute.Type);
+        key.Add(attribute.Count);
+        key.Add(attribute.Offset);
+    }
+
+    key.Add(desc.Topology);
+    key.Add(desc.PrimitiveRestartEnable);
+    key.Add(desc.Culling);
+    key.Add(desc.Winding);
+    key.Add(reinterpret_cast<std::uintptr_t>(desc.Layout));
+    key.Add(reinterpret_cast<std::uintptr_t>(desc.Pass));
+    key.Add(desc.DepthTest);
+    key.Add(desc.DepthWrite);
+    key.Add(desc.BlendEnable);
+    return key;
+}
@@ -0,0 +1,36 @@
+#include <fstream>
+#include <common/log.hxx>
+#include <glal/file.hxx>
+
+bool glal::WriteFileAtomic(const std::filesystem::path &path, const std::function<void(std::ostream &)> &write)
+{
+    auto temporary_path = path;
+    temporary_path += ".tmp";
+
+    {
+        std::ofstream stream(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open())
+        {
+            common::Log(common::LogLevel_Warning, "failed to write {}", path);
+            return false;
+        }
+
+        write(stream);
+
+        if (!stream)
+        {
+            common::Log(common::LogLevel_Warning, "failed to write {}", path);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary_path, path, error);
+    if (error)
+    {
+        common::Log(common::LogLevel_Warning, "failed to write {}: {}", path, error.message());
+        return false;
+    }
+
+    return true;
+}
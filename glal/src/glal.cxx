@@ -1,5 +1,74 @@
+#include <common/log.hxx>
 #include <glal/glal.hxx>
 
+void glal::GetFormatBlock(
+    const ImageFormat format,
+    std::uint32_t *block_width,
+    std::uint32_t *block_height,
+    std::uint32_t *block_size)
+{
+    std::uint32_t width = 1, height = 1, size;
+    switch (format)
+    {
+    case ImageFormat_RGBA8_UNorm:
+    case ImageFormat_RGBA8_SRGB:
+    case ImageFormat_BGRA8_UNorm:
+    case ImageFormat_RG16F:
+    case ImageFormat_D24S8:
+    case ImageFormat_D32F:
+        size = 4;
+        break;
+    case ImageFormat_RGBA16F:
+        size = 8;
+        break;
+    case ImageFormat_RGBA32F:
+        size = 16;
+        break;
+    case ImageFormat_BC1_UNorm:
+    case ImageFormat_BC1_SRGB:
+    case ImageFormat_BC4_UNorm:
+    case ImageFormat_ETC2_RGB8_UNorm:
+        width = height = 4;
+        size = 8;
+        break;
+    case ImageFormat_BC3_UNorm:
+    case ImageFormat_BC3_SRGB:
+    case ImageFormat_BC5_UNorm:
+    case ImageFormat_BC6H_UFloat:
+    case ImageFormat_BC7_UNorm:
+    case ImageFormat_BC7_SRGB:
+    case ImageFormat_ETC2_RGBA8_UNorm:
+    case ImageFormat_ASTC_4x4_UNorm:
+    case ImageFormat_ASTC_4x4_SRGB:
+        width = height = 4;
+        size = 16;
+        break;
+    default:
+        common::Fatal("image format not supported");
+    }
+
+    block_width && ((*block_width = width));
+    block_height && ((*block_height = height));
+    block_size && ((*block_size = size));
+}
+
+bool glal::IsCompressedFormat(const ImageFormat format)
+{
+    std::uint32_t block_width;
+    GetFormatBlock(format, &block_width, nullptr, nullptr);
+    return block_width > 1;
+}
+
+std::size_t glal::GetImageDataSize(const ImageFormat format, const Extent3D extent)
+{
+    std::uint32_t block_width, block_height, block_size;
+    GetFormatBlock(format, &block_width, &block_height, &block_size);
+
+    const std::size_t blocks_x = (extent.Width + block_width - 1) / block_width;
+    const std::size_t blocks_y = (extent.Height + block_height - 1) / block_height;
+    return blocks_x * blocks_y * extent.Depth * block_size;
+}
+
 void glal::DestroyInstance(Instance instance)
 {
     delete instance;
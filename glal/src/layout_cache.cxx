@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <map>
+#include <common/log.hxx>
+#include <glal/cache.hxx>
+#include <glal/glal.hxx>
+#include <glal/reflect.hxx>
+
+glal::LayoutCache::LayoutCache(Device device)
+    : m_Device(device)
+{
+}
+
+glal::LayoutCache::~LayoutCache()
+{
+    Clear();
+}
+
+glal::DescriptorSetLayout glal::LayoutCache::GetDescriptorSetLayout(const DescriptorSetLayoutDesc &desc)
+{
+    auto key = GetDescriptorSetLayoutKey(desc);
+    if (const auto it = m_DescriptorSetLayouts.find(key); it != m_DescriptorSetLayouts.end())
+        return it->second;
+
+    return m_DescriptorSetLayouts[std::move(key)] = m_Device->CreateDescriptorSetLayout(desc);
+}
+
+glal::PipelineLayout glal::LayoutCache::GetPipelineLayout(const PipelineLayoutDesc &desc)
+{
+    CacheKey key;
+    key.Add(desc.DescriptorSetLayoutCount);
+    for (std::uint32_t i = 0; i < desc.DescriptorSetLayoutCount; ++i)
+        key.Add(reinterpret_cast<std::uintptr_t>(desc.DescriptorSetLayouts[i]));
+    for (std::uint32_t i = 0; i < desc.PushConstantRangeCount; ++i)
+    {
+        key.Add(desc.PushConstantRanges[i].Offset);
+        key.Add(desc.PushConstantRanges[i].Size);
+        key.Add(desc.PushConstantRanges[i].Stages);
+    }
+
+    if (const auto it = m_PipelineLayouts.find(key); it != m_PipelineLayouts.end())
+        return it->second;
+
+    return m_PipelineLayouts[std::move(key)] = m_Device->CreatePipelineLayout(desc);
+}
+
+glal::PipelineLayout glal::LayoutCache::GetPipelineLayout(
+    const ShaderReflection *reflections,
+    const std::uint32_t reflection_count)
+{
+    // ordered by set and binding, so identical layouts hash identically regardless of stage order
+    std::map<std::uint32_t, std::map<std::uint32_t, DescriptorBinding>> sets;
+
+    for (std::uint32_t i = 0; i < reflection_count; ++i)
+        for (auto &reflected_binding : reflections[i].Bindings)
+        {
+            auto &bindings = sets[reflected_binding.Set];
+            const auto binding = reflected_binding.Binding;
+
+            if (auto it = bindings.find(binding.Binding); it != bindings.end())
+            {
+                common::Assert(
+                    it->second.Type == binding.Type && it->second.Count == binding.Count,
+                    "conflicting declarations of binding {} in set {}",
+                    binding.Binding,
+                    reflected_binding.Set);
+
+                it->second.Stages = static_cast<ShaderStage>(it->second.Stages | binding.Stages);
+                continue;
+            }
+
+            bindings.emplace(binding.Binding, binding);
+        }
+
+    const auto set_count = sets.empty() ? 0u : sets.rbegin()->first + 1;
+
+    std::vector<DescriptorSetLayout> descriptor_set_layouts(set_count);
+    for (std::uint32_t set = 0; set < set_count; ++set)
+    {
+        std::vector<DescriptorBinding> descriptor_bindings;
+        if (const auto it = sets.find(set); it != sets.end())
+            for (auto &[binding, descriptor_binding] : it->second)
+                descriptor_bindings.push_back(descriptor_binding);
+
+        descriptor_set_layouts[set] = GetDescriptorSetLayout(
+            {
+                .Set = set,
+                .DescriptorBindings = descriptor_bindings.data(),
+                .DescriptorBindingCount = static_cast<std::uint32_t>(descriptor_bindings.size()),
+            });
+    }
+
+    // a stage may only appear in one range, stages declaring the same block share it
+    std::vector<PushConstantRange> push_constant_ranges;
+    for (std::uint32_t i = 0; i < reflection_count; ++i)
+        for (auto &range : reflections[i].PushConstantRanges)
+        {
+            const auto it = std::ranges::find_if(
+                push_constant_ranges,
+                [&range](const PushConstantRange &other)
+                {
+                    return other.Offset == range.Offset && other.Size == range.Size;
+                });
+
+            if (it == push_constant_ranges.end())
+                push_constant_ranges.push_back(range);
+            else
+                it->Stages = static_cast<ShaderStage>(it->Stages | range.Stages);
+        }
+
+    return GetPipelineLayout(
+        {
+            .DescriptorSetLayouts = descriptor_set_layouts.data(),
+            .DescriptorSetLayoutCount = set_count,
+            .PushConstantRanges = push_constant_ranges.data(),
+            .PushConstantRangeCount = static_cast<std::uint32_t>(push_constant_ranges.size()),
+        });
+}
+
+void glal::LayoutCache::Clear()
+{
+    for (auto &[key, pipeline_layout] : m_PipelineLayouts)
+        m_Device->DestroyPipelineLayout(pipeline_layout);
+    for (auto &[key, descriptor_set_layout] : m_DescriptorSetLayouts)
+        m_Device->DestroyDescriptorSetLayout(descriptor_set_layout);
+
+    m_PipelineLayouts.clear();
+    m_DescriptorSetLayouts.clear();
+}
@@ -0,0 +1,32 @@
+#include <common/log.hxx>
+#include <glal/null.hxx>
+
+glal::null::BufferT::BufferT(DeviceT *device, const BufferDesc &desc)
+    : m_Device(device),
+      m_Size(desc.Size),
+      m_Usage(desc.Usage),
+      m_Memory(desc.Memory)
+{
+    if (m_Memory != MemoryUsage_DeviceLocal)
+        m_Data.resize(m_Size);
+}
+
+std::size_t glal::null::BufferT::GetSize() const
+{
+    return m_Size;
+}
+
+glal::BufferUsage glal::null::BufferT::GetUsage() const
+{
+    return m_Usage;
+}
+
+void *glal::null::BufferT::Map()
+{
+    common::Assert(m_Memory != MemoryUsage_DeviceLocal, "device local memory not accessible");
+    return m_Data.data();
+}
+
+void glal::null::BufferT::Unmap()
+{
+}
@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <common/log.hxx>
+#include <common/profile.hxx>
+#include <glal/null.hxx>
+
+glal::null::CommandBufferT::CommandBufferT(DeviceT *device, const CommandBufferUsage usage, const QueueType queue_type)
+    : m_Device(device),
+      m_Usage(usage),
+      m_Record(false),
+      m_Statistics()
+{
+    (void) queue_type;
+}
+
+void glal::null::CommandBufferT::Begin()
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::Begin");
+
+    m_Record = m_Device->IsRecordingStatistics();
+    m_Statistics = {};
+    m_Statistics.CommandBuffers = 1;
+}
+
+void glal::null::CommandBufferT::End()
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::End");
+}
+
+void glal::null::CommandBufferT::BeginRenderPass(RenderPass render_pass, Framebuffer framebuffer)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::BeginRenderPass");
+
+    (void) render_pass;
+    (void) framebuffer;
+
+    if (m_Record)
+        ++m_Statistics.RenderPasses;
+}
+
+void glal::null::CommandBufferT::EndRenderPass()
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::EndRenderPass");
+}
+
+void glal::null::CommandBufferT::SetViewport(
+    const float x,
+    const float y,
+    const float width,
+    const float height,
+    const float min_depth,
+    const float max_depth)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::SetViewport");
+
+    (void) x;
+    (void) y;
+    (void) width;
+    (void) height;
+    (void) min_depth;
+    (void) max_depth;
+}
+
+void glal::null::CommandBufferT::SetScissor(
+    const std::int32_t x,
+    const std::int32_t y,
+    const std::uint32_t width,
+    const std::uint32_t height)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::SetScissor");
+
+    (void) x;
+    (void) y;
+    (void) width;
+    (void) height;
+}
+
+void glal::null::CommandBufferT::BindPipeline(Pipeline pipeline)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::BindPipeline");
+
+    (void) pipeline;
+
+    if (m_Record)
+        ++m_Statistics.PipelineBinds;
+}
+
+void glal::null::CommandBufferT::BindVertexBuffer(Buffer buffer, const std::uint32_t binding, const std::size_t offset)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::BindVertexBuffer");
+
+    (void) buffer;
+    (void) binding;
+    (void) offset;
+
+    if (m_Record)
+        ++m_Statistics.VertexBufferBinds;
+}
+
+void glal::null::CommandBufferT::BindIndexBuffer(Buffer buffer, const DataType type)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::BindIndexBuffer");
+
+    (void) buffer;
+    (void) type;
+
+    if (m_Record)
+        ++m_Statistics.IndexBufferBinds;
+}
+
+void glal::null::CommandBufferT::BindDescriptorSets(
+    const std::uint32_t first_set,
+    const std::uint32_t set_count,
+    const DescriptorSet *descriptor_sets,
+    const std::uint32_t dynamic_offset_count,
+    const std::uint32_t *dynamic_offsets)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::BindDescriptorSets");
+
+    (void) first_set;
+    (void) descriptor_sets;
+
+    const auto alignment = m_Device->GetLimits().MinUniformBufferOffsetAlignment;
+    for (std::uint32_t i = 0; i < dynamic_offset_count; ++i)
+        common::Assert(
+            dynamic_offsets[i] % alignment == 0,
+            "dynamic offset {} is not aligned to {} bytes",
+            dynamic_offsets[i],
+            alignment);
+
+    if (m_Record)
+        m_Statistics.DescriptorSetBinds += set_count;
+}
+
+void glal::null::CommandBufferT::PushConstants(
+    const ShaderStage stages,
+    const std::uint32_t offset,
+    const std::uint32_t size,
+    const void *data)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::PushConstants");
+
+    (void) stages;
+    (void) data;
+
+    common::Assert(
+        offset % 4 == 0 && size % 4 == 0 && offset + size <= m_Device->GetLimits().MaxPushConstantsSize,
+        "push constant range {}+{} is out of bounds",
+        offset,
+        size);
+
+    if (!m_Record)
+        return;
+
+    ++m_Statistics.PushConstants;
+    m_Statistics.PushConstantBytes += size;
+}
+
+void glal::null::CommandBufferT::Draw(const std::uint32_t vertex_count, const std::uint32_t first_vertex)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::Draw");
+
+    (void) first_vertex;
+
+    if (!m_Record)
+        return;
+
+    ++m_Statistics.Draws;
+    ++m_Statistics.Instances;
+    m_Statistics.Vertices += vertex_count;
+}
+
+void glal::null::CommandBufferT::DrawIndexed(const std::uint32_t index_count, const std::uint32_t first_index)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::DrawIndexed");
+
+    (void) first_index;
+
+    if (!m_Record)
+        return;
+
+    ++m_Statistics.Draws;
+    ++m_Statistics.Instances;
+    m_Statistics.Indices += index_count;
+}
+
+void glal::null::CommandBufferT::DrawInstanced(
+    const std::uint32_t vertex_count,
+    const std::uint32_t instance_count,
+    const std::uint32_t first_vertex,
+    const std::uint32_t first_instance)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::DrawInstanced");
+
+    (void) first_vertex;
+    (void) first_instance;
+
+    if (!m_Record)
+        return;
+
+    ++m_Statistics.Draws;
+    m_Statistics.Instances += instance_count;
+    m_Statistics.Vertices += static_cast<std::uint64_t>(vertex_count) * instance_count;
+}
+
+void glal::null::CommandBufferT::DrawIndexedInstanced(
+    const std::uint32_t index_count,
+    const std::uint32_t instance_count,
+    const std::uint32_t first_index,
+    const std::int32_t vertex_offset,
+    const std::uint32_t first_instance)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::DrawIndexedInstanced");
+
+    (void) first_index;
+    (void) vertex_offset;
+    (void) first_instance;
+
+    if (!m_Record)
+        return;
+
+    ++m_Statistics.Draws;
+    m_Statistics.Instances += instance_count;
+    m_Statistics.Indices += static_cast<std::uint64_t>(index_count) * instance_count;
+}
+
+void glal::null::CommandBufferT::DrawIndexedIndirect(
+    Buffer buffer,
+    const std::size_t offset,
+    const std::uint32_t draw_count,
+    const std::uint32_t stride)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::DrawIndexedIndirect");
+
+    (void) buffer;
+    (void) offset;
+    (void) stride;
+
+    // the draws are written by the gpu, only their number is known
+    if (m_Record)
+        m_Statistics.IndirectDraws += draw_count;
+}
+
+void glal::null::CommandBufferT::Dispatch(const std::uint32_t x, const std::uint32_t y, const std::uint32_t z)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::Dispatch");
+
+    (void) x;
+    (void) y;
+    (void) z;
+
+    if (m_Record)
+        ++m_Statistics.Dispatches;
+}
+
+void glal::null::CommandBufferT::CopyBuffer(
+    Buffer src_buffer,
+    Buffer dst_buffer,
+    const std::size_t src_offset,
+    const std::size_t dst_offset,
+    const std::size_t size)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::CopyBuffer");
+
+    (void) src_buffer;
+    (void) dst_buffer;
+    (void) src_offset;
+    (void) dst_offset;
+
+    if (!m_Record)
+        return;
+
+    ++m_Statistics.Copies;
+    m_Statistics.BytesUploaded += size;
+}
+
+void glal::null::CommandBufferT::CopyBufferToImage(Buffer src_buffer, Image dst_image)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::CopyBufferToImage");
+
+    CopyBufferToImage(src_buffer, dst_image, 0, 0);
+}
+
+void glal::null::CommandBufferT::CopyBufferToImage(
+    Buffer src_buffer,
+    Image dst_image,
+    const std::size_t src_offset,
+    const std::uint32_t mip_level)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::CopyBufferToImage");
+
+    (void) src_buffer;
+    (void) src_offset;
+
+    if (!m_Record)
+        return;
+
+    const auto extent = dst_image->GetExtent();
+
+    ++m_Statistics.Copies;
+    m_Statistics.BytesUploaded += GetImageDataSize(
+        dst_image->GetFormat(),
+        {
+            .Width = std::max(extent.Width >> mip_level, 1u),
+            .Height = std::max(extent.Height >> mip_level, 1u),
+            .Depth = std::max(extent.Depth >> mip_level, 1u),
+        });
+}
+
+void glal::null::CommandBufferT::CopyImageToBuffer(
+    Image src_image,
+    Buffer dst_buffer,
+    const std::size_t dst_offset,
+    const std::uint32_t mip_level)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::CopyImageToBuffer");
+
+    (void) dst_buffer;
+    (void) dst_offset;
+
+    if (!m_Record)
+        return;
+
+    const auto extent = src_image->GetExtent();
+
+    ++m_Statistics.Copies;
+    m_Statistics.BytesReadBack += GetImageDataSize(
+        src_image->GetFormat(),
+        {
+            .Width = std::max(extent.Width >> mip_level, 1u),
+            .Height = std::max(extent.Height >> mip_level, 1u),
+            .Depth = std::max(extent.Depth >> mip_level, 1u),
+        });
+}
+
+void glal::null::CommandBufferT::Transition(Resource resource, const ResourceState state)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::Transition");
+
+    (void) resource;
+    (void) state;
+
+    if (m_Record)
+        ++m_Statistics.Transitions;
+}
+
+void glal::null::CommandBufferT::ResetQueries(
+    QueryPool query_pool,
+    const std::uint32_t first_query,
+    const std::uint32_t query_count)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::ResetQueries");
+
+    (void) query_pool;
+    (void) first_query;
+    (void) query_count;
+}
+
+void glal::null::CommandBufferT::WriteTimestamp(QueryPool query_pool, const std::uint32_t query)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::WriteTimestamp");
+
+    (void) query_pool;
+    (void) query;
+
+    if (m_Record)
+        ++m_Statistics.Queries;
+}
+
+void glal::null::CommandBufferT::BeginQuery(QueryPool query_pool, const std::uint32_t query)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::BeginQuery");
+
+    (void) query_pool;
+    (void) query;
+
+    if (m_Record)
+        ++m_Statistics.Queries;
+}
+
+void glal::null::CommandBufferT::EndQuery(QueryPool query_pool, const std::uint32_t query)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::EndQuery");
+
+    (void) query_pool;
+    (void) query;
+}
+
+const glal::null::Statistics &glal::null::CommandBufferT::GetStatistics() const
+{
+    return m_Statistics;
+}
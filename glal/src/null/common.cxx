@@ -0,0 +1,34 @@
+#include <glal/null.hxx>
+
+glal::Instance glal::CreateInstanceNull(const InstanceDesc &desc)
+{
+    return new null::InstanceT(desc);
+}
+
+glal::null::Statistics &glal::null::Statistics::operator+=(const Statistics &other)
+{
+    Submits += other.Submits;
+    CommandBuffers += other.CommandBuffers;
+    RenderPasses += other.RenderPasses;
+
+    Draws += other.Draws;
+    IndirectDraws += other.IndirectDraws;
+    Dispatches += other.Dispatches;
+    Instances += other.Instances;
+    Vertices += other.Vertices;
+    Indices += other.Indices;
+
+    PipelineBinds += other.PipelineBinds;
+    VertexBufferBinds += other.VertexBufferBinds;
+    IndexBufferBinds += other.IndexBufferBinds;
+    DescriptorSetBinds += other.DescriptorSetBinds;
+    PushConstants += other.PushConstants;
+    PushConstantBytes += other.PushConstantBytes;
+    Transitions += other.Transitions;
+    Queries += other.Queries;
+
+    Copies += other.Copies;
+    BytesUploaded += other.BytesUploaded;
+    BytesReadBack += other.BytesReadBack;
+    return *this;
+}
@@ -0,0 +1,50 @@
+#include <common/log.hxx>
+#include <glal/null.hxx>
+
+glal::null::DescriptorSetT::DescriptorSetT(DeviceT *device, const DescriptorSetDesc &desc)
+    : m_Device(device),
+      m_Layout(desc.Layout)
+{
+}
+
+void glal::null::DescriptorSetT::BindBuffer(const std::uint32_t binding, Buffer buffer)
+{
+    (void) binding;
+    (void) buffer;
+}
+
+void glal::null::DescriptorSetT::BindBuffer(
+    const std::uint32_t binding,
+    Buffer buffer,
+    const std::uint32_t offset,
+    const std::uint32_t size)
+{
+    (void) binding;
+    (void) buffer;
+    (void) offset;
+    (void) size;
+}
+
+void glal::null::DescriptorSetT::BindImageView(const std::uint32_t binding, ImageView image_view, Sampler sampler)
+{
+    BindImageView(binding, 0, image_view, sampler);
+}
+
+void glal::null::DescriptorSetT::BindImageView(
+    const std::uint32_t binding,
+    const std::uint32_t array_element,
+    ImageView image_view,
+    Sampler sampler)
+{
+    (void) image_view;
+    (void) sampler;
+
+    const auto descriptor_binding = m_Layout->FindDescriptorBinding(binding);
+    common::Assert(descriptor_binding, "missing descriptor for binding {}", binding);
+    common::Assert(
+        array_element < descriptor_binding->Count,
+        "element {} is out of range of binding {} with {} elements",
+        array_element,
+        binding,
+        descriptor_binding->Count);
+}
@@ -0,0 +1,444 @@
+#include <common/log.hxx>
+#include <glal/null.hxx>
+
+glal::null::DeviceT::DeviceT(PhysicalDeviceT *physical_device)
+    : m_PhysicalDevice(physical_device),
+      m_Queue(new QueueT(this)),
+      m_RecordStatistics(false),
+      m_Statistics(),
+      m_PipelineCompileTime()
+{
+}
+
+glal::null::DeviceT::~DeviceT()
+{
+    common::Assert(m_Buffers.empty(), "not all buffers were explicitly destroyed");
+    common::Assert(m_Images.empty(), "not all images were explicitly destroyed");
+    common::Assert(m_ImageViews.empty(), "not all image views were explicitly destroyed");
+    common::Assert(m_Samplers.empty(), "not all samplers were explicitly destroyed");
+    common::Assert(m_ShaderModules.empty(), "not all shader modules were explicitly destroyed");
+    common::Assert(m_PipelineLayouts.empty(), "not all pipeline layouts were explicitly destroyed");
+    common::Assert(m_Pipelines.empty(), "not all pipelines were explicitly destroyed");
+    common::Assert(m_DescriptorSetLayouts.empty(), "not all descriptor set layouts were explicitly destroyed");
+    common::Assert(m_DescriptorSets.empty(), "not all descriptor sets were explicitly destroyed");
+    common::Assert(m_Swapchains.empty(), "not all swapchains were explicitly destroyed");
+    common::Assert(m_RenderPasses.empty(), "not all render passes were explicitly destroyed");
+    common::Assert(m_Framebuffers.empty(), "not all framebuffers were explicitly destroyed");
+    common::Assert(m_CommandBuffers.empty(), "not all command buffers were explicitly destroyed");
+    common::Assert(m_Fences.empty(), "not all fences were explicitly destroyed");
+    common::Assert(m_Semaphores.empty(), "not all semaphores were explicitly destroyed");
+    common::Assert(m_QueryPools.empty(), "not all query pools were explicitly destroyed");
+
+    delete m_Queue;
+}
+
+glal::null::PhysicalDeviceT *glal::null::DeviceT::GetPhysicalDevice() const
+{
+    return m_PhysicalDevice;
+}
+
+glal::Buffer glal::null::DeviceT::CreateBuffer(const BufferDesc &desc)
+{
+    return m_Buffers.emplace_back(new BufferT(this, desc));
+}
+
+void glal::null::DeviceT::DestroyBuffer(Buffer buffer)
+{
+    for (auto it = m_Buffers.begin(); it != m_Buffers.end(); ++it)
+        if (*it == buffer)
+        {
+            m_Buffers.erase(it);
+            delete buffer;
+            return;
+        }
+    common::Fatal(
+        "buffer {} is not owned by device {}",
+        static_cast<const void *>(buffer),
+        static_cast<const void *>(this));
+}
+
+glal::Image glal::null::DeviceT::CreateImage(const ImageDesc &desc)
+{
+    return m_Images.emplace_back(new ImageT(this, desc));
+}
+
+void glal::null::DeviceT::DestroyImage(Image image)
+{
+    for (auto it = m_Images.begin(); it != m_Images.end(); ++it)
+        if (*it == image)
+        {
+            m_Images.erase(it);
+            delete image;
+            return;
+        }
+    common::Fatal(
+        "image {} is not owned by device {}",
+        static_cast<const void *>(image),
+        static_cast<const void *>(this));
+}
+
+glal::ImageView glal::null::DeviceT::CreateImageView(const ImageViewDesc &desc)
+{
+    return m_ImageViews.emplace_back(new ImageViewT(this, desc));
+}
+
+void glal::null::DeviceT::DestroyImageView(ImageView image_view)
+{
+    for (auto it = m_ImageViews.begin(); it != m_ImageViews.end(); ++it)
+        if (*it == image_view)
+        {
+            m_ImageViews.erase(it);
+            delete image_view;
+            return;
+        }
+    common::Fatal(
+        "image view {} is not owned by device {}",
+        static_cast<const void *>(image_view),
+        static_cast<const void *>(this));
+}
+
+glal::Sampler glal::null::DeviceT::CreateSampler(const SamplerDesc &desc)
+{
+    const auto key = GetSamplerKey(desc);
+    if (const auto sampler = m_SharedSamplers.Acquire(key))
+        return sampler;
+
+    return m_SharedSamplers.Insert(key, m_Samplers.emplace_back(new SamplerT(this, desc)));
+}
+
+void glal::null::DeviceT::DestroySampler(Sampler sampler)
+{
+    if (!m_SharedSamplers.Release(sampler))
+        return;
+
+    for (auto it = m_Samplers.begin(); it != m_Samplers.end(); ++it)
+        if (*it == sampler)
+        {
+            m_Samplers.erase(it);
+            delete sampler;
+            return;
+        }
+    common::Fatal(
+        "sampler {} is not owned by device {}",
+        static_cast<const void *>(sampler),
+        static_cast<const void *>(this));
+}
+
+glal::ShaderModule glal::null::DeviceT::CreateShaderModule(const ShaderModuleDesc &desc)
+{
+    return m_ShaderModules.emplace_back(new ShaderModuleT(this, desc));
+}
+
+void glal::null::DeviceT::DestroyShaderModule(ShaderModule shader_module)
+{
+    for (auto it = m_ShaderModules.begin(); it != m_ShaderModules.end(); ++it)
+        if (*it == shader_module)
+        {
+            m_ShaderModules.erase(it);
+            delete shader_module;
+            return;
+        }
+    common::Fatal(
+        "shader module {} is not owned by device {}",
+        static_cast<const void *>(shader_module),
+        static_cast<const void *>(this));
+}
+
+glal::PipelineLayout glal::null::DeviceT::CreatePipelineLayout(const PipelineLayoutDesc &desc)
+{
+    return m_PipelineLayouts.emplace_back(new PipelineLayoutT(this, desc));
+}
+
+void glal::null::DeviceT::DestroyPipelineLayout(PipelineLayout pipeline_layout)
+{
+    for (auto it = m_PipelineLayouts.begin(); it != m_PipelineLayouts.end(); ++it)
+        if (*it == pipeline_layout)
+        {
+            m_PipelineLayouts.erase(it);
+            delete pipeline_layout;
+            return;
+        }
+    common::Fatal(
+        "pipeline layout {} is not owned by device {}",
+        static_cast<const void *>(pipeline_layout),
+        static_cast<const void *>(this));
+}
+
+glal::Pipeline glal::null::DeviceT::CreatePipeline(const PipelineDesc &desc)
+{
+    auto key = GetPipelineKey(desc);
+    key.Add(false);
+    if (const auto pipeline = m_SharedPipelines.Acquire(key))
+        return pipeline;
+
+    return m_SharedPipelines.Insert(key, m_Pipelines.emplace_back(new PipelineT(this, desc, false)));
+}
+
+glal::Pipeline glal::null::DeviceT::CreatePipelineAsync(const PipelineDesc &desc)
+{
+    auto key = GetPipelineKey(desc);
+    key.Add(true);
+    if (const auto pipeline = m_SharedPipelines.Acquire(key))
+        return pipeline;
+
+    return m_SharedPipelines.Insert(key, m_Pipelines.emplace_back(new PipelineT(this, desc, true)));
+}
+
+void glal::null::DeviceT::DestroyPipeline(Pipeline pipeline)
+{
+    // shared pipelines go with their last reference
+    if (!m_SharedPipelines.Release(pipeline))
+        return;
+
+    for (auto it = m_Pipelines.begin(); it != m_Pipelines.end(); ++it)
+        if (*it == pipeline)
+        {
+            m_Pipelines.erase(it);
+            delete pipeline;
+            return;
+        }
+    common::Fatal(
+        "pipeline {} is not owned by device {}",
+        static_cast<const void *>(pipeline),
+        static_cast<const void *>(this));
+}
+
+glal::DescriptorSetLayout glal::null::DeviceT::CreateDescriptorSetLayout(const DescriptorSetLayoutDesc &desc)
+{
+    const auto key = GetDescriptorSetLayoutKey(desc);
+    if (const auto descriptor_set_layout = m_SharedDescriptorSetLayouts.Acquire(key))
+        return descriptor_set_layout;
+
+    return m_SharedDescriptorSetLayouts.Insert(
+        key,
+        m_DescriptorSetLayouts.emplace_back(new DescriptorSetLayoutT(this, desc)));
+}
+
+void glal::null::DeviceT::DestroyDescriptorSetLayout(DescriptorSetLayout descriptor_set_layout)
+{
+    if (!m_SharedDescriptorSetLayouts.Release(descriptor_set_layout))
+        return;
+
+    for (auto it = m_DescriptorSetLayouts.begin(); it != m_DescriptorSetLayouts.end(); ++it)
+        if (*it == descriptor_set_layout)
+        {
+            m_DescriptorSetLayouts.erase(it);
+            delete descriptor_set_layout;
+            return;
+        }
+    common::Fatal(
+        "descriptor set layout {} is not owned by device {}",
+        static_cast<const void *>(descriptor_set_layout),
+        static_cast<const void *>(this));
+}
+
+glal::DescriptorSet glal::null::DeviceT::CreateDescriptorSet(const DescriptorSetDesc &desc)
+{
+    return m_DescriptorSets.emplace_back(new DescriptorSetT(this, desc));
+}
+
+void glal::null::DeviceT::DestroyDescriptorSet(DescriptorSet descriptor_set)
+{
+    for (auto it = m_DescriptorSets.begin(); it != m_DescriptorSets.end(); ++it)
+        if (*it == descriptor_set)
+        {
+            m_DescriptorSets.erase(it);
+            delete descriptor_set;
+            return;
+        }
+    common::Fatal(
+        "descriptor set {} is not owned by device {}",
+        static_cast<const void *>(descriptor_set),
+        static_cast<const void *>(this));
+}
+
+glal::Swapchain glal::null::DeviceT::CreateSwapchain(const SwapchainDesc &desc)
+{
+    return m_Swapchains.emplace_back(new SwapchainT(this, desc));
+}
+
+void glal::null::DeviceT::DestroySwapchain(Swapchain swapchain)
+{
+    for (auto it = m_Swapchains.begin(); it != m_Swapchains.end(); ++it)
+        if (*it == swapchain)
+        {
+            m_Swapchains.erase(it);
+            delete swapchain;
+            return;
+        }
+    common::Fatal(
+        "swapchain {} is not owned by device {}",
+        static_cast<const void *>(swapchain),
+        static_cast<const void *>(this));
+}
+
+glal::RenderPass glal::null::DeviceT::CreateRenderPass(const RenderPassDesc &desc)
+{
+    return m_RenderPasses.emplace_back(new RenderPassT(this, desc));
+}
+
+void glal::null::DeviceT::DestroyRenderPass(RenderPass render_pass)
+{
+    for (auto it = m_RenderPasses.begin(); it != m_RenderPasses.end(); ++it)
+        if (*it == render_pass)
+        {
+            m_RenderPasses.erase(it);
+            delete render_pass;
+            return;
+        }
+    common::Fatal(
+        "render pass {} is not owned by device {}",
+        static_cast<const void *>(render_pass),
+        static_cast<const void *>(this));
+}
+
+glal::Framebuffer glal::null::DeviceT::CreateFramebuffer(const FramebufferDesc &desc)
+{
+    return m_Framebuffers.emplace_back(new FramebufferT(this, desc));
+}
+
+void glal::null::DeviceT::DestroyFramebuffer(Framebuffer framebuffer)
+{
+    for (auto it = m_Framebuffers.begin(); it != m_Framebuffers.end(); ++it)
+        if (*it == framebuffer)
+        {
+            m_Framebuffers.erase(it);
+            delete framebuffer;
+            return;
+        }
+    common::Fatal(
+        "framebuffer {} is not owned by device {}",
+        static_cast<const void *>(framebuffer),
+        static_cast<const void *>(this));
+}
+
+glal::CommandBuffer glal::null::DeviceT::CreateCommandBuffer(const CommandBufferUsage usage, const QueueType queue_type)
+{
+    return m_CommandBuffers.emplace_back(new CommandBufferT(this, usage, queue_type));
+}
+
+void glal::null::DeviceT::DestroyCommandBuffer(CommandBuffer command_buffer)
+{
+    for (auto it = m_CommandBuffers.begin(); it != m_CommandBuffers.end(); ++it)
+        if (*it == command_buffer)
+        {
+            m_CommandBuffers.erase(it);
+            delete command_buffer;
+            return;
+        }
+    common::Fatal(
+        "command buffer {} is not owned by device {}",
+        static_cast<const void *>(command_buffer),
+        static_cast<const void *>(this));
+}
+
+glal::Fence glal::null::DeviceT::CreateFence()
+{
+    return m_Fences.emplace_back(new FenceT(this));
+}
+
+void glal::null::DeviceT::DestroyFence(Fence fence)
+{
+    for (auto it = m_Fences.begin(); it != m_Fences.end(); ++it)
+        if (*it == fence)
+        {
+            m_Fences.erase(it);
+            delete fence;
+            return;
+        }
+    common::Fatal(
+        "fence {} is not owned by device {}",
+        static_cast<const void *>(fence),
+        static_cast<const void *>(this));
+}
+
+glal::Semaphore glal::null::DeviceT::CreateSemaphore(const SemaphoreDesc &desc)
+{
+    return m_Semaphores.emplace_back(new SemaphoreT(this, desc));
+}
+
+void glal::null::DeviceT::DestroySemaphore(Semaphore semaphore)
+{
+    for (auto it = m_Semaphores.begin(); it != m_Semaphores.end(); ++it)
+        if (*it == semaphore)
+        {
+            m_Semaphores.erase(it);
+            delete semaphore;
+            return;
+        }
+    common::Fatal(
+        "semaphore {} is not owned by device {}",
+        static_cast<const void *>(semaphore),
+        static_cast<const void *>(this));
+}
+
+glal::QueryPool glal::null::DeviceT::CreateQueryPool(const QueryPoolDesc &desc)
+{
+    return m_QueryPools.emplace_back(new QueryPoolT(this, desc));
+}
+
+void glal::null::DeviceT::DestroyQueryPool(QueryPool query_pool)
+{
+    for (auto it = m_QueryPools.begin(); it != m_QueryPools.end(); ++it)
+        if (*it == query_pool)
+        {
+            m_QueryPools.erase(it);
+            delete query_pool;
+            return;
+        }
+    common::Fatal(
+        "query pool {} is not owned by device {}",
+        static_cast<const void *>(query_pool),
+        static_cast<const void *>(this));
+}
+
+glal::Queue glal::null::DeviceT::GetQueue(const QueueType type)
+{
+    (void) type;
+    return m_Queue;
+}
+
+bool glal::null::DeviceT::Supports(const DeviceFeature feature) const
+{
+    return m_PhysicalDevice->Supports(feature);
+}
+
+const glal::DeviceLimits &glal::null::DeviceT::GetLimits() const
+{
+    return m_PhysicalDevice->GetLimits();
+}
+
+void glal::null::DeviceT::EnableStatistics(const bool enable)
+{
+    m_RecordStatistics = enable;
+}
+
+bool glal::null::DeviceT::IsRecordingStatistics() const
+{
+    return m_RecordStatistics;
+}
+
+const glal::null::Statistics &glal::null::DeviceT::GetStatistics() const
+{
+    return m_Statistics;
+}
+
+void glal::null::DeviceT::ResetStatistics()
+{
+    m_Statistics = {};
+}
+
+void glal::null::DeviceT::AddStatistics(const Statistics &statistics)
+{
+    m_Statistics += statistics;
+}
+
+void glal::null::DeviceT::SetPipelineCompileTime(const std::chrono::nanoseconds compile_time)
+{
+    m_PipelineCompileTime = compile_time;
+}
+
+std::chrono::nanoseconds glal::null::DeviceT::GetPipelineCompileTime() const
+{
+    return m_PipelineCompileTime;
+}
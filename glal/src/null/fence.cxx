@@ -0,0 +1,29 @@
+#include <common/log.hxx>
+#include <glal/null.hxx>
+
+glal::null::FenceT::FenceT(DeviceT *device)
+    : m_Device(device),
+      m_Signaled(false)
+{
+}
+
+void glal::null::FenceT::Wait()
+{
+    // submissions complete right away, an unsignaled fence was never submitted and would wait forever
+    common::Assert(m_Signaled, "waiting for fence {} that was never submitted", static_cast<const void *>(this));
+}
+
+void glal::null::FenceT::Reset()
+{
+    m_Signaled = false;
+}
+
+bool glal::null::FenceT::IsSignaled()
+{
+    return m_Signaled;
+}
+
+void glal::null::FenceT::Signal()
+{
+    m_Signaled = true;
+}
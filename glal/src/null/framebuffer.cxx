@@ -0,0 +1,17 @@
+#include <glal/null.hxx>
+
+glal::null::FramebufferT::FramebufferT(DeviceT *device, const FramebufferDesc &desc)
+    : m_Device(device),
+      m_Attachments(desc.Attachments, desc.Attachments + desc.AttachmentCount)
+{
+}
+
+std::uint32_t glal::null::FramebufferT::GetAttachmentCount() const
+{
+    return m_Attachments.size();
+}
+
+glal::ImageView glal::null::FramebufferT::GetAttachment(const std::uint32_t index) const
+{
+    return m_Attachments.at(index);
+}
@@ -0,0 +1,36 @@
+#include <glal/null.hxx>
+
+glal::null::ImageT::ImageT(DeviceT *device, const ImageDesc &desc)
+    : m_Device(device),
+      m_Format(desc.Format),
+      m_Type(desc.Type),
+      m_Extent(desc.Extent),
+      m_MipLevelCount(desc.MipLevelCount),
+      m_ArrayLayerCount(desc.ArrayLayerCount)
+{
+}
+
+glal::ImageFormat glal::null::ImageT::GetFormat() const
+{
+    return m_Format;
+}
+
+glal::ImageType glal::null::ImageT::GetType() const
+{
+    return m_Type;
+}
+
+glal::Extent3D glal::null::ImageT::GetExtent() const
+{
+    return m_Extent;
+}
+
+std::uint32_t glal::null::ImageT::GetMipLevelCount() const
+{
+    return m_MipLevelCount;
+}
+
+std::uint32_t glal::null::ImageT::GetArrayLayerCount() const
+{
+    return m_ArrayLayerCount;
+}
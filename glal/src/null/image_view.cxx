@@ -0,0 +1,24 @@
+#include <glal/null.hxx>
+
+glal::null::ImageViewT::ImageViewT(DeviceT *device, const ImageViewDesc &desc)
+    : m_Device(device),
+      m_Image(desc.ImageResource),
+      m_Format(desc.Format),
+      m_Type(desc.Type)
+{
+}
+
+glal::Image glal::null::ImageViewT::GetImage() const
+{
+    return m_Image;
+}
+
+glal::ImageFormat glal::null::ImageViewT::GetFormat() const
+{
+    return m_Format;
+}
+
+glal::ImageType glal::null::ImageViewT::GetType() const
+{
+    return m_Type;
+}
@@ -0,0 +1,15 @@
+#include <glal/null.hxx>
+
+glal::null::InstanceT::InstanceT(const InstanceDesc &desc)
+{
+    (void) desc;
+
+    m_PhysicalDevices.emplace_back(this);
+}
+
+std::uint32_t glal::null::InstanceT::EnumeratePhysicalDevices(PhysicalDevice *devices)
+{
+    if (devices)
+        *devices = m_PhysicalDevices.data();
+    return m_PhysicalDevices.size();
+}
@@ -0,0 +1,57 @@
+#include <common/log.hxx>
+#include <glal/null.hxx>
+
+glal::null::PhysicalDeviceT::PhysicalDeviceT(InstanceT *instance)
+    : m_Instance(instance),
+      m_Limits()
+{
+    // fixed limits keep runs comparable across machines
+    m_Limits.MaxTextureSize2D = 16384;
+    m_Limits.MaxUniformBuffers = 16;
+    m_Limits.MaxBufferSize = 1ull << 30;
+    m_Limits.MaxPushConstantsSize = 128;
+    m_Limits.MinUniformBufferOffsetAlignment = 256;
+    m_Limits.MaxBindlessTextures = 1 << 20;
+    m_Limits.TimestampPeriod = 1.0f;
+}
+
+glal::null::PhysicalDeviceT::~PhysicalDeviceT()
+{
+    common::Assert(m_Devices.empty(), "not all devices were explicitly destroyed");
+}
+
+glal::Device glal::null::PhysicalDeviceT::CreateDevice()
+{
+    return m_Devices.emplace_back(new DeviceT(this));
+}
+
+void glal::null::PhysicalDeviceT::DestroyDevice(Device device)
+{
+    for (auto it = m_Devices.begin(); it != m_Devices.end(); ++it)
+        if (*it == device)
+        {
+            m_Devices.erase(it);
+            delete device;
+            return;
+        }
+    common::Fatal(
+        "device {} is not owned by physical device {}",
+        static_cast<const void *>(device),
+        static_cast<const void *>(this));
+}
+
+glal::Instance glal::null::PhysicalDeviceT::GetInstance() const
+{
+    return m_Instance;
+}
+
+bool glal::null::PhysicalDeviceT::Supports(const DeviceFeature feature) const
+{
+    // everything the engine has a path for, ray tracing has none
+    return feature != DeviceFeature_RayTracing;
+}
+
+const glal::DeviceLimits &glal::null::PhysicalDeviceT::GetLimits() const
+{
+    return m_Limits;
+}
@@ -0,0 +1,39 @@
+#include <common/log.hxx>
+#include <glal/null.hxx>
+
+glal::null::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc, const bool async)
+    : m_Device(device),
+      m_Type(desc.Type),
+      m_Topology(desc.Topology),
+      m_ReadyTime(std::chrono::steady_clock::now())
+{
+    if (async)
+        m_ReadyTime += device->GetPipelineCompileTime();
+
+    // the real backends leave duplicates to the driver, which resolves them differently
+    for (std::uint32_t i = 0; i < desc.StageCount; ++i)
+    {
+        const auto &stage = desc.Stages[i];
+        for (std::uint32_t j = 0; j < stage.SpecializationConstantCount; ++j)
+            for (std::uint32_t k = 0; k < j; ++k)
+                common::Assert(
+                    stage.SpecializationConstants[j].Id != stage.SpecializationConstants[k].Id,
+                    "specialization constant {} is set twice",
+                    stage.SpecializationConstants[j].Id);
+    }
+}
+
+glal::PipelineType glal::null::PipelineT::GetType() const
+{
+    return m_Type;
+}
+
+glal::PrimitiveTopology glal::null::PipelineT::GetTopology() const
+{
+    return m_Topology;
+}
+
+glal::PipelineStatus glal::null::PipelineT::GetStatus()
+{
+    return std::chrono::steady_clock::now() < m_ReadyTime ? PipelineStatus_Pending : PipelineStatus_Ready;
+}
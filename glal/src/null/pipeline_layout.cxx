@@ -0,0 +1,29 @@
+#include <glal/null.hxx>
+
+glal::null::PipelineLayoutT::PipelineLayoutT(DeviceT *device, const PipelineLayoutDesc &desc)
+    : m_Device(device),
+      m_DescriptorSetLayouts(desc.DescriptorSetLayouts, desc.DescriptorSetLayouts + desc.DescriptorSetLayoutCount),
+      m_PushConstantRanges(desc.PushConstantRanges, desc.PushConstantRanges + desc.PushConstantRangeCount)
+{
+}
+
+std::uint32_t glal::null::PipelineLayoutT::GetDescriptorSetLayoutCount() const
+{
+    return m_DescriptorSetLayouts.size();
+}
+
+glal::DescriptorSetLayout glal::null::PipelineLayoutT::GetDescriptorSetLayout(
+    const std::uint32_t index) const
+{
+    return m_DescriptorSetLayouts.at(index);
+}
+
+std::uint32_t glal::null::PipelineLayoutT::GetPushConstantRangeCount() const
+{
+    return m_PushConstantRanges.size();
+}
+
+const glal::PushConstantRange &glal::null::PipelineLayoutT::GetPushConstantRange(const std::uint32_t index) const
+{
+    return m_PushConstantRanges.at(index);
+}
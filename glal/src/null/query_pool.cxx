@@ -0,0 +1,33 @@
+#include <algorithm>
+#include <glal/null.hxx>
+
+glal::null::QueryPoolT::QueryPoolT(DeviceT *device, const QueryPoolDesc &desc)
+    : m_Device(device),
+      m_Type(desc.Type),
+      m_Count(desc.Count)
+{
+}
+
+glal::QueryType glal::null::QueryPoolT::GetType() const
+{
+    return m_Type;
+}
+
+std::uint32_t glal::null::QueryPoolT::GetCount() const
+{
+    return m_Count;
+}
+
+bool glal::null::QueryPoolT::GetResults(
+    const std::uint32_t first_query,
+    const std::uint32_t query_count,
+    std::uint64_t *results)
+{
+    (void) first_query;
+
+    const auto value_count = m_Type == QueryType_PipelineStatistics
+                                 ? sizeof(PipelineStatistics) / sizeof(std::uint64_t)
+                                 : 1;
+    std::fill_n(results, query_count * value_count, 0);
+    return true;
+}
@@ -0,0 +1,48 @@
+#include <glal/null.hxx>
+
+glal::null::QueueT::QueueT(DeviceT *device)
+    : m_Device(device)
+{
+}
+
+void glal::null::QueueT::Submit(
+    const CommandBuffer *command_buffers,
+    const std::uint32_t command_buffer_count,
+    Fence fence)
+{
+    Submit(
+        {
+            .CommandBuffers = command_buffers,
+            .CommandBufferCount = command_buffer_count,
+            .WaitSemaphores = nullptr,
+            .WaitSemaphoreCount = 0,
+            .SignalSemaphores = nullptr,
+            .SignalSemaphoreCount = 0,
+            .SignalFence = fence,
+        });
+}
+
+void glal::null::QueueT::Submit(const SubmitDesc &desc)
+{
+    if (m_Device->IsRecordingStatistics())
+    {
+        Statistics statistics{};
+        statistics.Submits = 1;
+        for (std::uint32_t i = 0; i < desc.CommandBufferCount; ++i)
+            statistics += dynamic_cast<CommandBufferT *>(desc.CommandBuffers[i])->GetStatistics();
+        m_Device->AddStatistics(statistics);
+    }
+
+    // nothing executes, so the waits are satisfied and the signals happen right away
+    for (std::uint32_t i = 0; i < desc.SignalSemaphoreCount; ++i)
+        desc.SignalSemaphores[i].Target->Signal(desc.SignalSemaphores[i].Value);
+
+    if (const auto fence_impl = dynamic_cast<FenceT *>(desc.SignalFence))
+        fence_impl->Signal();
+}
+
+void glal::null::QueueT::Present(Swapchain swapchain, Semaphore wait_semaphore)
+{
+    (void) swapchain;
+    (void) wait_semaphore;
+}
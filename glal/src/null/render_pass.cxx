@@ -0,0 +1,17 @@
+#include <glal/null.hxx>
+
+glal::null::RenderPassT::RenderPassT(DeviceT *device, const RenderPassDesc &desc)
+    : m_Device(device),
+      m_Attachments(desc.Attachments, desc.Attachments + desc.AttachmentCount)
+{
+}
+
+std::uint32_t glal::null::RenderPassT::GetAttachmentCount() const
+{
+    return m_Attachments.size();
+}
+
+const glal::Attachment &glal::null::RenderPassT::GetAttachment(const std::uint32_t index) const
+{
+    return m_Attachments.at(index);
+}
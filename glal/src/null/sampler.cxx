@@ -0,0 +1,7 @@
+#include <glal/null.hxx>
+
+glal::null::SamplerT::SamplerT(DeviceT *device, const SamplerDesc &desc)
+    : m_Device(device)
+{
+    (void) desc;
+}
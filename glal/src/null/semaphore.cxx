@@ -0,0 +1,30 @@
+#include <glal/null.hxx>
+
+glal::null::SemaphoreT::SemaphoreT(DeviceT *device, const SemaphoreDesc &desc)
+    : m_Device(device),
+      m_Type(desc.Type),
+      m_Value(desc.Type == SemaphoreType_Timeline ? desc.InitialValue : 0)
+{
+}
+
+glal::SemaphoreType glal::null::SemaphoreT::GetType() const
+{
+    return m_Type;
+}
+
+std::uint64_t glal::null::SemaphoreT::GetValue()
+{
+    return m_Value;
+}
+
+bool glal::null::SemaphoreT::Wait(const std::uint64_t value, const std::uint64_t timeout)
+{
+    (void) timeout;
+    return m_Value >= value;
+}
+
+void glal::null::SemaphoreT::Signal(const std::uint64_t value)
+{
+    if (m_Type == SemaphoreType_Timeline)
+        m_Value = value;
+}
@@ -0,0 +1,19 @@
+#include <common/hash.hxx>
+#include <glal/null.hxx>
+
+glal::null::ShaderModuleT::ShaderModuleT(DeviceT *device, const ShaderModuleDesc &desc)
+    : m_Device(device),
+      m_Stage(desc.Stage),
+      m_Hash(common::Hash(desc.Code, desc.Size))
+{
+}
+
+glal::ShaderStage glal::null::ShaderModuleT::GetStage() const
+{
+    return m_Stage;
+}
+
+std::uint64_t glal::null::ShaderModuleT::GetHash() const
+{
+    return m_Hash;
+}
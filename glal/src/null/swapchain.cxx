@@ -0,0 +1,63 @@
+#include <glal/null.hxx>
+
+glal::null::SwapchainT::SwapchainT(DeviceT *device, const SwapchainDesc &desc)
+    : m_Device(device),
+      m_Extent(desc.Extent),
+      m_ImageIndex()
+{
+    for (std::uint32_t i = 0; i < desc.ImageCount; ++i)
+    {
+        const auto image = m_Device->CreateImage(
+            {
+                .Format = desc.Format,
+                .Type = ImageType_2D,
+                .Extent = { m_Extent.Width, m_Extent.Height, 1 },
+                .MipLevelCount = 1,
+                .ArrayLayerCount = 1,
+            });
+
+        m_Images.push_back(image);
+        m_ImageViews.push_back(
+            m_Device->CreateImageView(
+                {
+                    .Format = desc.Format,
+                    .Type = ImageType_2D,
+                    .ImageResource = image,
+                }));
+    }
+}
+
+glal::null::SwapchainT::~SwapchainT()
+{
+    for (const auto image_view : m_ImageViews)
+        m_Device->DestroyImageView(image_view);
+    for (const auto image : m_Images)
+        m_Device->DestroyImage(image);
+}
+
+std::uint32_t glal::null::SwapchainT::GetImageCount() const
+{
+    return m_Images.size();
+}
+
+glal::ImageView glal::null::SwapchainT::GetImageView(const std::uint32_t index) const
+{
+    return m_ImageViews.at(index);
+}
+
+glal::Extent2D glal::null::SwapchainT::GetExtent() const
+{
+    return m_Extent;
+}
+
+std::uint32_t glal::null::SwapchainT::AcquireNextImage(Semaphore semaphore, Fence fence)
+{
+    m_ImageIndex = (m_ImageIndex + 1) % m_Images.size();
+
+    if (semaphore)
+        semaphore->Signal(0);
+    if (const auto fence_impl = dynamic_cast<FenceT *>(fence))
+        fence_impl->Signal();
+
+    return m_ImageIndex;
+}
@@ -6,7 +6,8 @@ glal::opengl::BufferT::BufferT(DeviceT *device, const BufferDesc &desc)
       m_Size(desc.Size),
       m_Usage(desc.Usage),
       m_Memory(desc.Memory),
-      m_Handle()
+      m_Handle(),
+      m_PersistentMapping()
 {
     GLbitfield flags{};
     switch (m_Memory)
@@ -22,12 +23,23 @@ glal::opengl::BufferT::BufferT(DeviceT *device, const BufferDesc &desc)
         break;
     }
 
+    if (m_Usage == BufferUsage_Staging)
+    {
+        common::Assert(m_Memory != MemoryUsage_DeviceLocal, "staging buffers have to be host visible");
+        flags |= GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    }
+
     glCreateBuffers(1, &m_Handle);
     glNamedBufferStorage(m_Handle, static_cast<GLsizeiptr>(m_Size), nullptr, flags);
+
+    if (m_Usage == BufferUsage_Staging)
+        m_PersistentMapping = glMapNamedBufferRange(m_Handle, 0, static_cast<GLsizeiptr>(m_Size), flags);
 }
 
 glal::opengl::BufferT::~BufferT()
 {
+    if (m_PersistentMapping)
+        glUnmapNamedBuffer(m_Handle);
     glDeleteBuffers(1, &m_Handle);
 }
 
@@ -43,6 +55,9 @@ glal::BufferUsage glal::opengl::BufferT::GetUsage() const
 
 void *glal::opengl::BufferT::Map()
 {
+    if (m_PersistentMapping)
+        return m_PersistentMapping;
+
     GLenum access{};
     switch (m_Memory)
     {
@@ -61,6 +76,9 @@ void *glal::opengl::BufferT::Map()
 
 void glal::opengl::BufferT::Unmap()
 {
+    if (m_PersistentMapping)
+        return;
+
     glUnmapNamedBuffer(m_Handle);
 }
 
@@ -1,38 +1,74 @@
+#include <algorithm>
+#include <cstring>
 #include <common/log.hxx>
+#include <common/profile.hxx>
 #include <glal/opengl.hxx>
 
-glal::opengl::CommandBufferT::CommandBufferT(DeviceT *device, const CommandBufferUsage usage)
+glal::opengl::CommandBufferT::CommandBufferT(
+    DeviceT *device,
+    const CommandBufferUsage usage,
+    const QueueType queue_type)
     : m_Device(device),
       m_Usage(usage),
+      m_Deferred(dynamic_cast<QueueT *>(device->GetQueue(queue_type))->IsAsync()),
       m_Pipeline(nullptr),
       m_RenderPass(nullptr),
       m_Framebuffer(nullptr),
       m_VertexArray(0),
-      m_IndexType(DataType_None)
+      m_IndexType(DataType_None),
+      m_PushConstants(),
+      m_PushConstantsSize(0),
+      m_PushConstantsDirty(false)
 {
 }
 
 void glal::opengl::CommandBufferT::Begin()
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::Begin");
+
+    // deferred command buffers run on another context and never touch this one while recording
+    if (m_Deferred)
+    {
+        m_Commands.clear();
+        return;
+    }
+
     glCreateVertexArrays(1, &m_VertexArray);
     glBindVertexArray(m_VertexArray);
 }
 
 void glal::opengl::CommandBufferT::End()
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::End");
+
+    if (m_Deferred)
+        return;
+
     glUseProgram(0);
     glBindVertexArray(0);
     glDeleteVertexArrays(1, &m_VertexArray);
 
     m_Pipeline = nullptr;
     m_IndexType = DataType_None;
+    m_PushConstantsSize = 0;
+    m_PushConstantsDirty = false;
 }
 
 void glal::opengl::CommandBufferT::BeginRenderPass(RenderPass render_pass, Framebuffer framebuffer)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::BeginRenderPass");
+
     m_RenderPass = dynamic_cast<RenderPassT *>(render_pass);
     m_Framebuffer = dynamic_cast<FramebufferT *>(framebuffer);
 
+    // clears honor the depth mask of the last bound pipeline, the next bind masks depth writes again if it has to
+    if (!m_Device->GetStateBlock().DepthStencil.DepthMask)
+    {
+        auto state = m_Device->GetStateBlock();
+        state.DepthStencil.DepthMask = GL_TRUE;
+        m_Device->ApplyStateBlock(state);
+    }
+
     std::vector<GLenum> attachments(render_pass->GetAttachmentCount());
 
     auto color_attachment_count = 0u;
@@ -137,6 +173,8 @@ void glal::opengl::CommandBufferT::BeginRenderPass(RenderPass render_pass, Frame
 
 void glal::opengl::CommandBufferT::EndRenderPass()
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::EndRenderPass");
+
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
     m_RenderPass = nullptr;
@@ -145,8 +183,16 @@ void glal::opengl::CommandBufferT::EndRenderPass()
 
 void glal::opengl::CommandBufferT::BindPipeline(Pipeline pipeline)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::BindPipeline");
+
     const auto pipeline_impl = dynamic_cast<PipelineT *>(pipeline);
+    common::Assert(
+        pipeline_impl->GetStatus() == PipelineStatus_Ready,
+        "pipeline {} is not ready",
+        static_cast<const void *>(pipeline));
+
     glUseProgram(pipeline_impl->GetHandle());
+    m_Device->ApplyStateBlock(pipeline_impl->GetStateBlock());
 
     pipeline_impl->BindVertexArray(m_VertexArray);
 
@@ -161,6 +207,8 @@ void glal::opengl::CommandBufferT::SetViewport(
     const float min_depth,
     const float max_depth)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::SetViewport");
+
     glViewport(
         static_cast<GLint>(x),
         static_cast<GLint>(y),
@@ -170,6 +218,8 @@ void glal::opengl::CommandBufferT::SetViewport(
 
 void glal::opengl::CommandBufferT::SetScissor(std::int32_t x, std::int32_t y, std::uint32_t width, std::uint32_t height)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::SetScissor");
+
     glScissor(x, y, static_cast<GLsizei>(width), static_cast<GLsizei>(height));
 }
 
@@ -178,6 +228,8 @@ void glal::opengl::CommandBufferT::BindVertexBuffer(
     const std::uint32_t binding,
     const std::size_t offset)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::BindVertexBuffer");
+
     common::Assert(m_Pipeline, "pipeline not set");
 
     const auto buffer_impl = dynamic_cast<BufferT *>(buffer);
@@ -186,6 +238,8 @@ void glal::opengl::CommandBufferT::BindVertexBuffer(
 
 void glal::opengl::CommandBufferT::BindIndexBuffer(Buffer buffer, const DataType type)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::BindIndexBuffer");
+
     const auto buffer_impl = dynamic_cast<BufferT *>(buffer);
     glVertexArrayElementBuffer(m_VertexArray, buffer_impl->GetHandle());
 
@@ -195,23 +249,61 @@ void glal::opengl::CommandBufferT::BindIndexBuffer(Buffer buffer, const DataType
 void glal::opengl::CommandBufferT::BindDescriptorSets(
     const std::uint32_t first_set,
     const std::uint32_t set_count,
-    const DescriptorSet *descriptor_sets)
+    const DescriptorSet *descriptor_sets,
+    const std::uint32_t dynamic_offset_count,
+    const std::uint32_t *dynamic_offsets)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::BindDescriptorSets");
+
+    std::uint32_t dynamic_offset_index = 0;
     for (std::uint32_t i = 0; i < set_count; ++i)
     {
         const auto set_impl = dynamic_cast<DescriptorSetT *>(descriptor_sets[i]);
-        set_impl->Bind(first_set + i);
+
+        common::Assert(
+            dynamic_offset_index + set_impl->GetDynamicBindingCount() <= dynamic_offset_count,
+            "descriptor set {} needs more dynamic offsets than were passed",
+            first_set + i);
+
+        dynamic_offset_index += set_impl->Bind(first_set + i, dynamic_offsets + dynamic_offset_index);
     }
 }
 
+void glal::opengl::CommandBufferT::PushConstants(
+    const ShaderStage stages,
+    const std::uint32_t offset,
+    const std::uint32_t size,
+    const void *data)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::PushConstants");
+
+    // all stages read the same uniform block
+    (void) stages;
+
+    common::Assert(
+        offset % 4 == 0 && size % 4 == 0 && offset + size <= MaxPushConstantsSize,
+        "push constant range {}+{} is out of bounds",
+        offset,
+        size);
+
+    std::memcpy(m_PushConstants.data() + offset, data, size);
+
+    m_PushConstantsSize = std::max(m_PushConstantsSize, offset + size);
+    m_PushConstantsDirty = true;
+}
+
 void glal::opengl::CommandBufferT::Draw(const std::uint32_t vertex_count, const std::uint32_t first_vertex)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::Draw");
+
     common::Assert(m_Pipeline, "pipeline not set");
     common::Assert(m_Pipeline->GetType() == PipelineType_Graphics, "pipeline is not graphics");
 
     GLenum mode;
     TranslatePrimitiveTopology(m_Pipeline->GetTopology(), &mode);
 
+    FlushPushConstants();
+
     glBindVertexArray(m_VertexArray);
     glDrawArrays(
         mode,
@@ -221,6 +313,8 @@ void glal::opengl::CommandBufferT::Draw(const std::uint32_t vertex_count, const
 
 void glal::opengl::CommandBufferT::DrawIndexed(const std::uint32_t index_count, const std::uint32_t first_index)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::DrawIndexed");
+
     common::Assert(m_Pipeline, "pipeline not set");
     common::Assert(m_Pipeline->GetType() == PipelineType_Graphics, "pipeline is not graphics");
 
@@ -232,6 +326,8 @@ void glal::opengl::CommandBufferT::DrawIndexed(const std::uint32_t index_count,
     GLenum mode;
     TranslatePrimitiveTopology(m_Pipeline->GetTopology(), &mode);
 
+    FlushPushConstants();
+
     glBindVertexArray(m_VertexArray);
     glDrawElementsBaseVertex(
         mode,
@@ -241,11 +337,105 @@ void glal::opengl::CommandBufferT::DrawIndexed(const std::uint32_t index_count,
         0);
 }
 
+void glal::opengl::CommandBufferT::DrawInstanced(
+    const std::uint32_t vertex_count,
+    const std::uint32_t instance_count,
+    const std::uint32_t first_vertex,
+    const std::uint32_t first_instance)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::DrawInstanced");
+
+    common::Assert(m_Pipeline, "pipeline not set");
+    common::Assert(m_Pipeline->GetType() == PipelineType_Graphics, "pipeline is not graphics");
+
+    GLenum mode;
+    TranslatePrimitiveTopology(m_Pipeline->GetTopology(), &mode);
+
+    FlushPushConstants();
+
+    glBindVertexArray(m_VertexArray);
+    glDrawArraysInstancedBaseInstance(
+        mode,
+        static_cast<GLint>(first_vertex),
+        static_cast<GLsizei>(vertex_count),
+        static_cast<GLsizei>(instance_count),
+        first_instance);
+}
+
+void glal::opengl::CommandBufferT::DrawIndexedInstanced(
+    const std::uint32_t index_count,
+    const std::uint32_t instance_count,
+    const std::uint32_t first_index,
+    const std::int32_t vertex_offset,
+    const std::uint32_t first_instance)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::DrawIndexedInstanced");
+
+    common::Assert(m_Pipeline, "pipeline not set");
+    common::Assert(m_Pipeline->GetType() == PipelineType_Graphics, "pipeline is not graphics");
+
+    std::uint32_t size;
+    GLenum type;
+
+    TranslateDataType(m_IndexType, &size, &type, nullptr);
+
+    GLenum mode;
+    TranslatePrimitiveTopology(m_Pipeline->GetTopology(), &mode);
+
+    FlushPushConstants();
+
+    glBindVertexArray(m_VertexArray);
+    glDrawElementsInstancedBaseVertexBaseInstance(
+        mode,
+        static_cast<GLsizei>(index_count),
+        type,
+        reinterpret_cast<void *>(first_index * size),
+        static_cast<GLsizei>(instance_count),
+        vertex_offset,
+        first_instance);
+}
+
+void glal::opengl::CommandBufferT::DrawIndexedIndirect(
+    Buffer buffer,
+    const std::size_t offset,
+    const std::uint32_t draw_count,
+    const std::uint32_t stride)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::DrawIndexedIndirect");
+
+    common::Assert(m_Pipeline, "pipeline not set");
+    common::Assert(m_Pipeline->GetType() == PipelineType_Graphics, "pipeline is not graphics");
+
+    const auto buffer_impl = dynamic_cast<BufferT *>(buffer);
+
+    GLenum type;
+    TranslateDataType(m_IndexType, nullptr, &type, nullptr);
+
+    GLenum mode;
+    TranslatePrimitiveTopology(m_Pipeline->GetTopology(), &mode);
+
+    FlushPushConstants();
+
+    glBindVertexArray(m_VertexArray);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer_impl->GetHandle());
+    glMultiDrawElementsIndirect(
+        mode,
+        type,
+        reinterpret_cast<void *>(offset),
+        static_cast<GLsizei>(draw_count),
+        static_cast<GLsizei>(stride));
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
 void glal::opengl::CommandBufferT::Dispatch(const std::uint32_t x, const std::uint32_t y, const std::uint32_t z)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::Dispatch");
+
     common::Assert(m_Pipeline, "pipeline not set");
     common::Assert(m_Pipeline->GetType() == PipelineType_Compute, "pipeline is not compute");
 
+    FlushPushConstants();
+
     glDispatchCompute(x, y, z);
 }
 
@@ -256,74 +446,323 @@ void glal::opengl::CommandBufferT::CopyBuffer(
     const std::size_t dst_offset,
     const std::size_t size)
 {
-    common::Assert(src_buffer, "missing src buffer");
-    common::Assert(dst_buffer, "missing dst buffer");
-
-    const auto src_buffer_impl = dynamic_cast<BufferT *>(src_buffer);
-    const auto dst_buffer_impl = dynamic_cast<BufferT *>(dst_buffer);
-
-    glCopyNamedBufferSubData(
-        src_buffer_impl->GetHandle(),
-        dst_buffer_impl->GetHandle(),
-        static_cast<GLintptr>(src_offset),
-        static_cast<GLintptr>(dst_offset),
-        static_cast<GLsizei>(size));
+    COMMON_PROFILE_ZONE("CommandBuffer::CopyBuffer");
+
+    Record(
+        [=]
+        {
+            common::Assert(src_buffer, "missing src buffer");
+            common::Assert(dst_buffer, "missing dst buffer");
+
+            const auto src_buffer_impl = dynamic_cast<BufferT *>(src_buffer);
+            const auto dst_buffer_impl = dynamic_cast<BufferT *>(dst_buffer);
+
+            glCopyNamedBufferSubData(
+                src_buffer_impl->GetHandle(),
+                dst_buffer_impl->GetHandle(),
+                static_cast<GLintptr>(src_offset),
+                static_cast<GLintptr>(dst_offset),
+                static_cast<GLsizei>(size));
+        });
 }
 
 void glal::opengl::CommandBufferT::CopyBufferToImage(
     Buffer src_buffer,
     Image dst_image)
 {
-    const auto src_buffer_impl = dynamic_cast<BufferT *>(src_buffer);
-    const auto dst_image_impl = dynamic_cast<ImageT *>(dst_image);
+    COMMON_PROFILE_ZONE("CommandBuffer::CopyBufferToImage");
+
+    CopyBufferToImage(src_buffer, dst_image, 0, 0);
+}
+
+void glal::opengl::CommandBufferT::CopyBufferToImage(
+    Buffer src_buffer,
+    Image dst_image,
+    const std::size_t src_offset,
+    const std::uint32_t mip_level)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::CopyBufferToImage");
+
+    Record(
+        [=]
+        {
+            const auto src_buffer_impl = dynamic_cast<BufferT *>(src_buffer);
+            const auto dst_image_impl = dynamic_cast<ImageT *>(dst_image);
+
+            common::Assert(
+                mip_level < dst_image_impl->GetMipLevelCount(),
+                "mip level {} is out of range for image {}",
+                mip_level,
+                static_cast<const void *>(dst_image));
+
+            const auto image_format = dst_image_impl->GetFormat();
+
+            GLenum internal_format, format, type;
+            TranslateImageFormat(image_format, &internal_format, &format, &type);
+
+            const auto extent = dst_image_impl->GetExtent();
+            const Extent3D mip_extent
+            {
+                .Width = std::max(extent.Width >> mip_level, 1u),
+                .Height = std::max(extent.Height >> mip_level, 1u),
+                .Depth = std::max(extent.Depth >> mip_level, 1u),
+            };
+            const auto width = static_cast<GLsizei>(mip_extent.Width);
+            const auto height = static_cast<GLsizei>(mip_extent.Height);
+            const auto depth = static_cast<GLsizei>(mip_extent.Depth);
+
+            // with a pixel unpack buffer bound, the data pointer is an offset into it
+            const auto offset = reinterpret_cast<const void *>(src_offset);
+
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, src_buffer_impl->GetHandle());
+
+            if (IsCompressedFormat(image_format))
+            {
+                // the full level is written at once, so partial edge blocks are fine
+                const auto size = static_cast<GLsizei>(GetImageDataSize(image_format, mip_extent));
+
+                switch (dst_image_impl->GetType())
+                {
+                case ImageType_1D:
+                    common::Fatal("compressed formats are not supported for 1d images");
+                case ImageType_2D:
+                    glCompressedTextureSubImage2D(
+                        dst_image_impl->GetHandle(),
+                        static_cast<GLint>(mip_level),
+                        0,
+                        0,
+                        width,
+                        height,
+                        internal_format,
+                        size,
+                        offset);
+                    break;
+                case ImageType_3D:
+                    glCompressedTextureSubImage3D(
+                        dst_image_impl->GetHandle(),
+                        static_cast<GLint>(mip_level),
+                        0,
+                        0,
+                        0,
+                        width,
+                        height,
+                        depth,
+                        internal_format,
+                        size,
+                        offset);
+                    break;
+                }
+
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                return;
+            }
+
+            switch (dst_image_impl->GetType())
+            {
+            case ImageType_1D:
+                glTextureSubImage1D(
+                    dst_image_impl->GetHandle(),
+                    static_cast<GLint>(mip_level),
+                    0,
+                    width,
+                    format,
+                    type,
+                    offset);
+                break;
+            case ImageType_2D:
+                glTextureSubImage2D(
+                    dst_image_impl->GetHandle(),
+                    static_cast<GLint>(mip_level),
+                    0,
+                    0,
+                    width,
+                    height,
+                    format,
+                    type,
+                    offset);
+                break;
+            case ImageType_3D:
+                glTextureSubImage3D(
+                    dst_image_impl->GetHandle(),
+                    static_cast<GLint>(mip_level),
+                    0,
+                    0,
+                    0,
+                    width,
+                    height,
+                    depth,
+                    format,
+                    type,
+                    offset);
+                break;
+            }
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        });
+}
+
+void glal::opengl::CommandBufferT::CopyImageToBuffer(
+    Image src_image,
+    Buffer dst_buffer,
+    const std::size_t dst_offset,
+    const std::uint32_t mip_level)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::CopyImageToBuffer");
+
+    Record(
+        [=]
+        {
+            const auto src_image_impl = dynamic_cast<ImageT *>(src_image);
+            const auto dst_buffer_impl = dynamic_cast<BufferT *>(dst_buffer);
+
+            common::Assert(
+                mip_level < src_image_impl->GetMipLevelCount(),
+                "mip level {} is out of range for image {}",
+                mip_level,
+                static_cast<const void *>(src_image));
+
+            const auto image_format = src_image_impl->GetFormat();
+
+            GLenum internal_format, format, type;
+            TranslateImageFormat(image_format, &internal_format, &format, &type);
+
+            // with a pixel pack buffer bound, the copy is queued instead of stalling until the image is rendered
+            const auto offset = reinterpret_cast<void *>(dst_offset);
+            const auto size = static_cast<GLsizei>(dst_buffer_impl->GetSize() - dst_offset);
+
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, dst_buffer_impl->GetHandle());
+
+            if (IsCompressedFormat(image_format))
+                glGetCompressedTextureImage(
+                    src_image_impl->GetHandle(),
+                    static_cast<GLint>(mip_level),
+                    size,
+                    offset);
+            else
+                glGetTextureImage(
+                    src_image_impl->GetHandle(),
+                    static_cast<GLint>(mip_level),
+                    format,
+                    type,
+                    size,
+                    offset);
+
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        });
+}
+
+void glal::opengl::CommandBufferT::Transition(Resource resource, ResourceState state)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::Transition");
+
+    Record(
+        [=]
+        {
+            // opengl tracks hazards implicitly, except for shader writes consumed by fixed-function stages
+            switch (state)
+            {
+            case ResourceState_IndirectArgument:
+                glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+                break;
+            default:
+                break;
+            }
+        });
+}
+
+void glal::opengl::CommandBufferT::ResetQueries(
+    QueryPool query_pool,
+    const std::uint32_t first_query,
+    const std::uint32_t query_count)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::ResetQueries");
+
+    // gl queries are reset implicitly whenever they are issued again
+    (void) query_pool;
+    (void) first_query;
+    (void) query_count;
+}
+
+void glal::opengl::CommandBufferT::WriteTimestamp(QueryPool query_pool, const std::uint32_t query)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::WriteTimestamp");
+
+    Record(
+        [=]
+        {
+            const auto query_pool_impl = dynamic_cast<QueryPoolT *>(query_pool);
+
+            common::Assert(
+                query_pool_impl->GetType() == QueryType_Timestamp,
+                "query pool {} does not hold timestamps",
+                static_cast<const void *>(query_pool));
+
+            glQueryCounter(*query_pool_impl->GetHandles(query), GL_TIMESTAMP);
+        });
+}
+
+void glal::opengl::CommandBufferT::BeginQuery(QueryPool query_pool, const std::uint32_t query)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::BeginQuery");
+
+    Record(
+        [=]
+        {
+            const auto query_pool_impl = dynamic_cast<QueryPoolT *>(query_pool);
+
+            const auto targets = query_pool_impl->GetTargets();
+            const auto handles = query_pool_impl->GetHandles(query);
+
+            for (std::size_t i = 0; i < targets.size(); ++i)
+                glBeginQuery(targets[i], handles[i]);
+        });
+}
+
+void glal::opengl::CommandBufferT::EndQuery(QueryPool query_pool, const std::uint32_t query)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::EndQuery");
 
-    GLenum format, type;
-    TranslateImageFormat(dst_image_impl->GetFormat(), nullptr, &format, &type);
+    (void) query;
 
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, src_buffer_impl->GetHandle());
-    switch (dst_image_impl->GetType())
+    Record(
+        [=]
+        {
+            const auto query_pool_impl = dynamic_cast<QueryPoolT *>(query_pool);
+
+            for (const auto target : query_pool_impl->GetTargets())
+                glEndQuery(target);
+        });
+}
+
+const std::vector<std::function<void()>> &glal::opengl::CommandBufferT::GetCommands() const
+{
+    return m_Commands;
+}
+
+void glal::opengl::CommandBufferT::Record(std::function<void()> command)
+{
+    if (m_Deferred)
     {
-    case ImageType_1D:
-        glTextureSubImage1D(
-            dst_image_impl->GetHandle(),
-            0,
-            0,
-            static_cast<GLsizei>(dst_image_impl->GetExtent().Width),
-            format,
-            type,
-            nullptr);
-        break;
-    case ImageType_2D:
-        glTextureSubImage2D(
-            dst_image_impl->GetHandle(),
-            0,
-            0,
-            0,
-            static_cast<GLsizei>(dst_image_impl->GetExtent().Width),
-            static_cast<GLsizei>(dst_image_impl->GetExtent().Height),
-            format,
-            type,
-            nullptr);
-        break;
-    case ImageType_3D:
-        glTextureSubImage3D(
-            dst_image_impl->GetHandle(),
-            0,
-            0,
-            0,
-            0,
-            static_cast<GLsizei>(dst_image_impl->GetExtent().Width),
-            static_cast<GLsizei>(dst_image_impl->GetExtent().Height),
-            static_cast<GLsizei>(dst_image_impl->GetExtent().Depth),
-            format,
-            type,
-            nullptr);
-        break;
+        m_Commands.push_back(std::move(command));
+        return;
     }
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    command();
 }
 
-void glal::opengl::CommandBufferT::Transition(Resource resource, ResourceState state)
+void glal::opengl::CommandBufferT::FlushPushConstants()
 {
-    // noop
+    if (!m_PushConstantsDirty)
+        return;
+    m_PushConstantsDirty = false;
+
+    // the slices of earlier draws stay untouched until the gpu is done with them
+    const auto ring = m_Device->GetPushConstantRing();
+    const auto offset = ring->Push(m_PushConstants.data(), m_PushConstantsSize);
+
+    glBindBufferRange(
+        GL_UNIFORM_BUFFER,
+        PushConstantBinding,
+        ring->GetHandle(),
+        static_cast<GLintptr>(offset),
+        static_cast<GLsizeiptr>(m_PushConstantsSize));
 }
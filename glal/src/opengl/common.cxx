@@ -54,6 +54,72 @@ void glal::opengl::TranslateImageFormat(
         external_format && ((*external_format = GL_DEPTH_COMPONENT));
         type && ((*type = GL_FLOAT));
         break;
+    // compressed formats are uploaded as raw blocks, they have no external format or type
+    case ImageFormat_BC1_UNorm:
+        internal_format && ((*internal_format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT));
+        external_format && ((*external_format = GL_NONE));
+        type && ((*type = GL_NONE));
+        break;
+    case ImageFormat_BC1_SRGB:
+        internal_format && ((*internal_format = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT));
+        external_format && ((*external_format = GL_NONE));
+        type && ((*type = GL_NONE));
+        break;
+    case ImageFormat_BC3_UNorm:
+        internal_format && ((*internal_format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT));
+        external_format && ((*external_format = GL_NONE));
+        type && ((*type = GL_NONE));
+        break;
+    case ImageFormat_BC3_SRGB:
+        internal_format && ((*internal_format = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT));
+        external_format && ((*external_format = GL_NONE));
+        type && ((*type = GL_NONE));
+        break;
+    case ImageFormat_BC4_UNorm:
+        internal_format && ((*internal_format = GL_COMPRESSED_RED_RGTC1));
+        external_format && ((*external_format = GL_NONE));
+        type && ((*type = GL_NONE));
+        break;
+    case ImageFormat_BC5_UNorm:
+        internal_format && ((*internal_format = GL_COMPRESSED_RG_RGTC2));
+        external_format && ((*external_format = GL_NONE));
+        type && ((*type = GL_NONE));
+        break;
+    case ImageFormat_BC6H_UFloat:
+        internal_format && ((*internal_format = GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT));
+        external_format && ((*external_format = GL_NONE));
+        type && ((*type = GL_NONE));
+        break;
+    case ImageFormat_BC7_UNorm:
+        internal_format && ((*internal_format = GL_COMPRESSED_RGBA_BPTC_UNORM));
+        external_format && ((*external_format = GL_NONE));
+        type && ((*type = GL_NONE));
+        break;
+    case ImageFormat_BC7_SRGB:
+        internal_format && ((*internal_format = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM));
+        external_format && ((*external_format = GL_NONE));
+        type && ((*type = GL_NONE));
+        break;
+    case ImageFormat_ETC2_RGB8_UNorm:
+        internal_format && ((*internal_format = GL_COMPRESSED_RGB8_ETC2));
+        external_format && ((*external_format = GL_NONE));
+        type && ((*type = GL_NONE));
+        break;
+    case ImageFormat_ETC2_RGBA8_UNorm:
+        internal_format && ((*internal_format = GL_COMPRESSED_RGBA8_ETC2_EAC));
+        external_format && ((*external_format = GL_NONE));
+        type && ((*type = GL_NONE));
+        break;
+    case ImageFormat_ASTC_4x4_UNorm:
+        internal_format && ((*internal_format = GL_COMPRESSED_RGBA_ASTC_4x4_KHR));
+        external_format && ((*external_format = GL_NONE));
+        type && ((*type = GL_NONE));
+        break;
+    case ImageFormat_ASTC_4x4_SRGB:
+        internal_format && ((*internal_format = GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR));
+        external_format && ((*external_format = GL_NONE));
+        type && ((*type = GL_NONE));
+        break;
     }
 }
 
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <common/log.hxx>
 #include <glal/opengl.hxx>
 
@@ -5,6 +6,38 @@ glal::opengl::DescriptorSetT::DescriptorSetT(DeviceT *device, const DescriptorSe
     : m_Device(device),
       m_Layout(desc.Layout)
 {
+    for (std::uint32_t i = 0; i < m_Layout->GetDescriptorBindingCount(); ++i)
+    {
+        auto &descriptor_binding = m_Layout->GetDescriptorBinding(i);
+        if (descriptor_binding.Type != DescriptorType_CombinedImageSampler
+            || !(descriptor_binding.Flags & DescriptorBindingFlag_PartiallyBound))
+            continue;
+
+        common::Assert(GLEW_ARB_bindless_texture, "partially bound image arrays require bindless textures");
+
+        // unwritten elements stay zero, which is never a valid handle
+        auto &bindless_binding = m_BindlessBindings[descriptor_binding.Binding];
+        bindless_binding.Handles.resize(descriptor_binding.Count);
+
+        glCreateBuffers(1, &bindless_binding.Buffer);
+        glNamedBufferStorage(
+            bindless_binding.Buffer,
+            static_cast<GLsizeiptr>(bindless_binding.Handles.size() * sizeof(GLuint64)),
+            bindless_binding.Handles.data(),
+            GL_DYNAMIC_STORAGE_BIT);
+    }
+}
+
+glal::opengl::DescriptorSetT::~DescriptorSetT()
+{
+    for (auto &[binding, element] : m_BindlessBindings)
+    {
+        for (const auto handle : element.Handles)
+            if (handle)
+                m_Device->ReleaseTextureHandle(handle);
+
+        glDeleteBuffers(1, &element.Buffer);
+    }
 }
 
 void glal::opengl::DescriptorSetT::BindBuffer(const std::uint32_t binding, Buffer buffer)
@@ -29,6 +62,7 @@ void glal::opengl::DescriptorSetT::BindBuffer(
     switch (descriptor_binding->Type)
     {
     case DescriptorType_UniformBuffer:
+    case DescriptorType_UniformBufferDynamic:
         target = GL_UNIFORM_BUFFER;
         break;
     default:
@@ -41,6 +75,7 @@ void glal::opengl::DescriptorSetT::BindBuffer(
         .BufferImpl = buffer_impl,
         .Offset = offset,
         .Size = size,
+        .Dynamic = descriptor_binding->Type == DescriptorType_UniformBufferDynamic,
     };
 }
 
@@ -48,31 +83,91 @@ void glal::opengl::DescriptorSetT::BindImageView(
     const std::uint32_t binding,
     ImageView image_view,
     Sampler sampler)
+{
+    BindImageView(binding, 0, image_view, sampler);
+}
+
+void glal::opengl::DescriptorSetT::BindImageView(
+    const std::uint32_t binding,
+    const std::uint32_t array_element,
+    ImageView image_view,
+    Sampler sampler)
 {
     const auto image_view_impl = dynamic_cast<ImageViewT *>(image_view);
     const auto sampler_impl = dynamic_cast<SamplerT *>(sampler);
 
+    if (const auto it = m_BindlessBindings.find(binding); it != m_BindlessBindings.end())
+    {
+        auto &element = it->second;
+        common::Assert(
+            array_element < element.Handles.size(),
+            "element {} is out of range of binding {} with {} elements",
+            array_element,
+            binding,
+            element.Handles.size());
+
+        // acquired before the old handle is released, so rebinding the same texture keeps it resident
+        auto &handle = element.Handles[array_element];
+        const auto old_handle = handle;
+        handle = m_Device->AcquireTextureHandle(image_view_impl, sampler_impl);
+        if (old_handle)
+            m_Device->ReleaseTextureHandle(old_handle);
+
+        glNamedBufferSubData(
+            element.Buffer,
+            static_cast<GLintptr>(array_element * sizeof(GLuint64)),
+            sizeof(GLuint64),
+            &handle);
+        return;
+    }
+
+    // other image bindings occupy a single texture unit
+    common::Assert(!array_element, "image arrays require a partially bound binding");
+
     m_ImageBindings[binding] = {
         .ImageViewImpl = image_view_impl,
         .SamplerImpl = sampler_impl,
     };
 }
 
-void glal::opengl::DescriptorSetT::Bind(const std::uint32_t set) const
+std::uint32_t glal::opengl::DescriptorSetT::Bind(const std::uint32_t set, const std::uint32_t *dynamic_offsets) const
 {
     const auto binding_base = set * 8;
 
+    std::uint32_t dynamic_offset_count = 0;
     for (auto &[binding, element] : m_BufferBindings)
+    {
+        auto offset = element.Offset;
+        if (element.Dynamic)
+            offset += dynamic_offsets[dynamic_offset_count++];
+
         glBindBufferRange(
             element.Target,
             binding_base + binding,
             element.BufferImpl->GetHandle(),
-            element.Offset,
+            offset,
             element.Size);
+    }
 
     for (auto &[binding, element] : m_ImageBindings)
     {
         glBindTextureUnit(binding_base + binding, element.ImageViewImpl->GetImageHandle());
         glBindSampler(binding_base + binding, element.SamplerImpl->GetHandle());
     }
+
+    // switching materials only changes the indices the shaders read, the handle buffer stays bound
+    for (auto &[binding, element] : m_BindlessBindings)
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding_base + binding, element.Buffer);
+
+    return dynamic_offset_count;
+}
+
+std::uint32_t glal::opengl::DescriptorSetT::GetDynamicBindingCount() const
+{
+    return static_cast<std::uint32_t>(std::ranges::count_if(
+        m_BufferBindings,
+        [](const auto &element)
+        {
+            return element.second.Dynamic;
+        }));
 }
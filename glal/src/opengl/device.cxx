@@ -1,10 +1,70 @@
+#include <fstream>
+#include <common/hash.hxx>
 #include <common/log.hxx>
+#include <glal/file.hxx>
 #include <glal/opengl.hxx>
+#include <GLFW/glfw3.h>
+
+static constexpr std::uint32_t pipeline_cache_magic = 0x43505447; // 'GTPC'
+static constexpr std::uint32_t pipeline_cache_version = 1;
+
+static constexpr std::size_t push_constant_ring_size = 4 << 20;
+static constexpr std::uint32_t push_constant_ring_segments = 4;
+
+struct pipeline_cache_header_t
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t driver_hash;
+    std::uint32_t entry_count;
+};
+
+struct pipeline_cache_entry_t
+{
+    std::uint64_t key;
+    std::uint32_t format;
+    std::uint32_t size;
+};
 
 glal::opengl::DeviceT::DeviceT(PhysicalDeviceT *physical_device)
-    : m_PhysicalDevice(physical_device)
+    : m_PhysicalDevice(physical_device),
+      m_DriverHash(common::HashSeed),
+      m_PipelineCacheDirty(false)
 {
-    m_Queue = new QueueT(this);
+    m_GraphicsQueue = new QueueT(this, nullptr);
+
+    const auto instance_impl = dynamic_cast<InstanceT *>(m_PhysicalDevice->GetInstance());
+
+    // transfers run on a worker with its own context if the device was created on a glfw context to share with,
+    // headless devices transfer on the graphics queue
+    m_TransferQueue = nullptr;
+    m_CompileQueue = nullptr;
+    if (!instance_impl->IsHeadless())
+        if (const auto context = glfwGetCurrentContext())
+            m_TransferQueue = new QueueT(this, context);
+
+    m_PushConstantRing = new UniformRing(push_constant_ring_size, push_constant_ring_segments);
+
+    // let the driver pick the number of background compiler threads, without them async pipelines compile on a
+    // worker of their own. headless contexts have none to share with, there the driver compiles as it is issued
+    if (GLEW_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xffffffff);
+    else if (GLEW_ARB_parallel_shader_compile)
+        glMaxShaderCompilerThreadsARB(0xffffffff);
+    else if (m_TransferQueue)
+        m_CompileQueue = new QueueT(this, glfwGetCurrentContext());
+
+    // program binaries are only valid for the exact driver that produced them
+    for (const auto name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+        m_DriverHash = common::Hash(std::string_view(reinterpret_cast<const char *>(glGetString(name))), m_DriverHash);
+
+    GLint program_binary_format_count;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &program_binary_format_count);
+
+    if (program_binary_format_count > 0)
+        m_PipelineCachePath = instance_impl->GetPipelineCachePath();
+
+    LoadPipelineCache();
 }
 
 glal::opengl::DeviceT::~DeviceT()
@@ -20,8 +80,17 @@ glal::opengl::DeviceT::~DeviceT()
     common::Assert(m_Swapchains.empty(), "not all swapchains were explicitly destroyed");
     common::Assert(m_CommandBuffers.empty(), "not all command buffers were explicitly destroyed");
     common::Assert(m_Fences.empty(), "not all fences were explicitly destroyed");
+    common::Assert(m_Semaphores.empty(), "not all semaphores were explicitly destroyed");
+    common::Assert(m_QueryPools.empty(), "not all query pools were explicitly destroyed");
 
-    delete m_Queue;
+    // pending compiles still store their binaries
+    delete m_CompileQueue;
+
+    SavePipelineCache();
+
+    delete m_PushConstantRing;
+    delete m_TransferQueue;
+    delete m_GraphicsQueue;
 }
 
 glal::opengl::PhysicalDeviceT *glal::opengl::DeviceT::GetPhysicalDevice() const
@@ -91,11 +160,18 @@ void glal::opengl::DeviceT::DestroyImageView(ImageView image_view)
 
 glal::Sampler glal::opengl::DeviceT::CreateSampler(const SamplerDesc &desc)
 {
-    return m_Samplers.emplace_back(new SamplerT(this, desc));
+    const auto key = GetSamplerKey(desc);
+    if (const auto sampler = m_SharedSamplers.Acquire(key))
+        return sampler;
+
+    return m_SharedSamplers.Insert(key, m_Samplers.emplace_back(new SamplerT(this, desc)));
 }
 
 void glal::opengl::DeviceT::DestroySampler(Sampler sampler)
 {
+    if (!m_SharedSamplers.Release(sampler))
+        return;
+
     for (auto it = m_Samplers.begin(); it != m_Samplers.end(); ++it)
         if (*it == sampler)
         {
@@ -152,11 +228,31 @@ void glal::opengl::DeviceT::DestroyPipelineLayout(PipelineLayout pipeline_layout
 
 glal::Pipeline glal::opengl::DeviceT::CreatePipeline(const PipelineDesc &desc)
 {
-    return m_Pipelines.emplace_back(new PipelineT(this, desc));
+    // a blocking create must not get a pipeline that is still compiling, so blocking and async ones are kept apart
+    auto key = GetPipelineKey(desc);
+    key.Add(false);
+    if (const auto pipeline = m_SharedPipelines.Acquire(key))
+        return pipeline;
+
+    return m_SharedPipelines.Insert(key, m_Pipelines.emplace_back(new PipelineT(this, desc, false)));
+}
+
+glal::Pipeline glal::opengl::DeviceT::CreatePipelineAsync(const PipelineDesc &desc)
+{
+    auto key = GetPipelineKey(desc);
+    key.Add(true);
+    if (const auto pipeline = m_SharedPipelines.Acquire(key))
+        return pipeline;
+
+    return m_SharedPipelines.Insert(key, m_Pipelines.emplace_back(new PipelineT(this, desc, true)));
 }
 
 void glal::opengl::DeviceT::DestroyPipeline(Pipeline pipeline)
 {
+    // shared pipelines go with their last reference
+    if (!m_SharedPipelines.Release(pipeline))
+        return;
+
     for (auto it = m_Pipelines.begin(); it != m_Pipelines.end(); ++it)
         if (*it == pipeline)
         {
@@ -173,11 +269,20 @@ void glal::opengl::DeviceT::DestroyPipeline(Pipeline pipeline)
 glal::DescriptorSetLayout glal::opengl::DeviceT::CreateDescriptorSetLayout(
     const DescriptorSetLayoutDesc &desc)
 {
-    return m_DescriptorSetLayouts.emplace_back(new DescriptorSetLayoutT(this, desc));
+    const auto key = GetDescriptorSetLayoutKey(desc);
+    if (const auto descriptor_set_layout = m_SharedDescriptorSetLayouts.Acquire(key))
+        return descriptor_set_layout;
+
+    return m_SharedDescriptorSetLayouts.Insert(
+        key,
+        m_DescriptorSetLayouts.emplace_back(new DescriptorSetLayoutT(this, desc)));
 }
 
 void glal::opengl::DeviceT::DestroyDescriptorSetLayout(DescriptorSetLayout descriptor_set_layout)
 {
+    if (!m_SharedDescriptorSetLayouts.Release(descriptor_set_layout))
+        return;
+
     for (auto it = m_DescriptorSetLayouts.begin(); it != m_DescriptorSetLayouts.end(); ++it)
         if (*it == descriptor_set_layout)
         {
@@ -273,9 +378,10 @@ void glal::opengl::DeviceT::DestroyFramebuffer(Framebuffer framebuffer)
 }
 
 glal::CommandBuffer glal::opengl::DeviceT::CreateCommandBuffer(
-    const CommandBufferUsage usage)
+    const CommandBufferUsage usage,
+    const QueueType queue_type)
 {
-    return m_CommandBuffers.emplace_back(new CommandBufferT(this, usage));
+    return m_CommandBuffers.emplace_back(new CommandBufferT(this, usage, queue_type));
 }
 
 void glal::opengl::DeviceT::DestroyCommandBuffer(CommandBuffer command_buffer)
@@ -313,13 +419,57 @@ void glal::opengl::DeviceT::DestroyFence(Fence fence)
         static_cast<const void *>(this));
 }
 
-glal::Queue glal::opengl::DeviceT::GetQueue(QueueType type)
+glal::Semaphore glal::opengl::DeviceT::CreateSemaphore(const SemaphoreDesc &desc)
 {
-    return m_Queue;
+    return m_Semaphores.emplace_back(new SemaphoreT(this, desc));
+}
+
+void glal::opengl::DeviceT::DestroySemaphore(Semaphore semaphore)
+{
+    for (auto it = m_Semaphores.begin(); it != m_Semaphores.end(); ++it)
+        if (*it == semaphore)
+        {
+            m_Semaphores.erase(it);
+            delete semaphore;
+            return;
+        }
+    common::Fatal(
+        "semaphore {} is not owned by device {}",
+        static_cast<const void *>(semaphore),
+        static_cast<const void *>(this));
+}
+
+glal::QueryPool glal::opengl::DeviceT::CreateQueryPool(const QueryPoolDesc &desc)
+{
+    return m_QueryPools.emplace_back(new QueryPoolT(this, desc));
+}
+
+void glal::opengl::DeviceT::DestroyQueryPool(QueryPool query_pool)
+{
+    for (auto it = m_QueryPools.begin(); it != m_QueryPools.end(); ++it)
+        if (*it == query_pool)
+        {
+            m_QueryPools.erase(it);
+            delete query_pool;
+            return;
+        }
+    common::Fatal(
+        "query pool {} is not owned by device {}",
+        static_cast<const void *>(query_pool),
+        static_cast<const void *>(this));
+}
+
+glal::Queue glal::opengl::DeviceT::GetQueue(const QueueType type)
+{
+    if (type == QueueType_Transfer && m_TransferQueue)
+        return m_TransferQueue;
+    return m_GraphicsQueue;
 }
 
 bool glal::opengl::DeviceT::Supports(const DeviceFeature feature) const
 {
+    if (feature == DeviceFeature_AsyncPipelines && m_CompileQueue)
+        return true;
     return m_PhysicalDevice->Supports(feature);
 }
 
@@ -327,3 +477,198 @@ const glal::DeviceLimits &glal::opengl::DeviceT::GetLimits() const
 {
     return m_PhysicalDevice->GetLimits();
 }
+
+bool glal::opengl::DeviceT::FindProgramBinary(const std::uint64_t key, ProgramBinary *binary) const
+{
+    if (m_PipelineCachePath.empty())
+        return false;
+
+    std::lock_guard lock(m_ProgramBinaryMutex);
+
+    const auto it = m_ProgramBinaries.find(key);
+    if (it == m_ProgramBinaries.end())
+        return false;
+
+    *binary = it->second;
+    return true;
+}
+
+void glal::opengl::DeviceT::StoreProgramBinary(const std::uint64_t key, ProgramBinary binary)
+{
+    if (m_PipelineCachePath.empty())
+        return;
+
+    std::lock_guard lock(m_ProgramBinaryMutex);
+
+    m_ProgramBinaries[key] = std::move(binary);
+    m_PipelineCacheDirty = true;
+}
+
+glal::opengl::QueueT *glal::opengl::DeviceT::GetCompileQueue() const
+{
+    return m_CompileQueue;
+}
+
+glal::opengl::UniformRing *glal::opengl::DeviceT::GetPushConstantRing() const
+{
+    return m_PushConstantRing;
+}
+
+static void set_capability(const GLenum capability, const bool enable)
+{
+    if (enable)
+        glEnable(capability);
+    else
+        glDisable(capability);
+}
+
+void glal::opengl::DeviceT::ApplyStateBlock(const StateBlock &state)
+{
+    // whole blocks are compared first, most binds switch between pipelines that only differ in their program
+    if (const auto &raster = state.Raster; raster != m_StateBlock.Raster)
+    {
+        const auto &current = m_StateBlock.Raster;
+        if (raster.CullFace != current.CullFace)
+            set_capability(GL_CULL_FACE, raster.CullFace);
+        if (raster.CullMode != current.CullMode)
+            glCullFace(raster.CullMode);
+        if (raster.FrontFace != current.FrontFace)
+            glFrontFace(raster.FrontFace);
+        if (raster.PrimitiveRestart != current.PrimitiveRestart)
+            set_capability(GL_PRIMITIVE_RESTART_FIXED_INDEX, raster.PrimitiveRestart);
+    }
+
+    if (const auto &depth_stencil = state.DepthStencil; depth_stencil != m_StateBlock.DepthStencil)
+    {
+        const auto &current = m_StateBlock.DepthStencil;
+        if (depth_stencil.DepthTest != current.DepthTest)
+            set_capability(GL_DEPTH_TEST, depth_stencil.DepthTest);
+        if (depth_stencil.DepthMask != current.DepthMask)
+            glDepthMask(depth_stencil.DepthMask);
+        if (depth_stencil.DepthFunc != current.DepthFunc)
+            glDepthFunc(depth_stencil.DepthFunc);
+    }
+
+    if (const auto &blend = state.Blend; blend != m_StateBlock.Blend)
+    {
+        const auto &current = m_StateBlock.Blend;
+        if (blend.Blend != current.Blend)
+            set_capability(GL_BLEND, blend.Blend);
+        if (blend.SrcColor != current.SrcColor
+            || blend.DstColor != current.DstColor
+            || blend.SrcAlpha != current.SrcAlpha
+            || blend.DstAlpha != current.DstAlpha)
+            glBlendFuncSeparate(blend.SrcColor, blend.DstColor, blend.SrcAlpha, blend.DstAlpha);
+        if (blend.Equation != current.Equation)
+            glBlendEquation(blend.Equation);
+    }
+
+    m_StateBlock = state;
+}
+
+const glal::opengl::StateBlock &glal::opengl::DeviceT::GetStateBlock() const
+{
+    return m_StateBlock;
+}
+
+GLuint64 glal::opengl::DeviceT::AcquireTextureHandle(ImageViewT *image_view_impl, SamplerT *sampler_impl)
+{
+    const auto handle = glGetTextureSamplerHandleARB(image_view_impl->GetImageHandle(), sampler_impl->GetHandle());
+
+    if (!m_TextureHandleReferences[handle]++)
+        glMakeTextureHandleResidentARB(handle);
+    return handle;
+}
+
+void glal::opengl::DeviceT::ReleaseTextureHandle(const GLuint64 handle)
+{
+    const auto it = m_TextureHandleReferences.find(handle);
+    common::Assert(it != m_TextureHandleReferences.end(), "texture handle {} is not resident", handle);
+
+    if (--it->second)
+        return;
+
+    glMakeTextureHandleNonResidentARB(handle);
+    m_TextureHandleReferences.erase(it);
+}
+
+void glal::opengl::DeviceT::LoadPipelineCache()
+{
+    if (m_PipelineCachePath.empty())
+        return;
+
+    std::ifstream stream(m_PipelineCachePath, std::ios::binary);
+    if (!stream.is_open())
+        return;
+
+    pipeline_cache_header_t header{};
+    stream.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+    if (!stream
+        || header.magic != pipeline_cache_magic
+        || header.version != pipeline_cache_version
+        || header.driver_hash != m_DriverHash)
+    {
+        common::Log(common::LogLevel_Info, "discarding stale pipeline cache {}", m_PipelineCachePath);
+        return;
+    }
+
+    for (std::uint32_t i = 0; i < header.entry_count; ++i)
+    {
+        pipeline_cache_entry_t entry{};
+        stream.read(reinterpret_cast<char *>(&entry), sizeof(entry));
+
+        ProgramBinary binary
+        {
+            .Format = entry.format,
+            .Data = std::vector<char>(entry.size),
+        };
+        stream.read(binary.Data.data(), entry.size);
+
+        if (!stream)
+        {
+            common::Log(common::LogLevel_Warning, "truncated pipeline cache {}", m_PipelineCachePath);
+            break;
+        }
+
+        m_ProgramBinaries[entry.key] = std::move(binary);
+    }
+
+    common::Log(
+        common::LogLevel_Info,
+        "loaded {} program binaries from {}",
+        m_ProgramBinaries.size(),
+        m_PipelineCachePath);
+}
+
+void glal::opengl::DeviceT::SavePipelineCache() const
+{
+    if (m_PipelineCachePath.empty() || !m_PipelineCacheDirty)
+        return;
+
+    WriteFileAtomic(
+        m_PipelineCachePath,
+        [&](std::ostream &stream)
+        {
+            const pipeline_cache_header_t header
+            {
+                .magic = pipeline_cache_magic,
+                .version = pipeline_cache_version,
+                .driver_hash = m_DriverHash,
+                .entry_count = static_cast<std::uint32_t>(m_ProgramBinaries.size()),
+            };
+            stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+            for (auto &[key, binary] : m_ProgramBinaries)
+            {
+                const pipeline_cache_entry_t entry
+                {
+                    .key = key,
+                    .format = binary.Format,
+                    .size = static_cast<std::uint32_t>(binary.Data.size()),
+                };
+                stream.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+                stream.write(binary.Data.data(), static_cast<std::streamsize>(binary.Data.size()));
+            }
+        });
+}
@@ -1,22 +1,98 @@
 #include <glal/opengl.hxx>
 
+static constexpr GLuint64 sync_timeout = 1'000'000'000; // 1 second
+
 glal::opengl::FenceT::FenceT(DeviceT *device)
     : m_Device(device),
-      m_Sync()
+      m_Sync(),
+      m_Pending(false),
+      m_Signaled(false)
 {
 }
 
+glal::opengl::FenceT::~FenceT()
+{
+    if (m_Sync)
+        glDeleteSync(m_Sync);
+}
+
 void glal::opengl::FenceT::Wait()
 {
-    m_Sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
-    glWaitSync(m_Sync, 0, GL_TIMEOUT_IGNORED);
+    std::unique_lock lock(m_Mutex);
+
+    if (m_Sync)
+    {
+        while (glClientWaitSync(m_Sync, GL_SYNC_FLUSH_COMMANDS_BIT, sync_timeout) == GL_TIMEOUT_EXPIRED)
+        {
+        }
+
+        glDeleteSync(m_Sync);
+        m_Sync = nullptr;
+        m_Pending = false;
+        m_Signaled = true;
+        return;
+    }
+
+    // a fence that was never submitted does not block
+    m_Condition.wait(
+        lock,
+        [this]
+        {
+            return !m_Pending;
+        });
 }
 
 void glal::opengl::FenceT::Reset()
 {
+    std::lock_guard lock(m_Mutex);
+
     if (m_Sync)
     {
         glDeleteSync(m_Sync);
         m_Sync = nullptr;
     }
+
+    m_Pending = false;
+    m_Signaled = false;
+}
+
+bool glal::opengl::FenceT::IsSignaled()
+{
+    std::lock_guard lock(m_Mutex);
+
+    if (m_Sync)
+    {
+        const auto result = glClientWaitSync(m_Sync, 0, 0);
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+        {
+            glDeleteSync(m_Sync);
+            m_Sync = nullptr;
+            m_Pending = false;
+            m_Signaled = true;
+        }
+    }
+
+    return m_Signaled;
+}
+
+void glal::opengl::FenceT::Submit(const GLsync sync)
+{
+    std::lock_guard lock(m_Mutex);
+
+    if (m_Sync)
+        glDeleteSync(m_Sync);
+
+    m_Sync = sync;
+    m_Pending = true;
+    m_Signaled = false;
+}
+
+void glal::opengl::FenceT::Signal()
+{
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Pending = false;
+        m_Signaled = true;
+    }
+    m_Condition.notify_all();
 }
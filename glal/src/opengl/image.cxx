@@ -13,6 +13,9 @@ glal::opengl::ImageT::ImageT(DeviceT *device, const ImageDesc &desc)
     GLenum internal_format, external_format, type;
     TranslateImageFormat(m_Format, &internal_format, &external_format, &type);
 
+    // compressed images only receive data through block uploads
+    const auto compressed = IsCompressedFormat(m_Format);
+
     switch (m_Type)
     {
     case ImageType_1D:
@@ -22,14 +25,15 @@ glal::opengl::ImageT::ImageT(DeviceT *device, const ImageDesc &desc)
             static_cast<int>(m_MipLevelCount),
             internal_format,
             static_cast<GLsizei>(m_Extent.Width));
-        glTextureSubImage1D(
-            m_Handle,
-            0,
-            0,
-            static_cast<GLsizei>(m_Extent.Width),
-            external_format,
-            type,
-            nullptr);
+        if (!compressed)
+            glTextureSubImage1D(
+                m_Handle,
+                0,
+                0,
+                static_cast<GLsizei>(m_Extent.Width),
+                external_format,
+                type,
+                nullptr);
         break;
     case ImageType_2D:
         glCreateTextures(GL_TEXTURE_2D, 1, &m_Handle);
@@ -39,16 +43,17 @@ glal::opengl::ImageT::ImageT(DeviceT *device, const ImageDesc &desc)
             internal_format,
             static_cast<GLsizei>(m_Extent.Width),
             static_cast<GLsizei>(m_Extent.Height));
-        glTextureSubImage2D(
-            m_Handle,
-            0,
-            0,
-            0,
-            static_cast<GLsizei>(m_Extent.Width),
-            static_cast<GLsizei>(m_Extent.Height),
-            external_format,
-            type,
-            nullptr);
+        if (!compressed)
+            glTextureSubImage2D(
+                m_Handle,
+                0,
+                0,
+                0,
+                static_cast<GLsizei>(m_Extent.Width),
+                static_cast<GLsizei>(m_Extent.Height),
+                external_format,
+                type,
+                nullptr);
         break;
     case ImageType_3D:
         glCreateTextures(GL_TEXTURE_3D, 1, &m_Handle);
@@ -59,18 +64,19 @@ glal::opengl::ImageT::ImageT(DeviceT *device, const ImageDesc &desc)
             static_cast<GLsizei>(m_Extent.Width),
             static_cast<GLsizei>(m_Extent.Height),
             static_cast<GLsizei>(m_Extent.Depth));
-        glTextureSubImage3D(
-            m_Handle,
-            0,
-            0,
-            0,
-            0,
-            static_cast<GLsizei>(m_Extent.Width),
-            static_cast<GLsizei>(m_Extent.Height),
-            static_cast<GLsizei>(m_Extent.Depth),
-            external_format,
-            type,
-            nullptr);
+        if (!compressed)
+            glTextureSubImage3D(
+                m_Handle,
+                0,
+                0,
+                0,
+                0,
+                static_cast<GLsizei>(m_Extent.Width),
+                static_cast<GLsizei>(m_Extent.Height),
+                static_cast<GLsizei>(m_Extent.Depth),
+                external_format,
+                type,
+                nullptr);
         break;
     }
 }
@@ -1,6 +1,12 @@
+#include <cstring>
 #include <common/log.hxx>
 #include <glal/opengl.hxx>
 
+#ifdef GLAL_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
 static void gl_debug_message_callback(
     const GLenum source,
     const GLenum type,
@@ -94,9 +100,121 @@ static void gl_debug_message_callback(
     common::Log(log_level, "[GL] {} {} {}: {}", source_string, type_string, id, message);
 }
 
+#ifdef GLAL_EGL
+
+static bool has_extension(const char *extensions, const char *name)
+{
+    if (!extensions)
+        return false;
+
+    const auto length = std::strlen(name);
+    for (auto it = std::strstr(extensions, name); it; it = std::strstr(it + length, name))
+        if ((it == extensions || it[-1] == ' ') && (it[length] == ' ' || it[length] == '\0'))
+            return true;
+    return false;
+}
+
+/**
+ * prefers the surfaceless platform, which needs neither a display server nor a gpu with mesa, and falls back to
+ * the default display with a 1x1 pbuffer
+ */
+static void create_headless_context(const bool debug, void **display, void **surface, void **context)
+{
+    const auto client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+    EGLDisplay egl_display = EGL_NO_DISPLAY;
+    if (has_extension(client_extensions, "EGL_MESA_platform_surfaceless"))
+        if (const auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT")))
+            egl_display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (egl_display == EGL_NO_DISPLAY)
+        egl_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    common::Assert(
+        egl_display != EGL_NO_DISPLAY && eglInitialize(egl_display, nullptr, nullptr),
+        "failed to initialize egl display");
+    common::Assert(eglBindAPI(EGL_OPENGL_API), "egl does not support desktop opengl");
+
+    const auto surfaceless = has_extension(
+        eglQueryString(egl_display, EGL_EXTENSIONS),
+        "EGL_KHR_surfaceless_context");
+
+    const EGLint config_attributes[]
+    {
+        EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_NONE,
+    };
+
+    EGLConfig config;
+    EGLint config_count;
+    common::Assert(
+        eglChooseConfig(egl_display, config_attributes, &config, 1, &config_count) && config_count,
+        "no egl config supports offscreen opengl");
+
+    const EGLint context_attributes[]
+    {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 5,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_CONTEXT_OPENGL_DEBUG, debug ? EGL_TRUE : EGL_FALSE,
+        EGL_NONE,
+    };
+
+    const auto egl_context = eglCreateContext(egl_display, config, EGL_NO_CONTEXT, context_attributes);
+    common::Assert(egl_context != EGL_NO_CONTEXT, "failed to create a headless opengl 4.5 context");
+
+    EGLSurface egl_surface = EGL_NO_SURFACE;
+    if (!surfaceless)
+    {
+        const EGLint surface_attributes[]
+        {
+            EGL_WIDTH, 1,
+            EGL_HEIGHT, 1,
+            EGL_NONE,
+        };
+        egl_surface = eglCreatePbufferSurface(egl_display, config, surface_attributes);
+        common::Assert(egl_surface != EGL_NO_SURFACE, "failed to create a pbuffer surface");
+    }
+
+    common::Assert(
+        eglMakeCurrent(egl_display, egl_surface, egl_surface, egl_context),
+        "failed to make the headless context current");
+
+    *display = egl_display;
+    *surface = egl_surface;
+    *context = egl_context;
+}
+
+#endif
+
 glal::opengl::InstanceT::InstanceT(const InstanceDesc &desc)
+    : m_PipelineCachePath(desc.PipelineCachePath ? desc.PipelineCachePath : ""),
+      m_Headless(desc.Headless),
+      m_Display(),
+      m_Surface(),
+      m_Context()
 {
-    glewInit();
+    if (m_Headless)
+    {
+#ifdef GLAL_EGL
+        create_headless_context(desc.EnableValidation, &m_Display, &m_Surface, &m_Context);
+
+        // glewInit would also load the glx entry points, which fail without an x display
+        if (const auto error = glewContextInit())
+            common::Fatal("failed to initialize glew: {}", reinterpret_cast<const char *>(glewGetErrorString(error)));
+#else
+        common::Fatal("headless opengl needs egl, which was not found at build time");
+#endif
+    }
+    else
+    {
+        glewInit();
+    }
 
     if (desc.EnableValidation)
     {
@@ -108,9 +226,33 @@ glal::opengl::InstanceT::InstanceT(const InstanceDesc &desc)
     m_PhysicalDevices.emplace_back(this);
 }
 
+glal::opengl::InstanceT::~InstanceT()
+{
+#ifdef GLAL_EGL
+    if (!m_Headless)
+        return;
+
+    eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (m_Surface)
+        eglDestroySurface(m_Display, m_Surface);
+    eglDestroyContext(m_Display, m_Context);
+    eglTerminate(m_Display);
+#endif
+}
+
 std::uint32_t glal::opengl::InstanceT::EnumeratePhysicalDevices(PhysicalDevice *devices)
 {
     if (devices)
         *devices = m_PhysicalDevices.data();
     return m_PhysicalDevices.size();
 }
+
+const std::filesystem::path &glal::opengl::InstanceT::GetPipelineCachePath() const
+{
+    return m_PipelineCachePath;
+}
+
+bool glal::opengl::InstanceT::IsHeadless() const
+{
+    return m_Headless;
+}
@@ -11,6 +11,17 @@ glal::opengl::PhysicalDeviceT::PhysicalDeviceT(InstanceT *instance)
     m_Limits.MaxTextureSize2D = max_texture_size;
     m_Limits.MaxUniformBuffers = 16;
     m_Limits.MaxBufferSize = 1ull << 30;
+    m_Limits.MaxPushConstantsSize = MaxPushConstantsSize;
+
+    GLint uniform_buffer_offset_alignment;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniform_buffer_offset_alignment);
+    m_Limits.MinUniformBufferOffsetAlignment = uniform_buffer_offset_alignment;
+
+    // bindless handles are only bounded by memory, this caps the storage buffer of a single array
+    m_Limits.MaxBindlessTextures = GLEW_ARB_bindless_texture ? 1u << 20 : 0u;
+
+    // gl timestamps are in nanoseconds already
+    m_Limits.TimestampPeriod = 1.0f;
 }
 
 glal::opengl::PhysicalDeviceT::~PhysicalDeviceT()
@@ -45,9 +56,24 @@ glal::Instance glal::opengl::PhysicalDeviceT::GetInstance() const
 
 bool glal::opengl::PhysicalDeviceT::Supports(const DeviceFeature feature) const
 {
+    if (feature == DeviceFeature_AsyncPipelines)
+        return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+    if (feature == DeviceFeature_TextureCompressionBC)
+        return GLEW_EXT_texture_compression_s3tc;
+    if (feature == DeviceFeature_TextureCompressionASTC)
+        return GLEW_KHR_texture_compression_astc_ldr;
+    if (feature == DeviceFeature_TextureCompressionETC2)
+        return GLEW_ARB_ES3_compatibility;
+    if (feature == DeviceFeature_PipelineStatisticsQuery)
+        return GLEW_ARB_pipeline_statistics_query;
+    if (feature == DeviceFeature_BindlessTextures)
+        return GLEW_ARB_bindless_texture;
+
     return feature == DeviceFeature_GeometryShader
            || feature == DeviceFeature_Tessellation
-           || feature == DeviceFeature_Compute;
+           || feature == DeviceFeature_Compute
+           || feature == DeviceFeature_TimelineSemaphore
+           || feature == DeviceFeature_TimestampQuery;
 }
 
 const glal::DeviceLimits &glal::opengl::PhysicalDeviceT::GetLimits() const
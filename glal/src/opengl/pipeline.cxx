@@ -1,61 +1,94 @@
+#include <common/hash.hxx>
 #include <common/log.hxx>
 #include <glal/opengl.hxx>
 
-glal::opengl::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc)
+glal::opengl::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc, const bool async)
     : m_Device(device),
       m_Layout(dynamic_cast<PipelineLayoutT *>(desc.Layout)),
       m_Type(desc.Type),
       m_Topology(desc.Topology),
       m_VertexBindings(desc.VertexBindings, desc.VertexBindings + desc.VertexBindingCount),
-      m_VertexAttributes(desc.VertexAttributes, desc.VertexAttributes + desc.VertexAttributeCount)
+      m_VertexAttributes(desc.VertexAttributes, desc.VertexAttributes + desc.VertexAttributeCount),
+      m_Status(PipelineStatus_Pending),
+      m_Key(common::HashSeed),
+      m_CompileFence()
 {
-    // TODO
-    (void) desc.DepthTest;
-    (void) desc.DepthWrite;
-    (void) desc.BlendEnable;
-    (void) desc.PrimitiveRestartEnable;
+    m_StateBlock.Raster.CullFace = desc.Culling != CullMode_None;
+    m_StateBlock.Raster.CullMode = desc.Culling == CullMode_Front ? GL_FRONT : GL_BACK;
+    m_StateBlock.Raster.FrontFace = desc.Winding == FrontFace_Clockwise ? GL_CW : GL_CCW;
+    m_StateBlock.Raster.PrimitiveRestart = desc.PrimitiveRestartEnable;
+
+    m_StateBlock.DepthStencil.DepthTest = desc.DepthTest;
+    m_StateBlock.DepthStencil.DepthMask = desc.DepthWrite ? GL_TRUE : GL_FALSE;
+    m_StateBlock.DepthStencil.DepthFunc = GL_LEQUAL;
+
+    if (desc.BlendEnable)
+        m_StateBlock.Blend = {
+            .Blend = true,
+            .SrcColor = GL_SRC_ALPHA,
+            .DstColor = GL_ONE_MINUS_SRC_ALPHA,
+            .SrcAlpha = GL_ONE,
+            .DstAlpha = GL_ONE_MINUS_SRC_ALPHA,
+            .Equation = GL_FUNC_ADD,
+        };
 
     m_Handle = glCreateProgram();
 
+    std::uint32_t constant_count = 0;
+    for (std::uint32_t i = 0; i < desc.StageCount; ++i)
+        constant_count += desc.Stages[i].SpecializationConstantCount;
+
+    // reserved up front so the stages can point into it while it is filled
+    m_SpecializationConstants.reserve(constant_count);
     for (std::uint32_t i = 0; i < desc.StageCount; ++i)
     {
         const auto stage = desc.Stages + i;
         const auto shader_module_impl = dynamic_cast<ShaderModuleT *>(stage->Module);
 
-        glAttachShader(m_Handle, shader_module_impl->GetHandle());
-    }
+        m_Key = common::HashCombine(m_Key, stage->Stage);
+        m_Key = common::HashCombine(m_Key, shader_module_impl->GetHash());
+        m_Key = common::Hash(
+            stage->SpecializationConstants,
+            stage->SpecializationConstantCount * sizeof(SpecializationConstant),
+            m_Key);
 
-    glLinkProgram(m_Handle);
+        auto &owned_stage = m_Stages.emplace_back(*stage);
+        owned_stage.SpecializationConstants = m_SpecializationConstants.data() + m_SpecializationConstants.size();
+        m_SpecializationConstants.insert(
+            m_SpecializationConstants.end(),
+            stage->SpecializationConstants,
+            stage->SpecializationConstants + stage->SpecializationConstantCount);
+    }
 
-    GLint link_status;
-    glGetProgramiv(m_Handle, GL_LINK_STATUS, &link_status);
-    if (link_status != GL_TRUE)
+    // without parallel shader compile in the driver, specializing and linking block until they are done, so async
+    // pipelines move all of it onto the compile queue and only report ready once its context has finished
+    if (const auto compile_queue = m_Device->GetCompileQueue(); async && compile_queue)
     {
-        GLsizei log_length;
-        GLchar message[1024];
-        glGetProgramInfoLog(m_Handle, 1024, &log_length, message);
-        message[log_length] = 0;
-
-        common::Fatal("failed to link program: {}", message);
+        m_CompileFence = new FenceT(m_Device);
+        compile_queue->Execute(
+            [this]
+            {
+                Compile();
+                Finish(false);
+            },
+            m_CompileFence);
+        return;
     }
 
-    glValidateProgram(m_Handle);
-
-    GLint validate_status;
-    glGetProgramiv(m_Handle, GL_VALIDATE_STATUS, &validate_status);
-    if (validate_status != GL_TRUE)
-    {
-        GLsizei log_length;
-        GLchar message[1024];
-        glGetProgramInfoLog(m_Handle, 1024, &log_length, message);
-        message[log_length] = 0;
+    Compile();
 
-        common::Fatal("failed to validate program: {}", message);
-    }
+    if (!async)
+        Finish(true);
 }
 
 glal::opengl::PipelineT::~PipelineT()
 {
+    if (m_CompileFence)
+    {
+        m_CompileFence->Wait();
+        delete m_CompileFence;
+    }
+
     glDeleteProgram(m_Handle);
 }
 
@@ -69,6 +102,28 @@ glal::PrimitiveTopology glal::opengl::PipelineT::GetTopology() const
     return m_Topology;
 }
 
+glal::PipelineStatus glal::opengl::PipelineT::GetStatus()
+{
+    // the compile queue finishes the pipeline itself, its result is only visible here once the fence says so
+    if (m_CompileFence)
+        return m_CompileFence->IsSignaled() ? m_Status : PipelineStatus_Pending;
+
+    if (m_Status != PipelineStatus_Pending)
+        return m_Status;
+
+    // without the extension, querying the link status blocks until it is done anyway
+    if (m_Device->GetPhysicalDevice()->Supports(DeviceFeature_AsyncPipelines))
+    {
+        GLint completion_status;
+        glGetProgramiv(m_Handle, GL_COMPLETION_STATUS_KHR, &completion_status);
+        if (completion_status != GL_TRUE)
+            return m_Status;
+    }
+
+    Finish(false);
+    return m_Status;
+}
+
 void glal::opengl::PipelineT::BindVertexArray(GLuint vertex_array) const
 {
     for (auto &vertex_attribute : m_VertexAttributes)
@@ -88,6 +143,10 @@ void glal::opengl::PipelineT::BindVertexArray(GLuint vertex_array) const
             normalized,
             vertex_attribute.Offset);
     }
+
+    // per instance bindings step once per instance instead of once per vertex
+    for (auto &vertex_binding : m_VertexBindings)
+        glVertexArrayBindingDivisor(vertex_array, vertex_binding.Binding, vertex_binding.Instance ? 1 : 0);
 }
 
 void glal::opengl::PipelineT::BindVertexBuffer(
@@ -113,3 +172,123 @@ GLuint glal::opengl::PipelineT::GetHandle() const
 {
     return m_Handle;
 }
+
+const glal::opengl::StateBlock &glal::opengl::PipelineT::GetStateBlock() const
+{
+    return m_StateBlock;
+}
+
+void glal::opengl::PipelineT::Compile()
+{
+    // a cached binary replaces both link and validation, fall through to a full link if the driver rejects it
+    if (ProgramBinary binary; m_Device->FindProgramBinary(m_Key, &binary))
+    {
+        glProgramBinary(m_Handle, binary.Format, binary.Data.data(), static_cast<GLsizei>(binary.Data.size()));
+
+        GLint link_status;
+        glGetProgramiv(m_Handle, GL_LINK_STATUS, &link_status);
+        if (link_status == GL_TRUE)
+        {
+            m_Status = PipelineStatus_Ready;
+            return;
+        }
+
+        common::Log(common::LogLevel_Info, "cached program binary {:#016x} was rejected by the driver", m_Key);
+    }
+
+    for (auto &stage : m_Stages)
+    {
+        const auto shader_module_impl = dynamic_cast<ShaderModuleT *>(stage.Module);
+
+        if (!stage.SpecializationConstantCount)
+        {
+            glAttachShader(m_Handle, m_Shaders.emplace_back(shader_module_impl->GetHandle()));
+            continue;
+        }
+
+        // flagged for deletion right away, the shader goes with its last detach once the program is linked
+        const auto shader = shader_module_impl->CreateShader(
+            stage.SpecializationConstants,
+            stage.SpecializationConstantCount);
+        glAttachShader(m_Handle, m_Shaders.emplace_back(shader));
+        glDeleteShader(shader);
+    }
+
+    glProgramParameteri(m_Handle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+    // with parallel shader compile the driver specializes and links on its own threads and returns immediately,
+    // the result is collected once GL_COMPLETION_STATUS reports it as done
+    glLinkProgram(m_Handle);
+}
+
+void glal::opengl::PipelineT::Finish(const bool fatal)
+{
+    // a program loaded from its binary is done already
+    if (m_Status != PipelineStatus_Pending)
+        return;
+
+    const auto fail = [&](const char *action, const char *message)
+    {
+        if (fatal)
+            common::Fatal("failed to {}: {}", action, message);
+
+        // a background compile must not take the application down, the caller keeps using its fallback
+        common::Log(common::LogLevel_Error, "failed to {}: {}", action, message);
+        m_Status = PipelineStatus_Failed;
+    };
+
+    GLsizei log_length;
+    GLchar message[1024];
+
+    for (const auto shader : m_Shaders)
+    {
+        GLint compile_status;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &compile_status);
+        if (compile_status == GL_TRUE)
+            continue;
+
+        glGetShaderInfoLog(shader, 1024, &log_length, message);
+        message[log_length] = 0;
+        return fail("specialize shader", message);
+    }
+
+    GLint link_status;
+    glGetProgramiv(m_Handle, GL_LINK_STATUS, &link_status);
+    if (link_status != GL_TRUE)
+    {
+        glGetProgramInfoLog(m_Handle, 1024, &log_length, message);
+        message[log_length] = 0;
+        return fail("link program", message);
+    }
+
+    glValidateProgram(m_Handle);
+
+    GLint validate_status;
+    glGetProgramiv(m_Handle, GL_VALIDATE_STATUS, &validate_status);
+    if (validate_status != GL_TRUE)
+    {
+        glGetProgramInfoLog(m_Handle, 1024, &log_length, message);
+        message[log_length] = 0;
+        return fail("validate program", message);
+    }
+
+    for (const auto shader : m_Shaders)
+        glDetachShader(m_Handle, shader);
+    m_Shaders.clear();
+
+    m_Status = PipelineStatus_Ready;
+
+    GLint binary_length;
+    glGetProgramiv(m_Handle, GL_PROGRAM_BINARY_LENGTH, &binary_length);
+    if (binary_length <= 0)
+        return;
+
+    ProgramBinary binary
+    {
+        .Format = 0,
+        .Data = std::vector<char>(binary_length),
+    };
+    glGetProgramBinary(m_Handle, binary_length, nullptr, &binary.Format, binary.Data.data());
+
+    m_Device->StoreProgramBinary(m_Key, std::move(binary));
+}
@@ -2,7 +2,8 @@
 
 glal::opengl::PipelineLayoutT::PipelineLayoutT(DeviceT *device, const PipelineLayoutDesc &desc)
     : m_Device(device),
-      m_DescriptorSetLayouts(desc.DescriptorSetLayouts, desc.DescriptorSetLayouts + desc.DescriptorSetLayoutCount)
+      m_DescriptorSetLayouts(desc.DescriptorSetLayouts, desc.DescriptorSetLayouts + desc.DescriptorSetLayoutCount),
+      m_PushConstantRanges(desc.PushConstantRanges, desc.PushConstantRanges + desc.PushConstantRangeCount)
 {
 }
 
@@ -16,3 +17,13 @@ glal::DescriptorSetLayout glal::opengl::PipelineLayoutT::GetDescriptorSetLayout(
 {
     return m_DescriptorSetLayouts.at(index);
 }
+
+std::uint32_t glal::opengl::PipelineLayoutT::GetPushConstantRangeCount() const
+{
+    return m_PushConstantRanges.size();
+}
+
+const glal::PushConstantRange &glal::opengl::PipelineLayoutT::GetPushConstantRange(const std::uint32_t index) const
+{
+    return m_PushConstantRanges.at(index);
+}
@@ -0,0 +1,98 @@
+#include <array>
+#include <glal/opengl.hxx>
+
+static constexpr std::array timestamp_targets
+{
+    static_cast<GLenum>(GL_TIMESTAMP),
+};
+
+static constexpr std::array occlusion_targets
+{
+    static_cast<GLenum>(GL_SAMPLES_PASSED),
+};
+
+// same order as glal::PipelineStatistics
+static constexpr std::array pipeline_statistics_targets
+{
+    static_cast<GLenum>(GL_VERTICES_SUBMITTED_ARB),
+    static_cast<GLenum>(GL_PRIMITIVES_SUBMITTED_ARB),
+    static_cast<GLenum>(GL_VERTEX_SHADER_INVOCATIONS_ARB),
+    static_cast<GLenum>(GL_CLIPPING_INPUT_PRIMITIVES_ARB),
+    static_cast<GLenum>(GL_FRAGMENT_SHADER_INVOCATIONS_ARB),
+    static_cast<GLenum>(GL_COMPUTE_SHADER_INVOCATIONS_ARB),
+};
+
+glal::opengl::QueryPoolT::QueryPoolT(DeviceT *device, const QueryPoolDesc &desc)
+    : m_Device(device),
+      m_Type(desc.Type),
+      m_Count(desc.Count)
+{
+    const auto targets = GetTargets();
+
+    m_Handles.resize(m_Count * targets.size());
+    for (std::size_t i = 0; i < targets.size(); ++i)
+    {
+        // queries of one target are strided by the target count, so create them one by one
+        for (std::uint32_t query = 0; query < m_Count; ++query)
+            glCreateQueries(targets[i], 1, &m_Handles[query * targets.size() + i]);
+    }
+}
+
+glal::opengl::QueryPoolT::~QueryPoolT()
+{
+    glDeleteQueries(static_cast<GLsizei>(m_Handles.size()), m_Handles.data());
+}
+
+glal::QueryType glal::opengl::QueryPoolT::GetType() const
+{
+    return m_Type;
+}
+
+std::uint32_t glal::opengl::QueryPoolT::GetCount() const
+{
+    return m_Count;
+}
+
+bool glal::opengl::QueryPoolT::GetResults(
+    const std::uint32_t first_query,
+    const std::uint32_t query_count,
+    std::uint64_t *results)
+{
+    const auto target_count = GetTargets().size();
+
+    const auto begin = m_Handles.begin() + first_query * target_count;
+    const auto end = begin + query_count * target_count;
+
+    // results of a query become available in order, but the counters of a statistics query do not depend on each
+    // other, so every handle is checked
+    for (auto it = begin; it != end; ++it)
+    {
+        GLuint available;
+        glGetQueryObjectuiv(*it, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            return false;
+    }
+
+    for (auto it = begin; it != end; ++it)
+        glGetQueryObjectui64v(*it, GL_QUERY_RESULT, results++);
+    return true;
+}
+
+std::span<const GLenum> glal::opengl::QueryPoolT::GetTargets() const
+{
+    switch (m_Type)
+    {
+    case QueryType_Timestamp:
+        return timestamp_targets;
+    case QueryType_Occlusion:
+        return occlusion_targets;
+    case QueryType_PipelineStatistics:
+        return pipeline_statistics_targets;
+    }
+    return {};
+}
+
+const GLuint *glal::opengl::QueryPoolT::GetHandles(const std::uint32_t query) const
+{
+    return m_Handles.data() + query * GetTargets().size();
+}
@@ -1,8 +1,50 @@
+#include <common/log.hxx>
 #include <glal/opengl.hxx>
+#include <GLFW/glfw3.h>
 
-glal::opengl::QueueT::QueueT(DeviceT *device)
-    : m_Device(device)
+static constexpr GLuint64 sync_timeout = 1'000'000'000; // 1 second
+
+glal::opengl::QueueT::QueueT(DeviceT *device, void *shared_context)
+    : m_Device(device),
+      m_Window(),
+      m_Stop(false)
 {
+    if (!shared_context)
+        return;
+
+    // the hidden window only exists for its context, which has to match the shared one
+    const auto shared_window = static_cast<GLFWwindow *>(shared_context);
+
+    glfwDefaultWindowHints();
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_API);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, glfwGetWindowAttrib(shared_window, GLFW_CONTEXT_VERSION_MAJOR));
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, glfwGetWindowAttrib(shared_window, GLFW_CONTEXT_VERSION_MINOR));
+    glfwWindowHint(GLFW_OPENGL_PROFILE, glfwGetWindowAttrib(shared_window, GLFW_OPENGL_PROFILE));
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, glfwGetWindowAttrib(shared_window, GLFW_OPENGL_FORWARD_COMPAT));
+
+    const auto window = glfwCreateWindow(1, 1, "glal worker", nullptr, shared_window);
+    glfwDefaultWindowHints();
+
+    common::Assert(window, "failed to create a shared context for a worker queue");
+
+    m_Window = window;
+    m_Thread = std::thread(&QueueT::Run, this);
+}
+
+glal::opengl::QueueT::~QueueT()
+{
+    if (!m_Window)
+        return;
+
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_Condition.notify_all();
+
+    m_Thread.join();
+    glfwDestroyWindow(static_cast<GLFWwindow *>(m_Window));
 }
 
 void glal::opengl::QueueT::Submit(
@@ -10,13 +52,155 @@ void glal::opengl::QueueT::Submit(
     const std::uint32_t command_buffer_count,
     Fence fence)
 {
-    // noop
+    Submit(
+        {
+            .CommandBuffers = command_buffers,
+            .CommandBufferCount = command_buffer_count,
+            .WaitSemaphores = nullptr,
+            .WaitSemaphoreCount = 0,
+            .SignalSemaphores = nullptr,
+            .SignalSemaphoreCount = 0,
+            .SignalFence = fence,
+        });
+}
+
+void glal::opengl::QueueT::Submit(const SubmitDesc &desc)
+{
+    const auto fence_impl = dynamic_cast<FenceT *>(desc.SignalFence);
+
+    Submission submission
+    {
+        .FenceRef = fence_impl,
+    };
+
+    // binary semaphores are paired in submission order, whichever thread executes the work
+    for (std::uint32_t i = 0; i < desc.WaitSemaphoreCount; ++i)
+    {
+        const auto semaphore_impl = dynamic_cast<SemaphoreT *>(desc.WaitSemaphores[i].Target);
+        submission.Waits.emplace_back(
+            semaphore_impl,
+            semaphore_impl->ResolveWaitValue(desc.WaitSemaphores[i].Value));
+    }
+    for (std::uint32_t i = 0; i < desc.SignalSemaphoreCount; ++i)
+    {
+        const auto semaphore_impl = dynamic_cast<SemaphoreT *>(desc.SignalSemaphores[i].Target);
+        submission.Signals.emplace_back(
+            semaphore_impl,
+            semaphore_impl->ResolveSignalValue(desc.SignalSemaphores[i].Value));
+    }
+
+    // immediate command buffers already executed while recording, their commands are empty
+    for (std::uint32_t i = 0; i < desc.CommandBufferCount; ++i)
+    {
+        const auto command_buffer_impl = dynamic_cast<CommandBufferT *>(desc.CommandBuffers[i]);
+        auto &commands = command_buffer_impl->GetCommands();
+        submission.Commands.insert(submission.Commands.end(), commands.begin(), commands.end());
+    }
+
+    if (!m_Window)
+    {
+        // waits can only order what is issued after them, immediate commands ran before
+        for (auto &[semaphore, value] : submission.Waits)
+            semaphore->WaitOnGpu(value);
+        for (auto &command : submission.Commands)
+            command();
+        for (auto &[semaphore, value] : submission.Signals)
+            semaphore->Enqueue(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), value);
+
+        if (fence_impl)
+            fence_impl->Submit(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        return;
+    }
+
+    if (fence_impl)
+        fence_impl->Submit(nullptr);
+
+    // objects the submission refers to may have just been created on this context
+    glFlush();
+
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Submissions.push_back(std::move(submission));
+    }
+    m_Condition.notify_one();
+}
+
+void glal::opengl::QueueT::Present(Swapchain swapchain, Semaphore wait_semaphore)
+{
+    common::Assert(!m_Window, "the transfer queue cannot present");
+
+    if (const auto semaphore_impl = dynamic_cast<SemaphoreT *>(wait_semaphore))
+        semaphore_impl->WaitOnGpu(semaphore_impl->ResolveWaitValue(0));
 
-    if (fence)
-        fence->Reset();
+    dynamic_cast<SwapchainT *>(swapchain)->Present();
 }
 
-void glal::opengl::QueueT::Present(Swapchain swapchain)
+bool glal::opengl::QueueT::IsAsync() const
 {
-    swapchain->Present();
+    return m_Window != nullptr;
+}
+
+void glal::opengl::QueueT::Execute(std::function<void()> command, FenceT *fence)
+{
+    if (!m_Window)
+    {
+        command();
+        fence->Submit(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        return;
+    }
+
+    fence->Submit(nullptr);
+
+    // objects the command refers to may have just been created on this context
+    glFlush();
+
+    {
+        std::lock_guard lock(m_Mutex);
+        m_Submissions.push_back({ .Commands = { std::move(command) }, .FenceRef = fence });
+    }
+    m_Condition.notify_one();
+}
+
+void glal::opengl::QueueT::Run()
+{
+    glfwMakeContextCurrent(static_cast<GLFWwindow *>(m_Window));
+
+    for (;;)
+    {
+        Submission submission;
+        {
+            std::unique_lock lock(m_Mutex);
+            m_Condition.wait(
+                lock,
+                [this]
+                {
+                    return m_Stop || !m_Submissions.empty();
+                });
+
+            // pending submissions are finished before stopping, someone may still wait for them
+            if (m_Submissions.empty())
+                break;
+
+            submission = std::move(m_Submissions.front());
+            m_Submissions.pop_front();
+        }
+
+        for (auto &[semaphore, value] : submission.Waits)
+            semaphore->WaitOnGpu(value);
+        for (auto &command : submission.Commands)
+            command();
+        for (auto &[semaphore, value] : submission.Signals)
+            semaphore->Enqueue(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), value);
+
+        const auto sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        while (glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, sync_timeout) == GL_TIMEOUT_EXPIRED)
+        {
+        }
+        glDeleteSync(sync);
+
+        if (submission.FenceRef)
+            submission.FenceRef->Signal();
+    }
+
+    glfwMakeContextCurrent(nullptr);
 }
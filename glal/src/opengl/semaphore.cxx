@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <chrono>
+#include <common/log.hxx>
+#include <glal/opengl.hxx>
+
+glal::opengl::SemaphoreT::SemaphoreT(DeviceT *device, const SemaphoreDesc &desc)
+    : m_Device(device),
+      m_Type(desc.Type),
+      m_Value(desc.Type == SemaphoreType_Timeline ? desc.InitialValue : 0),
+      m_IssuedValue(m_Value),
+      m_BinarySignals(0),
+      m_BinaryWaits(0)
+{
+}
+
+glal::opengl::SemaphoreT::~SemaphoreT()
+{
+    for (auto &pending : m_Pending)
+        glDeleteSync(pending.Sync);
+}
+
+glal::SemaphoreType glal::opengl::SemaphoreT::GetType() const
+{
+    return m_Type;
+}
+
+std::uint64_t glal::opengl::SemaphoreT::GetValue()
+{
+    common::Assert(m_Type == SemaphoreType_Timeline, "binary semaphores have no value");
+
+    std::lock_guard lock(m_Mutex);
+
+    Poll();
+    return m_Value;
+}
+
+bool glal::opengl::SemaphoreT::Wait(const std::uint64_t value, const std::uint64_t timeout)
+{
+    common::Assert(m_Type == SemaphoreType_Timeline, "binary semaphores cannot be waited on from the host");
+
+    std::unique_lock lock(m_Mutex);
+
+    // there is nothing to wait on before the signaling submission was issued
+    const auto issued = [&]
+    {
+        return m_IssuedValue >= value;
+    };
+    if (timeout == UINT64_MAX)
+        m_Condition.wait(lock, issued);
+    else if (!m_Condition.wait_for(lock, std::chrono::nanoseconds(timeout), issued))
+        return false;
+
+    Poll();
+    if (m_Value >= value)
+        return true;
+
+    const auto it = std::ranges::find_if(
+        m_Pending,
+        [&](const PendingSignal &pending)
+        {
+            return pending.Value >= value;
+        });
+
+    const auto result = glClientWaitSync(it->Sync, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+    if (result == GL_TIMEOUT_EXPIRED || result == GL_WAIT_FAILED)
+        return false;
+
+    Poll();
+    return m_Value >= value;
+}
+
+void glal::opengl::SemaphoreT::Signal(const std::uint64_t value)
+{
+    common::Assert(m_Type == SemaphoreType_Timeline, "binary semaphores cannot be signaled from the host");
+
+    Enqueue(nullptr, value);
+}
+
+std::uint64_t glal::opengl::SemaphoreT::ResolveSignalValue(const std::uint64_t value)
+{
+    if (m_Type == SemaphoreType_Timeline)
+        return value;
+
+    std::lock_guard lock(m_Mutex);
+    return ++m_BinarySignals;
+}
+
+std::uint64_t glal::opengl::SemaphoreT::ResolveWaitValue(const std::uint64_t value)
+{
+    if (m_Type == SemaphoreType_Timeline)
+        return value;
+
+    std::lock_guard lock(m_Mutex);
+    return ++m_BinaryWaits;
+}
+
+void glal::opengl::SemaphoreT::Enqueue(const GLsync sync, const std::uint64_t value)
+{
+    {
+        std::lock_guard lock(m_Mutex);
+
+        if (sync)
+            m_Pending.push_back({ .Value = value, .Sync = sync });
+        else
+            m_Value = std::max(m_Value, value);
+
+        m_IssuedValue = std::max(m_IssuedValue, value);
+    }
+    m_Condition.notify_all();
+}
+
+void glal::opengl::SemaphoreT::WaitOnGpu(const std::uint64_t value)
+{
+    std::unique_lock lock(m_Mutex);
+    m_Condition.wait(
+        lock,
+        [&]
+        {
+            return m_IssuedValue >= value;
+        });
+
+    Poll();
+    if (m_Value >= value)
+        return;
+
+    const auto it = std::ranges::find_if(
+        m_Pending,
+        [&](const PendingSignal &pending)
+        {
+            return pending.Value >= value;
+        });
+    glWaitSync(it->Sync, 0, GL_TIMEOUT_IGNORED);
+}
+
+void glal::opengl::SemaphoreT::Poll()
+{
+    // signals complete in order, the first pending one bounds the rest
+    while (!m_Pending.empty())
+    {
+        const auto &pending = m_Pending.front();
+
+        const auto result = glClientWaitSync(pending.Sync, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+            break;
+
+        m_Value = std::max(m_Value, pending.Value);
+
+        glDeleteSync(pending.Sync);
+        m_Pending.pop_front();
+    }
+}
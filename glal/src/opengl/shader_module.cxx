@@ -1,9 +1,41 @@
+#include <common/hash.hxx>
 #include <common/log.hxx>
 #include <glal/opengl.hxx>
 
 glal::opengl::ShaderModuleT::ShaderModuleT(DeviceT *device, const ShaderModuleDesc &desc)
     : m_Device(device),
-      m_Stage(desc.Stage)
+      m_Stage(desc.Stage),
+      m_Hash(common::Hash(desc.Code, desc.Size)),
+      m_Code(static_cast<const char *>(desc.Code), static_cast<const char *>(desc.Code) + desc.Size)
+{
+    m_Handle = CreateShader(nullptr, 0);
+
+    GLint compile_status;
+    glGetShaderiv(m_Handle, GL_COMPILE_STATUS, &compile_status);
+    if (compile_status != GL_TRUE)
+    {
+        GLsizei log_length;
+        GLchar message[1024];
+        glGetShaderInfoLog(m_Handle, 1024, &log_length, message);
+        message[log_length] = 0;
+
+        common::Fatal("failed to specialize shader: {}", message);
+    }
+}
+
+glal::opengl::ShaderModuleT::~ShaderModuleT()
+{
+    glDeleteShader(m_Handle);
+}
+
+glal::ShaderStage glal::opengl::ShaderModuleT::GetStage() const
+{
+    return m_Stage;
+}
+
+GLuint glal::opengl::ShaderModuleT::CreateShader(
+    const SpecializationConstant *constants,
+    const std::uint32_t constant_count) const
 {
     GLenum type;
     switch (m_Stage)
@@ -30,22 +62,26 @@ glal::opengl::ShaderModuleT::ShaderModuleT(DeviceT *device, const ShaderModuleDe
         common::Fatal("stage not supported");
     }
 
-    m_Handle = glCreateShader(type);
-    glShaderBinary(1, &m_Handle, GL_SHADER_BINARY_FORMAT_SPIR_V, desc.Code, static_cast<GLsizei>(desc.Size));
-    glSpecializeShader(m_Handle, "main", 0, nullptr, nullptr);
-}
+    std::vector<GLuint> indices(constant_count);
+    std::vector<GLuint> values(constant_count);
+    for (std::uint32_t i = 0; i < constant_count; ++i)
+    {
+        indices[i] = constants[i].Id;
+        values[i] = constants[i].Value;
+    }
 
-glal::opengl::ShaderModuleT::~ShaderModuleT()
-{
-    glDeleteShader(m_Handle);
+    const auto shader = glCreateShader(type);
+    glShaderBinary(1, &shader, GL_SHADER_BINARY_FORMAT_SPIR_V, m_Code.data(), static_cast<GLsizei>(m_Code.size()));
+    glSpecializeShader(shader, "main", constant_count, indices.data(), values.data());
+    return shader;
 }
 
-glal::ShaderStage glal::opengl::ShaderModuleT::GetStage() const
+GLuint glal::opengl::ShaderModuleT::GetHandle() const
 {
-    return m_Stage;
+    return m_Handle;
 }
 
-GLuint glal::opengl::ShaderModuleT::GetHandle() const
+std::uint64_t glal::opengl::ShaderModuleT::GetHash() const
 {
-    return m_Handle;
+    return m_Hash;
 }
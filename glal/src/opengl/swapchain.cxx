@@ -30,7 +30,6 @@ glal::opengl::SwapchainT::SwapchainT(DeviceT *device, const SwapchainDesc &desc)
         m_Frames[i] = {
             .ImageRef = dynamic_cast<ImageT *>(image),
             .ImageViewRef = dynamic_cast<ImageViewT *>(image_view),
-            .FenceRef = nullptr,
         };
     }
 }
@@ -59,19 +58,26 @@ glal::ImageView glal::opengl::SwapchainT::GetImageView(const std::uint32_t index
     return m_Frames.at(index).ImageViewRef;
 }
 
-std::uint32_t glal::opengl::SwapchainT::AcquireNextImage(Fence fence)
+std::uint32_t glal::opengl::SwapchainT::AcquireNextImage(Semaphore semaphore, Fence fence)
 {
     m_FrameIndex = (m_FrameIndex + 1) % m_FrameCount;
 
-    if (const auto in_flight = m_Frames.at(m_FrameIndex).FenceRef)
-        in_flight->Wait();
+    // the images are only ever touched by the graphics context, which executes in order. so an image is available
+    // right away, limiting the frames in flight is up to the caller
+    if (const auto semaphore_impl = dynamic_cast<SemaphoreT *>(semaphore))
+        semaphore_impl->Enqueue(nullptr, semaphore_impl->ResolveSignalValue(0));
+    if (const auto fence_impl = dynamic_cast<FenceT *>(fence))
+        fence_impl->Signal();
 
-    m_Frames.at(m_FrameIndex).FenceRef = dynamic_cast<FenceT *>(fence);
     return m_FrameIndex;
 }
 
 void glal::opengl::SwapchainT::Present() const
 {
+    // offscreen images are read by the application, there is nothing to show
+    if (!m_NativeWindowHandle)
+        return;
+
     const auto image = m_Frames.at(m_FrameIndex).ImageRef;
 
     GLuint framebuffer;
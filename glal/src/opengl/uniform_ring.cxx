@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <cstring>
+#include <common/log.hxx>
+#include <glal/opengl.hxx>
+
+static constexpr GLuint64 sync_timeout = 1'000'000'000; // 1 second
+
+glal::opengl::UniformRing::UniformRing(const std::size_t size, const std::uint32_t segment_count)
+    : m_Handle(),
+      m_Mapping(),
+      m_Head(0),
+      m_Segment(0),
+      m_Fences(segment_count)
+{
+    GLint alignment;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    m_Alignment = std::max<std::size_t>(alignment, 1);
+
+    // every segment starts on a bindable offset
+    m_SegmentSize = size / segment_count / m_Alignment * m_Alignment;
+    common::Assert(m_SegmentSize, "uniform ring of {} bytes is too small for {} segments", size, segment_count);
+
+    constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    const auto ring_size = static_cast<GLsizeiptr>(m_SegmentSize * segment_count);
+
+    glCreateBuffers(1, &m_Handle);
+    glNamedBufferStorage(m_Handle, ring_size, nullptr, flags);
+    m_Mapping = static_cast<std::byte *>(glMapNamedBufferRange(m_Handle, 0, ring_size, flags));
+}
+
+glal::opengl::UniformRing::~UniformRing()
+{
+    for (const auto fence : m_Fences)
+        if (fence)
+            glDeleteSync(fence);
+
+    glUnmapNamedBuffer(m_Handle);
+    glDeleteBuffers(1, &m_Handle);
+}
+
+std::size_t glal::opengl::UniformRing::Push(const void *data, const std::size_t size)
+{
+    common::Assert(size <= m_SegmentSize, "{} bytes do not fit into a uniform ring segment", size);
+
+    auto offset = (m_Head + m_Alignment - 1) / m_Alignment * m_Alignment;
+
+    if (offset + size > (m_Segment + 1) * m_SegmentSize)
+    {
+        // every draw reading the segment was issued before this push, so the fence covers all of them
+        m_Fences[m_Segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_Segment = (m_Segment + 1) % m_Fences.size();
+
+        if (auto &fence = m_Fences[m_Segment])
+        {
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, sync_timeout) == GL_TIMEOUT_EXPIRED)
+            {
+            }
+
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        offset = m_Segment * m_SegmentSize;
+    }
+
+    std::memcpy(m_Mapping + offset, data, size);
+    m_Head = offset + size;
+    return offset;
+}
+
+GLuint glal::opengl::UniformRing::GetHandle() const
+{
+    return m_Handle;
+}
@@ -0,0 +1,693 @@
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <common/log.hxx>
+#include <glal/reflect.hxx>
+
+static constexpr std::uint32_t spirv_magic = 0x07230203;
+
+static constexpr std::uint32_t op_name = 5;
+static constexpr std::uint32_t op_member_name = 6;
+static constexpr std::uint32_t op_type_bool = 20;
+static constexpr std::uint32_t op_type_int = 21;
+static constexpr std::uint32_t op_type_float = 22;
+static constexpr std::uint32_t op_type_vector = 23;
+static constexpr std::uint32_t op_type_matrix = 24;
+static constexpr std::uint32_t op_type_image = 25;
+static constexpr std::uint32_t op_type_sampler = 26;
+static constexpr std::uint32_t op_type_sampled_image = 27;
+static constexpr std::uint32_t op_type_array = 28;
+static constexpr std::uint32_t op_type_runtime_array = 29;
+static constexpr std::uint32_t op_type_struct = 30;
+static constexpr std::uint32_t op_type_pointer = 32;
+static constexpr std::uint32_t op_constant = 43;
+static constexpr std::uint32_t op_variable = 59;
+static constexpr std::uint32_t op_decorate = 71;
+static constexpr std::uint32_t op_member_decorate = 72;
+
+static constexpr std::uint32_t decoration_spec_id = 1;
+static constexpr std::uint32_t decoration_block = 2;
+static constexpr std::uint32_t decoration_buffer_block = 3;
+static constexpr std::uint32_t decoration_row_major = 4;
+static constexpr std::uint32_t decoration_array_stride = 6;
+static constexpr std::uint32_t decoration_matrix_stride = 7;
+static constexpr std::uint32_t decoration_built_in = 11;
+static constexpr std::uint32_t decoration_location = 30;
+static constexpr std::uint32_t decoration_binding = 33;
+static constexpr std::uint32_t decoration_descriptor_set = 34;
+static constexpr std::uint32_t decoration_offset = 35;
+
+static constexpr std::uint32_t storage_class_uniform_constant = 0;
+static constexpr std::uint32_t storage_class_input = 1;
+static constexpr std::uint32_t storage_class_uniform = 2;
+static constexpr std::uint32_t storage_class_push_constant = 9;
+static constexpr std::uint32_t storage_class_storage_buffer = 12;
+
+static constexpr std::uint32_t image_sampled_storage = 2;
+
+struct spirv_member_t
+{
+    std::string name;
+    std::uint32_t offset = 0;
+    std::uint32_t matrix_stride = 0;
+    bool row_major = false;
+    bool built_in = false;
+};
+
+/**
+ * spirv_id_t - everything the reflection needs to know about a single result id
+ */
+struct spirv_id_t
+{
+    std::uint32_t opcode = 0;
+    std::vector<std::uint32_t> operands;
+
+    std::string name;
+    std::vector<spirv_member_t> members;
+
+    std::uint32_t set = 0;
+    std::uint32_t binding = 0;
+    std::uint32_t location = ~0u;
+    std::uint32_t spec_id = ~0u;
+    std::uint32_t array_stride = 0;
+    bool block = false;
+    bool buffer_block = false;
+    bool built_in = false;
+};
+
+class spirv_module_t
+{
+public:
+    explicit spirv_module_t(const glal::ShaderModuleDesc &desc)
+    {
+        common::Assert(
+            desc.Size % 4 == 0 && desc.Size >= 20,
+            "shader module code of size {} is not valid spir-v",
+            desc.Size);
+
+        std::vector<std::uint32_t> words(desc.Size / 4);
+        std::memcpy(words.data(), desc.Code, desc.Size);
+
+        common::Assert(words[0] == spirv_magic, "shader module code is not spir-v");
+
+        m_Ids.resize(words[3]);
+
+        for (std::size_t i = 5; i < words.size();)
+        {
+            const auto opcode = words[i] & 0xffff;
+            const auto count = words[i] >> 16;
+            common::Assert(count && i + count <= words.size(), "truncated spir-v instruction at word {}", i);
+
+            Parse(opcode, words.data() + i, count);
+            i += count;
+        }
+    }
+
+    [[nodiscard]] const spirv_id_t &operator[](const std::uint32_t id) const
+    {
+        common::Assert(id < m_Ids.size(), "spir-v id {} is out of bounds", id);
+        return m_Ids[id];
+    }
+
+    [[nodiscard]] std::uint32_t GetIdCount() const
+    {
+        return static_cast<std::uint32_t>(m_Ids.size());
+    }
+
+private:
+    static std::string ReadString(const std::uint32_t *words, const std::uint32_t count)
+    {
+        const auto data = reinterpret_cast<const char *>(words);
+        return { data, std::find(data, data + count * 4, '\0') };
+    }
+
+    spirv_id_t &At(const std::uint32_t id)
+    {
+        common::Assert(id < m_Ids.size(), "spir-v id {} is out of bounds", id);
+        return m_Ids[id];
+    }
+
+    spirv_member_t &AtMember(const std::uint32_t id, const std::uint32_t member)
+    {
+        auto &members = At(id).members;
+        if (members.size() <= member)
+            members.resize(member + 1);
+        return members[member];
+    }
+
+    void Parse(const std::uint32_t opcode, const std::uint32_t *words, const std::uint32_t count)
+    {
+        switch (opcode)
+        {
+        case op_name:
+            At(words[1]).name = ReadString(words + 2, count - 2);
+            break;
+
+        case op_member_name:
+            AtMember(words[1], words[2]).name = ReadString(words + 3, count - 3);
+            break;
+
+        case op_decorate:
+        {
+            auto &id = At(words[1]);
+            const auto literal = count > 3 ? words[3] : 0;
+            switch (words[2])
+            {
+            case decoration_spec_id:
+                id.spec_id = literal;
+                break;
+            case decoration_block:
+                id.block = true;
+                break;
+            case decoration_buffer_block:
+                id.buffer_block = true;
+                break;
+            case decoration_array_stride:
+                id.array_stride = literal;
+                break;
+            case decoration_built_in:
+                id.built_in = true;
+                break;
+            case decoration_location:
+                id.location = literal;
+                break;
+            case decoration_binding:
+                id.binding = literal;
+                break;
+            case decoration_descriptor_set:
+                id.set = literal;
+                break;
+            default:
+                break;
+            }
+            break;
+        }
+
+        case op_member_decorate:
+        {
+            auto &member = AtMember(words[1], words[2]);
+            const auto literal = count > 4 ? words[4] : 0;
+            switch (words[3])
+            {
+            case decoration_row_major:
+                member.row_major = true;
+                break;
+            case decoration_matrix_stride:
+                member.matrix_stride = literal;
+                break;
+            case decoration_built_in:
+                member.built_in = true;
+                break;
+            case decoration_offset:
+                member.offset = literal;
+                break;
+            default:
+                break;
+            }
+            break;
+        }
+
+        case op_type_bool:
+        case op_type_int:
+        case op_type_float:
+        case op_type_vector:
+        case op_type_matrix:
+        case op_type_image:
+        case op_type_sampler:
+        case op_type_sampled_image:
+        case op_type_array:
+        case op_type_runtime_array:
+        case op_type_struct:
+        case op_type_pointer:
+        {
+            auto &id = At(words[1]);
+            id.opcode = opcode;
+            id.operands.assign(words + 2, words + count);
+            break;
+        }
+
+        // constants and variables carry their type before the result id
+        case op_constant:
+        case op_variable:
+        {
+            auto &id = At(words[2]);
+            id.opcode = opcode;
+            id.operands.assign(words + 1, words + count);
+            id.operands.erase(id.operands.begin() + 1);
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    std::vector<spirv_id_t> m_Ids;
+};
+
+static void translate_scalar(const spirv_id_t &type, glal::DataType *data_type, std::uint32_t *size)
+{
+    auto width = 32u;
+    auto result = glal::DataType_UInt32;
+
+    switch (type.opcode)
+    {
+    case op_type_bool:
+        break;
+
+    case op_type_int:
+        width = type.operands[0];
+        switch (width)
+        {
+        case 8:
+            result = type.operands[1] ? glal::DataType_Int8 : glal::DataType_UInt8;
+            break;
+        case 16:
+            result = type.operands[1] ? glal::DataType_Int16 : glal::DataType_UInt16;
+            break;
+        default:
+            result = type.operands[1] ? glal::DataType_Int32 : glal::DataType_UInt32;
+            break;
+        }
+        break;
+
+    case op_type_float:
+        width = type.operands[0];
+        switch (width)
+        {
+        case 16:
+            result = glal::DataType_Half;
+            break;
+        case 64:
+            result = glal::DataType_Double;
+            break;
+        default:
+            result = glal::DataType_Float;
+            break;
+        }
+        break;
+
+    default:
+        common::Fatal("spir-v opcode {} is not a scalar type", type.opcode);
+    }
+
+    data_type && ((*data_type = result));
+    size && ((*size = width / 8));
+}
+
+static std::uint32_t get_constant(const spirv_module_t &module, const std::uint32_t id)
+{
+    const auto &constant = module[id];
+    common::Assert(constant.opcode == op_constant, "spir-v id {} is not a constant", id);
+    return constant.operands[1];
+}
+
+static std::uint32_t get_type_size(
+    const spirv_module_t &module,
+    const std::uint32_t type_id,
+    const std::uint32_t matrix_stride,
+    const bool row_major)
+{
+    const auto &type = module[type_id];
+    switch (type.opcode)
+    {
+    case op_type_bool:
+    case op_type_int:
+    case op_type_float:
+    {
+        std::uint32_t size;
+        translate_scalar(type, nullptr, &size);
+        return size;
+    }
+
+    case op_type_vector:
+        return type.operands[1] * get_type_size(module, type.operands[0], 0, false);
+
+    case op_type_matrix:
+    {
+        const auto columns = type.operands[1];
+        const auto rows = module[type.operands[0]].operands[1];
+        if (!matrix_stride)
+            return columns * get_type_size(module, type.operands[0], 0, false);
+        return (row_major ? rows : columns) * matrix_stride;
+    }
+
+    case op_type_array:
+    {
+        const auto length = get_constant(module, type.operands[1]);
+        if (type.array_stride)
+            return length * type.array_stride;
+        return length * get_type_size(module, type.operands[0], matrix_stride, row_major);
+    }
+
+    case op_type_runtime_array:
+        return 0;
+
+    case op_type_struct:
+    {
+        std::uint32_t size = 0;
+        for (std::uint32_t i = 0; i < type.operands.size(); ++i)
+        {
+            const auto &member = i < type.members.size() ? type.members[i] : spirv_member_t{};
+            size = std::max(
+                size,
+                member.offset + get_type_size(module, type.operands[i], member.matrix_stride, member.row_major));
+        }
+        return size;
+    }
+
+    default:
+        return 0;
+    }
+}
+
+static glal::BlockLayout get_block_layout(const spirv_module_t &module, const std::uint32_t type_id)
+{
+    const auto &type = module[type_id];
+    common::Assert(type.opcode == op_type_struct, "spir-v id {} is not a block", type_id);
+
+    glal::BlockLayout layout
+    {
+        .Name = type.name,
+        .Size = get_type_size(module, type_id, 0, false),
+        .Members = {},
+    };
+
+    for (std::uint32_t i = 0; i < type.operands.size(); ++i)
+    {
+        const auto &member = i < type.members.size() ? type.members[i] : spirv_member_t{};
+
+        glal::BlockMember block_member
+        {
+            .Name = member.name,
+            .Offset = member.offset,
+            .Size = get_type_size(module, type.operands[i], member.matrix_stride, member.row_major),
+            .Type = glal::DataType_None,
+            .Count = 0,
+            .MatrixStride = member.matrix_stride,
+            .ArrayCount = 1,
+            .ArrayStride = 0,
+        };
+
+        // peel arrays first, nested arrays are flattened into a single count
+        auto element = type.operands[i];
+        for (auto outer = true;; outer = false)
+        {
+            const auto &element_type = module[element];
+            if (element_type.opcode == op_type_array)
+                block_member.ArrayCount *= get_constant(module, element_type.operands[1]);
+            else if (element_type.opcode == op_type_runtime_array)
+                block_member.ArrayCount = 0;
+            else
+                break;
+
+            if (outer)
+                block_member.ArrayStride = element_type.array_stride;
+            element = element_type.operands[0];
+        }
+
+        block_member.Count = 1;
+        for (auto element_type = &module[element];; element_type = &module[element_type->operands[0]])
+        {
+            if (element_type->opcode == op_type_matrix || element_type->opcode == op_type_vector)
+            {
+                block_member.Count *= element_type->operands[1];
+                continue;
+            }
+            if (element_type->opcode != op_type_struct)
+                translate_scalar(*element_type, &block_member.Type, nullptr);
+            break;
+        }
+
+        layout.Members.push_back(std::move(block_member));
+    }
+
+    return layout;
+}
+
+static void reflect_descriptor(
+    const spirv_module_t &module,
+    const spirv_id_t &variable,
+    const std::uint32_t storage_class,
+    const glal::ShaderStage stage,
+    glal::ShaderReflection &reflection)
+{
+    auto type_id = module[variable.operands[0]].operands[1];
+
+    // arrays of descriptors, a runtime array is reported with a count of zero
+    auto count = 1u;
+    if (const auto &type = module[type_id]; type.opcode == op_type_array)
+    {
+        count = get_constant(module, type.operands[1]);
+        type_id = type.operands[0];
+    }
+    else if (type.opcode == op_type_runtime_array)
+    {
+        count = 0;
+        type_id = type.operands[0];
+    }
+
+    const auto &type = module[type_id];
+
+    glal::DescriptorType descriptor_type;
+    switch (type.opcode)
+    {
+    case op_type_struct:
+        descriptor_type = storage_class == storage_class_storage_buffer || type.buffer_block
+                              ? glal::DescriptorType_StorageBuffer
+                              : glal::DescriptorType_UniformBuffer;
+        break;
+    case op_type_sampled_image:
+        descriptor_type = glal::DescriptorType_CombinedImageSampler;
+        break;
+    case op_type_image:
+        descriptor_type = type.operands[5] == image_sampled_storage
+                              ? glal::DescriptorType_StorageImage
+                              : glal::DescriptorType_SampledImage;
+        break;
+    case op_type_sampler:
+        descriptor_type = glal::DescriptorType_Sampler;
+        break;
+    default:
+        common::Log(common::LogLevel_Warning, "unsupported descriptor type for variable '{}'", variable.name);
+        return;
+    }
+
+    reflection.Bindings.push_back(
+        {
+            .Name = variable.name.empty() ? type.name : variable.name,
+            .Set = variable.set,
+            .Binding = {
+                .Binding = variable.binding,
+                .Type = descriptor_type,
+                .Count = count,
+                .Stages = stage,
+                .Flags = glal::DescriptorBindingFlag_None,
+            },
+            .Block = type.opcode == op_type_struct ? get_block_layout(module, type_id) : glal::BlockLayout{},
+        });
+}
+
+static void reflect_input(
+    const spirv_module_t &module,
+    const spirv_id_t &variable,
+    glal::ShaderReflection &reflection)
+{
+    // built-ins and interface blocks do not take part in the vertex input
+    if (variable.built_in || variable.location == ~0u)
+        return;
+
+    const auto &type = module[module[variable.operands[0]].operands[1]];
+
+    auto columns = 1u;
+    auto count = 1u;
+    auto scalar = &type;
+
+    if (type.opcode == op_type_matrix)
+    {
+        columns = type.operands[1];
+        scalar = &module[type.operands[0]];
+    }
+    if (scalar->opcode == op_type_vector)
+    {
+        count = scalar->operands[1];
+        scalar = &module[scalar->operands[0]];
+    }
+    if (scalar->opcode != op_type_bool && scalar->opcode != op_type_int && scalar->opcode != op_type_float)
+        return;
+
+    glal::DataType data_type;
+    translate_scalar(*scalar, &data_type, nullptr);
+
+    for (std::uint32_t i = 0; i < columns; ++i)
+        reflection.Inputs.push_back(
+            {
+                .Name = variable.name,
+                .Location = variable.location + i,
+                .Type = data_type,
+                .Count = count,
+            });
+}
+
+static std::uint32_t get_data_type_size(const glal::DataType data_type)
+{
+    switch (data_type)
+    {
+    case glal::DataType_UInt8:
+    case glal::DataType_Int8:
+        return 1;
+    case glal::DataType_UInt16:
+    case glal::DataType_Int16:
+    case glal::DataType_Half:
+        return 2;
+    case glal::DataType_UInt32:
+    case glal::DataType_Int32:
+    case glal::DataType_Float:
+    case glal::DataType_Fixed:
+        return 4;
+    case glal::DataType_Double:
+        return 8;
+    default:
+        common::Fatal("data type {} has no size", static_cast<int>(data_type));
+    }
+}
+
+const glal::BlockMember *glal::BlockLayout::FindMember(const std::string_view name) const
+{
+    for (auto &member : Members)
+        if (member.Name == name)
+            return &member;
+    return nullptr;
+}
+
+const glal::ReflectedBinding *glal::ShaderReflection::FindBinding(const std::string_view name) const
+{
+    for (auto &binding : Bindings)
+        if (binding.Name == name || binding.Block.Name == name)
+            return &binding;
+    return nullptr;
+}
+
+const glal::ReflectedSpecializationConstant *glal::ShaderReflection::FindSpecializationConstant(
+    const std::uint32_t id) const
+{
+    for (auto &constant : SpecializationConstants)
+        if (constant.Id == id)
+            return &constant;
+    return nullptr;
+}
+
+glal::ShaderReflection glal::Reflect(const ShaderModuleDesc &desc)
+{
+    const spirv_module_t module(desc);
+
+    ShaderReflection reflection
+    {
+        .Stage = desc.Stage,
+        .Bindings = {},
+        .Inputs = {},
+        .SpecializationConstants = {},
+        .PushConstantRanges = {},
+        .PushConstantBlock = {},
+    };
+
+    for (std::uint32_t id = 0; id < module.GetIdCount(); ++id)
+    {
+        const auto &variable = module[id];
+
+        // only the decoration matters, the default value is left to the shader
+        if (variable.spec_id != ~0u)
+            reflection.SpecializationConstants.push_back({ .Name = variable.name, .Id = variable.spec_id });
+
+        if (variable.opcode != op_variable)
+            continue;
+
+        switch (const auto storage_class = variable.operands[1])
+        {
+        case storage_class_uniform_constant:
+        case storage_class_uniform:
+        case storage_class_storage_buffer:
+            reflect_descriptor(module, variable, storage_class, desc.Stage, reflection);
+            break;
+
+        case storage_class_input:
+            reflect_input(module, variable, reflection);
+            break;
+
+        case storage_class_push_constant:
+        {
+            reflection.PushConstantBlock = get_block_layout(module, module[variable.operands[0]].operands[1]);
+
+            // a stage only sees the members it declares, the range starts at the first of them
+            auto offset = reflection.PushConstantBlock.Size;
+            for (auto &member : reflection.PushConstantBlock.Members)
+                offset = std::min(offset, member.Offset);
+
+            reflection.PushConstantRanges.push_back(
+                {
+                    .Offset = offset,
+                    .Size = reflection.PushConstantBlock.Size - offset,
+                    .Stages = desc.Stage,
+                });
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    std::sort(
+        reflection.Bindings.begin(),
+        reflection.Bindings.end(),
+        [](const ReflectedBinding &a, const ReflectedBinding &b)
+        {
+            return a.Set != b.Set ? a.Set < b.Set : a.Binding.Binding < b.Binding.Binding;
+        });
+
+    std::sort(
+        reflection.Inputs.begin(),
+        reflection.Inputs.end(),
+        [](const ReflectedInput &a, const ReflectedInput &b)
+        {
+            return a.Location < b.Location;
+        });
+
+    std::sort(
+        reflection.SpecializationConstants.begin(),
+        reflection.SpecializationConstants.end(),
+        [](const ReflectedSpecializationConstant &a, const ReflectedSpecializationConstant &b)
+        {
+            return a.Id < b.Id;
+        });
+
+    return reflection;
+}
+
+glal::VertexBinding glal::DeriveVertexInput(
+    const ShaderReflection &reflection,
+    const std::uint32_t binding,
+    std::vector<VertexAttribute> &attributes)
+{
+    common::Assert(reflection.Stage == ShaderStage_Vertex, "vertex input can only be derived from a vertex shader");
+
+    std::uint32_t stride = 0;
+    for (auto &input : reflection.Inputs)
+    {
+        attributes.push_back(
+            {
+                .Binding = binding,
+                .Location = input.Location,
+                .Type = input.Type,
+                .Count = input.Count,
+                .Offset = stride,
+            });
+        stride += input.Count * get_data_type_size(input.Type);
+    }
+
+    return {
+        .Binding = binding,
+        .Stride = stride,
+        .Instance = false,
+    };
+}
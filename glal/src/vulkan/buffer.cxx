@@ -1,19 +1,6 @@
 #include <common/log.hxx>
 #include <glal/vulkan.hxx>
 
-static std::uint32_t find_memory_type_index(
-    const VkPhysicalDeviceMemoryProperties &memory_properties,
-    const std::uint32_t type_bits,
-    const VkMemoryPropertyFlags property_flags)
-{
-    for (std::uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i)
-        if ((type_bits & (1 << i))
-            && (memory_properties.memoryTypes[i].propertyFlags & property_flags) == property_flags)
-            return i;
-
-    common::Fatal("unsupported memory requirements");
-}
-
 glal::vulkan::BufferT::BufferT(DeviceT *device, const BufferDesc &desc)
     : m_Device(device),
       m_Size(desc.Size),
@@ -36,8 +23,22 @@ glal::vulkan::BufferT::BufferT(DeviceT *device, const BufferDesc &desc)
     case BufferUsage_Storage:
         usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
         break;
+    case BufferUsage_Indirect:
+        usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+        break;
+    case BufferUsage_Staging:
+        usage = desc.Memory == MemoryUsage_DeviceToHost
+                    ? VK_BUFFER_USAGE_TRANSFER_DST_BIT
+                    : VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        break;
     }
 
+    // everything but staging memory may be filled through uploads
+    if (m_Usage != BufferUsage_Staging)
+        usage |= VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+    auto &queue_families = m_Device->GetSharingQueueFamilies();
+
     VkMemoryPropertyFlags memory_property_flags{};
     switch (desc.Memory)
     {
@@ -45,10 +46,11 @@ glal::vulkan::BufferT::BufferT(DeviceT *device, const BufferDesc &desc)
         memory_property_flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
         break;
     case MemoryUsage_HostToDevice:
-        memory_property_flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        // buffers stay mapped while the cpu writes them, nothing flushes the written ranges
+        memory_property_flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
         break;
     case MemoryUsage_DeviceToHost:
-        memory_property_flags = VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        memory_property_flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
         break;
     }
 
@@ -57,28 +59,26 @@ glal::vulkan::BufferT::BufferT(DeviceT *device, const BufferDesc &desc)
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
         .size = m_Size,
         .usage = usage,
-        .sharingMode = VK_SHARING_MODE_CONCURRENT,
-        .queueFamilyIndexCount = 0,
-        .pQueueFamilyIndices = nullptr,
+        .sharingMode = queue_families.size() > 1 ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = static_cast<std::uint32_t>(queue_families.size()),
+        .pQueueFamilyIndices = queue_families.data(),
     };
     vkCreateBuffer(device->GetHandle(), &buffer_create_info, nullptr, &m_Handle);
 
     VkMemoryRequirements memory_requirements;
     vkGetBufferMemoryRequirements(m_Device->GetHandle(), m_Handle, &memory_requirements);
 
-    VkPhysicalDeviceMemoryProperties memory_properties;
-    vkGetPhysicalDeviceMemoryProperties(device->GetPhysicalDevice()->GetHandle(), &memory_properties);
-
     const VkMemoryAllocateInfo memory_allocate_info
     {
         .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
         .allocationSize = memory_requirements.size,
-        .memoryTypeIndex = find_memory_type_index(
-            memory_properties,
+        .memoryTypeIndex = FindMemoryTypeIndex(
+            m_Device->GetPhysicalDevice()->GetHandle(),
             memory_requirements.memoryTypeBits,
             memory_property_flags),
     };
     vkAllocateMemory(device->GetHandle(), &memory_allocate_info, nullptr, &m_MemoryHandle);
+    vkBindBufferMemory(device->GetHandle(), m_Handle, m_MemoryHandle, 0);
 }
 
 std::size_t glal::vulkan::BufferT::GetSize() const
@@ -107,3 +107,8 @@ VkBuffer glal::vulkan::BufferT::GetHandle() const
 {
     return m_Handle;
 }
+
+glal::vulkan::ResourceAccess &glal::vulkan::BufferT::GetAccess()
+{
+    return m_Access;
+}
@@ -1,16 +1,34 @@
+#include <algorithm>
 #include <cstring>
+#include <common/log.hxx>
+#include <common/profile.hxx>
 #include <glal/vulkan.hxx>
 
-glal::vulkan::CommandBufferT::CommandBufferT(DeviceT *device, CommandBufferUsage usage)
+static bool writes(const VkAccessFlags access)
+{
+    return access & (VK_ACCESS_SHADER_WRITE_BIT
+                     | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+                     | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+                     | VK_ACCESS_TRANSFER_WRITE_BIT
+                     | VK_ACCESS_HOST_WRITE_BIT
+                     | VK_ACCESS_MEMORY_WRITE_BIT);
+}
+
+glal::vulkan::CommandBufferT::CommandBufferT(
+    DeviceT *device,
+    CommandBufferUsage usage,
+    const QueueType queue_type)
     : m_Device(device),
       m_PoolHandle(),
-      m_Handle()
+      m_Handle(),
+      m_Pipeline(nullptr)
 {
-    // TODO: queue family
+    const auto queue_impl = dynamic_cast<QueueT *>(m_Device->GetQueue(queue_type));
+
     const VkCommandPoolCreateInfo command_pool_create_info
     {
         .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-        .queueFamilyIndex = 0,
+        .queueFamilyIndex = queue_impl->GetFamilyIndex(),
     };
     vkCreateCommandPool(m_Device->GetHandle(), &command_pool_create_info, nullptr, &m_PoolHandle);
 
@@ -32,6 +50,8 @@ glal::vulkan::CommandBufferT::~CommandBufferT()
 
 void glal::vulkan::CommandBufferT::Begin()
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::Begin");
+
     const VkCommandBufferBeginInfo command_buffer_begin_info
     {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
@@ -42,11 +62,17 @@ void glal::vulkan::CommandBufferT::Begin()
 
 void glal::vulkan::CommandBufferT::End()
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::End");
+
     vkEndCommandBuffer(m_Handle);
+
+    m_Pipeline = nullptr;
 }
 
 void glal::vulkan::CommandBufferT::BeginRenderPass(RenderPass render_pass, Framebuffer framebuffer)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::BeginRenderPass");
+
     const auto render_pass_impl = dynamic_cast<RenderPassT *>(render_pass);
     const auto framebuffer_impl = dynamic_cast<FramebufferT *>(framebuffer);
 
@@ -80,6 +106,8 @@ void glal::vulkan::CommandBufferT::BeginRenderPass(RenderPass render_pass, Frame
 
 void glal::vulkan::CommandBufferT::EndRenderPass()
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::EndRenderPass");
+
     vkCmdEndRenderPass(m_Handle);
 }
 
@@ -91,6 +119,8 @@ void glal::vulkan::CommandBufferT::SetViewport(
     const float min_depth,
     const float max_depth)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::SetViewport");
+
     const VkViewport viewport
     {
         .x = x,
@@ -109,6 +139,8 @@ void glal::vulkan::CommandBufferT::SetScissor(
     const std::uint32_t width,
     const std::uint32_t height)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::SetScissor");
+
     const VkRect2D scissor
     {
         .offset = { x, y },
@@ -119,50 +151,407 @@ void glal::vulkan::CommandBufferT::SetScissor(
 
 void glal::vulkan::CommandBufferT::BindPipeline(Pipeline pipeline)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::BindPipeline");
+
     auto pipeline_impl = dynamic_cast<PipelineT *>(pipeline);
+    common::Assert(
+        pipeline_impl->GetStatus() == PipelineStatus_Ready,
+        "pipeline {} is not ready",
+        static_cast<const void *>(pipeline));
+
     vkCmdBindPipeline(m_Handle, ToVkPipelineBindPoint(pipeline_impl->GetType()), pipeline_impl->GetHandle());
+
+    m_Pipeline = pipeline_impl;
 }
 
-void glal::vulkan::CommandBufferT::BindVertexBuffer(Buffer buffer, std::uint32_t binding, std::size_t offset)
+void glal::vulkan::CommandBufferT::BindVertexBuffer(
+    Buffer buffer,
+    const std::uint32_t binding,
+    const std::size_t offset)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::BindVertexBuffer");
+
+    const auto buffer_impl = dynamic_cast<BufferT *>(buffer);
+
+    const auto buffer_handle = buffer_impl->GetHandle();
+    const VkDeviceSize buffer_offset = offset;
+    vkCmdBindVertexBuffers(m_Handle, binding, 1, &buffer_handle, &buffer_offset);
 }
 
-void glal::vulkan::CommandBufferT::BindIndexBuffer(Buffer buffer, DataType type)
+void glal::vulkan::CommandBufferT::BindIndexBuffer(Buffer buffer, const DataType type)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::BindIndexBuffer");
+
+    const auto buffer_impl = dynamic_cast<BufferT *>(buffer);
+    vkCmdBindIndexBuffer(m_Handle, buffer_impl->GetHandle(), 0, ToVkIndexType(type));
 }
 
 void glal::vulkan::CommandBufferT::BindDescriptorSets(
-    std::uint32_t first_set,
-    std::uint32_t set_count,
-    const DescriptorSet *descriptor_sets)
+    const std::uint32_t first_set,
+    const std::uint32_t set_count,
+    const DescriptorSet *descriptor_sets,
+    const std::uint32_t dynamic_offset_count,
+    const std::uint32_t *dynamic_offsets)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::BindDescriptorSets");
+
+    common::Assert(m_Pipeline, "pipeline not set");
+
+    std::vector<VkDescriptorSet> descriptor_set_handles(set_count);
+    for (std::uint32_t i = 0; i < set_count; ++i)
+        descriptor_set_handles[i] = dynamic_cast<DescriptorSetT *>(descriptor_sets[i])->GetHandle();
+
+    vkCmdBindDescriptorSets(
+        m_Handle,
+        ToVkPipelineBindPoint(m_Pipeline->GetType()),
+        m_Pipeline->GetLayout()->GetHandle(),
+        first_set,
+        set_count,
+        descriptor_set_handles.data(),
+        dynamic_offset_count,
+        dynamic_offsets);
+}
+
+void glal::vulkan::CommandBufferT::PushConstants(
+    const ShaderStage stages,
+    const std::uint32_t offset,
+    const std::uint32_t size,
+    const void *data)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::PushConstants");
+
+    common::Assert(m_Pipeline, "pipeline not set");
+
+    vkCmdPushConstants(
+        m_Handle,
+        m_Pipeline->GetLayout()->GetHandle(),
+        ToVkShaderStageFlags(stages),
+        offset,
+        size,
+        data);
 }
 
-void glal::vulkan::CommandBufferT::Draw(std::uint32_t vertex_count, std::uint32_t first_vertex)
+void glal::vulkan::CommandBufferT::Draw(const std::uint32_t vertex_count, const std::uint32_t first_vertex)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::Draw");
+
+    vkCmdDraw(m_Handle, vertex_count, 1, first_vertex, 0);
 }
 
-void glal::vulkan::CommandBufferT::DrawIndexed(std::uint32_t index_count, std::uint32_t first_index)
+void glal::vulkan::CommandBufferT::DrawIndexed(const std::uint32_t index_count, const std::uint32_t first_index)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::DrawIndexed");
+
+    vkCmdDrawIndexed(m_Handle, index_count, 1, first_index, 0, 0);
 }
 
-void glal::vulkan::CommandBufferT::Dispatch(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+void glal::vulkan::CommandBufferT::DrawInstanced(
+    const std::uint32_t vertex_count,
+    const std::uint32_t instance_count,
+    const std::uint32_t first_vertex,
+    const std::uint32_t first_instance)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::DrawInstanced");
+
+    vkCmdDraw(m_Handle, vertex_count, instance_count, first_vertex, first_instance);
+}
+
+void glal::vulkan::CommandBufferT::DrawIndexedInstanced(
+    const std::uint32_t index_count,
+    const std::uint32_t instance_count,
+    const std::uint32_t first_index,
+    const std::int32_t vertex_offset,
+    const std::uint32_t first_instance)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::DrawIndexedInstanced");
+
+    vkCmdDrawIndexed(m_Handle, index_count, instance_count, first_index, vertex_offset, first_instance);
+}
+
+void glal::vulkan::CommandBufferT::DrawIndexedIndirect(
+    Buffer buffer,
+    const std::size_t offset,
+    const std::uint32_t draw_count,
+    const std::uint32_t stride)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::DrawIndexedIndirect");
+
+    const auto buffer_impl = dynamic_cast<BufferT *>(buffer);
+    vkCmdDrawIndexedIndirect(m_Handle, buffer_impl->GetHandle(), offset, draw_count, stride);
+}
+
+void glal::vulkan::CommandBufferT::Dispatch(const std::uint32_t x, const std::uint32_t y, const std::uint32_t z)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::Dispatch");
+
+    vkCmdDispatch(m_Handle, x, y, z);
 }
 
 void glal::vulkan::CommandBufferT::CopyBuffer(
     Buffer src_buffer,
     Buffer dst_buffer,
-    std::size_t src_offset,
-    std::size_t dst_offset,
-    std::size_t size)
+    const std::size_t src_offset,
+    const std::size_t dst_offset,
+    const std::size_t size)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::CopyBuffer");
+
+    const auto src_buffer_impl = dynamic_cast<BufferT *>(src_buffer);
+    const auto dst_buffer_impl = dynamic_cast<BufferT *>(dst_buffer);
+
+    const VkBufferCopy buffer_copy
+    {
+        .srcOffset = src_offset,
+        .dstOffset = dst_offset,
+        .size = size,
+    };
+
+    vkCmdCopyBuffer(m_Handle, src_buffer_impl->GetHandle(), dst_buffer_impl->GetHandle(), 1, &buffer_copy);
 }
 
 void glal::vulkan::CommandBufferT::CopyBufferToImage(Buffer src_buffer, Image dst_image)
 {
+    COMMON_PROFILE_ZONE("CommandBuffer::CopyBufferToImage");
+
+    CopyBufferToImage(src_buffer, dst_image, 0, 0);
+}
+
+void glal::vulkan::CommandBufferT::CopyBufferToImage(
+    Buffer src_buffer,
+    Image dst_image,
+    const std::size_t src_offset,
+    const std::uint32_t mip_level)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::CopyBufferToImage");
+
+    const auto src_buffer_impl = dynamic_cast<BufferT *>(src_buffer);
+    const auto dst_image_impl = dynamic_cast<ImageT *>(dst_image);
+
+    std::uint32_t block_size;
+    GetFormatBlock(dst_image_impl->GetFormat(), nullptr, nullptr, &block_size);
+    common::Assert(
+        src_offset % block_size == 0,
+        "buffer offset {} is not aligned to the block size {}",
+        src_offset,
+        block_size);
+
+    const auto extent = dst_image_impl->GetExtent();
+
+    const VkBufferImageCopy buffer_image_copy
+    {
+        .bufferOffset = src_offset,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel = mip_level,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+        .imageOffset = { 0, 0, 0 },
+        .imageExtent = {
+            .width = std::max(extent.Width >> mip_level, 1u),
+            .height = std::max(extent.Height >> mip_level, 1u),
+            .depth = std::max(extent.Depth >> mip_level, 1u),
+        },
+    };
+
+    // consecutive mip level copies into the same image need no barrier between them
+    if (dst_image_impl->GetAccess().Layout != VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+        Transition(dst_image, ResourceState_CopyDst);
+
+    vkCmdCopyBufferToImage(
+        m_Handle,
+        src_buffer_impl->GetHandle(),
+        dst_image_impl->GetHandle(),
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1,
+        &buffer_image_copy);
+}
+
+void glal::vulkan::CommandBufferT::CopyImageToBuffer(
+    Image src_image,
+    Buffer dst_buffer,
+    const std::size_t dst_offset,
+    const std::uint32_t mip_level)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::CopyImageToBuffer");
+
+    const auto src_image_impl = dynamic_cast<ImageT *>(src_image);
+    const auto dst_buffer_impl = dynamic_cast<BufferT *>(dst_buffer);
+
+    std::uint32_t block_size;
+    GetFormatBlock(src_image_impl->GetFormat(), nullptr, nullptr, &block_size);
+    common::Assert(
+        dst_offset % block_size == 0,
+        "buffer offset {} is not aligned to the block size {}",
+        dst_offset,
+        block_size);
+
+    const auto extent = src_image_impl->GetExtent();
+
+    const VkBufferImageCopy buffer_image_copy
+    {
+        .bufferOffset = dst_offset,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel = mip_level,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+        .imageOffset = { 0, 0, 0 },
+        .imageExtent = {
+            .width = std::max(extent.Width >> mip_level, 1u),
+            .height = std::max(extent.Height >> mip_level, 1u),
+            .depth = std::max(extent.Depth >> mip_level, 1u),
+        },
+    };
+
+    if (src_image_impl->GetAccess().Layout != VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+        Transition(src_image, ResourceState_CopySrc);
+
+    vkCmdCopyImageToBuffer(
+        m_Handle,
+        src_image_impl->GetHandle(),
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        dst_buffer_impl->GetHandle(),
+        1,
+        &buffer_image_copy);
+}
+
+void glal::vulkan::CommandBufferT::Transition(Resource resource, const ResourceState state)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::Transition");
+
+    const auto next = ToVkResourceAccess(state);
+
+    if (const auto image_impl = dynamic_cast<ImageT *>(resource))
+    {
+        auto &access = image_impl->GetAccess();
+
+        // reads in the same layout need no barrier, later writes wait for all of them
+        if (access.Layout == next.Layout && !writes(access.Access) && !writes(next.Access))
+        {
+            access.Stages |= next.Stages;
+            access.Access |= next.Access;
+            return;
+        }
+
+        VkImageAspectFlags aspect_mask = VK_IMAGE_ASPECT_COLOR_BIT;
+        if (image_impl->GetFormat() == ImageFormat_D32F)
+            aspect_mask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        else if (image_impl->GetFormat() == ImageFormat_D24S8)
+            aspect_mask = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+
+        const VkImageMemoryBarrier image_memory_barrier
+        {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = access.Access,
+            .dstAccessMask = next.Access,
+            .oldLayout = access.Layout,
+            .newLayout = next.Layout,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = image_impl->GetHandle(),
+            .subresourceRange = {
+                .aspectMask = aspect_mask,
+                .baseMipLevel = 0,
+                .levelCount = VK_REMAINING_MIP_LEVELS,
+                .baseArrayLayer = 0,
+                .layerCount = VK_REMAINING_ARRAY_LAYERS,
+            },
+        };
+        vkCmdPipelineBarrier(
+            m_Handle,
+            access.Stages,
+            next.Stages,
+            0,
+            0,
+            nullptr,
+            0,
+            nullptr,
+            1,
+            &image_memory_barrier);
+
+        access = next;
+        return;
+    }
+
+    const auto buffer_impl = dynamic_cast<BufferT *>(resource);
+    common::Assert(buffer_impl, "resource {} is neither a buffer nor an image", static_cast<const void *>(resource));
+
+    auto &access = buffer_impl->GetAccess();
+    if (!writes(access.Access) && !writes(next.Access))
+    {
+        access.Stages |= next.Stages;
+        access.Access |= next.Access;
+        return;
+    }
+
+    const VkBufferMemoryBarrier buffer_memory_barrier
+    {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask = access.Access,
+        .dstAccessMask = next.Access,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = buffer_impl->GetHandle(),
+        .offset = 0,
+        .size = VK_WHOLE_SIZE,
+    };
+    vkCmdPipelineBarrier(
+        m_Handle,
+        access.Stages,
+        next.Stages,
+        0,
+        0,
+        nullptr,
+        1,
+        &buffer_memory_barrier,
+        0,
+        nullptr);
+
+    access = next;
+}
+
+void glal::vulkan::CommandBufferT::ResetQueries(
+    QueryPool query_pool,
+    const std::uint32_t first_query,
+    const std::uint32_t query_count)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::ResetQueries");
+
+    const auto query_pool_impl = dynamic_cast<QueryPoolT *>(query_pool);
+    vkCmdResetQueryPool(m_Handle, query_pool_impl->GetHandle(), first_query, query_count);
+}
+
+void glal::vulkan::CommandBufferT::WriteTimestamp(QueryPool query_pool, const std::uint32_t query)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::WriteTimestamp");
+
+    const auto query_pool_impl = dynamic_cast<QueryPoolT *>(query_pool);
+    vkCmdWriteTimestamp(m_Handle, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool_impl->GetHandle(), query);
+}
+
+void glal::vulkan::CommandBufferT::BeginQuery(QueryPool query_pool, const std::uint32_t query)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::BeginQuery");
+
+    const auto query_pool_impl = dynamic_cast<QueryPoolT *>(query_pool);
+    vkCmdBeginQuery(m_Handle, query_pool_impl->GetHandle(), query, 0);
+}
+
+void glal::vulkan::CommandBufferT::EndQuery(QueryPool query_pool, const std::uint32_t query)
+{
+    COMMON_PROFILE_ZONE("CommandBuffer::EndQuery");
+
+    const auto query_pool_impl = dynamic_cast<QueryPoolT *>(query_pool);
+    vkCmdEndQuery(m_Handle, query_pool_impl->GetHandle(), query);
 }
 
-void glal::vulkan::CommandBufferT::Transition(Resource resource, ResourceState state)
+VkCommandBuffer glal::vulkan::CommandBufferT::GetHandle() const
 {
+    return m_Handle;
 }
@@ -76,6 +76,41 @@ VkShaderStageFlagBits glal::vulkan::ToVkShaderStage(const ShaderStage shader_sta
     }
 }
 
+VkShaderStageFlags glal::vulkan::ToVkShaderStageFlags(const ShaderStage shader_stages)
+{
+    VkShaderStageFlags shader_stage_flags{};
+    if (shader_stages & ShaderStage_Vertex)
+        shader_stage_flags |= VK_SHADER_STAGE_VERTEX_BIT;
+    if (shader_stages & ShaderStage_Geometry)
+        shader_stage_flags |= VK_SHADER_STAGE_GEOMETRY_BIT;
+    if (shader_stages & ShaderStage_TessellationControl)
+        shader_stage_flags |= VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+    if (shader_stages & ShaderStage_TessellationEvaluation)
+        shader_stage_flags |= VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+    if (shader_stages & ShaderStage_Fragment)
+        shader_stage_flags |= VK_SHADER_STAGE_FRAGMENT_BIT;
+    if (shader_stages & ShaderStage_Compute)
+        shader_stage_flags |= VK_SHADER_STAGE_COMPUTE_BIT;
+    if (shader_stages & ShaderStage_RayGeneration)
+        shader_stage_flags |= VK_SHADER_STAGE_RAYGEN_BIT_KHR;
+    if (shader_stages & ShaderStage_RayHit)
+        shader_stage_flags |= VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
+    if (shader_stages & ShaderStage_RayMiss)
+        shader_stage_flags |= VK_SHADER_STAGE_MISS_BIT_KHR;
+    return shader_stage_flags;
+}
+
+VkDescriptorBindingFlags glal::vulkan::ToVkDescriptorBindingFlags(
+    const DescriptorBindingFlag descriptor_binding_flags)
+{
+    VkDescriptorBindingFlags flags{};
+    if (descriptor_binding_flags & DescriptorBindingFlag_PartiallyBound)
+        flags |= VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+    if (descriptor_binding_flags & DescriptorBindingFlag_UpdateAfterBind)
+        flags |= VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+    return flags;
+}
+
 VkFormat glal::vulkan::ToVkFormat(const DataType data_type, const std::uint32_t count)
 {
     switch (data_type)
@@ -230,13 +265,13 @@ VkFormat glal::vulkan::ToVkFormat(const ImageFormat image_format)
     switch (image_format)
     {
     case ImageFormat_RGBA8_UNorm:
-        return VK_FORMAT_R8G8B8_UNORM;
+        return VK_FORMAT_R8G8B8A8_UNORM;
     case ImageFormat_RGBA8_SRGB:
         return VK_FORMAT_R8G8B8A8_SRGB;
     case ImageFormat_BGRA8_UNorm:
-        return VK_FORMAT_B8G8R8_UNORM;
+        return VK_FORMAT_B8G8R8A8_UNORM;
     case ImageFormat_RG16F:
-        return VK_FORMAT_R16G16B16_SFLOAT;
+        return VK_FORMAT_R16G16_SFLOAT;
     case ImageFormat_RGBA16F:
         return VK_FORMAT_R16G16B16A16_SFLOAT;
     case ImageFormat_RGBA32F:
@@ -245,6 +280,32 @@ VkFormat glal::vulkan::ToVkFormat(const ImageFormat image_format)
         return VK_FORMAT_D24_UNORM_S8_UINT;
     case ImageFormat_D32F:
         return VK_FORMAT_D32_SFLOAT;
+    case ImageFormat_BC1_UNorm:
+        return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+    case ImageFormat_BC1_SRGB:
+        return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+    case ImageFormat_BC3_UNorm:
+        return VK_FORMAT_BC3_UNORM_BLOCK;
+    case ImageFormat_BC3_SRGB:
+        return VK_FORMAT_BC3_SRGB_BLOCK;
+    case ImageFormat_BC4_UNorm:
+        return VK_FORMAT_BC4_UNORM_BLOCK;
+    case ImageFormat_BC5_UNorm:
+        return VK_FORMAT_BC5_UNORM_BLOCK;
+    case ImageFormat_BC6H_UFloat:
+        return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+    case ImageFormat_BC7_UNorm:
+        return VK_FORMAT_BC7_UNORM_BLOCK;
+    case ImageFormat_BC7_SRGB:
+        return VK_FORMAT_BC7_SRGB_BLOCK;
+    case ImageFormat_ETC2_RGB8_UNorm:
+        return VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+    case ImageFormat_ETC2_RGBA8_UNorm:
+        return VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
+    case ImageFormat_ASTC_4x4_UNorm:
+        return VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+    case ImageFormat_ASTC_4x4_SRGB:
+        return VK_FORMAT_ASTC_4x4_SRGB_BLOCK;
     default:
         common::Fatal("image format not supported");
     }
@@ -271,12 +332,127 @@ VkPrimitiveTopology glal::vulkan::ToVkPrimitiveTopology(const PrimitiveTopology
     }
 }
 
+VkCullModeFlags glal::vulkan::ToVkCullMode(const CullMode cull_mode)
+{
+    switch (cull_mode)
+    {
+    case CullMode_None:
+        return VK_CULL_MODE_NONE;
+    case CullMode_Front:
+        return VK_CULL_MODE_FRONT_BIT;
+    case CullMode_Back:
+        return VK_CULL_MODE_BACK_BIT;
+    default:
+        common::Fatal("cull mode not supported");
+    }
+}
+
+VkFrontFace glal::vulkan::ToVkFrontFace(const FrontFace front_face)
+{
+    switch (front_face)
+    {
+    case FrontFace_CounterClockwise:
+        return VK_FRONT_FACE_CLOCKWISE;
+    case FrontFace_Clockwise:
+        return VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    default:
+        common::Fatal("front face not supported");
+    }
+}
+
+VkIndexType glal::vulkan::ToVkIndexType(const DataType data_type)
+{
+    switch (data_type)
+    {
+    case DataType_UInt16:
+        return VK_INDEX_TYPE_UINT16;
+    case DataType_UInt32:
+        return VK_INDEX_TYPE_UINT32;
+    default:
+        common::Fatal("index type not supported");
+    }
+}
+
+glal::vulkan::ResourceAccess glal::vulkan::ToVkResourceAccess(const ResourceState resource_state)
+{
+    switch (resource_state)
+    {
+    case ResourceState_VertexBuffer:
+        return {
+            .Stages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+            .Access = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT,
+        };
+    case ResourceState_IndexBuffer:
+        return {
+            .Stages = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+            .Access = VK_ACCESS_INDEX_READ_BIT,
+        };
+    case ResourceState_ConstantBuffer:
+        return {
+            .Stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            .Access = VK_ACCESS_UNIFORM_READ_BIT,
+        };
+    case ResourceState_ShaderResource:
+        // uploads leave images shader readable on the transfer queue, which knows no shader stages
+        return {
+            .Stages = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+            .Access = VK_ACCESS_SHADER_READ_BIT,
+            .Layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        };
+    case ResourceState_UnorderedAccess:
+        return {
+            .Stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            .Access = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+            .Layout = VK_IMAGE_LAYOUT_GENERAL,
+        };
+    case ResourceState_RenderTarget:
+        return {
+            .Stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            .Access = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .Layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        };
+    case ResourceState_DepthStencil:
+        return {
+            .Stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+            .Access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            .Layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+        };
+    case ResourceState_CopySrc:
+        return {
+            .Stages = VK_PIPELINE_STAGE_TRANSFER_BIT,
+            .Access = VK_ACCESS_TRANSFER_READ_BIT,
+            .Layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        };
+    case ResourceState_CopyDst:
+        return {
+            .Stages = VK_PIPELINE_STAGE_TRANSFER_BIT,
+            .Access = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .Layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        };
+    case ResourceState_IndirectArgument:
+        return {
+            .Stages = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+            .Access = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+        };
+    case ResourceState_Present:
+        return {
+            .Stages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            .Access = 0,
+            .Layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+        };
+    default:
+        common::Fatal("resource state not supported");
+    }
+}
+
 VkDescriptorType glal::vulkan::ToVkDescriptorType(const DescriptorType descriptor_type)
 {
     switch (descriptor_type)
     {
     case DescriptorType_UniformBuffer:
         return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    case DescriptorType_UniformBufferDynamic:
+        return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     case DescriptorType_StorageBuffer:
         return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
     case DescriptorType_CombinedImageSampler:
@@ -291,3 +467,19 @@ VkDescriptorType glal::vulkan::ToVkDescriptorType(const DescriptorType descripto
         common::Fatal("descriptor type not supported");
     }
 }
+
+std::uint32_t glal::vulkan::FindMemoryTypeIndex(
+    VkPhysicalDevice physical_device,
+    const std::uint32_t type_bits,
+    const VkMemoryPropertyFlags property_flags)
+{
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties);
+
+    for (std::uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i)
+        if ((type_bits & (1 << i))
+            && (memory_properties.memoryTypes[i].propertyFlags & property_flags) == property_flags)
+            return i;
+
+    common::Fatal("unsupported memory requirements");
+}
@@ -6,10 +6,16 @@ glal::vulkan::DescriptorSetT::DescriptorSetT(DeviceT *device, const DescriptorSe
       m_Handle(nullptr)
 {
     std::vector<VkDescriptorPoolSize> descriptor_pool_sizes(m_Layout->GetDescriptorBindingCount());
+
+    // sets of layouts with update after bind bindings have to come from pools created for them
+    VkDescriptorPoolCreateFlags flags = 0;
     for (std::uint32_t i = 0; i < m_Layout->GetDescriptorBindingCount(); ++i)
     {
         auto &descriptor_binding = m_Layout->GetDescriptorBinding(i);
 
+        if (descriptor_binding.Flags & DescriptorBindingFlag_UpdateAfterBind)
+            flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+
         descriptor_pool_sizes[i] = {
             .type = ToVkDescriptorType(descriptor_binding.Type),
             .descriptorCount = descriptor_binding.Count,
@@ -19,6 +25,7 @@ glal::vulkan::DescriptorSetT::DescriptorSetT(DeviceT *device, const DescriptorSe
     const VkDescriptorPoolCreateInfo descriptor_pool_create_info
     {
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = flags,
         .maxSets = 1,
         .poolSizeCount = static_cast<std::uint32_t>(descriptor_pool_sizes.size()),
         .pPoolSizes = descriptor_pool_sizes.data(),
@@ -41,7 +48,7 @@ glal::vulkan::DescriptorSetT::DescriptorSetT(DeviceT *device, const DescriptorSe
 
 glal::vulkan::DescriptorSetT::~DescriptorSetT()
 {
-    vkFreeDescriptorSets(m_Device->GetHandle(), m_PoolHandle, 1, &m_Handle);
+    // the pool is not created to free sets individually, destroying it frees the set
     vkDestroyDescriptorPool(m_Device->GetHandle(), m_PoolHandle, nullptr);
 }
 
@@ -82,10 +89,20 @@ void glal::vulkan::DescriptorSetT::BindBuffer(
         .pTexelBufferView = nullptr,
     };
 
-    m_WriteDescriptorSets.emplace_back(write_descriptor_set);
+    // written right away, the buffer and image infos only live until the end of the call
+    vkUpdateDescriptorSets(m_Device->GetHandle(), 1, &write_descriptor_set, 0, nullptr);
 }
 
 void glal::vulkan::DescriptorSetT::BindImageView(const std::uint32_t binding, ImageView image_view, Sampler sampler)
+{
+    BindImageView(binding, 0, image_view, sampler);
+}
+
+void glal::vulkan::DescriptorSetT::BindImageView(
+    const std::uint32_t binding,
+    const std::uint32_t array_element,
+    ImageView image_view,
+    Sampler sampler)
 {
     const auto image_view_impl = dynamic_cast<ImageViewT *>(image_view);
     const auto sampler_impl = dynamic_cast<SamplerT *>(sampler);
@@ -105,7 +122,7 @@ void glal::vulkan::DescriptorSetT::BindImageView(const std::uint32_t binding, Im
         .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
         .dstSet = m_Handle,
         .dstBinding = binding,
-        .dstArrayElement = 0,
+        .dstArrayElement = array_element,
         .descriptorCount = 1,
         .descriptorType = ToVkDescriptorType(descriptor_binding->Type),
         .pImageInfo = &descriptor_image_info,
@@ -113,15 +130,11 @@ void glal::vulkan::DescriptorSetT::BindImageView(const std::uint32_t binding, Im
         .pTexelBufferView = nullptr,
     };
 
-    m_WriteDescriptorSets.emplace_back(write_descriptor_set);
+    // written right away, the buffer and image infos only live until the end of the call
+    vkUpdateDescriptorSets(m_Device->GetHandle(), 1, &write_descriptor_set, 0, nullptr);
 }
 
-void glal::vulkan::DescriptorSetT::Bind() const
+VkDescriptorSet glal::vulkan::DescriptorSetT::GetHandle() const
 {
-    vkUpdateDescriptorSets(
-        m_Device->GetHandle(),
-        m_WriteDescriptorSets.size(),
-        m_WriteDescriptorSets.data(),
-        0,
-        nullptr);
+    return m_Handle;
 }
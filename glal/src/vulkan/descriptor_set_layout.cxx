@@ -7,42 +7,38 @@ glal::vulkan::DescriptorSetLayoutT::DescriptorSetLayoutT(DeviceT *device, const
       m_Handle(nullptr)
 {
     std::vector<VkDescriptorSetLayoutBinding> descriptor_set_layout_bindings(desc.DescriptorBindingCount);
+    std::vector<VkDescriptorBindingFlags> descriptor_binding_flags(desc.DescriptorBindingCount);
+
+    VkDescriptorSetLayoutCreateFlags flags = 0;
     for (std::uint32_t i = 0; i < descriptor_set_layout_bindings.size(); ++i)
     {
         const auto descriptor_binding = desc.DescriptorBindings + i;
 
-        VkShaderStageFlags shader_stage_flags{};
-        if (descriptor_binding->Stages & ShaderStage_Vertex)
-            shader_stage_flags |= VK_SHADER_STAGE_VERTEX_BIT;
-        if (descriptor_binding->Stages & ShaderStage_Geometry)
-            shader_stage_flags |= VK_SHADER_STAGE_GEOMETRY_BIT;
-        if (descriptor_binding->Stages & ShaderStage_TessellationControl)
-            shader_stage_flags |= VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
-        if (descriptor_binding->Stages & ShaderStage_TessellationEvaluation)
-            shader_stage_flags |= VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
-        if (descriptor_binding->Stages & ShaderStage_Fragment)
-            shader_stage_flags |= VK_SHADER_STAGE_FRAGMENT_BIT;
-        if (descriptor_binding->Stages & ShaderStage_Compute)
-            shader_stage_flags |= VK_SHADER_STAGE_COMPUTE_BIT;
-        if (descriptor_binding->Stages & ShaderStage_RayGeneration)
-            shader_stage_flags |= VK_SHADER_STAGE_RAYGEN_BIT_KHR;
-        if (descriptor_binding->Stages & ShaderStage_RayHit)
-            shader_stage_flags |= VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
-        if (descriptor_binding->Stages & ShaderStage_RayMiss)
-            shader_stage_flags |= VK_SHADER_STAGE_MISS_BIT_KHR;
+        descriptor_binding_flags[i] = ToVkDescriptorBindingFlags(descriptor_binding->Flags);
+        if (descriptor_binding->Flags & DescriptorBindingFlag_UpdateAfterBind)
+            flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
 
         descriptor_set_layout_bindings[i] = {
             .binding = descriptor_binding->Binding,
             .descriptorType = ToVkDescriptorType(descriptor_binding->Type),
             .descriptorCount = descriptor_binding->Count,
-            .stageFlags = shader_stage_flags,
+            .stageFlags = ToVkShaderStageFlags(descriptor_binding->Stages),
             .pImmutableSamplers = nullptr,
         };
     }
 
+    const VkDescriptorSetLayoutBindingFlagsCreateInfo descriptor_set_layout_binding_flags_create_info
+    {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount = static_cast<std::uint32_t>(descriptor_binding_flags.size()),
+        .pBindingFlags = descriptor_binding_flags.data(),
+    };
+
     const VkDescriptorSetLayoutCreateInfo descriptor_set_layout_create_info
     {
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = &descriptor_set_layout_binding_flags_create_info,
+        .flags = flags,
         .bindingCount = static_cast<std::uint32_t>(descriptor_set_layout_bindings.size()),
         .pBindings = descriptor_set_layout_bindings.data(),
     };
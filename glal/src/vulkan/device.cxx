@@ -1,14 +1,41 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
 #include <common/log.hxx>
+#include <glal/file.hxx>
 #include <glal/vulkan.hxx>
+#include <GLFW/glfw3.h>
 
 static constexpr std::array extensions
 {
     VK_KHR_SWAPCHAIN_EXTENSION_NAME,
 };
 
+/**
+ * checks the cache header against the device, drivers are not required to reject foreign data themselves
+ */
+static bool is_pipeline_cache_compatible(VkPhysicalDevice physical_device, const std::vector<char> &data)
+{
+    if (data.size() < sizeof(VkPipelineCacheHeaderVersionOne))
+        return false;
+
+    VkPipelineCacheHeaderVersionOne header;
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physical_device, &properties);
+
+    return header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+           && header.vendorID == properties.vendorID
+           && header.deviceID == properties.deviceID
+           && !std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+}
+
 glal::vulkan::DeviceT::DeviceT(PhysicalDeviceT *physical_device)
     : m_PhysicalDevice(physical_device),
-      m_Handle()
+      m_Handle(),
+      m_PipelineCache()
 {
     std::uint32_t queue_family_property_count;
     vkGetPhysicalDeviceQueueFamilyProperties(
@@ -33,20 +60,101 @@ glal::vulkan::DeviceT::DeviceT(PhysicalDeviceT *physical_device)
             .pQueuePriorities = &queue_priority,
         };
 
-    // TODO: layers, extensions and queue families
+    // compressed formats and pipeline statistics queries may only be used when their feature is enabled
+    VkPhysicalDeviceFeatures supported_features;
+    vkGetPhysicalDeviceFeatures(m_PhysicalDevice->GetHandle(), &supported_features);
+
+    const VkPhysicalDeviceFeatures enabled_features
+    {
+        .textureCompressionETC2 = supported_features.textureCompressionETC2,
+        .textureCompressionASTC_LDR = supported_features.textureCompressionASTC_LDR,
+        .textureCompressionBC = supported_features.textureCompressionBC,
+        .pipelineStatisticsQuery = supported_features.pipelineStatisticsQuery,
+    };
+
+    // bindless textures need the descriptor indexing subset their arrays are created and sampled with
+    const auto bindless_textures = m_PhysicalDevice->Supports(DeviceFeature_BindlessTextures);
+
+    const VkPhysicalDeviceVulkan12Features enabled_vulkan_12_features
+    {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .descriptorIndexing = bindless_textures,
+        .shaderSampledImageArrayNonUniformIndexing = bindless_textures,
+        .descriptorBindingSampledImageUpdateAfterBind = bindless_textures,
+        .descriptorBindingPartiallyBound = bindless_textures,
+        .runtimeDescriptorArray = bindless_textures,
+        .timelineSemaphore = m_PhysicalDevice->Supports(DeviceFeature_TimelineSemaphore),
+    };
+
+    const auto instance_impl = dynamic_cast<InstanceT *>(m_PhysicalDevice->GetInstance());
+    const auto headless = instance_impl->IsHeadless();
+
+    // TODO: layers
     const VkDeviceCreateInfo device_create_info
     {
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .pNext = &enabled_vulkan_12_features,
         .queueCreateInfoCount = static_cast<std::uint32_t>(device_queue_create_infos.size()),
         .pQueueCreateInfos = device_queue_create_infos.data(),
         .enabledLayerCount = 0,
         .ppEnabledLayerNames = nullptr,
-        .enabledExtensionCount = extensions.size(),
+        .enabledExtensionCount = headless ? 0u : static_cast<std::uint32_t>(extensions.size()),
         .ppEnabledExtensionNames = extensions.data(),
-        .pEnabledFeatures = nullptr,
+        .pEnabledFeatures = &enabled_features,
     };
 
     vkCreateDevice(physical_device->GetHandle(), &device_create_info, nullptr, &m_Handle);
+
+    for (std::uint32_t i = 0; i < queue_family_property_count; ++i)
+    {
+        const auto flags = queue_family_properties[i].queueFlags;
+
+        std::uint32_t types = QueueType_None;
+        if (flags & VK_QUEUE_GRAPHICS_BIT)
+            types |= QueueType_Graphics;
+        // surfaces only exist once a swapchain is created, glfw answers for the windows of the platform instead
+        if (!headless
+            && glfwGetPhysicalDevicePresentationSupport(instance_impl->GetHandle(), m_PhysicalDevice->GetHandle(), i))
+            types |= QueueType_Present;
+        if (flags & VK_QUEUE_COMPUTE_BIT)
+            types |= QueueType_Compute;
+        if (flags & (VK_QUEUE_TRANSFER_BIT | VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))
+            types |= QueueType_Transfer;
+
+        m_Queues.push_back(new QueueT(this, i, static_cast<QueueType>(types)));
+    }
+
+    for (const auto type : { QueueType_Graphics, QueueType_Transfer })
+    {
+        const auto family_index = dynamic_cast<QueueT *>(GetQueue(type))->GetFamilyIndex();
+        if (std::ranges::find(m_SharingQueueFamilies, family_index) == m_SharingQueueFamilies.end())
+            m_SharingQueueFamilies.push_back(family_index);
+    }
+
+    m_PipelineCachePath = instance_impl->GetPipelineCachePath();
+
+    std::vector<char> initial_data;
+    if (!m_PipelineCachePath.empty())
+        if (std::ifstream stream(m_PipelineCachePath, std::ios::binary | std::ios::ate); stream.is_open())
+        {
+            initial_data.resize(stream.tellg());
+            stream.seekg(0, std::ios::beg);
+            stream.read(initial_data.data(), static_cast<std::streamsize>(initial_data.size()));
+
+            if (!stream || !is_pipeline_cache_compatible(m_PhysicalDevice->GetHandle(), initial_data))
+            {
+                common::Log(common::LogLevel_Info, "discarding stale pipeline cache {}", m_PipelineCachePath);
+                initial_data.clear();
+            }
+        }
+
+    const VkPipelineCacheCreateInfo pipeline_cache_create_info
+    {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = initial_data.size(),
+        .pInitialData = initial_data.data(),
+    };
+    vkCreatePipelineCache(m_Handle, &pipeline_cache_create_info, nullptr, &m_PipelineCache);
 }
 
 glal::vulkan::DeviceT::~DeviceT()
@@ -62,6 +170,14 @@ glal::vulkan::DeviceT::~DeviceT()
     common::Assert(m_Swapchains.empty(), "not all swapchains were explicitly destroyed");
     common::Assert(m_CommandBuffers.empty(), "not all command buffers were explicitly destroyed");
     common::Assert(m_Fences.empty(), "not all fences were explicitly destroyed");
+    common::Assert(m_Semaphores.empty(), "not all semaphores were explicitly destroyed");
+    common::Assert(m_QueryPools.empty(), "not all query pools were explicitly destroyed");
+
+    SavePipelineCache();
+    vkDestroyPipelineCache(m_Handle, m_PipelineCache, nullptr);
+
+    for (const auto queue : m_Queues)
+        delete queue;
 }
 
 glal::vulkan::PhysicalDeviceT *glal::vulkan::DeviceT::GetPhysicalDevice() const
@@ -131,11 +247,18 @@ void glal::vulkan::DeviceT::DestroyImageView(ImageView image_view)
 
 glal::Sampler glal::vulkan::DeviceT::CreateSampler(const SamplerDesc &desc)
 {
-    return m_Samplers.emplace_back(new SamplerT(this, desc));
+    const auto key = GetSamplerKey(desc);
+    if (const auto sampler = m_SharedSamplers.Acquire(key))
+        return sampler;
+
+    return m_SharedSamplers.Insert(key, m_Samplers.emplace_back(new SamplerT(this, desc)));
 }
 
 void glal::vulkan::DeviceT::DestroySampler(Sampler sampler)
 {
+    if (!m_SharedSamplers.Release(sampler))
+        return;
+
     for (auto it = m_Samplers.begin(); it != m_Samplers.end(); ++it)
         if (*it == sampler)
         {
@@ -191,11 +314,31 @@ void glal::vulkan::DeviceT::DestroyPipelineLayout(PipelineLayout pipeline_layout
 
 glal::Pipeline glal::vulkan::DeviceT::CreatePipeline(const PipelineDesc &desc)
 {
-    return m_Pipelines.emplace_back(new PipelineT(this, desc));
+    // a blocking create must not get a pipeline that is still compiling, so blocking and async ones are kept apart
+    auto key = GetPipelineKey(desc);
+    key.Add(false);
+    if (const auto pipeline = m_SharedPipelines.Acquire(key))
+        return pipeline;
+
+    return m_SharedPipelines.Insert(key, m_Pipelines.emplace_back(new PipelineT(this, desc, false)));
+}
+
+glal::Pipeline glal::vulkan::DeviceT::CreatePipelineAsync(const PipelineDesc &desc)
+{
+    auto key = GetPipelineKey(desc);
+    key.Add(true);
+    if (const auto pipeline = m_SharedPipelines.Acquire(key))
+        return pipeline;
+
+    return m_SharedPipelines.Insert(key, m_Pipelines.emplace_back(new PipelineT(this, desc, true)));
 }
 
 void glal::vulkan::DeviceT::DestroyPipeline(Pipeline pipeline)
 {
+    // shared pipelines go with their last reference
+    if (!m_SharedPipelines.Release(pipeline))
+        return;
+
     for (auto it = m_Pipelines.begin(); it != m_Pipelines.end(); ++it)
         if (*it == pipeline)
         {
@@ -211,11 +354,20 @@ void glal::vulkan::DeviceT::DestroyPipeline(Pipeline pipeline)
 
 glal::DescriptorSetLayout glal::vulkan::DeviceT::CreateDescriptorSetLayout(const DescriptorSetLayoutDesc &desc)
 {
-    return m_DescriptorSetLayouts.emplace_back(new DescriptorSetLayoutT(this, desc));
+    const auto key = GetDescriptorSetLayoutKey(desc);
+    if (const auto descriptor_set_layout = m_SharedDescriptorSetLayouts.Acquire(key))
+        return descriptor_set_layout;
+
+    return m_SharedDescriptorSetLayouts.Insert(
+        key,
+        m_DescriptorSetLayouts.emplace_back(new DescriptorSetLayoutT(this, desc)));
 }
 
 void glal::vulkan::DeviceT::DestroyDescriptorSetLayout(DescriptorSetLayout descriptor_set_layout)
 {
+    if (!m_SharedDescriptorSetLayouts.Release(descriptor_set_layout))
+        return;
+
     for (auto it = m_DescriptorSetLayouts.begin(); it != m_DescriptorSetLayouts.end(); ++it)
         if (*it == descriptor_set_layout)
         {
@@ -309,9 +461,11 @@ void glal::vulkan::DeviceT::DestroyFramebuffer(Framebuffer framebuffer)
         static_cast<const void *>(this));
 }
 
-glal::CommandBuffer glal::vulkan::DeviceT::CreateCommandBuffer(const CommandBufferUsage usage)
+glal::CommandBuffer glal::vulkan::DeviceT::CreateCommandBuffer(
+    const CommandBufferUsage usage,
+    const QueueType queue_type)
 {
-    return m_CommandBuffers.emplace_back(new CommandBufferT(this, usage));
+    return m_CommandBuffers.emplace_back(new CommandBufferT(this, usage, queue_type));
 }
 
 void glal::vulkan::DeviceT::DestroyCommandBuffer(CommandBuffer command_buffer)
@@ -349,10 +503,60 @@ void glal::vulkan::DeviceT::DestroyFence(Fence fence)
         static_cast<const void *>(this));
 }
 
-glal::Queue glal::vulkan::DeviceT::GetQueue(QueueType type)
+glal::Semaphore glal::vulkan::DeviceT::CreateSemaphore(const SemaphoreDesc &desc)
 {
-    for (auto queue : m_Queues); // TODO
-    return nullptr;
+    return m_Semaphores.emplace_back(new SemaphoreT(this, desc));
+}
+
+void glal::vulkan::DeviceT::DestroySemaphore(Semaphore semaphore)
+{
+    for (auto it = m_Semaphores.begin(); it != m_Semaphores.end(); ++it)
+        if (*it == semaphore)
+        {
+            m_Semaphores.erase(it);
+            delete semaphore;
+            return;
+        }
+    common::Fatal(
+        "semaphore {} is not owned by device {}",
+        static_cast<const void *>(semaphore),
+        static_cast<const void *>(this));
+}
+
+glal::QueryPool glal::vulkan::DeviceT::CreateQueryPool(const QueryPoolDesc &desc)
+{
+    return m_QueryPools.emplace_back(new QueryPoolT(this, desc));
+}
+
+void glal::vulkan::DeviceT::DestroyQueryPool(QueryPool query_pool)
+{
+    for (auto it = m_QueryPools.begin(); it != m_QueryPools.end(); ++it)
+        if (*it == query_pool)
+        {
+            m_QueryPools.erase(it);
+            delete query_pool;
+            return;
+        }
+    common::Fatal(
+        "query pool {} is not owned by device {}",
+        static_cast<const void *>(query_pool),
+        static_cast<const void *>(this));
+}
+
+glal::Queue glal::vulkan::DeviceT::GetQueue(const QueueType type)
+{
+    // the queue with the fewest other capabilities is the most dedicated one
+    QueueT *best = nullptr;
+    for (const auto queue : m_Queues)
+    {
+        if (!(queue->GetTypes() & type))
+            continue;
+        if (!best || std::popcount<std::uint32_t>(queue->GetTypes()) < std::popcount<std::uint32_t>(best->GetTypes()))
+            best = queue;
+    }
+
+    common::Assert(best, "no queue supports type {}", static_cast<std::uint32_t>(type));
+    return best;
 }
 
 bool glal::vulkan::DeviceT::Supports(const DeviceFeature feature) const
@@ -369,3 +573,32 @@ VkDevice glal::vulkan::DeviceT::GetHandle() const
 {
     return m_Handle;
 }
+
+VkPipelineCache glal::vulkan::DeviceT::GetPipelineCache() const
+{
+    return m_PipelineCache;
+}
+
+const std::vector<std::uint32_t> &glal::vulkan::DeviceT::GetSharingQueueFamilies() const
+{
+    return m_SharingQueueFamilies;
+}
+
+void glal::vulkan::DeviceT::SavePipelineCache() const
+{
+    if (m_PipelineCachePath.empty())
+        return;
+
+    std::size_t size;
+    vkGetPipelineCacheData(m_Handle, m_PipelineCache, &size, nullptr);
+
+    std::vector<char> data(size);
+    vkGetPipelineCacheData(m_Handle, m_PipelineCache, &size, data.data());
+
+    WriteFileAtomic(
+        m_PipelineCachePath,
+        [&](std::ostream &stream)
+        {
+            stream.write(data.data(), static_cast<std::streamsize>(size));
+        });
+}
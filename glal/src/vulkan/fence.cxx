@@ -24,3 +24,13 @@ void glal::vulkan::FenceT::Reset()
 {
     vkResetFences(m_Device->GetHandle(), 1, &m_Handle);
 }
+
+bool glal::vulkan::FenceT::IsSignaled()
+{
+    return vkGetFenceStatus(m_Device->GetHandle(), m_Handle) == VK_SUCCESS;
+}
+
+VkFence glal::vulkan::FenceT::GetHandle() const
+{
+    return m_Handle;
+}
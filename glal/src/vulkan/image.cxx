@@ -7,7 +7,8 @@ glal::vulkan::ImageT::ImageT(const VkImage handle, const ImageDesc &desc)
       m_Extent(desc.Extent),
       m_MipLevelCount(desc.MipLevelCount),
       m_ArrayLayerCount(desc.ArrayLayerCount),
-      m_Handle(handle)
+      m_Handle(handle),
+      m_MemoryHandle()
 {
 }
 
@@ -18,7 +19,8 @@ glal::vulkan::ImageT::ImageT(DeviceT *device, const ImageDesc &desc)
       m_Extent(desc.Extent),
       m_MipLevelCount(desc.MipLevelCount),
       m_ArrayLayerCount(desc.ArrayLayerCount),
-      m_Handle()
+      m_Handle(),
+      m_MemoryHandle()
 {
     VkImageType image_type{};
     switch (m_Type)
@@ -34,34 +36,16 @@ glal::vulkan::ImageT::ImageT(DeviceT *device, const ImageDesc &desc)
         break;
     }
 
-    VkFormat format{};
-    switch (m_Format)
-    {
-    case ImageFormat_RGBA8_UNorm:
-        format = VK_FORMAT_R8G8B8A8_UNORM;
-        break;
-    case ImageFormat_RGBA8_SRGB:
-        format = VK_FORMAT_R8G8B8A8_SRGB;
-        break;
-    case ImageFormat_BGRA8_UNorm:
-        format = VK_FORMAT_B8G8R8A8_UNORM;
-        break;
-    case ImageFormat_RG16F:
-        format = VK_FORMAT_R16G16_SFLOAT;
-        break;
-    case ImageFormat_RGBA16F:
-        format = VK_FORMAT_R16G16B16A16_SFLOAT;
-        break;
-    case ImageFormat_RGBA32F:
-        format = VK_FORMAT_R32G32B32A32_SFLOAT;
-        break;
-    case ImageFormat_D24S8:
-        format = VK_FORMAT_D24_UNORM_S8_UINT;
-        break;
-    case ImageFormat_D32F:
-        format = VK_FORMAT_D32_SFLOAT;
-        break;
-    }
+    const auto format = ToVkFormat(m_Format);
+
+    // uncompressed images may be rendered to and read back, which offscreen rendering relies on
+    VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    if (m_Format == ImageFormat_D24S8 || m_Format == ImageFormat_D32F)
+        usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    else if (!IsCompressedFormat(m_Format))
+        usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+
+    auto &queue_families = m_Device->GetSharingQueueFamilies();
 
     // TODO
     const VkImageCreateInfo image_create_info
@@ -74,13 +58,28 @@ glal::vulkan::ImageT::ImageT(DeviceT *device, const ImageDesc &desc)
         .arrayLayers = m_ArrayLayerCount,
         .samples = VK_SAMPLE_COUNT_1_BIT,
         .tiling = VK_IMAGE_TILING_OPTIMAL,
-        .usage = {},
-        .sharingMode = VK_SHARING_MODE_CONCURRENT,
-        .queueFamilyIndexCount = 0,
-        .pQueueFamilyIndices = nullptr,
+        .usage = usage,
+        .sharingMode = queue_families.size() > 1 ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = static_cast<std::uint32_t>(queue_families.size()),
+        .pQueueFamilyIndices = queue_families.data(),
         .initialLayout = {},
     };
     vkCreateImage(device->GetHandle(), &image_create_info, nullptr, &m_Handle);
+
+    VkMemoryRequirements memory_requirements;
+    vkGetImageMemoryRequirements(m_Device->GetHandle(), m_Handle, &memory_requirements);
+
+    const VkMemoryAllocateInfo memory_allocate_info
+    {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = memory_requirements.size,
+        .memoryTypeIndex = FindMemoryTypeIndex(
+            m_Device->GetPhysicalDevice()->GetHandle(),
+            memory_requirements.memoryTypeBits,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT),
+    };
+    vkAllocateMemory(device->GetHandle(), &memory_allocate_info, nullptr, &m_MemoryHandle);
+    vkBindImageMemory(device->GetHandle(), m_Handle, m_MemoryHandle, 0);
 }
 
 glal::vulkan::ImageT::~ImageT()
@@ -88,6 +87,7 @@ glal::vulkan::ImageT::~ImageT()
     if (m_Device)
     {
         vkDestroyImage(m_Device->GetHandle(), m_Handle, nullptr);
+        vkFreeMemory(m_Device->GetHandle(), m_MemoryHandle, nullptr);
     }
 }
 
@@ -120,3 +120,8 @@ VkImage glal::vulkan::ImageT::GetHandle() const
 {
     return m_Handle;
 }
+
+glal::vulkan::ResourceAccess &glal::vulkan::ImageT::GetAccess()
+{
+    return m_Access;
+}
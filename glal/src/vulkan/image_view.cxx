@@ -21,34 +21,7 @@ glal::vulkan::ImageViewT::ImageViewT(DeviceT *device, const ImageViewDesc &desc)
         break;
     }
 
-    VkFormat format{};
-    switch (m_Format)
-    {
-    case ImageFormat_RGBA8_UNorm:
-        format = VK_FORMAT_R8G8B8A8_UNORM;
-        break;
-    case ImageFormat_RGBA8_SRGB:
-        format = VK_FORMAT_R8G8B8A8_SRGB;
-        break;
-    case ImageFormat_BGRA8_UNorm:
-        format = VK_FORMAT_B8G8R8A8_UNORM;
-        break;
-    case ImageFormat_RG16F:
-        format = VK_FORMAT_R16G16_SFLOAT;
-        break;
-    case ImageFormat_RGBA16F:
-        format = VK_FORMAT_R16G16B16A16_SFLOAT;
-        break;
-    case ImageFormat_RGBA32F:
-        format = VK_FORMAT_R32G32B32A32_SFLOAT;
-        break;
-    case ImageFormat_D24S8:
-        format = VK_FORMAT_D24_UNORM_S8_UINT;
-        break;
-    case ImageFormat_D32F:
-        format = VK_FORMAT_D32_SFLOAT;
-        break;
-    }
+    const auto format = ToVkFormat(m_Format);
 
     const VkImageViewCreateInfo image_view_create_info
     {
@@ -114,9 +114,13 @@ static void vkXDestroyDebugUtilsMessengerEXT(
 }
 
 glal::vulkan::InstanceT::InstanceT(const InstanceDesc &desc)
-    : m_Handle()
+    : m_Handle(),
+      m_DebugUtilsMessenger(),
+      m_PipelineCachePath(desc.PipelineCachePath ? desc.PipelineCachePath : ""),
+      m_Headless(desc.Headless)
 {
-    check_layers_present();
+    if (desc.EnableValidation)
+        check_layers_present();
 
     const VkDebugUtilsMessengerCreateInfoEXT debug_utils_messenger_create_info
     {
@@ -132,18 +136,22 @@ glal::vulkan::InstanceT::InstanceT(const InstanceDesc &desc)
         .pUserData = nullptr,
     };
 
-    std::uint32_t required_extension_count;
-    const auto required_extensions = glfwGetRequiredInstanceExtensions(&required_extension_count);
-
+    // headless instances have no surfaces, so glfw does not even need to be initialized
     std::vector<const char *> enabled_extensions;
-    enabled_extensions.insert(
-        enabled_extensions.end(),
-        required_extensions,
-        required_extensions + required_extension_count);
-    enabled_extensions.insert(
-        enabled_extensions.end(),
-        extensions.begin(),
-        extensions.end());
+    if (!m_Headless)
+    {
+        std::uint32_t required_extension_count;
+        const auto required_extensions = glfwGetRequiredInstanceExtensions(&required_extension_count);
+        enabled_extensions.insert(
+            enabled_extensions.end(),
+            required_extensions,
+            required_extensions + required_extension_count);
+    }
+    if (desc.EnableValidation)
+        enabled_extensions.insert(
+            enabled_extensions.end(),
+            extensions.begin(),
+            extensions.end());
 
     const VkApplicationInfo application_info
     {
@@ -152,15 +160,15 @@ glal::vulkan::InstanceT::InstanceT(const InstanceDesc &desc)
         .applicationVersion = VK_MAKE_VERSION(0, 0, 1),
         .pEngineName = "GLAL",
         .engineVersion = VK_MAKE_VERSION(0, 0, 1),
-        .apiVersion = VK_API_VERSION_1_1,
+        .apiVersion = VK_API_VERSION_1_2,
     };
 
     const VkInstanceCreateInfo instance_create_info
     {
         .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
-        .pNext = &debug_utils_messenger_create_info,
+        .pNext = desc.EnableValidation ? &debug_utils_messenger_create_info : nullptr,
         .pApplicationInfo = &application_info,
-        .enabledLayerCount = layers.size(),
+        .enabledLayerCount = desc.EnableValidation ? static_cast<std::uint32_t>(layers.size()) : 0u,
         .ppEnabledLayerNames = layers.data(),
         .enabledExtensionCount = static_cast<std::uint32_t>(enabled_extensions.size()),
         .ppEnabledExtensionNames = enabled_extensions.data(),
@@ -169,7 +177,12 @@ glal::vulkan::InstanceT::InstanceT(const InstanceDesc &desc)
     const auto result = vkCreateInstance(&instance_create_info, nullptr, &m_Handle);
     common::Assert(result == VK_SUCCESS, "failed to create vulkan instance");
 
-    vkXCreateDebugUtilsMessengerEXT(m_Handle, &debug_utils_messenger_create_info, nullptr, &m_DebugUtilsMessenger);
+    if (desc.EnableValidation)
+        vkXCreateDebugUtilsMessengerEXT(
+            m_Handle,
+            &debug_utils_messenger_create_info,
+            nullptr,
+            &m_DebugUtilsMessenger);
 
     std::uint32_t count;
     vkEnumeratePhysicalDevices(m_Handle, &count, nullptr);
@@ -183,7 +196,8 @@ glal::vulkan::InstanceT::InstanceT(const InstanceDesc &desc)
 
 glal::vulkan::InstanceT::~InstanceT()
 {
-    vkXDestroyDebugUtilsMessengerEXT(m_Handle, m_DebugUtilsMessenger, nullptr);
+    if (m_DebugUtilsMessenger)
+        vkXDestroyDebugUtilsMessengerEXT(m_Handle, m_DebugUtilsMessenger, nullptr);
     vkDestroyInstance(m_Handle, nullptr);
 }
 
@@ -198,3 +212,13 @@ VkInstance glal::vulkan::InstanceT::GetHandle() const
 {
     return m_Handle;
 }
+
+const std::filesystem::path &glal::vulkan::InstanceT::GetPipelineCachePath() const
+{
+    return m_PipelineCachePath;
+}
+
+bool glal::vulkan::InstanceT::IsHeadless() const
+{
+    return m_Headless;
+}
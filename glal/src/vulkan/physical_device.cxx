@@ -1,9 +1,41 @@
+#include <algorithm>
 #include <glal/vulkan.hxx>
 
 glal::vulkan::PhysicalDeviceT::PhysicalDeviceT(InstanceT *instance, VkPhysicalDevice handle)
     : m_Instance(instance),
-      m_Handle(handle)
+      m_Handle(handle),
+      m_Limits()
 {
+    VkPhysicalDeviceMaintenance3Properties maintenance_3_properties
+    {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_3_PROPERTIES,
+    };
+    VkPhysicalDeviceVulkan12Properties vulkan_12_properties
+    {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES,
+        .pNext = &maintenance_3_properties,
+    };
+    VkPhysicalDeviceProperties2 properties_2
+    {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &vulkan_12_properties,
+    };
+    vkGetPhysicalDeviceProperties2(m_Handle, &properties_2);
+
+    const auto &properties = properties_2.properties;
+
+    m_Limits.MaxTextureSize2D = properties.limits.maxImageDimension2D;
+    m_Limits.MaxUniformBuffers = properties.limits.maxPerStageDescriptorUniformBuffers;
+    // each buffer gets a memory allocation of its own, so it can be no larger than the largest allocation
+    m_Limits.MaxBufferSize = maintenance_3_properties.maxMemoryAllocationSize;
+    m_Limits.MaxPushConstantsSize = properties.limits.maxPushConstantsSize;
+    m_Limits.MinUniformBufferOffsetAlignment = properties.limits.minUniformBufferOffsetAlignment;
+    m_Limits.MaxBindlessTextures = Supports(DeviceFeature_BindlessTextures)
+                                       ? std::min(
+                                           vulkan_12_properties.maxDescriptorSetUpdateAfterBindSampledImages,
+                                           vulkan_12_properties.maxPerStageDescriptorUpdateAfterBindSampledImages)
+                                       : 0;
+    m_Limits.TimestampPeriod = properties.limits.timestampPeriod;
 }
 
 glal::Device glal::vulkan::PhysicalDeviceT::CreateDevice()
@@ -27,17 +59,53 @@ glal::Instance glal::vulkan::PhysicalDeviceT::GetInstance() const
     return m_Instance;
 }
 
-bool glal::vulkan::PhysicalDeviceT::Supports(DeviceFeature feature) const
+bool glal::vulkan::PhysicalDeviceT::Supports(const DeviceFeature feature) const
 {
-    // TODO: features
-    return true;
+    VkPhysicalDeviceVulkan12Features vulkan_12_features
+    {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+    };
+    VkPhysicalDeviceFeatures2 features_2
+    {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &vulkan_12_features,
+    };
+    vkGetPhysicalDeviceFeatures2(m_Handle, &features_2);
+
+    const auto &features = features_2.features;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_Handle, &properties);
+
+    switch (feature)
+    {
+    case DeviceFeature_TimelineSemaphore:
+        return vulkan_12_features.timelineSemaphore;
+    case DeviceFeature_TextureCompressionBC:
+        return features.textureCompressionBC;
+    case DeviceFeature_TextureCompressionETC2:
+        return features.textureCompressionETC2;
+    case DeviceFeature_TextureCompressionASTC:
+        return features.textureCompressionASTC_LDR;
+    case DeviceFeature_TimestampQuery:
+        return properties.limits.timestampComputeAndGraphics;
+    case DeviceFeature_PipelineStatisticsQuery:
+        return features.pipelineStatisticsQuery;
+    case DeviceFeature_BindlessTextures:
+        return vulkan_12_features.descriptorIndexing
+               && vulkan_12_features.runtimeDescriptorArray
+               && vulkan_12_features.descriptorBindingPartiallyBound
+               && vulkan_12_features.descriptorBindingSampledImageUpdateAfterBind
+               && vulkan_12_features.shaderSampledImageArrayNonUniformIndexing;
+    default:
+        // TODO: features
+        return true;
+    }
 }
 
 const glal::DeviceLimits &glal::vulkan::PhysicalDeviceT::GetLimits() const
 {
-    // TODO: limits
-    static DeviceLimits limits;
-    return limits;
+    return m_Limits;
 }
 
 VkPhysicalDevice glal::vulkan::PhysicalDeviceT::GetHandle() const
@@ -1,22 +1,90 @@
+#include <cstddef>
 #include <common/log.hxx>
 #include <glal/vulkan.hxx>
 
-glal::vulkan::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc)
+/**
+ * the constants are read in place, every map entry points at the value of its constant in the stage's array
+ */
+static const VkSpecializationInfo *to_specialization_info(
+    const glal::PipelineStage &stage,
+    std::vector<VkSpecializationMapEntry> &map_entries,
+    VkSpecializationInfo &specialization_info)
+{
+    if (!stage.SpecializationConstantCount)
+        return nullptr;
+
+    map_entries.resize(stage.SpecializationConstantCount);
+    for (std::uint32_t i = 0; i < stage.SpecializationConstantCount; ++i)
+        map_entries[i] = {
+            .constantID = stage.SpecializationConstants[i].Id,
+            .offset = static_cast<std::uint32_t>(
+                i * sizeof(glal::SpecializationConstant) + offsetof(glal::SpecializationConstant, Value)),
+            .size = sizeof(std::uint32_t),
+        };
+
+    specialization_info = {
+        .mapEntryCount = stage.SpecializationConstantCount,
+        .pMapEntries = map_entries.data(),
+        .dataSize = stage.SpecializationConstantCount * sizeof(glal::SpecializationConstant),
+        .pData = stage.SpecializationConstants,
+    };
+    return &specialization_info;
+}
+
+glal::vulkan::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc, const bool async)
     : m_Device(device),
       m_Type(desc.Type),
       m_Topology(desc.Topology),
-      m_Handle()
+      m_Desc(desc),
+      m_Stages(desc.Stages, desc.Stages + desc.StageCount),
+      m_VertexBindings(desc.VertexBindings, desc.VertexBindings + desc.VertexBindingCount),
+      m_VertexAttributes(desc.VertexAttributes, desc.VertexAttributes + desc.VertexAttributeCount),
+      m_Handle(),
+      m_Status(PipelineStatus_Pending)
+{
+    // the caller's arrays are gone by the time a background compile runs, point the copy at owned storage
+    for (auto &stage : m_Stages)
+        m_SpecializationConstants.insert(
+            m_SpecializationConstants.end(),
+            stage.SpecializationConstants,
+            stage.SpecializationConstants + stage.SpecializationConstantCount);
+
+    std::size_t constant_offset = 0;
+    for (auto &stage : m_Stages)
+    {
+        stage.SpecializationConstants = m_SpecializationConstants.data() + constant_offset;
+        constant_offset += stage.SpecializationConstantCount;
+    }
+
+    m_Desc.Stages = m_Stages.data();
+    m_Desc.VertexBindings = m_VertexBindings.data();
+    m_Desc.VertexAttributes = m_VertexAttributes.data();
+
+    // the device pipeline cache is internally synchronized, workers share it without further locking
+    if (async)
+        m_Future = std::async(std::launch::async, &PipelineT::Create, this);
+    else
+        Create();
+
+    common::Assert(async || m_Status == PipelineStatus_Ready, "failed to create pipeline");
+}
+
+void glal::vulkan::PipelineT::Create()
 {
-    const auto layout_impl = dynamic_cast<PipelineLayoutT *>(desc.Layout);
+    const auto layout_impl = dynamic_cast<PipelineLayoutT *>(m_Desc.Layout);
+
+    auto result = VK_ERROR_UNKNOWN;
 
     switch (m_Type)
     {
     case PipelineType_Graphics:
     {
-        std::vector<VkPipelineShaderStageCreateInfo> pipeline_shader_stage_create_infos(desc.StageCount);
-        for (std::uint32_t i = 0; i < desc.StageCount; ++i)
+        std::vector<VkPipelineShaderStageCreateInfo> pipeline_shader_stage_create_infos(m_Desc.StageCount);
+        std::vector<std::vector<VkSpecializationMapEntry>> specialization_map_entries(m_Desc.StageCount);
+        std::vector<VkSpecializationInfo> specialization_infos(m_Desc.StageCount);
+        for (std::uint32_t i = 0; i < m_Desc.StageCount; ++i)
         {
-            const auto stage = desc.Stages + i;
+            const auto stage = m_Desc.Stages + i;
             const auto shader_module_impl = dynamic_cast<ShaderModuleT *>(stage->Module);
 
             pipeline_shader_stage_create_infos[i] = {
@@ -24,13 +92,17 @@ glal::vulkan::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc)
                 .stage = ToVkShaderStage(stage->Stage),
                 .module = shader_module_impl->GetHandle(),
                 .pName = "main",
+                .pSpecializationInfo = to_specialization_info(
+                    *stage,
+                    specialization_map_entries[i],
+                    specialization_infos[i]),
             };
         }
 
-        std::vector<VkVertexInputBindingDescription> vertex_input_binding_descriptions(desc.VertexBindingCount);
-        for (std::uint32_t i = 0; i < desc.VertexBindingCount; ++i)
+        std::vector<VkVertexInputBindingDescription> vertex_input_binding_descriptions(m_Desc.VertexBindingCount);
+        for (std::uint32_t i = 0; i < m_Desc.VertexBindingCount; ++i)
         {
-            const auto binding = desc.VertexBindings + i;
+            const auto binding = m_Desc.VertexBindings + i;
 
             vertex_input_binding_descriptions[i] = {
                 .binding = binding->Binding,
@@ -39,10 +111,10 @@ glal::vulkan::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc)
             };
         }
 
-        std::vector<VkVertexInputAttributeDescription> vertex_input_attribute_descriptions(desc.VertexAttributeCount);
-        for (std::uint32_t i = 0; i < desc.VertexAttributeCount; ++i)
+        std::vector<VkVertexInputAttributeDescription> vertex_input_attribute_descriptions(m_Desc.VertexAttributeCount);
+        for (std::uint32_t i = 0; i < m_Desc.VertexAttributeCount; ++i)
         {
-            const auto attribute = desc.VertexAttributes + i;
+            const auto attribute = m_Desc.VertexAttributes + i;
 
             vertex_input_attribute_descriptions[i] = {
                 .location = attribute->Location,
@@ -64,8 +136,8 @@ glal::vulkan::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc)
         const VkPipelineInputAssemblyStateCreateInfo pipeline_input_assembly_state_create_info
         {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
-            .topology = ToVkPrimitiveTopology(desc.Topology),
-            .primitiveRestartEnable = desc.PrimitiveRestartEnable,
+            .topology = ToVkPrimitiveTopology(m_Desc.Topology),
+            .primitiveRestartEnable = m_Desc.PrimitiveRestartEnable,
         };
 
         // TODO: make customizable
@@ -85,15 +157,14 @@ glal::vulkan::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc)
             .pScissors = nullptr,
         };
 
-        // TODO: make customizable
         const VkPipelineRasterizationStateCreateInfo pipeline_rasterization_state_create_info
         {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
-            .depthClampEnable = true,
-            .rasterizerDiscardEnable = true,
+            .depthClampEnable = false,
+            .rasterizerDiscardEnable = false,
             .polygonMode = VK_POLYGON_MODE_FILL,
-            .cullMode = VK_CULL_MODE_BACK_BIT,
-            .frontFace = VK_FRONT_FACE_CLOCKWISE,
+            .cullMode = ToVkCullMode(m_Desc.Culling),
+            .frontFace = ToVkFrontFace(m_Desc.Winding),
             .depthBiasEnable = false,
             .depthBiasConstantFactor = 0.f,
             .depthBiasClamp = 0.f,
@@ -117,8 +188,8 @@ glal::vulkan::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc)
         const VkPipelineDepthStencilStateCreateInfo pipeline_depth_stencil_state_create_info
         {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
-            .depthTestEnable = desc.DepthTest,
-            .depthWriteEnable = desc.DepthWrite,
+            .depthTestEnable = m_Desc.DepthTest,
+            .depthWriteEnable = m_Desc.DepthWrite,
             .depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL,
             .depthBoundsTestEnable = false,
             .stencilTestEnable = false,
@@ -152,7 +223,7 @@ glal::vulkan::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc)
             .pDynamicStates = dynamic_states.data(),
         };
 
-        auto render_pass_impl = dynamic_cast<RenderPassT *>(desc.Pass);
+        auto render_pass_impl = dynamic_cast<RenderPassT *>(m_Desc.Pass);
 
         // TODO: render pass
         const VkGraphicsPipelineCreateInfo graphics_pipeline_create_info
@@ -173,9 +244,9 @@ glal::vulkan::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc)
             .renderPass = render_pass_impl->GetHandle(),
             .subpass = 0,
         };
-        vkCreateGraphicsPipelines(
+        result = vkCreateGraphicsPipelines(
             m_Device->GetHandle(),
-            nullptr,
+            m_Device->GetPipelineCache(),
             1,
             &graphics_pipeline_create_info,
             nullptr,
@@ -184,14 +255,21 @@ glal::vulkan::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc)
     }
     case PipelineType_Compute:
     {
-        const auto shader_module_impl = dynamic_cast<ShaderModuleT *>(desc.Stages->Module);
+        const auto shader_module_impl = dynamic_cast<ShaderModuleT *>(m_Desc.Stages->Module);
+
+        std::vector<VkSpecializationMapEntry> specialization_map_entries;
+        VkSpecializationInfo specialization_info;
 
         const VkPipelineShaderStageCreateInfo pipeline_shader_stage_create_info
         {
             .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-            .stage = ToVkShaderStage(desc.Stages->Stage),
+            .stage = ToVkShaderStage(m_Desc.Stages->Stage),
             .module = shader_module_impl->GetHandle(),
             .pName = "main",
+            .pSpecializationInfo = to_specialization_info(
+                *m_Desc.Stages,
+                specialization_map_entries,
+                specialization_info),
         };
 
         const VkComputePipelineCreateInfo compute_pipeline_create_info
@@ -200,9 +278,9 @@ glal::vulkan::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc)
             .stage = pipeline_shader_stage_create_info,
             .layout = layout_impl->GetHandle(),
         };
-        vkCreateComputePipelines(
+        result = vkCreateComputePipelines(
             m_Device->GetHandle(),
-            nullptr,
+            m_Device->GetPipelineCache(),
             1,
             &compute_pipeline_create_info,
             nullptr,
@@ -213,10 +291,22 @@ glal::vulkan::PipelineT::PipelineT(DeviceT *device, const PipelineDesc &desc)
         common::Fatal("pipeline type not supported");
         break;
     }
+
+    if (result != VK_SUCCESS)
+    {
+        common::Log(common::LogLevel_Error, "failed to create pipeline: {}", static_cast<int>(result));
+        m_Status = PipelineStatus_Failed;
+        return;
+    }
+
+    m_Status = PipelineStatus_Ready;
 }
 
 glal::vulkan::PipelineT::~PipelineT()
 {
+    if (m_Future.valid())
+        m_Future.wait();
+
     vkDestroyPipeline(m_Device->GetHandle(), m_Handle, nullptr);
 }
 
@@ -230,7 +320,17 @@ glal::PrimitiveTopology glal::vulkan::PipelineT::GetTopology() const
     return m_Topology;
 }
 
+glal::PipelineStatus glal::vulkan::PipelineT::GetStatus()
+{
+    return m_Status;
+}
+
 VkPipeline glal::vulkan::PipelineT::GetHandle() const
 {
     return m_Handle;
 }
+
+glal::vulkan::PipelineLayoutT *glal::vulkan::PipelineT::GetLayout() const
+{
+    return dynamic_cast<PipelineLayoutT *>(m_Desc.Layout);
+}
@@ -3,19 +3,28 @@
 glal::vulkan::PipelineLayoutT::PipelineLayoutT(DeviceT *device, const PipelineLayoutDesc &desc)
     : m_Device(device),
       m_DescriptorSetLayouts(desc.DescriptorSetLayouts, desc.DescriptorSetLayouts + desc.DescriptorSetLayoutCount),
+      m_PushConstantRanges(desc.PushConstantRanges, desc.PushConstantRanges + desc.PushConstantRangeCount),
       m_Handle(nullptr)
 {
     std::vector<VkDescriptorSetLayout> descriptor_set_layouts(desc.DescriptorSetLayoutCount);
     for (std::uint32_t i = 0; i < descriptor_set_layouts.size(); ++i)
         descriptor_set_layouts[i] = dynamic_cast<DescriptorSetLayoutT *>(desc.DescriptorSetLayouts[i])->GetHandle();
 
+    std::vector<VkPushConstantRange> push_constant_ranges(desc.PushConstantRangeCount);
+    for (std::uint32_t i = 0; i < push_constant_ranges.size(); ++i)
+        push_constant_ranges[i] = {
+            .stageFlags = ToVkShaderStageFlags(desc.PushConstantRanges[i].Stages),
+            .offset = desc.PushConstantRanges[i].Offset,
+            .size = desc.PushConstantRanges[i].Size,
+        };
+
     const VkPipelineLayoutCreateInfo pipeline_layout_create_info
     {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
         .setLayoutCount = static_cast<std::uint32_t>(descriptor_set_layouts.size()),
         .pSetLayouts = descriptor_set_layouts.data(),
-        .pushConstantRangeCount = 0,
-        .pPushConstantRanges = nullptr,
+        .pushConstantRangeCount = static_cast<std::uint32_t>(push_constant_ranges.size()),
+        .pPushConstantRanges = push_constant_ranges.data(),
     };
 
     vkCreatePipelineLayout(device->GetHandle(), &pipeline_layout_create_info, nullptr, &m_Handle);
@@ -31,6 +40,16 @@ glal::DescriptorSetLayout glal::vulkan::PipelineLayoutT::GetDescriptorSetLayout(
     return m_DescriptorSetLayouts.at(index);
 }
 
+std::uint32_t glal::vulkan::PipelineLayoutT::GetPushConstantRangeCount() const
+{
+    return m_PushConstantRanges.size();
+}
+
+const glal::PushConstantRange &glal::vulkan::PipelineLayoutT::GetPushConstantRange(const std::uint32_t index) const
+{
+    return m_PushConstantRanges.at(index);
+}
+
 VkPipelineLayout glal::vulkan::PipelineLayoutT::GetHandle() const
 {
     return m_Handle;
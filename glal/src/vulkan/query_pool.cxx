@@ -0,0 +1,88 @@
+#include <common/log.hxx>
+#include <glal/vulkan.hxx>
+
+// ascending bit order, which is the order vulkan writes the counters in, matches glal::PipelineStatistics
+static constexpr VkQueryPipelineStatisticFlags pipeline_statistics_flags
+        = VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT
+          | VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT
+          | VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT
+          | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT
+          | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT
+          | VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+static constexpr std::uint32_t pipeline_statistics_count = sizeof(glal::PipelineStatistics) / sizeof(std::uint64_t);
+
+glal::vulkan::QueryPoolT::QueryPoolT(DeviceT *device, const QueryPoolDesc &desc)
+    : m_Device(device),
+      m_Type(desc.Type),
+      m_Count(desc.Count),
+      m_Handle()
+{
+    common::Assert(
+        m_Type != QueryType_PipelineStatistics || m_Device->Supports(DeviceFeature_PipelineStatisticsQuery),
+        "pipeline statistics queries are not supported by this device");
+
+    VkQueryType query_type{};
+    switch (m_Type)
+    {
+    case QueryType_Timestamp:
+        query_type = VK_QUERY_TYPE_TIMESTAMP;
+        break;
+    case QueryType_Occlusion:
+        query_type = VK_QUERY_TYPE_OCCLUSION;
+        break;
+    case QueryType_PipelineStatistics:
+        query_type = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        break;
+    }
+
+    const VkQueryPoolCreateInfo query_pool_create_info
+    {
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .queryType = query_type,
+        .queryCount = m_Count,
+        .pipelineStatistics = m_Type == QueryType_PipelineStatistics ? pipeline_statistics_flags : 0,
+    };
+    vkCreateQueryPool(m_Device->GetHandle(), &query_pool_create_info, nullptr, &m_Handle);
+}
+
+glal::vulkan::QueryPoolT::~QueryPoolT()
+{
+    vkDestroyQueryPool(m_Device->GetHandle(), m_Handle, nullptr);
+}
+
+glal::QueryType glal::vulkan::QueryPoolT::GetType() const
+{
+    return m_Type;
+}
+
+std::uint32_t glal::vulkan::QueryPoolT::GetCount() const
+{
+    return m_Count;
+}
+
+bool glal::vulkan::QueryPoolT::GetResults(
+    const std::uint32_t first_query,
+    const std::uint32_t query_count,
+    std::uint64_t *results)
+{
+    const auto value_count = m_Type == QueryType_PipelineStatistics ? pipeline_statistics_count : 1u;
+    const auto stride = value_count * sizeof(std::uint64_t);
+
+    // without the wait bit, the call returns VK_NOT_READY instead of blocking
+    const auto result = vkGetQueryPoolResults(
+        m_Device->GetHandle(),
+        m_Handle,
+        first_query,
+        query_count,
+        query_count * stride,
+        results,
+        stride,
+        VK_QUERY_RESULT_64_BIT);
+    return result == VK_SUCCESS;
+}
+
+VkQueryPool glal::vulkan::QueryPoolT::GetHandle() const
+{
+    return m_Handle;
+}
@@ -0,0 +1,113 @@
+#include <vector>
+#include <glal/vulkan.hxx>
+
+glal::vulkan::QueueT::QueueT(DeviceT *device, const std::uint32_t family_index, const QueueType types)
+    : m_Device(device),
+      m_FamilyIndex(family_index),
+      m_Types(types),
+      m_Handle()
+{
+    vkGetDeviceQueue(m_Device->GetHandle(), m_FamilyIndex, 0, &m_Handle);
+}
+
+void glal::vulkan::QueueT::Submit(
+    const CommandBuffer *command_buffers,
+    const std::uint32_t command_buffer_count,
+    Fence fence)
+{
+    Submit(
+        {
+            .CommandBuffers = command_buffers,
+            .CommandBufferCount = command_buffer_count,
+            .WaitSemaphores = nullptr,
+            .WaitSemaphoreCount = 0,
+            .SignalSemaphores = nullptr,
+            .SignalSemaphoreCount = 0,
+            .SignalFence = fence,
+        });
+}
+
+void glal::vulkan::QueueT::Submit(const SubmitDesc &desc)
+{
+    std::vector<VkCommandBuffer> command_buffer_handles(desc.CommandBufferCount);
+    for (std::uint32_t i = 0; i < desc.CommandBufferCount; ++i)
+        command_buffer_handles[i] = dynamic_cast<CommandBufferT *>(desc.CommandBuffers[i])->GetHandle();
+
+    auto timeline = false;
+
+    std::vector<VkSemaphore> wait_semaphore_handles(desc.WaitSemaphoreCount);
+    std::vector<VkPipelineStageFlags> wait_stages(desc.WaitSemaphoreCount);
+    std::vector<std::uint64_t> wait_values(desc.WaitSemaphoreCount);
+    for (std::uint32_t i = 0; i < desc.WaitSemaphoreCount; ++i)
+    {
+        const auto semaphore_impl = dynamic_cast<SemaphoreT *>(desc.WaitSemaphores[i].Target);
+        wait_semaphore_handles[i] = semaphore_impl->GetHandle();
+        // a semaphore value does not say which stages consume what it guards, so every stage of the submission waits.
+        // for the acquired image this also holds back uploads and culling recorded ahead of the render pass, which is
+        // accepted over a stage mask every caller would have to get right
+        wait_stages[i] = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        wait_values[i] = desc.WaitSemaphores[i].Value;
+        timeline |= semaphore_impl->GetType() == SemaphoreType_Timeline;
+    }
+
+    std::vector<VkSemaphore> signal_semaphore_handles(desc.SignalSemaphoreCount);
+    std::vector<std::uint64_t> signal_values(desc.SignalSemaphoreCount);
+    for (std::uint32_t i = 0; i < desc.SignalSemaphoreCount; ++i)
+    {
+        const auto semaphore_impl = dynamic_cast<SemaphoreT *>(desc.SignalSemaphores[i].Target);
+        signal_semaphore_handles[i] = semaphore_impl->GetHandle();
+        signal_values[i] = desc.SignalSemaphores[i].Value;
+        timeline |= semaphore_impl->GetType() == SemaphoreType_Timeline;
+    }
+
+    // values of binary semaphores in the arrays are ignored
+    const VkTimelineSemaphoreSubmitInfo timeline_semaphore_submit_info
+    {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .waitSemaphoreValueCount = desc.WaitSemaphoreCount,
+        .pWaitSemaphoreValues = wait_values.data(),
+        .signalSemaphoreValueCount = desc.SignalSemaphoreCount,
+        .pSignalSemaphoreValues = signal_values.data(),
+    };
+
+    const VkSubmitInfo submit_info
+    {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = timeline ? &timeline_semaphore_submit_info : nullptr,
+        .waitSemaphoreCount = desc.WaitSemaphoreCount,
+        .pWaitSemaphores = wait_semaphore_handles.data(),
+        .pWaitDstStageMask = wait_stages.data(),
+        .commandBufferCount = desc.CommandBufferCount,
+        .pCommandBuffers = command_buffer_handles.data(),
+        .signalSemaphoreCount = desc.SignalSemaphoreCount,
+        .pSignalSemaphores = signal_semaphore_handles.data(),
+    };
+
+    const auto fence_handle = desc.SignalFence
+                                  ? dynamic_cast<FenceT *>(desc.SignalFence)->GetHandle()
+                                  : VK_NULL_HANDLE;
+    vkQueueSubmit(m_Handle, 1, &submit_info, fence_handle);
+}
+
+void glal::vulkan::QueueT::Present(Swapchain swapchain, Semaphore wait_semaphore)
+{
+    const auto semaphore_handle = wait_semaphore
+                                      ? dynamic_cast<SemaphoreT *>(wait_semaphore)->GetHandle()
+                                      : VK_NULL_HANDLE;
+    dynamic_cast<SwapchainT *>(swapchain)->Present(m_Handle, semaphore_handle);
+}
+
+std::uint32_t glal::vulkan::QueueT::GetFamilyIndex() const
+{
+    return m_FamilyIndex;
+}
+
+glal::QueueType glal::vulkan::QueueT::GetTypes() const
+{
+    return m_Types;
+}
+
+VkQueue glal::vulkan::QueueT::GetHandle() const
+{
+    return m_Handle;
+}
@@ -0,0 +1,76 @@
+#include <common/log.hxx>
+#include <glal/vulkan.hxx>
+
+glal::vulkan::SemaphoreT::SemaphoreT(DeviceT *device, const SemaphoreDesc &desc)
+    : m_Device(device),
+      m_Type(desc.Type)
+{
+    common::Assert(
+        m_Type != SemaphoreType_Timeline || m_Device->Supports(DeviceFeature_TimelineSemaphore),
+        "timeline semaphores are not supported by this device");
+
+    const VkSemaphoreTypeCreateInfo semaphore_type_create_info
+    {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = m_Type == SemaphoreType_Timeline ? VK_SEMAPHORE_TYPE_TIMELINE : VK_SEMAPHORE_TYPE_BINARY,
+        .initialValue = m_Type == SemaphoreType_Timeline ? desc.InitialValue : 0,
+    };
+
+    const VkSemaphoreCreateInfo semaphore_create_info
+    {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = m_Type == SemaphoreType_Timeline ? &semaphore_type_create_info : nullptr,
+    };
+    vkCreateSemaphore(m_Device->GetHandle(), &semaphore_create_info, nullptr, &m_Handle);
+}
+
+glal::vulkan::SemaphoreT::~SemaphoreT()
+{
+    vkDestroySemaphore(m_Device->GetHandle(), m_Handle, nullptr);
+}
+
+glal::SemaphoreType glal::vulkan::SemaphoreT::GetType() const
+{
+    return m_Type;
+}
+
+std::uint64_t glal::vulkan::SemaphoreT::GetValue()
+{
+    common::Assert(m_Type == SemaphoreType_Timeline, "binary semaphores have no value");
+
+    std::uint64_t value;
+    vkGetSemaphoreCounterValue(m_Device->GetHandle(), m_Handle, &value);
+    return value;
+}
+
+bool glal::vulkan::SemaphoreT::Wait(const std::uint64_t value, const std::uint64_t timeout)
+{
+    common::Assert(m_Type == SemaphoreType_Timeline, "binary semaphores cannot be waited on from the host");
+
+    const VkSemaphoreWaitInfo semaphore_wait_info
+    {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores = &m_Handle,
+        .pValues = &value,
+    };
+    return vkWaitSemaphores(m_Device->GetHandle(), &semaphore_wait_info, timeout) == VK_SUCCESS;
+}
+
+void glal::vulkan::SemaphoreT::Signal(const std::uint64_t value)
+{
+    common::Assert(m_Type == SemaphoreType_Timeline, "binary semaphores cannot be signaled from the host");
+
+    const VkSemaphoreSignalInfo semaphore_signal_info
+    {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO,
+        .semaphore = m_Handle,
+        .value = value,
+    };
+    vkSignalSemaphore(m_Device->GetHandle(), &semaphore_signal_info);
+}
+
+VkSemaphore glal::vulkan::SemaphoreT::GetHandle() const
+{
+    return m_Handle;
+}
@@ -1,8 +1,10 @@
+#include <common/hash.hxx>
 #include <glal/vulkan.hxx>
 
 glal::vulkan::ShaderModuleT::ShaderModuleT(DeviceT *device, const ShaderModuleDesc &desc)
     : m_Device(device),
       m_Stage(desc.Stage),
+      m_Hash(common::Hash(desc.Code, desc.Size)),
       m_Handle()
 {
     const VkShaderModuleCreateInfo shader_module_create_info
@@ -24,6 +26,11 @@ glal::ShaderStage glal::vulkan::ShaderModuleT::GetStage() const
     return m_Stage;
 }
 
+std::uint64_t glal::vulkan::ShaderModuleT::GetHash() const
+{
+    return m_Hash;
+}
+
 VkShaderModule glal::vulkan::ShaderModuleT::GetHandle() const
 {
     return m_Handle;
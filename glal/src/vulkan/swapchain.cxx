@@ -1,16 +1,59 @@
+#include <common/log.hxx>
 #include <glal/vulkan.hxx>
 #include <GLFW/glfw3.h>
 
 glal::vulkan::SwapchainT::SwapchainT(DeviceT *device, const SwapchainDesc &desc)
     : m_Device(device),
-      m_Extent(desc.Extent)
+      m_Extent(desc.Extent),
+      m_ImageIndex(),
+      m_Handle(),
+      m_Surface()
 {
+    if (!desc.NativeWindowHandle)
+    {
+        // offscreen images come from the device, presenting leaves them for the application to read back
+        for (std::uint32_t i = 0; i < desc.ImageCount; ++i)
+        {
+            const auto image = m_Device->CreateImage(
+                {
+                    .Format = desc.Format,
+                    .Type = ImageType_2D,
+                    .Extent = { m_Extent.Width, m_Extent.Height, 1 },
+                    .MipLevelCount = 1,
+                    .ArrayLayerCount = 1,
+                });
+
+            m_Frames.push_back(
+                {
+                    .Resource = image,
+                    .View = m_Device->CreateImageView(
+                        {
+                            .Format = desc.Format,
+                            .Type = ImageType_2D,
+                            .ImageResource = image,
+                        }),
+                });
+        }
+        return;
+    }
+
     glfwCreateWindowSurface(
         dynamic_cast<InstanceT *>(m_Device->GetPhysicalDevice()->GetInstance())->GetHandle(),
         static_cast<GLFWwindow *>(desc.NativeWindowHandle),
         nullptr,
         &m_Surface);
 
+    // the device chose its present queue before any surface existed, the window has the final say
+    const auto present_family_index = dynamic_cast<QueueT *>(m_Device->GetQueue(QueueType_Present))->GetFamilyIndex();
+
+    VkBool32 surface_support;
+    vkGetPhysicalDeviceSurfaceSupportKHR(
+        m_Device->GetPhysicalDevice()->GetHandle(),
+        present_family_index,
+        m_Surface,
+        &surface_support);
+    common::Assert(surface_support, "queue family {} cannot present to the window", present_family_index);
+
     // TODO: queue families
     const VkSwapchainCreateInfoKHR swapchain_create_info
     {
@@ -20,7 +63,7 @@ glal::vulkan::SwapchainT::SwapchainT(DeviceT *device, const SwapchainDesc &desc)
         .imageFormat = ToVkFormat(desc.Format),
         .imageColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR,
         .imageExtent = { desc.Extent.Width, desc.Extent.Height },
-        .imageArrayLayers = 0,
+        .imageArrayLayers = 1,
         .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
         .imageSharingMode = VK_SHARING_MODE_CONCURRENT,
         .queueFamilyIndexCount = 0,
@@ -47,9 +90,9 @@ glal::vulkan::SwapchainT::SwapchainT(DeviceT *device, const SwapchainDesc &desc)
             {
                 .Format = desc.Format,
                 .Type = ImageType_2D,
-                .Extent = { m_Extent.Width, m_Extent.Height, 0 },
+                .Extent = { m_Extent.Width, m_Extent.Height, 1 },
                 .MipLevelCount = 1,
-                .ArrayLayerCount = 0,
+                .ArrayLayerCount = 1,
             });
 
         m_Frames.push_back(
@@ -65,6 +108,29 @@ glal::vulkan::SwapchainT::SwapchainT(DeviceT *device, const SwapchainDesc &desc)
     }
 }
 
+glal::vulkan::SwapchainT::~SwapchainT()
+{
+    for (const auto &[resource, view] : m_Frames)
+    {
+        m_Device->DestroyImageView(view);
+
+        // images of a window swapchain belong to it, not to the device
+        if (m_Handle)
+            delete resource;
+        else
+            m_Device->DestroyImage(resource);
+    }
+
+    if (!m_Handle)
+        return;
+
+    vkDestroySwapchainKHR(m_Device->GetHandle(), m_Handle, nullptr);
+    vkDestroySurfaceKHR(
+        dynamic_cast<InstanceT *>(m_Device->GetPhysicalDevice()->GetInstance())->GetHandle(),
+        m_Surface,
+        nullptr);
+}
+
 std::uint32_t glal::vulkan::SwapchainT::GetImageCount() const
 {
     return m_Frames.size();
@@ -80,28 +146,75 @@ glal::Extent2D glal::vulkan::SwapchainT::GetExtent() const
     return m_Extent;
 }
 
-std::uint32_t glal::vulkan::SwapchainT::AcquireNextImage(Fence fence)
+std::uint32_t glal::vulkan::SwapchainT::AcquireNextImage(Semaphore semaphore, Fence fence)
 {
-    std::uint32_t image_index;
-    // TODO: semaphore and fence
-    vkAcquireNextImageKHR(m_Device->GetHandle(), m_Handle, 0, nullptr, nullptr, &image_index);
-    return image_index;
+    const auto semaphore_handle = semaphore ? dynamic_cast<SemaphoreT *>(semaphore)->GetHandle() : VK_NULL_HANDLE;
+    const auto fence_handle = fence ? dynamic_cast<FenceT *>(fence)->GetHandle() : VK_NULL_HANDLE;
+
+    if (!m_Handle)
+    {
+        m_ImageIndex = (m_ImageIndex + 1) % m_Frames.size();
+        Signal(semaphore_handle, fence_handle);
+        return m_ImageIndex;
+    }
+
+    vkAcquireNextImageKHR(
+        m_Device->GetHandle(),
+        m_Handle,
+        UINT64_MAX,
+        semaphore_handle,
+        fence_handle,
+        &m_ImageIndex);
+    return m_ImageIndex;
 }
 
-void glal::vulkan::SwapchainT::Present() const
+void glal::vulkan::SwapchainT::Present(VkQueue queue, VkSemaphore wait_semaphore) const
 {
-    // TODO
+    if (!m_Handle)
+    {
+        // nothing is shown, but the semaphore still has to be waited on before it can be signaled again
+        if (!wait_semaphore)
+            return;
+
+        constexpr VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+        const VkSubmitInfo submit_info
+        {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .waitSemaphoreCount = 1,
+            .pWaitSemaphores = &wait_semaphore,
+            .pWaitDstStageMask = &wait_stage,
+        };
+        vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE);
+        return;
+    }
+
     const VkPresentInfoKHR present_info
     {
         .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-        .waitSemaphoreCount = 0,
-        .pWaitSemaphores = nullptr,
+        .waitSemaphoreCount = wait_semaphore ? 1u : 0u,
+        .pWaitSemaphores = &wait_semaphore,
         .swapchainCount = 1,
         .pSwapchains = &m_Handle,
-        .pImageIndices = nullptr,
+        .pImageIndices = &m_ImageIndex,
         .pResults = nullptr,
     };
 
-    // TODO: queue
-    vkQueuePresentKHR(nullptr, &present_info);
+    vkQueuePresentKHR(queue, &present_info);
+}
+
+void glal::vulkan::SwapchainT::Signal(VkSemaphore semaphore, VkFence fence) const
+{
+    if (!semaphore && !fence)
+        return;
+
+    const VkSubmitInfo submit_info
+    {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .signalSemaphoreCount = semaphore ? 1u : 0u,
+        .pSignalSemaphores = &semaphore,
+    };
+
+    const auto queue = dynamic_cast<QueueT *>(m_Device->GetQueue(QueueType_Graphics));
+    vkQueueSubmit(queue->GetHandle(), 1, &submit_info, fence);
 }
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+#include <glal/enum.hxx>
+
+namespace texconv
+{
+    /**
+     * Source Image - tightly packed rgba8 pixels, rows from top to bottom
+     */
+    struct SourceImage
+    {
+        std::uint32_t Width;
+        std::uint32_t Height;
+        std::vector<std::uint8_t> Pixels;
+    };
+
+    /**
+     * LoadNetpbm - reads binary pgm (P5), ppm (P6) and pam (P7) files with 8 bit channels, missing channels are
+     * expanded to opaque rgba
+     */
+    SourceImage LoadNetpbm(const std::filesystem::path &path);
+
+    /**
+     * Downsample - halves the image with a box filter, srgb images are averaged in linear space
+     */
+    SourceImage Downsample(const SourceImage &image, bool srgb);
+
+    /**
+     * Encode - converts a single mip level to the target format, partial blocks at the edges repeat the last row
+     * and column
+     */
+    std::vector<char> Encode(const SourceImage &image, glal::ImageFormat format);
+
+    /**
+     * block encoders, each reads a 4x4 block of rgba8 pixels and writes one compressed block
+     */
+    void EncodeBC1(const std::uint8_t *block, std::uint8_t *dst);
+    void EncodeBC3(const std::uint8_t *block, std::uint8_t *dst);
+    void EncodeBC4(const std::uint8_t *block, std::uint32_t channel, std::uint8_t *dst);
+    void EncodeBC5(const std::uint8_t *block, std::uint8_t *dst);
+}
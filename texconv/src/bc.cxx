@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <texconv/texconv.hxx>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define TEXCONV_SSE2
+#include <emmintrin.h>
+#endif
+
+static std::uint16_t to_565(const std::uint8_t *color)
+{
+    const auto r = (color[0] * 31u + 127u) / 255u;
+    const auto g = (color[1] * 63u + 127u) / 255u;
+    const auto b = (color[2] * 31u + 127u) / 255u;
+    return static_cast<std::uint16_t>(r << 11 | g << 5 | b);
+}
+
+static void from_565(const std::uint16_t value, std::uint8_t *color)
+{
+    const auto r = value >> 11 & 0x1f;
+    const auto g = value >> 5 & 0x3f;
+    const auto b = value & 0x1f;
+    color[0] = static_cast<std::uint8_t>(r << 3 | r >> 2);
+    color[1] = static_cast<std::uint8_t>(g << 2 | g >> 4);
+    color[2] = static_cast<std::uint8_t>(b << 3 | b >> 2);
+    color[3] = 0;
+}
+
+/**
+ * per-channel bounding box of the 16 pixels of a block
+ */
+static void get_bounds(const std::uint8_t *block, std::uint8_t *min, std::uint8_t *max)
+{
+#ifdef TEXCONV_SSE2
+    auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+    auto hi = lo;
+    for (std::uint32_t i = 1; i < 4; ++i)
+    {
+        const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i * 16));
+        lo = _mm_min_epu8(lo, pixels);
+        hi = _mm_max_epu8(hi, pixels);
+    }
+
+    // fold the four pixels of each register onto the first one
+    lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 8));
+    lo = _mm_min_epu8(lo, _mm_srli_si128(lo, 4));
+    hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 8));
+    hi = _mm_max_epu8(hi, _mm_srli_si128(hi, 4));
+
+    const auto min_value = _mm_cvtsi128_si32(lo);
+    const auto max_value = _mm_cvtsi128_si32(hi);
+    std::memcpy(min, &min_value, 4);
+    std::memcpy(max, &max_value, 4);
+#else
+    std::memcpy(min, block, 4);
+    std::memcpy(max, block, 4);
+    for (std::uint32_t i = 1; i < 16; ++i)
+        for (std::uint32_t c = 0; c < 4; ++c)
+        {
+            min[c] = std::min(min[c], block[i * 4 + c]);
+            max[c] = std::max(max[c], block[i * 4 + c]);
+        }
+#endif
+}
+
+#ifdef TEXCONV_SSE2
+/**
+ * squared rgb distances of four pixels, given as two registers of 16 bit channels, to a palette color
+ */
+static __m128i get_distances(const __m128i lo, const __m128i hi, const __m128i color)
+{
+    const auto rgb_mask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+
+    const auto delta_lo = _mm_and_si128(_mm_sub_epi16(lo, color), rgb_mask);
+    const auto delta_hi = _mm_and_si128(_mm_sub_epi16(hi, color), rgb_mask);
+
+    // r*r + g*g and b*b + 0 for each pixel
+    const auto square_lo = _mm_castsi128_ps(_mm_madd_epi16(delta_lo, delta_lo));
+    const auto square_hi = _mm_castsi128_ps(_mm_madd_epi16(delta_hi, delta_hi));
+
+    const auto rg = _mm_castps_si128(_mm_shuffle_ps(square_lo, square_hi, _MM_SHUFFLE(2, 0, 2, 0)));
+    const auto b = _mm_castps_si128(_mm_shuffle_ps(square_lo, square_hi, _MM_SHUFFLE(3, 1, 3, 1)));
+    return _mm_add_epi32(rg, b);
+}
+#endif
+
+/**
+ * picks the closest palette entry for every pixel, two bits per pixel starting at the lowest
+ */
+static std::uint32_t select_indices(const std::uint8_t *block, const std::uint8_t (&palette)[4][4])
+{
+    std::uint32_t indices = 0;
+
+#ifdef TEXCONV_SSE2
+    const auto zero = _mm_setzero_si128();
+
+    __m128i colors[4];
+    for (std::uint32_t k = 0; k < 4; ++k)
+        colors[k] = _mm_set_epi16(0, palette[k][2], palette[k][1], palette[k][0], 0, palette[k][2], palette[k][1], palette[k][0]);
+
+    for (std::uint32_t group = 0; group < 4; ++group)
+    {
+        const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + group * 16));
+        const auto lo = _mm_unpacklo_epi8(pixels, zero);
+        const auto hi = _mm_unpackhi_epi8(pixels, zero);
+
+        auto best = get_distances(lo, hi, colors[0]);
+        auto best_index = zero;
+        for (std::uint32_t k = 1; k < 4; ++k)
+        {
+            const auto distance = get_distances(lo, hi, colors[k]);
+            const auto closer = _mm_cmplt_epi32(distance, best);
+
+            best = _mm_or_si128(_mm_and_si128(closer, distance), _mm_andnot_si128(closer, best));
+            best_index = _mm_or_si128(
+                _mm_and_si128(closer, _mm_set1_epi32(static_cast<int>(k))),
+                _mm_andnot_si128(closer, best_index));
+        }
+
+        alignas(16) std::uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(lanes), best_index);
+        for (std::uint32_t i = 0; i < 4; ++i)
+            indices |= lanes[i] << (group * 4 + i) * 2;
+    }
+#else
+    for (std::uint32_t i = 0; i < 16; ++i)
+    {
+        const auto pixel = block + i * 4;
+
+        std::uint32_t best = ~0u, best_index = 0;
+        for (std::uint32_t k = 0; k < 4; ++k)
+        {
+            std::uint32_t distance = 0;
+            for (std::uint32_t c = 0; c < 3; ++c)
+            {
+                const auto delta = static_cast<std::int32_t>(pixel[c]) - palette[k][c];
+                distance += static_cast<std::uint32_t>(delta * delta);
+            }
+
+            if (distance < best)
+            {
+                best = distance;
+                best_index = k;
+            }
+        }
+
+        indices |= best_index << i * 2;
+    }
+#endif
+
+    return indices;
+}
+
+static void build_palette(const std::uint16_t color0, const std::uint16_t color1, std::uint8_t (&palette)[4][4])
+{
+    from_565(color0, palette[0]);
+    from_565(color1, palette[1]);
+    for (std::uint32_t c = 0; c < 3; ++c)
+    {
+        palette[2][c] = static_cast<std::uint8_t>((2 * palette[0][c] + palette[1][c] + 1) / 3);
+        palette[3][c] = static_cast<std::uint8_t>((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+    }
+    palette[2][3] = palette[3][3] = 0;
+}
+
+/**
+ * least squares fit of both endpoints to the pixels, keeping the palette positions the indices assigned them to
+ */
+static bool refine_endpoints(
+    const std::uint8_t *block,
+    const std::uint32_t indices,
+    std::uint16_t *color0,
+    std::uint16_t *color1)
+{
+    static constexpr float weights[4] = { 1.f, 0.f, 2.f / 3.f, 1.f / 3.f };
+
+    float aa = 0.f, bb = 0.f, ab = 0.f;
+    float ax[3]{}, bx[3]{};
+    for (std::uint32_t i = 0; i < 16; ++i)
+    {
+        const auto a = weights[indices >> i * 2 & 3];
+        const auto b = 1.f - a;
+
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+        for (std::uint32_t c = 0; c < 3; ++c)
+        {
+            ax[c] += a * block[i * 4 + c];
+            bx[c] += b * block[i * 4 + c];
+        }
+    }
+
+    const auto determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) < 1e-6f)
+        return false;
+
+    std::uint8_t endpoint0[4]{}, endpoint1[4]{};
+    for (std::uint32_t c = 0; c < 3; ++c)
+    {
+        const auto value0 = (ax[c] * bb - bx[c] * ab) / determinant;
+        const auto value1 = (bx[c] * aa - ax[c] * ab) / determinant;
+        endpoint0[c] = static_cast<std::uint8_t>(std::clamp(std::lround(value0), 0l, 255l));
+        endpoint1[c] = static_cast<std::uint8_t>(std::clamp(std::lround(value1), 0l, 255l));
+    }
+
+    *color0 = to_565(endpoint0);
+    *color1 = to_565(endpoint1);
+    return true;
+}
+
+static void write_bc1(std::uint8_t *dst, const std::uint16_t color0, const std::uint16_t color1, const std::uint32_t indices)
+{
+    dst[0] = static_cast<std::uint8_t>(color0);
+    dst[1] = static_cast<std::uint8_t>(color0 >> 8);
+    dst[2] = static_cast<std::uint8_t>(color1);
+    dst[3] = static_cast<std::uint8_t>(color1 >> 8);
+    for (std::uint32_t i = 0; i < 4; ++i)
+        dst[4 + i] = static_cast<std::uint8_t>(indices >> i * 8);
+}
+
+void texconv::EncodeBC1(const std::uint8_t *block, std::uint8_t *dst)
+{
+    std::uint8_t min[4], max[4];
+    get_bounds(block, min, max);
+
+    // pull the endpoints inwards, the interpolated entries then cover the box better
+    for (std::uint32_t c = 0; c < 3; ++c)
+    {
+        const auto inset = static_cast<std::uint8_t>((max[c] - min[c]) >> 4);
+        min[c] += inset;
+        max[c] -= inset;
+    }
+
+    // a componentwise larger color never packs to a smaller 565 value, so this is the four color mode
+    auto color0 = to_565(max);
+    auto color1 = to_565(min);
+    if (color0 == color1)
+    {
+        write_bc1(dst, color0, color1, 0);
+        return;
+    }
+
+    std::uint8_t palette[4][4];
+    build_palette(color0, color1, palette);
+    auto indices = select_indices(block, palette);
+
+    if (std::uint16_t refined0, refined1; refine_endpoints(block, indices, &refined0, &refined1))
+    {
+        if (refined0 < refined1)
+            std::swap(refined0, refined1);
+
+        if (refined0 == refined1)
+        {
+            write_bc1(dst, refined0, refined1, 0);
+            return;
+        }
+
+        color0 = refined0;
+        color1 = refined1;
+        build_palette(color0, color1, palette);
+        indices = select_indices(block, palette);
+    }
+
+    write_bc1(dst, color0, color1, indices);
+}
+
+void texconv::EncodeBC3(const std::uint8_t *block, std::uint8_t *dst)
+{
+    EncodeBC4(block, 3, dst);
+    EncodeBC1(block, dst + 8);
+}
+
+void texconv::EncodeBC4(const std::uint8_t *block, const std::uint32_t channel, std::uint8_t *dst)
+{
+    std::uint8_t min[4], max[4];
+    get_bounds(block, min, max);
+
+    const auto lo = min[channel];
+    const auto hi = max[channel];
+
+    // eight value mode: index 0 and 1 are the endpoints, 2 to 7 step from hi down to lo
+    std::uint64_t indices = 0;
+    if (hi > lo)
+    {
+        const auto range = static_cast<std::uint32_t>(hi - lo);
+        for (std::uint32_t i = 0; i < 16; ++i)
+        {
+            const auto value = static_cast<std::uint32_t>(block[i * 4 + channel] - lo);
+            const auto step = (value * 14 + range) / (range * 2);
+
+            const std::uint64_t index = step == 7 ? 0 : step == 0 ? 1 : 8 - step;
+            indices |= index << i * 3;
+        }
+    }
+
+    dst[0] = hi;
+    dst[1] = lo;
+    for (std::uint32_t i = 0; i < 6; ++i)
+        dst[2 + i] = static_cast<std::uint8_t>(indices >> i * 8);
+}
+
+void texconv::EncodeBC5(const std::uint8_t *block, std::uint8_t *dst)
+{
+    EncodeBC4(block, 0, dst);
+    EncodeBC4(block, 1, dst + 8);
+}
@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <common/log.hxx>
+#include <glal/glal.hxx>
+#include <texconv/texconv.hxx>
+
+using block_encoder_t = void (*)(const std::uint8_t *block, std::uint8_t *dst);
+
+static block_encoder_t get_block_encoder(const glal::ImageFormat format)
+{
+    switch (format)
+    {
+    case glal::ImageFormat_BC1_UNorm:
+    case glal::ImageFormat_BC1_SRGB:
+        return texconv::EncodeBC1;
+    case glal::ImageFormat_BC3_UNorm:
+    case glal::ImageFormat_BC3_SRGB:
+        return texconv::EncodeBC3;
+    case glal::ImageFormat_BC4_UNorm:
+        return [](const std::uint8_t *block, std::uint8_t *dst)
+        {
+            texconv::EncodeBC4(block, 0, dst);
+        };
+    case glal::ImageFormat_BC5_UNorm:
+        return texconv::EncodeBC5;
+    default:
+        common::Fatal("no encoder for image format {}", static_cast<int>(format));
+    }
+}
+
+std::vector<char> texconv::Encode(const SourceImage &image, const glal::ImageFormat format)
+{
+    if (format == glal::ImageFormat_RGBA8_UNorm || format == glal::ImageFormat_RGBA8_SRGB)
+        return { image.Pixels.begin(), image.Pixels.end() };
+
+    const auto encoder = get_block_encoder(format);
+
+    std::uint32_t block_size;
+    glal::GetFormatBlock(format, nullptr, nullptr, &block_size);
+
+    const auto blocks_x = (image.Width + 3) / 4;
+    const auto blocks_y = (image.Height + 3) / 4;
+
+    std::vector<char> data(glal::GetImageDataSize(format, { .Width = image.Width, .Height = image.Height, .Depth = 1 }));
+    auto dst = reinterpret_cast<std::uint8_t *>(data.data());
+
+    alignas(16) std::uint8_t block[64];
+    for (std::uint32_t by = 0; by < blocks_y; ++by)
+        for (std::uint32_t bx = 0; bx < blocks_x; ++bx)
+        {
+            for (std::uint32_t y = 0; y < 4; ++y)
+                for (std::uint32_t x = 0; x < 4; ++x)
+                {
+                    const auto src_x = std::min(bx * 4 + x, image.Width - 1);
+                    const auto src_y = std::min(by * 4 + y, image.Height - 1);
+                    const auto src = &image.Pixels[(static_cast<std::size_t>(src_y) * image.Width + src_x) * 4];
+                    std::copy_n(src, 4, &block[(y * 4 + x) * 4]);
+                }
+
+            encoder(block, dst);
+            dst += block_size;
+        }
+
+    return data;
+}
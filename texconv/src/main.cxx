@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string_view>
+#include <common/log.hxx>
+#include <fxng/texture.hxx>
+#include <texconv/texconv.hxx>
+
+struct target_format_t
+{
+    std::string_view name;
+    glal::ImageFormat format;
+    bool srgb;
+};
+
+static constexpr target_format_t target_formats[]
+{
+    { "rgba8", glal::ImageFormat_RGBA8_UNorm, false },
+    { "rgba8_srgb", glal::ImageFormat_RGBA8_SRGB, true },
+    { "bc1", glal::ImageFormat_BC1_UNorm, false },
+    { "bc1_srgb", glal::ImageFormat_BC1_SRGB, true },
+    { "bc3", glal::ImageFormat_BC3_UNorm, false },
+    { "bc3_srgb", glal::ImageFormat_BC3_SRGB, true },
+    { "bc4", glal::ImageFormat_BC4_UNorm, false },
+    { "bc5", glal::ImageFormat_BC5_UNorm, false },
+};
+
+static void print_usage()
+{
+    common::Log(
+        common::LogLevel_Info,
+        "usage: texconv <input.pgm|ppm|pam> <output> [--format <rgba8|rgba8_srgb|bc1|bc1_srgb|bc3|bc3_srgb|bc4|bc5>] [--no-mips]");
+}
+
+int main(const int argc, const char **argv)
+{
+    if (argc < 3)
+    {
+        print_usage();
+        return 1;
+    }
+
+    const std::filesystem::path input_path = argv[1];
+    const std::filesystem::path output_path = argv[2];
+
+    auto target = &target_formats[4];
+    auto mips = true;
+
+    for (int i = 3; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--no-mips"))
+        {
+            mips = false;
+            continue;
+        }
+
+        if (!std::strcmp(argv[i], "--format") && i + 1 < argc)
+        {
+            const std::string_view name = argv[++i];
+
+            const auto it = std::find_if(
+                std::begin(target_formats),
+                std::end(target_formats),
+                [&](const target_format_t &format)
+                {
+                    return format.name == name;
+                });
+            common::Assert(it != std::end(target_formats), "unknown format '{}'", name);
+
+            target = it;
+            continue;
+        }
+
+        print_usage();
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    auto image = texconv::LoadNetpbm(input_path);
+    const glal::Extent3D extent
+    {
+        .Width = image.Width,
+        .Height = image.Height,
+        .Depth = 1,
+    };
+
+    std::vector<std::vector<char>> levels;
+    levels.push_back(texconv::Encode(image, target->format));
+
+    while (mips && (image.Width > 1 || image.Height > 1))
+    {
+        image = texconv::Downsample(image, target->srgb);
+        levels.push_back(texconv::Encode(image, target->format));
+    }
+
+    fxng::SaveTexture(output_path, target->format, glal::ImageType_2D, extent, levels);
+
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    common::Log(
+        common::LogLevel_Info,
+        "converted {} to {} ({}x{}, {} mip levels, {}) in {} ms",
+        input_path,
+        output_path,
+        extent.Width,
+        extent.Height,
+        levels.size(),
+        target->name,
+        duration.count());
+    return 0;
+}
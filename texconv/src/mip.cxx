@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <texconv/texconv.hxx>
+
+static float srgb_to_linear(const float value)
+{
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static float linear_to_srgb(const float value)
+{
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+}
+
+static const std::array<float, 256> &get_srgb_table()
+{
+    static const auto table = []
+    {
+        std::array<float, 256> values{};
+        for (std::uint32_t i = 0; i < values.size(); ++i)
+            values[i] = srgb_to_linear(static_cast<float>(i) / 255.f);
+        return values;
+    }();
+    return table;
+}
+
+texconv::SourceImage texconv::Downsample(const SourceImage &image, const bool srgb)
+{
+    SourceImage result
+    {
+        .Width = std::max(image.Width >> 1, 1u),
+        .Height = std::max(image.Height >> 1, 1u),
+    };
+    result.Pixels.resize(static_cast<std::size_t>(result.Width) * result.Height * 4);
+
+    auto &srgb_table = get_srgb_table();
+
+    for (std::uint32_t y = 0; y < result.Height; ++y)
+        for (std::uint32_t x = 0; x < result.Width; ++x)
+        {
+            // odd source sizes fold the last row or column into the footprint of the last texel, nothing is dropped
+            const auto x0 = std::min(x * 2, image.Width - 1);
+            const auto x1 = x + 1 == result.Width ? image.Width - 1 : x * 2 + 1;
+            const auto y0 = std::min(y * 2, image.Height - 1);
+            const auto y1 = y + 1 == result.Height ? image.Height - 1 : y * 2 + 1;
+            const auto count = (x1 - x0 + 1) * (y1 - y0 + 1);
+
+            const auto texel = [&](const std::uint32_t sx, const std::uint32_t sy)
+            {
+                return &image.Pixels[(static_cast<std::size_t>(sy) * image.Width + sx) * 4];
+            };
+
+            const auto dst = &result.Pixels[(static_cast<std::size_t>(y) * result.Width + x) * 4];
+            for (std::uint32_t c = 0; c < 4; ++c)
+            {
+                // alpha is always linear
+                if (srgb && c < 3)
+                {
+                    auto sum = 0.f;
+                    for (auto sy = y0; sy <= y1; ++sy)
+                        for (auto sx = x0; sx <= x1; ++sx)
+                            sum += srgb_table[texel(sx, sy)[c]];
+                    dst[c] = static_cast<std::uint8_t>(std::lround(linear_to_srgb(sum / count) * 255.f));
+                    continue;
+                }
+
+                std::uint32_t sum = 0;
+                for (auto sy = y0; sy <= y1; ++sy)
+                    for (auto sx = x0; sx <= x1; ++sx)
+                        sum += texel(sx, sy)[c];
+                dst[c] = static_cast<std::uint8_t>((sum + count / 2) / count);
+            }
+        }
+
+    return result;
+}
@@ -0,0 +1,100 @@
+#include <cctype>
+#include <fstream>
+#include <string>
+#include <common/log.hxx>
+#include <texconv/texconv.hxx>
+
+/**
+ * reads the next whitespace separated token of a netpbm header, skipping comments
+ */
+static std::string read_token(std::istream &stream)
+{
+    std::string token;
+    while (stream)
+    {
+        const auto c = stream.get();
+        if (c == '#')
+        {
+            std::string comment;
+            std::getline(stream, comment);
+            continue;
+        }
+        if (c == EOF || std::isspace(c))
+        {
+            if (!token.empty())
+                break;
+            continue;
+        }
+        token += static_cast<char>(c);
+    }
+    return token;
+}
+
+texconv::SourceImage texconv::LoadNetpbm(const std::filesystem::path &path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    common::Assert(stream.is_open(), "failed to open {}", path);
+
+    const auto magic = read_token(stream);
+
+    std::uint32_t width = 0, height = 0, channels = 0, max_value = 0;
+    if (magic == "P5" || magic == "P6")
+    {
+        width = std::stoul(read_token(stream));
+        height = std::stoul(read_token(stream));
+        max_value = std::stoul(read_token(stream));
+        channels = magic == "P5" ? 1 : 3;
+    }
+    else if (magic == "P7")
+    {
+        for (auto token = read_token(stream); token != "ENDHDR"; token = read_token(stream))
+        {
+            common::Assert(!token.empty(), "unterminated pam header in {}", path);
+
+            if (token == "WIDTH")
+                width = std::stoul(read_token(stream));
+            else if (token == "HEIGHT")
+                height = std::stoul(read_token(stream));
+            else if (token == "DEPTH")
+                channels = std::stoul(read_token(stream));
+            else if (token == "MAXVAL")
+                max_value = std::stoul(read_token(stream));
+            else if (token == "TUPLTYPE")
+                read_token(stream);
+        }
+    }
+    else
+    {
+        common::Fatal("{} is not a binary netpbm file", path);
+    }
+
+    common::Assert(width && height, "{} has no pixels", path);
+    common::Assert(max_value == 255, "{} has a maximum value of {}, only 8 bit channels are supported", path, max_value);
+    common::Assert(channels >= 1 && channels <= 4, "{} has {} channels, expected 1 to 4", path, channels);
+
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(width) * height * channels);
+    stream.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    common::Assert(!!stream, "truncated pixel data in {}", path);
+
+    SourceImage image
+    {
+        .Width = width,
+        .Height = height,
+        .Pixels = std::vector<std::uint8_t>(static_cast<std::size_t>(width) * height * 4),
+    };
+
+    for (std::size_t i = 0; i < static_cast<std::size_t>(width) * height; ++i)
+    {
+        const auto src = &data[i * channels];
+        const auto dst = &image.Pixels[i * 4];
+
+        // gray (+ alpha) or rgb (+ alpha)
+        const auto color_channels = channels < 3 ? 1u : 3u;
+        dst[0] = src[0];
+        dst[1] = src[color_channels == 1 ? 0 : 1];
+        dst[2] = src[color_channels == 1 ? 0 : 2];
+        dst[3] = channels > color_channels ? src[color_channels] : 0xff;
+    }
+
+    return image;
+}